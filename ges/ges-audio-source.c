@@ -122,7 +122,7 @@ _track_changed_cb (GESAudioSource * self, GParamSpec * arg G_GNUC_UNUSED,
 static GstElement *
 ges_audio_source_create_element (GESTrackElement * trksrc)
 {
-  GstElement *volume, *vbin;
+  GstElement *volume;
   GstElement *topbin;
   GstElement *sub_element;
   GPtrArray *elements;
@@ -135,17 +135,18 @@ ges_audio_source_create_element (GESTrackElement * trksrc)
   sub_element = source_class->create_source (GES_SOURCE (trksrc));
 
   GST_DEBUG_OBJECT (trksrc, "Creating a bin sub_element ! volume");
-  vbin =
-      gst_parse_bin_from_description
-      ("audioconvert ! audioresample ! volume name=v ! capsfilter name=audio-track-caps-filter",
-      TRUE, NULL);
+  volume = gst_object_ref (gst_element_factory_make ("volume", "v"));
+  self->priv->capsfilter = gst_object_ref (gst_element_factory_make
+      ("capsfilter", "audio-track-caps-filter"));
+
   elements = g_ptr_array_new ();
-  g_ptr_array_add (elements, vbin);
+  g_ptr_array_add (elements, ges_source_make_converter ("audioconvert", NULL));
+  g_ptr_array_add (elements, ges_source_make_converter ("audioresample",
+          NULL));
+  g_ptr_array_add (elements, volume);
+  g_ptr_array_add (elements, self->priv->capsfilter);
   topbin = ges_source_create_topbin (GES_SOURCE (trksrc), "audiosrcbin",
       sub_element, elements);
-  volume = gst_bin_get_by_name (GST_BIN (vbin), "v");
-  self->priv->capsfilter = gst_bin_get_by_name (GST_BIN (vbin),
-      "audio-track-caps-filter");
 
   g_signal_connect (self, "notify::track", (GCallback) _track_changed_cb, NULL);
   _track_changed_cb (self, NULL, NULL);
@@ -41,6 +41,8 @@ struct _GESAudioTransitionPrivate
 
   GstControlSource *b_control_source;
 
+  /* Drives the native transition mixer, from 0.0 to 1.0 */
+  GstControlSource *native_control_source;
 };
 
 enum
@@ -120,6 +122,8 @@ ges_audio_transition_dispose (GObject * object)
     self->priv->b_control_source = NULL;
   }
 
+  gst_clear_object (&self->priv->native_control_source);
+
   g_signal_handlers_disconnect_by_func (GES_TRACK_ELEMENT (self),
       duration_changed_cb, NULL);
 
@@ -171,11 +175,70 @@ link_element_to_mixer_with_volume (GstBin * bin, GstElement * element,
   return G_OBJECT (volume);
 }
 
+/* Called by the GESTransitionBin each time the transition prerolls */
+static gboolean
+ges_audio_transition_use_native (GESTrackElement * element)
+{
+  GstCaps *restriction;
+  gboolean use_native;
+  GESTimeline *timeline = GES_TIMELINE_ELEMENT_GET_TIMELINE (element);
+  GESTrack *track = ges_track_element_get_track (element);
+
+  if (!timeline || !track || !timeline_get_native_transitions (timeline))
+    return FALSE;
+
+  restriction = ges_track_get_restriction_caps (track);
+  use_native = ges_audio_transition_mixer_can_mix (restriction);
+  if (!use_native)
+    GST_INFO_OBJECT (element, "Samples restricted to %" GST_PTR_FORMAT
+        " can not be mixed natively", restriction);
+  gst_clear_caps (&restriction);
+
+  return use_native;
+}
+
+/* A single mixer crossfading its two inputs */
+static GstElement *
+ges_audio_transition_create_native_element (GESAudioTransition * self)
+{
+  GstElement *topbin, *mixer;
+  GstPad *sinka_target, *sinkb_target, *src_target;
+  GstControlSource *control_source;
+
+  GST_LOG ("creating a native audio bin");
+
+  topbin = gst_bin_new ("native-transition");
+  mixer = ges_audio_transition_mixer_new ();
+  gst_bin_add (GST_BIN (topbin), mixer);
+
+  /* The first requested pad is the one being faded out */
+  sinka_target = gst_element_request_pad_simple (mixer, "sink_%u");
+  sinkb_target = gst_element_request_pad_simple (mixer, "sink_%u");
+  src_target = gst_element_get_static_pad (mixer, "src");
+
+  gst_element_add_pad (topbin, gst_ghost_pad_new ("src", src_target));
+  gst_element_add_pad (topbin, gst_ghost_pad_new ("sinka", sinka_target));
+  gst_element_add_pad (topbin, gst_ghost_pad_new ("sinkb", sinkb_target));
+
+  gst_object_unref (sinka_target);
+  gst_object_unref (sinkb_target);
+  gst_object_unref (src_target);
+
+  control_source = gst_interpolation_control_source_new ();
+  g_object_set (control_source, "mode", GST_INTERPOLATION_MODE_LINEAR, NULL);
+  gst_object_add_control_binding (GST_OBJECT (mixer),
+      gst_direct_control_binding_new (GST_OBJECT (mixer), "position",
+          control_source));
+  self->priv->native_control_source = control_source;
+
+  return topbin;
+}
+
 static GstElement *
 ges_audio_transition_create_element (GESTrackElement * track_element)
 {
   GESAudioTransition *self;
-  GstElement *topbin, *iconva, *iconvb, *oconv;
+  GstElement *topbin, *iconva, *iconvb, *oconv, *native;
   GObject *atarget, *btarget = NULL;
   const gchar *propname = "volume";
   GstElement *mixer = NULL;
@@ -187,7 +250,7 @@ ges_audio_transition_create_element (GESTrackElement * track_element)
 
   GST_LOG ("creating an audio bin");
 
-  topbin = gst_bin_new ("transition-bin");
+  topbin = gst_bin_new ("volume-transition");
   iconva = gst_element_factory_make ("audioconvert", "tr-aconv-a");
   iconvb = gst_element_factory_make ("audioconvert", "tr-aconv-b");
   oconv = gst_element_factory_make ("audioconvert", "tr-aconv-output");
@@ -231,6 +294,8 @@ ges_audio_transition_create_element (GESTrackElement * track_element)
   self->priv->a_control_source = acontrol_source;
   self->priv->b_control_source = bcontrol_source;
 
+  native = ges_audio_transition_create_native_element (self);
+
   duration =
       ges_timeline_element_get_duration (GES_TIMELINE_ELEMENT (track_element));
   ges_audio_transition_duration_changed (track_element, duration);
@@ -248,7 +313,8 @@ ges_audio_transition_create_element (GESTrackElement * track_element)
   self->priv->a_control_source = acontrol_source;
   self->priv->b_control_source = bcontrol_source;
 
-  return topbin;
+  return ges_transition_bin_new (track_element, topbin, native, NULL,
+      ges_audio_transition_use_native);
 }
 
 static void
@@ -263,6 +329,14 @@ ges_audio_transition_duration_changed (GESTrackElement * track_element,
 
   GST_INFO ("updating controller: nleobj (%p)", nleobj);
 
+  if (self->priv->native_control_source) {
+    tb = GST_TIMED_VALUE_CONTROL_SOURCE (self->priv->native_control_source);
+
+    gst_timed_value_control_source_unset_all (tb);
+    gst_timed_value_control_source_set (tb, 0, 0.0);
+    gst_timed_value_control_source_set (tb, duration, 1.0);
+  }
+
   if (G_UNLIKELY ((!self->priv->a_control_source ||
               !self->priv->b_control_source)))
     return;
@@ -142,6 +142,11 @@ void
 ges_auto_transition_set_source (GESAutoTransition * self,
     GESTrackElement * source, GESEdge edge)
 {
+  GESTimeline *timeline = GES_TIMELINE_ELEMENT_TIMELINE (self->transition);
+  /* The timeline indexes its auto-transitions by source */
+  gboolean indexed = timeline
+      && ges_timeline_unindex_auto_transition (timeline, self);
+
   _disconnect_from_source (self, self->previous_source);
   _connect_to_source (self, source);
 
@@ -149,6 +154,9 @@ ges_auto_transition_set_source (GESAutoTransition * self,
     self->next_source = source;
   else
     self->previous_source = source;
+
+  if (indexed)
+    ges_timeline_index_auto_transition (timeline, self);
 }
 
 static void
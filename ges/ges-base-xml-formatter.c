@@ -32,8 +32,11 @@ GST_DEBUG_CATEGORY_STATIC (base_xml_formatter);
 
 #define _GET_PRIV(o) (((GESBaseXmlFormatter*) o)->priv)
 
+#define STREAM_CHUNK_SIZE (64 * 1024)
+
 
 static gboolean _loading_done_cb (GESFormatter * self);
+static void _streaming_flush_pending_clips (GESBaseXmlFormatter * self);
 
 typedef struct PendingGroup
 {
@@ -58,16 +61,76 @@ typedef struct PendingAsset
   gchar *id;
 } PendingAsset;
 
-/* @STATE_CHECK_LOADABLE: Quickly check if XML is valid
+typedef enum
+{
+  PENDING_CLIP_SOURCE,
+  PENDING_CLIP_BINDING,
+  PENDING_CLIP_TRACK_ELEMENT,
+} PendingClipChildType;
+
+/* Children of a clip, as seen while streaming, waiting for the asset of the
+ * clip to be loaded */
+typedef struct PendingClipChild
+{
+  PendingClipChildType type;
+
+  GType track_element_type;
+  gchar *asset_id;
+  gchar *track_id;
+  gchar *timeline_obj_id;
+  GstStructure *children_properties;
+  GstStructure *properties;
+  gchar *metadatas;
+
+  gchar *binding_type;
+  gchar *source_type;
+  gchar *property_name;
+  gint mode;
+  GSList *timed_values;
+} PendingClipChild;
+
+typedef struct PendingClip
+{
+  gchar *id;
+  gchar *asset_id;
+  GType type;
+  GstClockTime start;
+  GstClockTime inpoint;
+  GstClockTime duration;
+  guint layer_prio;
+  GESTrackType track_types;
+  GstStructure *properties;
+  GstStructure *children_properties;
+  gchar *metadatas;
+
+  /* PendingClipChild, in reverse order */
+  GList *children;
+} PendingClip;
+
+/* An asset being loaded while streaming */
+typedef struct LoadingAsset
+{
+  /* PendingClip referencing the asset */
+  GQueue pending_clips;
+
+  /* IDs of the assets which are waiting for this asset, as their proxy, to
+   * be loaded */
+  GList *proxied_ids;
+} LoadingAsset;
+
+/* @STATE_CHECK_LOADABLE: Quickly check the root element of the XML
  * @STATE_ASSETS: start loading all assets asynchronously
  * and setup all elements that are synchronously loadable (tracks, and layers basically).
  * @STATE_LOADING_CLIPS: adding clips and groups to the timeline
+ * @STATE_STREAMING: single pass loading, assets are requested as soon as
+ * they are parsed and clips are added as soon as their asset is loaded
  */
 typedef enum
 {
   STATE_CHECK_LOADABLE,
   STATE_LOADING_ASSETS_AND_SYNC,
   STATE_LOADING_CLIPS,
+  STATE_STREAMING,
 } LoadingState;
 
 struct _GESBaseXmlFormatterPrivate
@@ -99,10 +162,38 @@ struct _GESBaseXmlFormatterPrivate
   gboolean timeline_auto_transition;
 
   GList *groups;
+
+  /* Streaming loading */
+  GInputStream *stream;
+  gboolean parsing_done;
+
+  /* Asset ID -> LoadingAsset */
+  GHashTable *loading_assets;
+
+  /* PendingAsset to be requested once the current chunk is parsed */
+  GList *assets_to_request;
+
+  /* Clip being parsed, waiting for its asset */
+  PendingClip *deferred_clip;
+
+  /* Chunk being parsed, and position of its first byte */
+  const gchar *chunk;
+  gsize chunk_size;
+  guint64 chunk_offset;
+  gint chunk_line;
+  guint64 chunk_line_start;
+
+  /* Part of the stream being captured, see
+   * ges_base_xml_formatter_start_capture() */
+  GString *capture;
+  guint64 capture_offset;
 };
 
 static void new_asset_cb (GESAsset * source, GAsyncResult * res,
     PendingAsset * passet);
+static void _check_loading_done (GESFormatter * self);
+static void _free_pending_asset (GESBaseXmlFormatterPrivate * priv,
+    PendingAsset * passet);
 
 static const gchar *
 loading_state_name (LoadingState state)
@@ -114,11 +205,32 @@ loading_state_name (LoadingState state)
       return "loading-assets-and-sync";
     case STATE_LOADING_CLIPS:
       return "loading-clips";
+    case STATE_STREAMING:
+      return "streaming";
   }
 
   return "??";
 }
 
+static inline gboolean
+_loads_sync_elements (GESBaseXmlFormatterPrivate * priv)
+{
+  return priv->state == STATE_LOADING_ASSETS_AND_SYNC
+      || priv->state == STATE_STREAMING;
+}
+
+static inline gboolean
+_loads_clips (GESBaseXmlFormatterPrivate * priv)
+{
+  return priv->state == STATE_LOADING_CLIPS || priv->state == STATE_STREAMING;
+}
+
+static gboolean
+_streaming_enabled (GESFormatter * self)
+{
+  return self->project && ges_project_get_streaming_load (self->project);
+}
+
 
 static void
 _free_layer_entry (LayerEntry * entry)
@@ -136,6 +248,57 @@ _free_pending_group (PendingGroup * pgroup)
   g_slice_free (PendingGroup, pgroup);
 }
 
+static GstStructure *
+_copy_structure (GstStructure * structure)
+{
+  return structure ? gst_structure_copy (structure) : NULL;
+}
+
+static void
+_free_structure (GstStructure * structure)
+{
+  if (structure)
+    gst_structure_free (structure);
+}
+
+static void
+_free_pending_clip_child (PendingClipChild * child)
+{
+  g_free (child->asset_id);
+  g_free (child->track_id);
+  g_free (child->timeline_obj_id);
+  _free_structure (child->children_properties);
+  _free_structure (child->properties);
+  g_free (child->metadatas);
+  g_free (child->binding_type);
+  g_free (child->source_type);
+  g_free (child->property_name);
+  g_slist_free_full (child->timed_values, g_free);
+  g_slice_free (PendingClipChild, child);
+}
+
+static void
+_free_pending_clip (PendingClip * pclip)
+{
+  g_free (pclip->id);
+  g_free (pclip->asset_id);
+  _free_structure (pclip->properties);
+  _free_structure (pclip->children_properties);
+  g_free (pclip->metadatas);
+  g_list_free_full (pclip->children,
+      (GDestroyNotify) _free_pending_clip_child);
+  g_slice_free (PendingClip, pclip);
+}
+
+static void
+_free_loading_asset (LoadingAsset * lasset)
+{
+  g_queue_clear_full (&lasset->pending_clips,
+      (GDestroyNotify) _free_pending_clip);
+  g_list_free_full (lasset->proxied_ids, g_free);
+  g_slice_free (LoadingAsset, lasset);
+}
+
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (GESBaseXmlFormatter,
     ges_base_xml_formatter, GES_TYPE_FORMATTER);
 static gint
@@ -249,25 +412,284 @@ failed:
   return NULL;
 }
 
+/***********************************************
+ *                                             *
+ *              Streaming loading              *
+ *                                             *
+ ***********************************************/
+
+/* When GESProject:streaming-load is set, the project file is read and parsed
+ * in chunks in a single pass instead of being loaded in memory and parsed
+ * twice. Assets are requested as soon as the chunk they are in is parsed,
+ * and clips whose asset is still being loaded are kept aside, along with
+ * their children, until it is. */
+
+/* Returns the offset in the stream of a position reported by the parser,
+ * which has to be in the chunk being parsed. */
+static guint64
+_stream_position_offset (GESBaseXmlFormatterPrivate * priv, gint line_number,
+    gint char_number)
+{
+  gsize i;
+  gint line = priv->chunk_line;
+  guint64 line_start = priv->chunk_line_start;
+
+  for (i = 0; i < priv->chunk_size && line < line_number; i++) {
+    if (priv->chunk[i] == '\n') {
+      line++;
+      line_start = priv->chunk_offset + i + 1;
+    }
+  }
+
+  return line_start + char_number - 1;
+}
+
+static void
+_stream_request_assets (GESBaseXmlFormatter * self)
+{
+  GList *tmp;
+  GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
+
+  priv->assets_to_request = g_list_sort (priv->assets_to_request,
+      (GCompareFunc) compare_assets_for_loading);
+  for (tmp = priv->assets_to_request; tmp; tmp = tmp->next) {
+    PendingAsset *passet = tmp->data;
+
+    ges_project_add_loading_asset (GES_FORMATTER (self)->project,
+        passet->extractable_type, passet->id);
+    ges_asset_request_async (passet->extractable_type, passet->id, NULL,
+        (GAsyncReadyCallback) new_asset_cb, passet);
+  }
+  g_clear_pointer (&priv->assets_to_request, g_list_free);
+}
+
+static gboolean
+_stream_parse_chunk (GESBaseXmlFormatter * self, GBytes * bytes,
+    GError ** error)
+{
+  gsize i;
+  gboolean res;
+  GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
+
+  priv->chunk = g_bytes_get_data (bytes, &priv->chunk_size);
+  if (priv->capture)
+    g_string_append_len (priv->capture, priv->chunk, priv->chunk_size);
+
+  res = g_markup_parse_context_parse (priv->parsecontext, priv->chunk,
+      priv->chunk_size, error);
+
+  for (i = 0; i < priv->chunk_size; i++) {
+    if (priv->chunk[i] == '\n') {
+      priv->chunk_line++;
+      priv->chunk_line_start = priv->chunk_offset + i + 1;
+    }
+  }
+  priv->chunk_offset += priv->chunk_size;
+  priv->chunk = NULL;
+  priv->chunk_size = 0;
+
+  /* Subprojects are only usable once fully captured */
+  if (res && !priv->capture)
+    _stream_request_assets (self);
+
+  return res;
+}
+
+/* Takes ownership of @error */
+static void
+_streaming_parsing_done (GESBaseXmlFormatter * self, GError * error)
+{
+  GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
+
+  if (error) {
+    GST_WARNING_OBJECT (self, "failed to load contents: %s", error->message);
+    if (!priv->asset_error)
+      priv->asset_error = error;
+    else
+      g_error_free (error);
+
+    while (priv->assets_to_request) {
+      PendingAsset *passet = priv->assets_to_request->data;
+
+      priv->assets_to_request = g_list_delete_link (priv->assets_to_request,
+          priv->assets_to_request);
+      gst_object_unref (passet->formatter);
+      _free_pending_asset (priv, passet);
+    }
+  } else {
+    _stream_request_assets (self);
+  }
+
+  priv->parsing_done = TRUE;
+}
+
+static void
+_stream_done (GESBaseXmlFormatter * self, GError * error)
+{
+  GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
+
+  g_input_stream_close (priv->stream, NULL, NULL);
+  g_clear_object (&priv->stream);
+  if (priv->capture) {
+    g_string_free (priv->capture, TRUE);
+    priv->capture = NULL;
+  }
+
+  GST_INFO_OBJECT (self, "Done parsing %" G_GUINT64_FORMAT " bytes",
+      priv->chunk_offset);
+  _streaming_parsing_done (self, error);
+  _check_loading_done (GES_FORMATTER (self));
+  gst_object_unref (self);
+}
+
+static void
+_stream_read_cb (GInputStream * stream, GAsyncResult * res,
+    GESBaseXmlFormatter * self)
+{
+  GError *err = NULL;
+  GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
+  GBytes *bytes = g_input_stream_read_bytes_finish (stream, res, &err);
+
+  if (bytes && g_bytes_get_size (bytes)) {
+    if (_stream_parse_chunk (self, bytes, &err)) {
+      g_bytes_unref (bytes);
+      g_input_stream_read_bytes_async (stream, STREAM_CHUNK_SIZE,
+          G_PRIORITY_DEFAULT, NULL, (GAsyncReadyCallback) _stream_read_cb,
+          self);
+
+      return;
+    }
+  } else if (bytes) {
+    g_markup_parse_context_end_parse (priv->parsecontext, &err);
+  }
+
+  if (bytes)
+    g_bytes_unref (bytes);
+  _stream_done (self, err);
+}
+
+static gboolean
+_load_streaming (GESBaseXmlFormatter * self, const gchar * uri,
+    GError ** error)
+{
+  GFile *file;
+  GESBaseXmlFormatterClass *self_class =
+      GES_BASE_XML_FORMATTER_GET_CLASS (self);
+  GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
+
+  file = g_file_new_for_uri (uri);
+  priv->stream = G_INPUT_STREAM (g_file_read (file, NULL, error));
+  g_object_unref (file);
+  if (!priv->stream) {
+    GST_INFO_OBJECT (self, "failed to open \"%s\"", uri);
+    return FALSE;
+  }
+
+  GST_DEBUG_OBJECT (self, "Streaming %s", uri);
+  ges_base_xml_formatter_start_streaming (self);
+  priv->chunk_offset = 0;
+  priv->chunk_line = 1;
+  priv->chunk_line_start = 0;
+  priv->parsecontext = g_markup_parse_context_new (&self_class->content_parser,
+      G_MARKUP_TREAT_CDATA_AS_TEXT, self, NULL);
+
+  g_input_stream_read_bytes_async (priv->stream, STREAM_CHUNK_SIZE,
+      G_PRIORITY_DEFAULT, NULL, (GAsyncReadyCallback) _stream_read_cb,
+      gst_object_ref (self));
+
+  return TRUE;
+}
+
 /***********************************************
  *                                             *
  * GESFormatter virtual methods implementation *
  *                                             *
  ***********************************************/
 
+/* Maximum number of bytes read from the beginning of a file to find its root
+ * element when checking if it can be loaded */
+#define CHECK_LOADABLE_MAX_SIZE (64 * 1024)
+
+typedef struct
+{
+  GESBaseXmlFormatter *self;
+  gboolean root_parsed;
+} CheckLoadableData;
+
+static void
+_check_loadable_start_element (GMarkupParseContext * context,
+    const gchar * element_name, const gchar ** attribute_names,
+    const gchar ** attribute_values, gpointer udata, GError ** error)
+{
+  CheckLoadableData *data = udata;
+  GESBaseXmlFormatterClass *self_class =
+      GES_BASE_XML_FORMATTER_GET_CLASS (data->self);
+
+  self_class->content_parser.start_element (context, element_name,
+      attribute_names, attribute_values, data->self, error);
+  if (*error)
+    return;
+
+  /* Only the root element is checked, stop parsing */
+  data->root_parsed = TRUE;
+  g_set_error_literal (error, G_MARKUP_ERROR, G_MARKUP_ERROR_PARSE,
+      "Root element parsed");
+}
+
 static gboolean
 _can_load_uri (GESFormatter * dummy_formatter, const gchar * uri,
     GError ** error)
 {
+  GFile *file;
+  gssize len;
+  gsize total = 0;
+  GError *err = NULL;
+  GInputStream *stream;
   GMarkupParseContext *ctx;
+  gchar buffer[4096];
+  GMarkupParser parser = { _check_loadable_start_element, };
   GESBaseXmlFormatter *self = GES_BASE_XML_FORMATTER (dummy_formatter);
+  CheckLoadableData data = { self, FALSE };
+
+  file = g_file_new_for_uri (uri);
+  stream = G_INPUT_STREAM (g_file_read (file, NULL, &err));
+  g_object_unref (file);
+  if (!stream) {
+    GST_INFO_OBJECT (self, "failed to read \"%s\": %s", uri, err->message);
+    g_propagate_error (error, err);
 
-  ctx = _load_and_parse (self, uri, error, STATE_CHECK_LOADABLE);
-  if (!ctx)
     return FALSE;
+  }
+
+  _GET_PRIV (self)->state = STATE_CHECK_LOADABLE;
+  GST_DEBUG_OBJECT (self, "Checking the root element of %s", uri);
+  ctx = g_markup_parse_context_new (&parser, G_MARKUP_TREAT_CDATA_AS_TEXT,
+      &data, NULL);
+  while (!err && total < CHECK_LOADABLE_MAX_SIZE) {
+    len = g_input_stream_read (stream, buffer, sizeof (buffer), NULL, &err);
+    if (len <= 0)
+      break;
 
+    total += len;
+    g_markup_parse_context_parse (ctx, buffer, len, &err);
+  }
   g_markup_parse_context_free (ctx);
-  return TRUE;
+  g_object_unref (stream);
+
+  if (data.root_parsed) {
+    g_clear_error (&err);
+
+    return TRUE;
+  }
+
+  if (!err)
+    err = g_error_new (GST_RESOURCE_ERROR, GST_RESOURCE_ERROR_FAILED,
+        total ? "No root element found in \"%s\"" :
+        "Nothing contained in the project file \"%s\"", uri);
+  GST_WARNING_OBJECT (self, "Can not load %s: %s", uri, err->message);
+  g_propagate_error (error, err);
+
+  return FALSE;
 }
 
 static gboolean
@@ -279,6 +701,9 @@ _load_from_uri (GESFormatter * self, GESTimeline * timeline, const gchar * uri,
   GST_INFO_OBJECT (self, "Loading %s in %" GST_PTR_FORMAT, uri, timeline);
   ges_timeline_set_auto_transition (timeline, FALSE);
 
+  if (_streaming_enabled (self))
+    return _load_streaming (GES_BASE_XML_FORMATTER (self), uri, error);
+
   priv->parsecontext =
       _load_and_parse (GES_BASE_XML_FORMATTER (self), uri, error,
       STATE_LOADING_ASSETS_AND_SYNC);
@@ -377,6 +802,7 @@ _dispose (GObject * object)
   g_clear_pointer (&priv->containers, g_hash_table_unref);
   g_clear_pointer (&priv->tracks, g_hash_table_unref);
   g_clear_pointer (&priv->layers, g_hash_table_unref);
+  g_clear_pointer (&priv->loading_assets, g_hash_table_unref);
 
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
@@ -513,6 +939,9 @@ _loading_done (GESFormatter * self)
   }
   g_list_free_full (assets, g_object_unref);
 
+  if (priv->state == STATE_STREAMING)
+    _streaming_flush_pending_clips (GES_BASE_XML_FORMATTER (self));
+
   if (priv->asset_error) {
     error = priv->asset_error;
     priv->asset_error = NULL;
@@ -544,6 +973,20 @@ _loading_done_cb (GESFormatter * self)
   return FALSE;
 }
 
+static void
+_check_loading_done (GESFormatter * self)
+{
+  GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
+
+  if (priv->pending_assets)
+    return;
+
+  if (priv->state == STATE_STREAMING && !priv->parsing_done)
+    return;
+
+  _loading_done (self);
+}
+
 static gboolean
 _set_child_property (GQuark field_id, const GValue * value,
     GESTimelineElement * tlelement)
@@ -666,6 +1109,167 @@ _free_pending_asset (GESBaseXmlFormatterPrivate * priv, PendingAsset * passet)
   g_slice_free (PendingAsset, passet);
 }
 
+static void
+_replay_pending_clip (GESBaseXmlFormatter * self, PendingClip * pclip)
+{
+  GList *tmp;
+  GError *err = NULL;
+  GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
+
+  ges_base_xml_formatter_add_clip (self, pclip->id, pclip->asset_id,
+      pclip->type, pclip->start, pclip->inpoint, pclip->duration,
+      pclip->layer_prio, pclip->track_types, pclip->properties,
+      pclip->children_properties, pclip->metadatas, &err);
+
+  if (!priv->current_clip)
+    goto done;
+
+  pclip->children = g_list_reverse (pclip->children);
+  for (tmp = pclip->children; tmp && !err; tmp = tmp->next) {
+    PendingClipChild *child = tmp->data;
+
+    switch (child->type) {
+      case PENDING_CLIP_SOURCE:
+        ges_base_xml_formatter_add_source (self, child->track_id,
+            child->children_properties, child->properties);
+        break;
+      case PENDING_CLIP_BINDING:
+        ges_base_xml_formatter_add_control_binding (self, child->binding_type,
+            child->source_type, child->property_name, child->mode,
+            child->track_id, child->timed_values);
+        /* Ownership transfered */
+        child->timed_values = NULL;
+        break;
+      case PENDING_CLIP_TRACK_ELEMENT:
+        ges_base_xml_formatter_add_track_element (self,
+            child->track_element_type, child->asset_id, child->track_id,
+            child->timeline_obj_id, child->children_properties,
+            child->properties, child->metadatas, &err);
+        break;
+    }
+  }
+  ges_base_xml_formatter_end_current_clip (self);
+
+done:
+  if (err) {
+    GST_WARNING_OBJECT (self, "Could not add clip %s: %s", pclip->id,
+        err->message);
+    if (!priv->asset_error)
+      priv->asset_error = err;
+    else
+      g_error_free (err);
+  }
+}
+
+/* Adds the clips that were waiting for @id to be loaded */
+static void
+_streaming_asset_ready (GESBaseXmlFormatter * self, const gchar * id)
+{
+  GList *tmp;
+  PendingClip *pclip;
+  LoadingAsset *lasset;
+  gchar *key;
+  GESClip *current_clip;
+  GstClockTime current_clip_duration;
+  GESTrackElement *current_track_element;
+  PendingClip *deferred_clip;
+  GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
+
+  if (!g_hash_table_lookup_extended (priv->loading_assets, id,
+          (gpointer *) & key, (gpointer *) & lasset))
+    return;
+  g_hash_table_steal (priv->loading_assets, id);
+
+  GST_DEBUG_OBJECT (self, "%s ready, adding %u clips", id,
+      lasset->pending_clips.length);
+
+  /* We might be in the middle of parsing a clip */
+  current_clip = priv->current_clip;
+  current_clip_duration = priv->current_clip_duration;
+  current_track_element = priv->current_track_element;
+  deferred_clip = priv->deferred_clip;
+  priv->current_clip = NULL;
+  priv->current_track_element = NULL;
+  priv->deferred_clip = NULL;
+
+  while ((pclip = g_queue_pop_head (&lasset->pending_clips))) {
+    _replay_pending_clip (self, pclip);
+    _free_pending_clip (pclip);
+  }
+
+  priv->current_clip = current_clip;
+  priv->current_clip_duration = current_clip_duration;
+  priv->current_track_element = current_track_element;
+  priv->deferred_clip = deferred_clip;
+
+  for (tmp = lasset->proxied_ids; tmp; tmp = tmp->next)
+    _streaming_asset_ready (self, tmp->data);
+
+  _free_loading_asset (lasset);
+  g_free (key);
+}
+
+static void
+_streaming_asset_loaded (GESBaseXmlFormatter * self, GESAsset * asset,
+    PendingAsset * passet)
+{
+  LoadingAsset *proxy_lasset = NULL;
+  GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
+
+  /* Set @asset as the proxy of the assets which already tried to use it,
+   * as done for all assets at the end of the loading otherwise */
+  ges_asset_finish_proxy (asset);
+
+  if (passet->proxy_id) {
+    proxy_lasset = g_hash_table_lookup (priv->loading_assets,
+        passet->proxy_id);
+
+    if (proxy_lasset) {
+      GST_DEBUG_OBJECT (self, "%s waiting for its proxy %s to be loaded",
+          passet->id, passet->proxy_id);
+      proxy_lasset->proxied_ids = g_list_prepend (proxy_lasset->proxied_ids,
+          g_strdup (passet->id));
+
+      return;
+    } else {
+      GESAsset *proxy = ges_project_get_asset (GES_FORMATTER (self)->project,
+          passet->proxy_id, passet->extractable_type);
+
+      if (proxy) {
+        ges_asset_finish_proxy (proxy);
+        gst_object_unref (proxy);
+      }
+    }
+  }
+
+  _streaming_asset_ready (self, passet->id);
+}
+
+/* Adds the clips for which we never got the asset, the errors will be
+ * reported as for any other clip */
+static void
+_streaming_flush_pending_clips (GESBaseXmlFormatter * self)
+{
+  gchar *id;
+  gpointer key;
+  GHashTableIter iter;
+  GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
+
+  if (!priv->loading_assets)
+    return;
+
+  /* Making an asset ready can make other ones ready too */
+  while (g_hash_table_size (priv->loading_assets)) {
+    g_hash_table_iter_init (&iter, priv->loading_assets);
+    g_hash_table_iter_next (&iter, &key, NULL);
+
+    id = g_strdup (key);
+    GST_WARNING_OBJECT (self, "Asset %s never got loaded", id);
+    _streaming_asset_ready (self, id);
+    g_free (id);
+  }
+}
+
 static void
 new_asset_cb (GESAsset * source, GAsyncResult * res, PendingAsset * passet)
 {
@@ -696,9 +1300,11 @@ new_asset_cb (GESAsset * source, GAsyncResult * res, PendingAsset * passet)
           "- Error: %s", g_type_name (G_OBJECT_TYPE (source)), id,
           error->message);
 
-      _free_pending_asset (priv, passet);
       if (!priv->asset_error)
         priv->asset_error = g_error_copy (error);
+      if (priv->state == STATE_STREAMING)
+        _streaming_asset_ready (GES_BASE_XML_FORMATTER (self), passet->id);
+      _free_pending_asset (priv, passet);
       goto done;
     }
 
@@ -726,6 +1332,9 @@ new_asset_cb (GESAsset * source, GAsyncResult * res, PendingAsset * passet)
   ges_project_add_asset (self->project, asset);
   gst_object_unref (self);
 
+  if (priv->state == STATE_STREAMING)
+    _streaming_asset_loaded (GES_BASE_XML_FORMATTER (self), asset, passet);
+
   _free_pending_asset (priv, passet);
 
 done:
@@ -736,8 +1345,7 @@ done:
 
   g_clear_error (&error);
 
-  if (priv->pending_assets == NULL)
-    _loading_done (self);
+  _check_loading_done (self);
 }
 
 GstElement *
@@ -835,7 +1443,7 @@ ges_base_xml_formatter_add_asset (GESBaseXmlFormatter * self,
   PendingAsset *passet;
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
 
-  if (priv->state != STATE_LOADING_ASSETS_AND_SYNC) {
+  if (!_loads_sync_elements (priv)) {
     GST_DEBUG_OBJECT (self, "Not parsing assets in %s state",
         loading_state_name (priv->state));
 
@@ -851,6 +1459,13 @@ ges_base_xml_formatter_add_asset (GESBaseXmlFormatter * self,
   if (properties)
     passet->properties = gst_structure_copy (properties);
   priv->pending_assets = g_list_prepend (priv->pending_assets, passet);
+
+  if (priv->state == STATE_STREAMING) {
+    if (!g_hash_table_contains (priv->loading_assets, id))
+      g_hash_table_insert (priv->loading_assets, g_strdup (id),
+          g_slice_new0 (LoadingAsset));
+    priv->assets_to_request = g_list_prepend (priv->assets_to_request, passet);
+  }
 }
 
 void
@@ -866,12 +1481,39 @@ ges_base_xml_formatter_add_clip (GESBaseXmlFormatter * self,
   LayerEntry *entry;
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
 
-  if (priv->state != STATE_LOADING_CLIPS) {
+  if (!_loads_clips (priv)) {
     GST_DEBUG_OBJECT (self, "Not adding clip in %s state.",
         loading_state_name (priv->state));
     return;
   }
 
+  if (priv->state == STATE_STREAMING) {
+    LoadingAsset *lasset = g_hash_table_lookup (priv->loading_assets,
+        asset_id);
+
+    if (lasset) {
+      PendingClip *pclip = g_slice_new0 (PendingClip);
+
+      GST_LOG_OBJECT (self, "Clip %s waiting for %s to be loaded", id,
+          asset_id);
+      pclip->id = g_strdup (id);
+      pclip->asset_id = g_strdup (asset_id);
+      pclip->type = type;
+      pclip->start = start;
+      pclip->inpoint = inpoint;
+      pclip->duration = duration;
+      pclip->layer_prio = layer_prio;
+      pclip->track_types = track_types;
+      pclip->properties = _copy_structure (properties);
+      pclip->children_properties = _copy_structure (children_properties);
+      pclip->metadatas = g_strdup (metadatas);
+      g_queue_push_tail (&lasset->pending_clips, pclip);
+      priv->deferred_clip = pclip;
+
+      return;
+    }
+  }
+
   entry = g_hash_table_lookup (priv->layers, GINT_TO_POINTER (layer_prio));
   if (entry == NULL) {
     g_set_error (error, GES_ERROR, GES_ERROR_FORMATTER_MALFORMED_INPUT_FILE,
@@ -946,7 +1588,7 @@ ges_base_xml_formatter_add_layer (GESBaseXmlFormatter * self,
   gboolean auto_transition = FALSE;
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
 
-  if (priv->state != STATE_LOADING_ASSETS_AND_SYNC) {
+  if (!_loads_sync_elements (priv)) {
     GST_INFO_OBJECT (self, "Not loading layer in %s state.",
         loading_state_name (priv->state));
     return;
@@ -1020,7 +1662,7 @@ ges_base_xml_formatter_add_track (GESBaseXmlFormatter * self,
   GESTrack *track;
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
 
-  if (priv->state != STATE_LOADING_ASSETS_AND_SYNC) {
+  if (!_loads_sync_elements (priv)) {
     GST_INFO_OBJECT (self, "Not loading track in %s state.",
         loading_state_name (priv->state));
     return;
@@ -1066,12 +1708,28 @@ ges_base_xml_formatter_add_control_binding (GESBaseXmlFormatter * self,
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
   GESTrackElement *element = NULL;
 
-  if (priv->state != STATE_LOADING_CLIPS) {
+  if (!_loads_clips (priv)) {
     GST_DEBUG_OBJECT (self, "Not loading control bindings in %s state.",
         loading_state_name (priv->state));
     goto done;
   }
 
+  if (priv->deferred_clip) {
+    PendingClipChild *child = g_slice_new0 (PendingClipChild);
+
+    child->type = PENDING_CLIP_BINDING;
+    child->binding_type = g_strdup (binding_type);
+    child->source_type = g_strdup (source_type);
+    child->property_name = g_strdup (property_name);
+    child->mode = mode;
+    child->track_id = g_strdup (track_id);
+    child->timed_values = timed_values;
+    priv->deferred_clip->children =
+        g_list_prepend (priv->deferred_clip->children, child);
+
+    return;
+  }
+
   if (track_id[0] != '-' && priv->current_clip)
     element = _get_element_by_track_id (priv, track_id, priv->current_clip);
   else
@@ -1114,12 +1772,25 @@ ges_base_xml_formatter_add_source (GESBaseXmlFormatter * self,
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
   GESTrackElement *element = NULL;
 
-  if (priv->state != STATE_LOADING_CLIPS) {
+  if (!_loads_clips (priv)) {
     GST_DEBUG_OBJECT (self, "Not loading source elements in %s state.",
         loading_state_name (priv->state));
     return;
   }
 
+  if (priv->deferred_clip) {
+    PendingClipChild *child = g_slice_new0 (PendingClipChild);
+
+    child->type = PENDING_CLIP_SOURCE;
+    child->track_id = g_strdup (track_id);
+    child->children_properties = _copy_structure (children_properties);
+    child->properties = _copy_structure (properties);
+    priv->deferred_clip->children =
+        g_list_prepend (priv->deferred_clip->children, child);
+
+    return;
+  }
+
   if (track_id[0] != '-' && priv->current_clip)
     element = _get_element_by_track_id (priv, track_id, priv->current_clip);
   else
@@ -1152,12 +1823,29 @@ ges_base_xml_formatter_add_track_element (GESBaseXmlFormatter * self,
   GESAsset *asset = NULL;
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
 
-  if (priv->state != STATE_LOADING_CLIPS) {
+  if (!_loads_clips (priv)) {
     GST_DEBUG_OBJECT (self, "Not loading track elements in %s state.",
         loading_state_name (priv->state));
     return;
   }
 
+  if (priv->deferred_clip) {
+    PendingClipChild *child = g_slice_new0 (PendingClipChild);
+
+    child->type = PENDING_CLIP_TRACK_ELEMENT;
+    child->track_element_type = track_element_type;
+    child->asset_id = g_strdup (asset_id);
+    child->track_id = g_strdup (track_id);
+    child->timeline_obj_id = g_strdup (timeline_obj_id);
+    child->children_properties = _copy_structure (children_properties);
+    child->properties = _copy_structure (properties);
+    child->metadatas = g_strdup (metadatas);
+    priv->deferred_clip->children =
+        g_list_prepend (priv->deferred_clip->children, child);
+
+    return;
+  }
+
   if (g_type_is_a (track_element_type, GES_TYPE_TRACK_ELEMENT) == FALSE) {
     GST_DEBUG_OBJECT (self, "%s is not a TrackElement, can not create it",
         g_type_name (track_element_type));
@@ -1217,7 +1905,7 @@ ges_base_xml_formatter_add_encoding_profile (GESBaseXmlFormatter * self,
   GstEncodingContainerProfile *parent_profile = NULL;
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
 
-  if (priv->state != STATE_LOADING_ASSETS_AND_SYNC) {
+  if (!_loads_sync_elements (priv)) {
     GST_DEBUG_OBJECT (self, "Not loading encoding profiles in %s state.",
         loading_state_name (priv->state));
     goto done;
@@ -1282,7 +1970,7 @@ ges_base_xml_formatter_add_group (GESBaseXmlFormatter * self,
   PendingGroup *pgroup;
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
 
-  if (priv->state != STATE_LOADING_ASSETS_AND_SYNC) {
+  if (!_loads_sync_elements (priv)) {
     GST_DEBUG_OBJECT (self, "Not loading groups in %s state.",
         loading_state_name (priv->state));
     return;
@@ -1309,7 +1997,7 @@ ges_base_xml_formatter_last_group_add_child (GESBaseXmlFormatter * self,
   PendingGroup *pgroup;
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
 
-  if (priv->state != STATE_LOADING_CLIPS) {
+  if (!_loads_clips (priv)) {
     GST_DEBUG_OBJECT (self, "Not adding children to groups in %s state.",
         loading_state_name (priv->state));
 
@@ -1332,12 +2020,17 @@ ges_base_xml_formatter_end_current_clip (GESBaseXmlFormatter * self)
 {
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
 
-  if (priv->state != STATE_LOADING_CLIPS) {
+  if (!_loads_clips (priv)) {
     GST_DEBUG_OBJECT (self, "Not ending clip in %s state.",
         loading_state_name (priv->state));
     return;
   }
 
+  if (priv->deferred_clip) {
+    priv->deferred_clip = NULL;
+    return;
+  }
+
   g_return_if_fail (priv->current_clip);
 
   if (_DURATION (priv->current_clip) != priv->current_clip_duration)
@@ -1347,3 +2040,78 @@ ges_base_xml_formatter_end_current_clip (GESBaseXmlFormatter * self)
   priv->current_clip = NULL;
   priv->current_clip_duration = GST_CLOCK_TIME_NONE;
 }
+
+/* Captures the content of the stream being loaded between two positions
+ * reported by the parser, only needed while streaming as the whole content
+ * is available in ->xmlcontent otherwise */
+void
+ges_base_xml_formatter_start_capture (GESBaseXmlFormatter * self,
+    gint line_number, gint char_number)
+{
+  guint64 offset;
+  GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
+
+  if (priv->state != STATE_STREAMING || !priv->chunk)
+    return;
+
+  offset = _stream_position_offset (priv, line_number, char_number);
+  offset = CLAMP (offset, priv->chunk_offset,
+      priv->chunk_offset + priv->chunk_size);
+
+  if (priv->capture)
+    g_string_free (priv->capture, TRUE);
+  priv->capture_offset = offset;
+  priv->capture = g_string_new_len (priv->chunk + offset - priv->chunk_offset,
+      priv->chunk_offset + priv->chunk_size - offset);
+}
+
+gchar *
+ges_base_xml_formatter_end_capture (GESBaseXmlFormatter * self,
+    gint line_number, gint char_number, gsize * size)
+{
+  guint64 offset;
+  GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
+
+  if (!priv->capture || !priv->chunk)
+    return NULL;
+
+  offset = _stream_position_offset (priv, line_number, char_number);
+  g_string_truncate (priv->capture, MIN (priv->capture->len,
+          offset - MIN (offset, priv->capture_offset)));
+
+  *size = priv->capture->len;
+
+  return g_string_free (g_steal_pointer (&priv->capture), FALSE);
+}
+
+/* Lets subclasses which do not go through the GMarkup parser feed the
+ * formatter with the add_* methods in a single pass, as done when
+ * streaming. ges_base_xml_formatter_end_streaming() has to be called once
+ * everything has been added. */
+void
+ges_base_xml_formatter_start_streaming (GESBaseXmlFormatter * self)
+{
+  GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
+
+  priv->state = STATE_STREAMING;
+  priv->parsing_done = FALSE;
+  if (!priv->loading_assets)
+    priv->loading_assets = g_hash_table_new_full (g_str_hash, g_str_equal,
+        g_free, (GDestroyNotify) _free_loading_asset);
+}
+
+/* Requests the assets that have been added and finishes the loading once
+ * they are all loaded, takes ownership of @error which will be reported as
+ * the loading error if set */
+void
+ges_base_xml_formatter_end_streaming (GESBaseXmlFormatter * self,
+    GError * error)
+{
+  GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
+
+  g_return_if_fail (priv->state == STATE_STREAMING);
+
+  _streaming_parsing_done (self, error);
+  if (priv->pending_assets == NULL)
+    ges_idle_add ((GSourceFunc) _loading_done_cb, g_object_ref (self), NULL);
+}
@@ -0,0 +1,1124 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION: gesbinaryformatter
+ * @title: GESBinaryFormatter
+ * @short_description: Compact binary serialization of projects
+ *
+ * A #GESFormatter saving and loading projects in a compact binary
+ * representation of the same model as #GESXmlFormatter: assets, tracks,
+ * layers, clips with their effects, sources, children properties and
+ * keyframes, groups and encoding profiles. It is meant to be used where
+ * saving and loading has to be fast, for example for autosaving, and
+ * handles files with the `.gesb` extension.
+ *
+ * The file starts with the `GESB` magic and a 32 bits little endian
+ * version number, followed by a single little endian serialized #GVariant.
+ * Files are memory mapped when loading from a local URI, and are loaded
+ * in a single pass, adding clips as soon as their asset is ready.
+ *
+ * Contrary to #GESXmlFormatter, subprojects are referenced by their URI
+ * instead of being embedded in the file.
+ *
+ * Since: 1.20
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#undef VERSION
+#endif
+
+#include <string.h>
+
+#include "ges.h"
+#include "ges-internal.h"
+
+#define parent_class ges_binary_formatter_parent_class
+
+#define MAGIC "GESB"
+#define FORMAT_VERSION 1
+#define HEADER_SIZE 8
+
+#define PROFILE_TYPE "(smsmsmsmsmsmsmsuumsubb)"
+#define ASSET_TYPE "(ssssms)"
+#define TRACK_TYPE "(uusss)"
+#define BINDING_TYPE "(ssia(td))"
+#define EFFECT_TYPE "(ssisssa" BINDING_TYPE ")"
+#define SOURCE_TYPE "(imssa" BINDING_TYPE ")"
+#define CLIP_TYPE "(ussutttssmsa" EFFECT_TYPE "a" SOURCE_TYPE ")"
+#define LAYER_TYPE "(ussaua" CLIP_TYPE ")"
+#define GROUP_TYPE "(ussa(us))"
+#define TIMELINE_TYPE "(ssa" TRACK_TYPE "a" LAYER_TYPE "a" GROUP_TYPE ")"
+#define PROJECT_TYPE "(ssa" PROFILE_TYPE "a" ASSET_TYPE TIMELINE_TYPE ")"
+
+#define _GET_PRIV(o) (((GESBinaryFormatter*)o)->priv)
+
+struct _GESBinaryFormatterPrivate
+{
+  /* Only valid while saving */
+  GList *tracks;
+  GHashTable *element_id;
+  guint nbelements;
+};
+
+G_DEFINE_TYPE_WITH_PRIVATE (GESBinaryFormatter, ges_binary_formatter,
+    GES_TYPE_BASE_XML_FORMATTER);
+
+/***********************************************
+ *                                             *
+ *                   Saving                    *
+ *                                             *
+ ***********************************************/
+
+static void
+_save_encoding_profile (GVariantBuilder * builder, GstEncodingProfile * prof,
+    const gchar * parent, guint id)
+{
+  gchar *format = NULL, *restriction = NULL, *preset_properties = NULL;
+  GstCaps *caps;
+  GstStructure *properties;
+  guint pass = 0;
+  gboolean variableframerate = FALSE;
+
+  caps = gst_encoding_profile_get_format (prof);
+  if (caps) {
+    format = gst_caps_to_string (caps);
+    gst_caps_unref (caps);
+  }
+
+  caps = gst_encoding_profile_get_restriction (prof);
+  if (caps) {
+    restriction = gst_caps_to_string (caps);
+    gst_caps_unref (caps);
+  }
+
+  properties = gst_encoding_profile_get_element_properties (prof);
+  if (properties) {
+    preset_properties = gst_structure_to_string (properties);
+    gst_structure_free (properties);
+  }
+
+  if (GST_IS_ENCODING_VIDEO_PROFILE (prof)) {
+    GstEncodingVideoProfile *vp = (GstEncodingVideoProfile *) prof;
+
+    pass = gst_encoding_video_profile_get_pass (vp);
+    variableframerate = gst_encoding_video_profile_get_variableframerate (vp);
+  }
+
+  g_variant_builder_add (builder, PROFILE_TYPE,
+      gst_encoding_profile_get_type_nick (prof), parent,
+      gst_encoding_profile_get_name (prof),
+      gst_encoding_profile_get_description (prof), format,
+      gst_encoding_profile_get_preset (prof), preset_properties,
+      gst_encoding_profile_get_preset_name (prof), id,
+      gst_encoding_profile_get_presence (prof), restriction, pass,
+      variableframerate, gst_encoding_profile_is_enabled (prof));
+
+  g_free (format);
+  g_free (restriction);
+  g_free (preset_properties);
+}
+
+/* Container profiles are followed by their stream profiles, as in the XML
+ * format */
+static void
+_save_encoding_profiles (GVariantBuilder * builder, GESProject * project)
+{
+  GList *tmp, *profiles = g_list_reverse (g_list_copy ((GList *)
+          ges_project_list_encoding_profiles (project)));
+
+  g_variant_builder_open (builder, G_VARIANT_TYPE ("a" PROFILE_TYPE));
+  for (tmp = profiles; tmp; tmp = tmp->next) {
+    GstEncodingProfile *prof = GST_ENCODING_PROFILE (tmp->data);
+
+    _save_encoding_profile (builder, prof, NULL, 0);
+    if (GST_IS_ENCODING_CONTAINER_PROFILE (prof)) {
+      guint i = 0;
+      const GList *tmp2;
+
+      for (tmp2 = gst_encoding_container_profile_get_profiles
+          (GST_ENCODING_CONTAINER_PROFILE (prof)); tmp2;
+          tmp2 = tmp2->next, i++)
+        _save_encoding_profile (builder, tmp2->data,
+            gst_encoding_profile_get_name (prof), i);
+    }
+  }
+  g_variant_builder_close (builder);
+  g_list_free (profiles);
+}
+
+static gint
+sort_assets (GESAsset * a, GESAsset * b)
+{
+  if (GES_IS_PROJECT (a))
+    return -1;
+
+  if (GES_IS_PROJECT (b))
+    return 1;
+
+  return 0;
+}
+
+static void
+_save_assets (GVariantBuilder * builder, GESProject * project)
+{
+  gchar *properties, *metas;
+  GESAsset *asset, *proxy;
+  GList *assets, *tmp;
+
+  g_variant_builder_open (builder, G_VARIANT_TYPE ("a" ASSET_TYPE));
+  assets = g_list_sort (ges_project_list_assets (project,
+          GES_TYPE_EXTRACTABLE), (GCompareFunc) sort_assets);
+  for (tmp = assets; tmp; tmp = tmp->next) {
+    asset = GES_ASSET (tmp->data);
+
+    proxy = ges_asset_get_proxy (asset);
+    if (proxy && !g_list_find (assets, proxy))
+      assets = g_list_append (assets, gst_object_ref (proxy));
+
+    properties = ges_util_serialize_properties (G_OBJECT (asset), NULL, NULL);
+    metas = ges_meta_container_metas_to_string (GES_META_CONTAINER (asset));
+    g_variant_builder_add (builder, ASSET_TYPE, ges_asset_get_id (asset),
+        g_type_name (ges_asset_get_extractable_type (asset)), properties,
+        metas, proxy ? ges_asset_get_id (proxy) : NULL);
+    g_free (properties);
+    g_free (metas);
+  }
+  g_variant_builder_close (builder);
+
+  g_list_free_full (assets, gst_object_unref);
+}
+
+static void
+_save_tracks (GESBinaryFormatter * self, GVariantBuilder * builder)
+{
+  GList *tmp;
+  guint nb_tracks = 0;
+  gchar *caps, *properties, *metas;
+
+  g_variant_builder_open (builder, G_VARIANT_TYPE ("a" TRACK_TYPE));
+  for (tmp = self->priv->tracks; tmp; tmp = tmp->next) {
+    GESTrack *track = GES_TRACK (tmp->data);
+
+    properties =
+        ges_util_serialize_properties (G_OBJECT (track), NULL, "caps", NULL);
+    caps = gst_caps_to_string (ges_track_get_caps (track));
+    metas = ges_meta_container_metas_to_string (GES_META_CONTAINER (track));
+    g_variant_builder_add (builder, TRACK_TYPE, track->type, nb_tracks++,
+        caps, properties, metas);
+    g_free (caps);
+    g_free (properties);
+    g_free (metas);
+  }
+  g_variant_builder_close (builder);
+}
+
+static void
+_save_keyframes (GVariantBuilder * builder, GESTrackElement * trackelement)
+{
+  GHashTableIter iter;
+  gpointer key, value;
+
+  g_variant_builder_open (builder, G_VARIANT_TYPE ("a" BINDING_TYPE));
+  g_hash_table_iter_init (&iter,
+      ges_track_element_get_all_control_bindings (trackelement));
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    GList *timed_values, *tmp;
+    GstControlSource *source;
+    GstInterpolationMode mode;
+    gboolean absolute = FALSE;
+
+    if (!GST_IS_DIRECT_CONTROL_BINDING (value)) {
+      GST_DEBUG ("Binding type not in [direct, direct-absolute]");
+      continue;
+    }
+
+    g_object_get (value, "control-source", &source, "absolute", &absolute,
+        NULL);
+    if (!GST_IS_INTERPOLATION_CONTROL_SOURCE (source)) {
+      GST_DEBUG ("control source not in [interpolation]");
+      gst_object_unref (source);
+      continue;
+    }
+
+    g_object_get (source, "mode", &mode, NULL);
+    g_variant_builder_open (builder, G_VARIANT_TYPE (BINDING_TYPE));
+    g_variant_builder_add (builder, "s",
+        absolute ? "direct-absolute" : "direct");
+    g_variant_builder_add (builder, "s", (const gchar *) key);
+    g_variant_builder_add (builder, "i", mode);
+
+    g_variant_builder_open (builder, G_VARIANT_TYPE ("a(td)"));
+    timed_values =
+        gst_timed_value_control_source_get_all (GST_TIMED_VALUE_CONTROL_SOURCE
+        (source));
+    for (tmp = timed_values; tmp; tmp = tmp->next) {
+      GstTimedValue *timed_value = tmp->data;
+
+      g_variant_builder_add (builder, "(td)", timed_value->timestamp,
+          timed_value->value);
+    }
+    g_list_free (timed_values);
+    g_variant_builder_close (builder);
+
+    g_variant_builder_close (builder);
+    gst_object_unref (source);
+  }
+  g_variant_builder_close (builder);
+}
+
+static void
+_save_effect (GESBinaryFormatter * self, GVariantBuilder * builder,
+    GESTrackElement * trackelement)
+{
+  gint track_id;
+  gboolean serialize;
+  gchar *properties, *metas, *children_properties, *extractable_id;
+  GESTrack *track = ges_track_element_get_track (trackelement);
+
+  g_object_get (trackelement, "serialize", &serialize, NULL);
+  if (!serialize) {
+    GST_DEBUG_OBJECT (trackelement, "Should not be serialized");
+
+    return;
+  }
+
+  if (track == NULL) {
+    GST_WARNING_OBJECT (trackelement, " Not in any track, can not save it");
+
+    return;
+  }
+
+  track_id = g_list_index (self->priv->tracks, track);
+  properties = ges_util_serialize_properties (G_OBJECT (trackelement), NULL,
+      "start", "duration", "locked", "name", "priority", NULL);
+  metas =
+      ges_meta_container_metas_to_string (GES_META_CONTAINER (trackelement));
+  children_properties =
+      ges_util_serialize_children_properties (GES_TIMELINE_ELEMENT
+      (trackelement));
+  extractable_id = ges_extractable_get_id (GES_EXTRACTABLE (trackelement));
+
+  g_variant_builder_open (builder, G_VARIANT_TYPE (EFFECT_TYPE));
+  g_variant_builder_add (builder, "s", extractable_id);
+  g_variant_builder_add (builder, "s",
+      g_type_name (G_OBJECT_TYPE (trackelement)));
+  g_variant_builder_add (builder, "i", track_id);
+  g_variant_builder_add (builder, "s", properties);
+  g_variant_builder_add (builder, "s", metas);
+  g_variant_builder_add (builder, "s", children_properties);
+  _save_keyframes (builder, trackelement);
+  g_variant_builder_close (builder);
+
+  g_free (extractable_id);
+  g_free (children_properties);
+  g_free (properties);
+  g_free (metas);
+}
+
+static void
+_save_source (GESBinaryFormatter * self, GVariantBuilder * builder,
+    GESTimelineElement * element)
+{
+  gint n_props;
+  gboolean serialize;
+  gchar *properties, *children_properties;
+
+  if (!GES_IS_SOURCE (element))
+    return;
+
+  g_object_get (element, "serialize", &serialize, NULL);
+  if (!serialize) {
+    GST_DEBUG_OBJECT (element, "Should not be serialized");
+    return;
+  }
+
+  properties = ges_util_serialize_properties (G_OBJECT (element), &n_props,
+      "in-point", "priority", "start", "duration", "track", "track-type",
+      "uri", "name", "max-duration", NULL);
+  children_properties = ges_util_serialize_children_properties (element);
+
+  g_variant_builder_open (builder, G_VARIANT_TYPE (SOURCE_TYPE));
+  g_variant_builder_add (builder, "i", g_list_index (self->priv->tracks,
+          ges_track_element_get_track (GES_TRACK_ELEMENT (element))));
+  g_variant_builder_add (builder, "ms", n_props ? properties : NULL);
+  g_variant_builder_add (builder, "s", children_properties);
+  _save_keyframes (builder, GES_TRACK_ELEMENT (element));
+  g_variant_builder_close (builder);
+
+  g_free (children_properties);
+  g_free (properties);
+}
+
+static void
+_save_clip (GESBinaryFormatter * self, GVariantBuilder * builder,
+    GESClip * clip)
+{
+  GList *effects, *tmp;
+  gchar *properties, *metas, *children_properties = NULL, *extractable_id;
+  GESBinaryFormatterPrivate *priv = self->priv;
+
+  /* Handled separately, and vtype for StandardTransition as it is the asset
+   * ID */
+  properties = ges_util_serialize_properties (G_OBJECT (clip), NULL,
+      "supported-formats", "rate", "in-point", "start", "duration",
+      "max-duration", "priority", "vtype", "uri", NULL);
+  metas = ges_meta_container_metas_to_string (GES_META_CONTAINER (clip));
+  extractable_id = ges_extractable_get_id (GES_EXTRACTABLE (clip));
+  if (GES_IS_TRANSITION_CLIP (clip))
+    children_properties =
+        ges_util_serialize_children_properties (GES_TIMELINE_ELEMENT (clip));
+
+  g_variant_builder_open (builder, G_VARIANT_TYPE (CLIP_TYPE));
+  g_variant_builder_add (builder, "u", priv->nbelements);
+  g_variant_builder_add (builder, "s", extractable_id);
+  g_variant_builder_add (builder, "s", g_type_name (G_OBJECT_TYPE (clip)));
+  g_variant_builder_add (builder, "u", ges_clip_get_supported_formats (clip));
+  g_variant_builder_add (builder, "t", _START (clip));
+  g_variant_builder_add (builder, "t", _DURATION (clip));
+  g_variant_builder_add (builder, "t", _INPOINT (clip));
+  g_variant_builder_add (builder, "s", properties);
+  g_variant_builder_add (builder, "s", metas);
+  g_variant_builder_add (builder, "ms", children_properties);
+
+  g_hash_table_insert (priv->element_id, clip,
+      GUINT_TO_POINTER (priv->nbelements));
+  priv->nbelements++;
+
+  /* Effects must always be serialized in the right priority order.
+   * List order is guaranteed by the fact that ges_clip_get_top_effects
+   * sorts the effects. */
+  g_variant_builder_open (builder, G_VARIANT_TYPE ("a" EFFECT_TYPE));
+  effects = ges_clip_get_top_effects (clip);
+  for (tmp = effects; tmp; tmp = tmp->next)
+    _save_effect (self, builder, GES_TRACK_ELEMENT (tmp->data));
+  g_list_free (effects);
+  g_variant_builder_close (builder);
+
+  g_variant_builder_open (builder, G_VARIANT_TYPE ("a" SOURCE_TYPE));
+  for (tmp = GES_CONTAINER_CHILDREN (clip); tmp; tmp = tmp->next)
+    _save_source (self, builder, tmp->data);
+  g_variant_builder_close (builder);
+
+  g_variant_builder_close (builder);
+
+  g_free (extractable_id);
+  g_free (children_properties);
+  g_free (properties);
+  g_free (metas);
+}
+
+static void
+_save_layers (GESBinaryFormatter * self, GVariantBuilder * builder,
+    GESTimeline * timeline)
+{
+  GList *tmplayer, *tmp, *clips;
+  gchar *properties, *metas;
+  guint i;
+
+  g_variant_builder_open (builder, G_VARIANT_TYPE ("a" LAYER_TYPE));
+  for (tmplayer = timeline->layers; tmplayer; tmplayer = tmplayer->next) {
+    GESLayer *layer = GES_LAYER (tmplayer->data);
+
+    properties = ges_util_serialize_properties (G_OBJECT (layer), NULL,
+        "priority", NULL);
+    metas = ges_meta_container_metas_to_string (GES_META_CONTAINER (layer));
+
+    g_variant_builder_open (builder, G_VARIANT_TYPE (LAYER_TYPE));
+    g_variant_builder_add (builder, "u", ges_layer_get_priority (layer));
+    g_variant_builder_add (builder, "s", properties);
+    g_variant_builder_add (builder, "s", metas);
+
+    g_variant_builder_open (builder, G_VARIANT_TYPE ("au"));
+    for (tmp = self->priv->tracks, i = 0; tmp; tmp = tmp->next, i++) {
+      if (!ges_layer_get_active_for_track (layer, tmp->data))
+        g_variant_builder_add (builder, "u", i);
+    }
+    g_variant_builder_close (builder);
+
+    g_variant_builder_open (builder, G_VARIANT_TYPE ("a" CLIP_TYPE));
+    clips = ges_layer_get_clips (layer);
+    for (tmp = clips; tmp; tmp = tmp->next) {
+      gboolean serialize;
+
+      g_object_get (tmp->data, "serialize", &serialize, NULL);
+      if (!serialize) {
+        GST_DEBUG_OBJECT (tmp->data, "Should not be serialized");
+        continue;
+      }
+
+      _save_clip (self, builder, GES_CLIP (tmp->data));
+    }
+    g_list_free_full (clips, gst_object_unref);
+    g_variant_builder_close (builder);
+
+    g_variant_builder_close (builder);
+    g_free (properties);
+    g_free (metas);
+  }
+  g_variant_builder_close (builder);
+}
+
+/* Children groups are saved before their parent so that their ID is known */
+static void
+_save_group (GESBinaryFormatter * self, GVariantBuilder * builder,
+    GList ** seen_groups, GESGroup * group)
+{
+  GList *tmp;
+  gboolean serialize;
+  gchar *properties, *metas;
+  GESBinaryFormatterPrivate *priv = self->priv;
+
+  g_object_get (group, "serialize", &serialize, NULL);
+  if (!serialize) {
+    GST_DEBUG_OBJECT (group, "Should not be serialized");
+
+    return;
+  }
+
+  if (g_list_find (*seen_groups, group)) {
+    GST_DEBUG_OBJECT (group, "Already serialized");
+
+    return;
+  }
+
+  *seen_groups = g_list_prepend (*seen_groups, group);
+  for (tmp = GES_CONTAINER_CHILDREN (group); tmp; tmp = tmp->next) {
+    if (GES_IS_GROUP (tmp->data))
+      _save_group (self, builder, seen_groups, tmp->data);
+  }
+
+  properties = ges_util_serialize_properties (G_OBJECT (group), NULL, NULL);
+  metas = ges_meta_container_metas_to_string (GES_META_CONTAINER (group));
+
+  g_variant_builder_open (builder, G_VARIANT_TYPE (GROUP_TYPE));
+  g_variant_builder_add (builder, "u", priv->nbelements);
+  g_variant_builder_add (builder, "s", properties);
+  g_variant_builder_add (builder, "s", metas);
+  g_hash_table_insert (priv->element_id, group,
+      GUINT_TO_POINTER (priv->nbelements));
+  priv->nbelements++;
+
+  g_variant_builder_open (builder, G_VARIANT_TYPE ("a(us)"));
+  for (tmp = GES_CONTAINER_CHILDREN (group); tmp; tmp = tmp->next) {
+    g_variant_builder_add (builder, "(us)",
+        GPOINTER_TO_UINT (g_hash_table_lookup (priv->element_id, tmp->data)),
+        GES_TIMELINE_ELEMENT_NAME (tmp->data));
+  }
+  g_variant_builder_close (builder);
+
+  g_variant_builder_close (builder);
+  g_free (properties);
+  g_free (metas);
+}
+
+static void
+_save_timeline (GESBinaryFormatter * self, GVariantBuilder * builder,
+    GESTimeline * timeline)
+{
+  GList *tmp, *seen_groups = NULL;
+  gchar *properties, *metas;
+
+  /* The playback and rendering tuning knobs are not part of the project */
+  properties = ges_util_serialize_properties (G_OBJECT (timeline), NULL,
+      "update", "name", "async-handling", "message-forward",
+      "decoder-pool-size", "occlusion-culling", "warm-sources",
+      "coalesce-commits", "still-frames", "native-transitions", "smart-cut",
+      NULL);
+  ges_meta_container_set_uint64 (GES_META_CONTAINER (timeline), "duration",
+      ges_timeline_get_duration (timeline));
+  metas = ges_meta_container_metas_to_string (GES_META_CONTAINER (timeline));
+
+  g_variant_builder_open (builder, G_VARIANT_TYPE (TIMELINE_TYPE));
+  g_variant_builder_add (builder, "s", properties);
+  g_variant_builder_add (builder, "s", metas);
+  _save_tracks (self, builder);
+  _save_layers (self, builder, timeline);
+
+  g_variant_builder_open (builder, G_VARIANT_TYPE ("a" GROUP_TYPE));
+  for (tmp = ges_timeline_get_groups (timeline); tmp; tmp = tmp->next)
+    _save_group (self, builder, &seen_groups, tmp->data);
+  g_list_free (seen_groups);
+  g_variant_builder_close (builder);
+
+  g_variant_builder_close (builder);
+
+  g_free (properties);
+  g_free (metas);
+}
+
+static GString *
+_save (GESFormatter * formatter, GESTimeline * timeline, GError ** error)
+{
+  guint32 version;
+  GString *str;
+  GVariant *variant;
+  GVariantBuilder builder;
+  gchar *properties, *metas;
+  GESProject *project = formatter->project;
+  GESBinaryFormatter *self = GES_BINARY_FORMATTER (formatter);
+  GESBinaryFormatterPrivate *priv = self->priv;
+
+  priv->tracks = ges_timeline_get_tracks (timeline);
+  priv->element_id = g_hash_table_new (g_direct_hash, g_direct_equal);
+  priv->nbelements = 0;
+
+  properties = ges_util_serialize_properties (G_OBJECT (project), NULL, NULL);
+  metas = ges_meta_container_metas_to_string (GES_META_CONTAINER (project));
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE (PROJECT_TYPE));
+  g_variant_builder_add (&builder, "s", properties);
+  g_variant_builder_add (&builder, "s", metas);
+  _save_encoding_profiles (&builder, project);
+  _save_assets (&builder, project);
+  _save_timeline (self, &builder, timeline);
+  variant = g_variant_ref_sink (g_variant_builder_end (&builder));
+
+  g_free (properties);
+  g_free (metas);
+  g_list_free_full (priv->tracks, gst_object_unref);
+  priv->tracks = NULL;
+  g_clear_pointer (&priv->element_id, g_hash_table_unref);
+
+  if (G_BYTE_ORDER == G_BIG_ENDIAN) {
+    GVariant *swapped = g_variant_byteswap (variant);
+
+    g_variant_unref (variant);
+    variant = g_variant_ref_sink (swapped);
+  }
+
+  str = g_string_sized_new (HEADER_SIZE + g_variant_get_size (variant));
+  version = GUINT32_TO_LE (FORMAT_VERSION);
+  g_string_append_len (str, MAGIC, 4);
+  g_string_append_len (str, (const gchar *) &version, 4);
+  g_string_append_len (str, g_variant_get_data (variant),
+      g_variant_get_size (variant));
+  g_variant_unref (variant);
+
+  GST_DEBUG_OBJECT (self, "Serialized %" G_GSIZE_FORMAT " bytes", str->len);
+
+  return str;
+}
+
+/***********************************************
+ *                                             *
+ *                  Loading                    *
+ *                                             *
+ ***********************************************/
+
+static gboolean
+_check_header (const guint8 * data, gsize size, const gchar * uri,
+    GError ** error)
+{
+  guint32 version;
+
+  if (size < HEADER_SIZE || memcmp (data, MAGIC, 4)) {
+    g_set_error (error, GES_ERROR, GES_ERROR_FORMATTER_MALFORMED_INPUT_FILE,
+        "%s is not a binary GES project", uri);
+
+    return FALSE;
+  }
+
+  memcpy (&version, data + 4, sizeof (version));
+  version = GUINT32_FROM_LE (version);
+  if (version > FORMAT_VERSION) {
+    g_set_error (error, GES_ERROR, GES_ERROR_FORMATTER_MALFORMED_INPUT_FILE,
+        "%s uses version %u of the format, only %u is supported", uri,
+        version, FORMAT_VERSION);
+
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Maps local files, loads the others in memory */
+static GBytes *
+_load_bytes (const gchar * uri, GError ** error)
+{
+  GFile *file;
+  GBytes *bytes;
+  gchar *filename = g_filename_from_uri (uri, NULL, NULL);
+
+  if (filename) {
+    GMappedFile *mapped = g_mapped_file_new (filename, FALSE, error);
+
+    g_free (filename);
+    if (!mapped)
+      return NULL;
+
+    bytes = g_mapped_file_get_bytes (mapped);
+    g_mapped_file_unref (mapped);
+
+    return bytes;
+  }
+
+  file = g_file_new_for_uri (uri);
+  bytes = g_file_load_bytes (file, NULL, NULL, error);
+  g_object_unref (file);
+
+  return bytes;
+}
+
+static gboolean
+_structure_from_string (const gchar * str, GstStructure ** structure,
+    GError ** error)
+{
+  *structure = NULL;
+  if (!str)
+    return TRUE;
+
+  *structure = gst_structure_from_string (str, NULL);
+  if (!*structure) {
+    g_set_error (error, GES_ERROR, GES_ERROR_FORMATTER_MALFORMED_INPUT_FILE,
+        "Could not deserialize '%s'", str);
+
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+static GType
+_get_type (const gchar * type_name, GType parent_type, GError ** error)
+{
+  GType type = g_type_from_name (type_name);
+
+  if (!g_type_is_a (type, parent_type)) {
+    g_set_error (error, GES_ERROR, GES_ERROR_FORMATTER_MALFORMED_INPUT_FILE,
+        "%s is not a %s", type_name, g_type_name (parent_type));
+
+    return G_TYPE_NONE;
+  }
+
+  return type;
+}
+
+static void
+_load_encoding_profiles (GESBinaryFormatter * self, GVariantIter * profiles,
+    GError ** error)
+{
+  GstCaps *format, *restriction;
+  GstStructure *preset_properties;
+  const gchar *type, *parent, *name, *description, *format_str, *preset,
+      *preset_properties_str, *preset_name, *restriction_str;
+  guint32 id, presence, pass;
+  gboolean variableframerate, enabled;
+
+  while (!*error && g_variant_iter_next (profiles,
+          "(&sm&sm&sm&sm&sm&sm&sm&suum&subb)", &type,
+          &parent, &name, &description, &format_str, &preset,
+          &preset_properties_str, &preset_name, &id, &presence,
+          &restriction_str, &pass, &variableframerate, &enabled)) {
+    if (_structure_from_string (preset_properties_str, &preset_properties,
+            error)) {
+      format = format_str ? gst_caps_from_string (format_str) : NULL;
+      restriction =
+          restriction_str ? gst_caps_from_string (restriction_str) : NULL;
+
+      ges_base_xml_formatter_add_encoding_profile (GES_BASE_XML_FORMATTER
+          (self), type, parent, name, description, format, preset,
+          preset_properties, preset_name, id, presence, restriction, pass,
+          variableframerate, NULL, enabled, error);
+
+      if (preset_properties)
+        gst_structure_free (preset_properties);
+    }
+  }
+}
+
+static void
+_load_assets (GESBinaryFormatter * self, GVariantIter * assets,
+    GError ** error)
+{
+  GType type;
+  GstStructure *props;
+  const gchar *id, *type_name, *properties, *metas, *proxy_id;
+
+  while (!*error && g_variant_iter_next (assets, "(&s&s&s&sm&s)", &id,
+          &type_name, &properties, &metas, &proxy_id)) {
+    type = _get_type (type_name, GES_TYPE_EXTRACTABLE, error);
+    if (type == G_TYPE_NONE || !_structure_from_string (properties, &props,
+            error))
+      break;
+
+    ges_base_xml_formatter_add_asset (GES_BASE_XML_FORMATTER (self), id, type,
+        props, metas, proxy_id, error);
+    gst_structure_free (props);
+  }
+}
+
+static void
+_load_tracks (GESBinaryFormatter * self, GVariantIter * tracks,
+    GError ** error)
+{
+  GstCaps *caps;
+  GstStructure *props;
+  guint32 track_type, track_id;
+  gchar strid[16];
+  const gchar *caps_str, *properties, *metas;
+
+  while (!*error && g_variant_iter_next (tracks, "(uu&s&s&s)", &track_type,
+          &track_id, &caps_str, &properties, &metas)) {
+    if (!_structure_from_string (properties, &props, error))
+      break;
+
+    caps = gst_caps_from_string (caps_str);
+    if (!caps) {
+      g_set_error (error, GES_ERROR, GES_ERROR_FORMATTER_MALFORMED_INPUT_FILE,
+          "Can not create caps: %s", caps_str);
+      gst_structure_free (props);
+      break;
+    }
+
+    g_snprintf (strid, sizeof (strid), "%u", track_id);
+    ges_base_xml_formatter_add_track (GES_BASE_XML_FORMATTER (self),
+        track_type, caps, strid, props, metas, error);
+    gst_structure_free (props);
+    gst_caps_unref (caps);
+  }
+}
+
+static void
+_load_bindings (GESBinaryFormatter * self, GVariantIter * bindings,
+    const gchar * track_id)
+{
+  gint32 mode;
+  GVariantIter *values;
+  const gchar *type, *property_name;
+
+  while (g_variant_iter_next (bindings, "(&s&sia(td))", &type,
+          &property_name, &mode, &values)) {
+    GSList *list = NULL;
+    GstTimedValue *value = g_new0 (GstTimedValue, 1);
+
+    while (g_variant_iter_next (values, "(td)", &value->timestamp,
+            &value->value)) {
+      list = g_slist_prepend (list, value);
+      value = g_new0 (GstTimedValue, 1);
+    }
+    g_free (value);
+    g_variant_iter_free (values);
+
+    ges_base_xml_formatter_add_control_binding (GES_BASE_XML_FORMATTER (self),
+        type, "interpolation", property_name, mode, track_id,
+        g_slist_reverse (list));
+  }
+}
+
+static void
+_load_effects (GESBinaryFormatter * self, GVariantIter * effects,
+    const gchar * clip_id, GError ** error)
+{
+  GType type;
+  gint32 track_id;
+  gchar strid[16];
+  GVariantIter *bindings;
+  GstStructure *props, *children_props;
+  const gchar *asset_id, *type_name, *properties, *metas, *children_properties;
+
+  while (!*error && g_variant_iter_next (effects, "(&s&si&s&s&sa"
+          BINDING_TYPE ")", &asset_id, &type_name, &track_id, &properties,
+          &metas, &children_properties, &bindings)) {
+    type = _get_type (type_name, GES_TYPE_BASE_EFFECT, error);
+    if (type != G_TYPE_NONE
+        && _structure_from_string (properties, &props, error)) {
+      if (_structure_from_string (children_properties, &children_props,
+              error)) {
+        g_snprintf (strid, sizeof (strid), "%d", track_id);
+        ges_base_xml_formatter_add_track_element (GES_BASE_XML_FORMATTER
+            (self), type, asset_id, strid, clip_id, children_props, props,
+            metas, error);
+        _load_bindings (self, bindings, "-1");
+        gst_structure_free (children_props);
+      }
+      gst_structure_free (props);
+    }
+    g_variant_iter_free (bindings);
+  }
+}
+
+static void
+_load_sources (GESBinaryFormatter * self, GVariantIter * sources,
+    GError ** error)
+{
+  gint32 track_id;
+  gchar strid[16];
+  GVariantIter *bindings;
+  GstStructure *props, *children_props;
+  const gchar *properties, *children_properties;
+
+  while (!*error && g_variant_iter_next (sources, "(im&s&sa" BINDING_TYPE ")",
+          &track_id, &properties, &children_properties, &bindings)) {
+    if (_structure_from_string (properties, &props, error)) {
+      if (_structure_from_string (children_properties, &children_props,
+              error)) {
+        g_snprintf (strid, sizeof (strid), "%d", track_id);
+        ges_base_xml_formatter_add_source (GES_BASE_XML_FORMATTER (self),
+            strid, children_props, props);
+        _load_bindings (self, bindings, strid);
+        gst_structure_free (children_props);
+      }
+      if (props)
+        gst_structure_free (props);
+    }
+    g_variant_iter_free (bindings);
+  }
+}
+
+static void
+_load_clips (GESBinaryFormatter * self, GVariantIter * clips,
+    guint layer_prio, GError ** error)
+{
+  GType type;
+  guint32 id, track_types;
+  guint64 start, duration, inpoint;
+  gchar strid[16];
+  GVariantIter *effects, *sources;
+  GstStructure *props, *children_props;
+  const gchar *asset_id, *type_name, *properties, *metas,
+      *children_properties;
+
+  while (!*error && g_variant_iter_next (clips, "(u&s&sutt&s&sm&sa"
+          EFFECT_TYPE "a" SOURCE_TYPE ")", &id, &asset_id, &type_name,
+          &track_types, &start, &duration, &inpoint, &properties, &metas,
+          &children_properties, &effects, &sources)) {
+    type = _get_type (type_name, GES_TYPE_CLIP, error);
+    if (type == G_TYPE_NONE
+        || !_structure_from_string (properties, &props, error))
+      goto next;
+
+    if (!_structure_from_string (children_properties, &children_props, error)) {
+      gst_structure_free (props);
+      goto next;
+    }
+
+    g_snprintf (strid, sizeof (strid), "%u", id);
+    ges_base_xml_formatter_add_clip (GES_BASE_XML_FORMATTER (self), strid,
+        asset_id, type, start, inpoint, duration, layer_prio, track_types,
+        props, children_props, metas, error);
+    gst_structure_free (props);
+    if (children_props)
+      gst_structure_free (children_props);
+
+    if (!*error) {
+      _load_effects (self, effects, strid, error);
+      _load_sources (self, sources, error);
+      ges_base_xml_formatter_end_current_clip (GES_BASE_XML_FORMATTER (self));
+    }
+
+  next:
+    g_variant_iter_free (effects);
+    g_variant_iter_free (sources);
+  }
+}
+
+static void
+_load_layers (GESBinaryFormatter * self, GVariantIter * layers,
+    GError ** error)
+{
+  guint32 priority, track_id;
+  GstStructure *props;
+  GVariantIter *deactivated, *clips;
+  const gchar *properties, *metas;
+
+  while (!*error && g_variant_iter_next (layers, "(u&s&saua" CLIP_TYPE ")",
+          &priority, &properties, &metas, &deactivated, &clips)) {
+    if (_structure_from_string (properties, &props, error)) {
+      guint i = 0;
+      gchar **deactivated_tracks =
+          g_new0 (gchar *, g_variant_iter_n_children (deactivated) + 1);
+
+      while (g_variant_iter_next (deactivated, "u", &track_id))
+        deactivated_tracks[i++] = g_strdup_printf ("%u", track_id);
+
+      ges_base_xml_formatter_add_layer (GES_BASE_XML_FORMATTER (self),
+          G_TYPE_NONE, priority, props, metas, deactivated_tracks, error);
+      g_strfreev (deactivated_tracks);
+      gst_structure_free (props);
+
+      if (!*error)
+        _load_clips (self, clips, priority, error);
+    }
+
+    g_variant_iter_free (deactivated);
+    g_variant_iter_free (clips);
+  }
+}
+
+static void
+_load_groups (GESBinaryFormatter * self, GVariantIter * groups)
+{
+  guint32 id, child_id;
+  gchar strid[16];
+  GVariantIter *children;
+  const gchar *properties, *metas, *name;
+
+  while (g_variant_iter_next (groups, "(u&s&sa(us))", &id, &properties,
+          &metas, &children)) {
+    g_snprintf (strid, sizeof (strid), "%u", id);
+    ges_base_xml_formatter_add_group (GES_BASE_XML_FORMATTER (self), strid,
+        properties, metas);
+
+    while (g_variant_iter_next (children, "(u&s)", &child_id, &name)) {
+      g_snprintf (strid, sizeof (strid), "%u", child_id);
+      ges_base_xml_formatter_last_group_add_child (GES_BASE_XML_FORMATTER
+          (self), strid, name);
+    }
+    g_variant_iter_free (children);
+  }
+}
+
+static void
+_load_project (GESBinaryFormatter * self, GVariant * project, GError ** error)
+{
+  GESFormatter *formatter = GES_FORMATTER (self);
+  const gchar *metas, *timeline_properties, *timeline_metas;
+  GVariantIter *profiles, *assets, *tracks, *layers, *groups;
+
+  g_variant_get (project, "(&s&sa" PROFILE_TYPE "a" ASSET_TYPE "(&s&sa"
+      TRACK_TYPE "a" LAYER_TYPE "a" GROUP_TYPE "))", NULL, &metas, &profiles,
+      &assets, &timeline_properties, &timeline_metas, &tracks, &layers,
+      &groups);
+
+  ges_meta_container_add_metas_from_string (GES_META_CONTAINER
+      (formatter->project), metas);
+  ges_base_xml_formatter_set_timeline_properties (GES_BASE_XML_FORMATTER
+      (self), formatter->timeline, timeline_properties, timeline_metas);
+
+  _load_encoding_profiles (self, profiles, error);
+  if (!*error)
+    _load_assets (self, assets, error);
+  if (!*error)
+    _load_tracks (self, tracks, error);
+  if (!*error)
+    _load_layers (self, layers, error);
+  if (!*error)
+    _load_groups (self, groups);
+
+  g_variant_iter_free (profiles);
+  g_variant_iter_free (assets);
+  g_variant_iter_free (tracks);
+  g_variant_iter_free (layers);
+  g_variant_iter_free (groups);
+}
+
+/***********************************************
+ *                                             *
+ * GESFormatter virtual methods implementation *
+ *                                             *
+ ***********************************************/
+
+static gboolean
+_can_load_uri (GESFormatter * dummy_formatter, const gchar * uri,
+    GError ** error)
+{
+  gsize size;
+  gboolean res;
+  GFile *file;
+  GInputStream *stream;
+  guint8 header[HEADER_SIZE];
+
+  file = g_file_new_for_uri (uri);
+  stream = G_INPUT_STREAM (g_file_read (file, NULL, error));
+  g_object_unref (file);
+  if (!stream)
+    return FALSE;
+
+  res = g_input_stream_read_all (stream, header, HEADER_SIZE, &size, NULL,
+      error);
+  g_object_unref (stream);
+
+  return res && _check_header (header, size, uri, error);
+}
+
+static gboolean
+_load_from_uri (GESFormatter * formatter, GESTimeline * timeline,
+    const gchar * uri, GError ** error)
+{
+  gsize size;
+  GBytes *bytes, *payload;
+  GVariant *project;
+  GError *err = NULL;
+  const guint8 *data;
+  GESBinaryFormatter *self = GES_BINARY_FORMATTER (formatter);
+
+  GST_INFO_OBJECT (self, "Loading %s in %" GST_PTR_FORMAT, uri, timeline);
+
+  bytes = _load_bytes (uri, error);
+  if (!bytes)
+    return FALSE;
+
+  data = g_bytes_get_data (bytes, &size);
+  if (!_check_header (data, size, uri, error)) {
+    g_bytes_unref (bytes);
+
+    return FALSE;
+  }
+
+  payload = g_bytes_new_from_bytes (bytes, HEADER_SIZE, size - HEADER_SIZE);
+  g_bytes_unref (bytes);
+  project = g_variant_ref_sink (g_variant_new_from_bytes (G_VARIANT_TYPE
+          (PROJECT_TYPE), payload, FALSE));
+  g_bytes_unref (payload);
+
+  if (G_BYTE_ORDER == G_BIG_ENDIAN) {
+    GVariant *swapped = g_variant_byteswap (project);
+
+    g_variant_unref (project);
+    project = g_variant_ref_sink (swapped);
+  }
+
+  ges_timeline_set_auto_transition (timeline, FALSE);
+  ges_base_xml_formatter_start_streaming (GES_BASE_XML_FORMATTER (self));
+  _load_project (self, project, &err);
+  ges_base_xml_formatter_end_streaming (GES_BASE_XML_FORMATTER (self), err);
+  g_variant_unref (project);
+
+  return TRUE;
+}
+
+/***********************************************
+ *                                             *
+ *   GObject virtual methods implementation    *
+ *                                             *
+ ***********************************************/
+
+static void
+ges_binary_formatter_init (GESBinaryFormatter * self)
+{
+  self->priv = ges_binary_formatter_get_instance_private (self);
+}
+
+static void
+ges_binary_formatter_class_init (GESBinaryFormatterClass * self_class)
+{
+  GESFormatterClass *formatter_klass = GES_FORMATTER_CLASS (self_class);
+  GESBaseXmlFormatterClass *basexmlformatter_class =
+      GES_BASE_XML_FORMATTER_CLASS (self_class);
+
+  formatter_klass->can_load_uri = _can_load_uri;
+  formatter_klass->load_from_uri = _load_from_uri;
+
+  basexmlformatter_class->save = _save;
+
+  ges_formatter_class_register_metas (formatter_klass, "gesb",
+      "GStreamer Editing Services binary project files", "gesb",
+      "application/x-ges-binary", FORMAT_VERSION, GST_RANK_SECONDARY);
+}
@@ -0,0 +1,52 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#pragma once
+
+#include "ges-base-xml-formatter.h"
+
+G_BEGIN_DECLS
+#define GES_TYPE_BINARY_FORMATTER (ges_binary_formatter_get_type ())
+GES_DECLARE_TYPE(BinaryFormatter, binary_formatter, BINARY_FORMATTER);
+
+/**
+ * GESBinaryFormatter:
+ *
+ * Since: 1.20
+ */
+struct _GESBinaryFormatter
+{
+  GESBaseXmlFormatter parent;
+
+  GESBinaryFormatterPrivate *priv;
+
+  gpointer _ges_reserved[GES_PADDING];
+};
+
+/**
+ * GESBinaryFormatterClass:
+ *
+ * Since: 1.20
+ */
+struct _GESBinaryFormatterClass
+{
+  GESBaseXmlFormatterClass parent;
+
+  gpointer _ges_reserved[GES_PADDING];
+};
+
+G_END_DECLS
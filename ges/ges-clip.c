@@ -2409,14 +2409,14 @@ _deep_copy (GESTimelineElement * element, GESTimelineElement * copy)
   ccopy->priv->copied_timeline = self->priv->layer->timeline;
 }
 
-static GESTimelineElement *
-_paste (GESTimelineElement * element, GESTimelineElement * ref,
+static GESClip *
+_paste_into_layer (GESClip * self, GESLayer * layer,
     GstClockTime paste_position)
 {
   GList *tmp;
-  GESClip *self = GES_CLIP (element);
-  GESLayer *layer = self->priv->copied_layer;
-  GESClip *nclip = GES_CLIP (ges_timeline_element_copy (element, FALSE));
+  GESClip *nclip =
+      GES_CLIP (ges_timeline_element_copy (GES_TIMELINE_ELEMENT (self),
+          FALSE));
 
   ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (nclip), paste_position);
 
@@ -2425,29 +2425,47 @@ _paste (GESTimelineElement * element, GESTimelineElement * ref,
     ges_clip_copy_track_element_into (nclip, tmp->data, GST_CLOCK_TIME_NONE);
 
   if (layer) {
-    if (layer->timeline != self->priv->copied_timeline) {
-      GST_WARNING_OBJECT (self, "Cannot be pasted into the layer %"
-          GST_PTR_FORMAT " because its timeline has changed", layer);
-      gst_object_ref_sink (nclip);
-      gst_object_unref (nclip);
-      return NULL;
-    }
-
     /* adding the clip to the layer will add it to the tracks, but not
      * necessarily the same ones depending on select-tracks-for-object */
     if (!ges_layer_add_clip (layer, nclip)) {
       GST_INFO ("%" GES_FORMAT " could not be pasted to %" GST_TIME_FORMAT,
-          GES_ARGS (element), GST_TIME_ARGS (paste_position));
+          GES_ARGS (self), GST_TIME_ARGS (paste_position));
 
       return NULL;
     }
   }
 
+  return nclip;
+}
+
+static GESTimelineElement *
+_paste (GESTimelineElement * element, GESTimelineElement * ref,
+    GstClockTime paste_position)
+{
+  GESClip *self = GES_CLIP (element);
+  GESLayer *layer = self->priv->copied_layer;
+
+  if (layer && layer->timeline != self->priv->copied_timeline) {
+    GST_WARNING_OBJECT (self, "Cannot be pasted into the layer %"
+        GST_PTR_FORMAT " because its timeline has changed", layer);
+    return NULL;
+  }
+
   /* NOTE: self should not be used and be freed after this call, so we can
    * leave the freeing of copied_layer and copied_track_elements to the
    * dispose method */
 
-  return GES_TIMELINE_ELEMENT (nclip);
+  return GES_TIMELINE_ELEMENT (_paste_into_layer (self, layer,
+          paste_position));
+}
+
+/* Pastes @copy, the deep copy of a clip, into @layer, which can be in
+ * another timeline than the one of the copied clip */
+GESClip *
+ges_clip_paste_into_layer (GESClip * copy, GESLayer * layer,
+    GstClockTime position)
+{
+  return _paste_into_layer (copy, layer, position);
 }
 
 static gboolean
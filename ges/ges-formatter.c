@@ -673,6 +673,7 @@ _init_formatter_assets (void)
 #endif
     g_type_class_ref (GES_TYPE_COMMAND_LINE_FORMATTER);
     g_type_class_ref (GES_TYPE_XML_FORMATTER);
+    g_type_class_ref (GES_TYPE_BINARY_FORMATTER);
 
     load_python_formatters ();
 
@@ -693,6 +694,7 @@ _deinit_formatter_assets (void)
 
     g_type_class_unref (g_type_class_peek (GES_TYPE_COMMAND_LINE_FORMATTER));
     g_type_class_unref (g_type_class_peek (GES_TYPE_XML_FORMATTER));
+    g_type_class_unref (g_type_class_peek (GES_TYPE_BINARY_FORMATTER));
   }
 }
 
@@ -151,7 +151,8 @@ ges_image_source_create_source (GESSource * source)
   g_signal_connect (G_OBJECT (src), "pad-added",
       G_CALLBACK (pad_added_cb), scale);
 
-  return bin;
+  return ges_still_frame_bin_new_for_uri (GES_TRACK_ELEMENT (source), bin,
+      ((GESImageSource *) source)->uri);
 }
 
 static void
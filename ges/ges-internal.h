@@ -120,6 +120,12 @@ G_GNUC_INTERNAL GESAutoTransition *
 ges_timeline_get_auto_transition_at_edge (GESTimeline * timeline, GESTrackElement * source,
   GESEdge edge);
 
+G_GNUC_INTERNAL gboolean
+ges_timeline_unindex_auto_transition (GESTimeline * timeline, GESAutoTransition * auto_transition);
+
+G_GNUC_INTERNAL void
+ges_timeline_index_auto_transition (GESTimeline * timeline, GESAutoTransition * auto_transition);
+
 G_GNUC_INTERNAL gboolean ges_timeline_is_disposed (GESTimeline* timeline);
 
 G_GNUC_INTERNAL gboolean
@@ -168,14 +174,61 @@ G_GNUC_INTERNAL
 void
 timeline_fill_gaps            (GESTimeline *timeline);
 
+G_GNUC_INTERNAL
+void
+timeline_track_changed        (GESTimeline *timeline,
+                               GESTrack *track);
+
+G_GNUC_INTERNAL
+void
+timeline_track_element_changed (GESTimeline *timeline,
+                                GESTrackElement *element,
+                                GESTrack *track);
+
 G_GNUC_INTERNAL void
 timeline_create_transitions (GESTimeline * timeline, GESTrackElement * track_element);
 
+/* Idle decoders shared by the uri sources of a timeline */
+typedef struct _GESDecoderPool GESDecoderPool;
+
+G_GNUC_INTERNAL GESDecoderPool * ges_decoder_pool_new (void);
+G_GNUC_INTERNAL GESDecoderPool * ges_decoder_pool_ref (GESDecoderPool *pool);
+G_GNUC_INTERNAL void ges_decoder_pool_unref (GESDecoderPool *pool);
+G_GNUC_INTERNAL void ges_decoder_pool_set_size (GESDecoderPool *pool, guint size);
+G_GNUC_INTERNAL guint ges_decoder_pool_get_size (GESDecoderPool *pool);
+G_GNUC_INTERNAL void ges_decoder_pool_get_stats (GESDecoderPool *pool,
+                                                 guint *hits,
+                                                 guint *misses);
+G_GNUC_INTERNAL GESDecoderPool * timeline_get_decoder_pool (GESTimeline *timeline);
+G_GNUC_INTERNAL gboolean timeline_get_occlusion_culling (GESTimeline *timeline);
+
+/* Unused sources of a timeline keeping their converters */
+typedef struct _GESWarmSources GESWarmSources;
+
+G_GNUC_INTERNAL GESWarmSources * ges_warm_sources_new (void);
+G_GNUC_INTERNAL GESWarmSources * ges_warm_sources_ref (GESWarmSources *warm);
+G_GNUC_INTERNAL void ges_warm_sources_unref (GESWarmSources *warm);
+G_GNUC_INTERNAL void ges_warm_sources_set_max (GESWarmSources *warm, guint max);
+G_GNUC_INTERNAL guint ges_warm_sources_get_max (GESWarmSources *warm);
+G_GNUC_INTERNAL GESWarmSources * timeline_get_warm_sources (GESTimeline *timeline);
+G_GNUC_INTERNAL gboolean timeline_get_still_frames (GESTimeline *timeline);
+G_GNUC_INTERNAL gboolean timeline_get_native_transitions (GESTimeline *timeline);
+G_GNUC_INTERNAL gboolean timeline_get_smart_cut (GESTimeline *timeline);
+
 G_GNUC_INTERNAL void timeline_get_framerate(GESTimeline *self, gint *fps_n,
                                             gint *fps_d);
 G_GNUC_INTERNAL void
 ges_timeline_set_moving_track_elements (GESTimeline * timeline, gboolean moving);
 
+G_GNUC_INTERNAL void
+ges_timeline_begin_bulk_add (GESTimeline * timeline);
+
+G_GNUC_INTERNAL gboolean
+ges_timeline_end_bulk_add (GESTimeline * timeline, GError ** error);
+
+G_GNUC_INTERNAL gboolean
+ges_timeline_is_bulk_adding (GESTimeline * timeline);
+
 G_GNUC_INTERNAL gboolean
 ges_timeline_add_clip (GESTimeline * timeline, GESClip * clip, GError ** error);
 
@@ -188,6 +241,12 @@ ges_timeline_set_smart_rendering (GESTimeline * timeline, gboolean rendering_sma
 G_GNUC_INTERNAL gboolean
 ges_timeline_get_smart_rendering (GESTimeline *timeline);
 
+G_GNUC_INTERNAL void
+ges_timeline_set_use_generated_proxies (GESTimeline * timeline, gboolean use_generated_proxies);
+
+G_GNUC_INTERNAL gboolean
+ges_timeline_get_use_generated_proxies (GESTimeline *timeline);
+
 G_GNUC_INTERNAL void
 ges_auto_transition_set_source (GESAutoTransition * self, GESTrackElement * source, GESEdge edge);
 
@@ -293,7 +352,41 @@ G_GNUC_INTERNAL  gchar * ges_project_try_updating_id              (GESProject *s
 G_GNUC_INTERNAL  void ges_project_add_loading_asset               (GESProject *project,
                                                                    GType extractable_type,
                                                                    const gchar *id);
+G_GNUC_INTERNAL  gboolean ges_project_get_streaming_load          (GESProject *project);
 G_GNUC_INTERNAL  gchar* ges_uri_asset_try_update_id               (GError *error, GESAsset *wrong_asset);
+
+typedef struct _GESProjectJournal GESProjectJournal;
+
+G_GNUC_INTERNAL GESProjectJournal * ges_project_journal_new     (GESProject *project,
+                                                                 GESTimeline *timeline,
+                                                                 const gchar *uri);
+G_GNUC_INTERNAL void ges_project_journal_free                   (GESProjectJournal *journal);
+G_GNUC_INTERNAL gboolean ges_project_journal_matches            (GESProjectJournal *journal,
+                                                                 GESTimeline *timeline,
+                                                                 const gchar *uri);
+G_GNUC_INTERNAL void ges_project_journal_reset                  (GESProjectJournal *journal);
+G_GNUC_INTERNAL gboolean ges_project_journal_needs_full_save    (GESProjectJournal *journal);
+G_GNUC_INTERNAL gboolean ges_project_journal_append             (GESProjectJournal *journal,
+                                                                 GError **error);
+G_GNUC_INTERNAL gchar * ges_project_journal_get_uri             (const gchar *uri);
+G_GNUC_INTERNAL void ges_project_journal_discard                (const gchar *uri);
+G_GNUC_INTERNAL gboolean ges_project_journal_replay             (GESTimeline *timeline,
+                                                                 const gchar *uri,
+                                                                 GError **error);
+
+/* Boolean meta set on the proxies created by the GESProxyGenerator */
+#define GES_META_GENERATED_PROXY "ges-generated-proxy"
+
+typedef struct _GESProxyGenerator GESProxyGenerator;
+
+G_GNUC_INTERNAL GESProxyGenerator * ges_proxy_generator_new     (GESProject *project);
+G_GNUC_INTERNAL void ges_proxy_generator_free                   (GESProxyGenerator *generator);
+G_GNUC_INTERNAL void ges_proxy_generator_configure              (GESProxyGenerator *generator,
+                                                                 gint min_height,
+                                                                 guint min_bitrate,
+                                                                 gint proxy_height);
+G_GNUC_INTERNAL void ges_proxy_generator_add_asset              (GESProxyGenerator *generator,
+                                                                 GESAsset *asset);
 /************************************************
  *                                              *
  *   GESBaseXmlFormatter internal methods       *
@@ -392,6 +485,20 @@ G_GNUC_INTERNAL void ges_base_xml_formatter_set_timeline_properties(GESBaseXmlFo
 
 G_GNUC_INTERNAL void ges_base_xml_formatter_end_current_clip       (GESBaseXmlFormatter *self);
 
+G_GNUC_INTERNAL void ges_base_xml_formatter_start_capture          (GESBaseXmlFormatter *self,
+                                                                    gint line_number,
+                                                                    gint char_number);
+
+G_GNUC_INTERNAL gchar * ges_base_xml_formatter_end_capture        (GESBaseXmlFormatter *self,
+                                                                    gint line_number,
+                                                                    gint char_number,
+                                                                    gsize *size);
+
+G_GNUC_INTERNAL void ges_base_xml_formatter_start_streaming       (GESBaseXmlFormatter *self);
+
+G_GNUC_INTERNAL void ges_base_xml_formatter_end_streaming         (GESBaseXmlFormatter *self,
+                                                                    GError *error);
+
 G_GNUC_INTERNAL void ges_xml_formatter_deinit                      (void);
 
 G_GNUC_INTERNAL gboolean set_property_foreach                   (GQuark field_id,
@@ -424,6 +531,13 @@ ges_util_structure_get_clocktime (GstStructure *structure, const gchar *name,
 G_GNUC_INTERNAL gboolean /* From ges-xml-formatter.c */
 ges_util_can_serialize_spec (GParamSpec * spec);
 
+G_GNUC_INTERNAL gchar * /* From ges-xml-formatter.c */
+ges_util_serialize_properties (GObject * object, gint * ret_n_props,
+                               const gchar * fieldname, ...);
+
+G_GNUC_INTERNAL gchar * /* From ges-xml-formatter.c */
+ges_util_serialize_children_properties (GESTimelineElement * element);
+
 /****************************************************
  *              GESContainer                        *
  ****************************************************/
@@ -453,6 +567,7 @@ G_GNUC_INTERNAL void              ges_clip_set_add_error          (GESClip * cli
 G_GNUC_INTERNAL void              ges_clip_take_add_error         (GESClip * clip, GError ** error);
 G_GNUC_INTERNAL void              ges_clip_set_remove_error       (GESClip * clip, GError * error);
 G_GNUC_INTERNAL void              ges_clip_take_remove_error      (GESClip * clip, GError ** error);
+G_GNUC_INTERNAL GESClip *         ges_clip_paste_into_layer       (GESClip * copy, GESLayer * layer, GstClockTime position);
 
 /****************************************************
  *              GESLayer                            *
@@ -489,11 +604,44 @@ G_GNUC_INTERNAL GstElement* ges_source_create_topbin  (GESSource *source,
                                                        const gchar* bin_name,
                                                        GstElement* sub_element,
                                                        GPtrArray* elements);
+G_GNUC_INTERNAL GstElement* ges_source_make_converter (const gchar* factory_name,
+                                                       const gchar* name);
+G_GNUC_INTERNAL gboolean    ges_source_replace_sub_element (GESSource *source,
+                                                            GstElement *sub_element);
+G_GNUC_INTERNAL void        ges_source_release_converters (GESSource *source,
+                                                           GESTimeline *timeline);
 G_GNUC_INTERNAL void ges_source_set_rendering_smartly (GESSource *source,
                                                        gboolean rendering_smartly);
 G_GNUC_INTERNAL gboolean
 ges_source_get_rendering_smartly                      (GESSource *source);
 
+/* ges-still-frame-source.c */
+G_GNUC_INTERNAL GstElement* ges_still_frame_bin_new          (GESTrackElement *owner,
+                                                              GstElement *element,
+                                                              GstElement *renderer);
+G_GNUC_INTERNAL GstElement* ges_still_frame_bin_new_for_uri  (GESTrackElement *owner,
+                                                              GstElement *element,
+                                                              const gchar *uri);
+G_GNUC_INTERNAL gboolean    ges_still_frame_bin_owns_pad     (GstPad *pad);
+
+/* ges-transition-mixer.c */
+typedef gboolean (*GESTransitionBinSelectFunc) (GESTrackElement *owner);
+
+G_GNUC_INTERNAL gboolean    ges_video_transition_mixer_supports_type (GESVideoStandardTransitionType type);
+G_GNUC_INTERNAL gboolean    ges_video_transition_mixer_can_blend     (const GstCaps *caps);
+G_GNUC_INTERNAL GstElement* ges_video_transition_mixer_new           (void);
+G_GNUC_INTERNAL gboolean    ges_audio_transition_mixer_can_mix       (const GstCaps *caps);
+G_GNUC_INTERNAL GstElement* ges_audio_transition_mixer_new           (void);
+G_GNUC_INTERNAL GstElement* ges_transition_bin_new                   (GESTrackElement *owner,
+                                                                      GstElement *element,
+                                                                      GstElement *native,
+                                                                      GstElement *output,
+                                                                      GESTransitionBinSelectFunc use_native);
+
+/* ges-smart-cutter.c */
+G_GNUC_INTERNAL gboolean    ges_smart_cutter_can_cut (const GstCaps *caps);
+G_GNUC_INTERNAL GstElement* ges_smart_cutter_new     (void);
+
 G_GNUC_INTERNAL void ges_track_set_smart_rendering     (GESTrack* track, gboolean rendering_smartly);
 G_GNUC_INTERNAL GstElement * ges_track_get_composition (GESTrack *track);
 
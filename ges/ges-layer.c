@@ -67,6 +67,9 @@ struct _GESLayerPrivate
   gboolean auto_transition;
 
   GHashTable *tracks_activness;
+
+  /* Whether we are in ges_layer_add_clips() */
+  gboolean adding_clips;
 };
 
 typedef struct
@@ -748,8 +751,13 @@ ges_layer_add_clip_full (GESLayer * layer, GESClip * clip, GError ** error)
   }
 
   /* Take a reference to the clip and store it stored by start/priority */
-  priv->clips_start = g_list_insert_sorted (priv->clips_start, clip,
-      (GCompareFunc) element_start_compare);
+  if (priv->adding_clips) {
+    /* Sorted when resyncing the priorities once all clips are added */
+    priv->clips_start = g_list_prepend (priv->clips_start, clip);
+  } else {
+    priv->clips_start = g_list_insert_sorted (priv->clips_start, clip,
+        (GCompareFunc) element_start_compare);
+  }
 
   /* Inform the clip it's now in this layer */
   ges_clip_set_layer (clip, layer);
@@ -766,7 +774,8 @@ ges_layer_add_clip_full (GESLayer * layer, GESClip * clip, GError ** error)
     _set_priority0 (GES_TIMELINE_ELEMENT (clip), LAYER_HEIGHT - 1);
   }
 
-  ges_layer_resync_priorities (layer);
+  if (!priv->adding_clips)
+    ges_layer_resync_priorities (layer);
 
   /* FIXME: ideally we would only emit if we are going to return TRUE.
    * However, for backward-compatibility, we ensure the "clip-added"
@@ -835,6 +844,83 @@ ges_layer_add_clip (GESLayer * layer, GESClip * clip)
   return ges_layer_add_clip_full (layer, clip, NULL);
 }
 
+/**
+ * ges_layer_add_clips:
+ * @layer: The #GESLayer
+ * @clips: (element-type GESClip) (transfer none): The clips to add, floating
+ * references are sunk
+ * @error: (nullable): Return location for an error
+ *
+ * Adds the given clips to the layer, as ges_layer_add_clip_full() would,
+ * but much faster when adding many clips: the priorities of the clips of
+ * the layer are resynced, the clips are checked against the timeline
+ * configuration rules and the auto-transitions are created only once all
+ * of them have been added.
+ *
+ * If any of the clips can not be added, none of them is.
+ *
+ * Returns: %TRUE if all the @clips were added to @layer, %FALSE
+ * otherwise.
+ * Since: 1.20
+ */
+gboolean
+ges_layer_add_clips (GESLayer * layer, GList * clips, GError ** error)
+{
+  GList *tmp, *added = NULL;
+  GError *add_error = NULL;
+  GESTimeline *timeline;
+  gboolean ret = TRUE;
+
+  g_return_val_if_fail (GES_IS_LAYER (layer), FALSE);
+  g_return_val_if_fail (!layer->priv->adding_clips, FALSE);
+  g_return_val_if_fail (!error || !*error, FALSE);
+
+  timeline = layer->timeline;
+  if (timeline)
+    ges_timeline_begin_bulk_add (timeline);
+
+  layer->priv->adding_clips = TRUE;
+  for (tmp = clips; tmp; tmp = tmp->next) {
+    GESClip *clip = tmp->data;
+
+    gst_object_ref_sink (clip);
+    if (!ges_layer_add_clip_full (layer, clip, &add_error)) {
+      GST_INFO_OBJECT (layer, "Could not add clip %" GES_FORMAT,
+          GES_ARGS (clip));
+      gst_object_unref (clip);
+      ret = FALSE;
+      break;
+    }
+    added = g_list_prepend (added, clip);
+  }
+  layer->priv->adding_clips = FALSE;
+
+  ges_layer_resync_priorities (layer);
+  if (timeline && !ges_timeline_end_bulk_add (timeline,
+          ret ? &add_error : NULL))
+    ret = FALSE;
+
+  if (!ret) {
+    for (tmp = added; tmp; tmp = tmp->next) {
+      GESLayer *clip_layer = ges_clip_get_layer (tmp->data);
+
+      if (clip_layer == layer)
+        ges_layer_remove_clip (layer, tmp->data);
+      gst_clear_object (&clip_layer);
+    }
+  }
+  g_list_free_full (added, gst_object_unref);
+
+  if (add_error) {
+    if (error)
+      *error = add_error;
+    else
+      g_error_free (add_error);
+  }
+
+  return ret;
+}
+
 /**
  * ges_layer_add_asset_full:
  * @layer: The #GESLayer
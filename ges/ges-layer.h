@@ -89,6 +89,10 @@ gboolean      ges_layer_add_clip_full         (GESLayer * layer,
                                                GESClip * clip,
                                                GError ** error);
 GES_API
+gboolean      ges_layer_add_clips             (GESLayer * layer,
+                                               GList * clips,
+                                               GError ** error);
+GES_API
 GESClip *     ges_layer_add_asset             (GESLayer *layer,
                                                GESAsset *asset,
                                                GstClockTime start,
@@ -36,6 +36,9 @@
  *
  * You can set the encoding and save location used in rendering by calling
  * ges_pipeline_set_render_settings().
+ *
+ * Series of thumbnails of the timeline, for example to display a filmstrip,
+ * can be created in any mode with ges_pipeline_get_thumbnails().
  */
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -43,13 +46,16 @@
 
 #include <gst/gst.h>
 #include <gst/video/videooverlay.h>
+#include <glib/gstdio.h>
 #include <stdio.h>
+#include <errno.h>
 
 #include "ges-internal.h"
 #include "ges-pipeline.h"
 #include "ges-screenshot.h"
 #include "ges-audio-track.h"
 #include "ges-video-track.h"
+#include "ges.h"
 
 GST_DEBUG_CATEGORY_STATIC (ges_pipeline_debug);
 #undef GST_CAT_DEFAULT
@@ -87,6 +93,18 @@ struct _GESPipelinePrivate
 
   GstEncodingProfile *profile;
 
+  /* Set by ges_pipeline_set_render_cache() */
+  gchar *render_cache_dir;
+  guint64 render_cache_max_size;
+
+  /* Private prerolled pipeline producing the thumbnails, see
+   * ges_pipeline_get_thumbnails() */
+  GstElement *thumbnailer;
+  GstElement *thumbnail_sink;
+  GstCaps *thumbnail_caps;
+  GstClockTime thumbnail_position;
+  gint thumbnailer_stale;
+
   GThread *valid_thread;
 };
 
@@ -109,6 +127,7 @@ static GstStateChangeReturn ges_pipeline_change_state (GstElement *
 
 static OutputChain *get_output_chain_for_track (GESPipeline * self,
     GESTrack * track);
+static void _clear_thumbnailer (GESPipeline * self);
 static OutputChain *new_output_chain_for_track (GESPipeline * self,
     GESTrack * track);
 static void _link_track (GESPipeline * self, GESTrack * track);
@@ -280,6 +299,8 @@ ges_pipeline_dispose (GObject * object)
     gst_encoding_profile_unref (self->priv->profile);
     self->priv->profile = NULL;
   }
+  g_clear_pointer (&self->priv->render_cache_dir, g_free);
+  _clear_thumbnailer (self);
 
   if (self->priv->timeline) {
     g_signal_handlers_disconnect_by_func (self->priv->timeline,
@@ -599,6 +620,10 @@ ges_pipeline_change_state (GstElement * element, GstStateChange transition)
         ret = GST_STATE_CHANGE_FAILURE;
         goto done;
       }
+      /* The sources pick the proxies generated by the project or their
+       * original media when going to PAUSED */
+      ges_timeline_set_use_generated_proxies (self->priv->timeline,
+          !IN_RENDERING_MODE (self));
       if (IN_RENDERING_MODE (self)) {
         GST_DEBUG ("rendering => Updating pipeline caps");
         /* Set caps on all tracks according to profile if present */
@@ -1496,3 +1521,1632 @@ ges_pipeline_preview_set_audio_sink (GESPipeline * self, GstElement * sink)
 
   g_object_set (self->priv->playsink, "audio-sink", sink, NULL);
 };
+
+/****************************************************
+ *               Segmented rendering                *
+ ****************************************************/
+
+typedef struct
+{
+  GMutex lock;
+  GCond cond;
+  guint n_running;
+  GError *error;
+} RenderSync;
+
+static gint
+_compare_clock_times (const GstClockTime * a, const GstClockTime * b)
+{
+  return (*a > *b) - (*a < *b);
+}
+
+#define KEYFRAME_PROBE_TIMEOUT (5 * GST_SECOND)
+
+/* Returns the stream time of the keyframe at or before @position in the
+ * video stream of @uri, or GST_CLOCK_TIME_NONE if it could not be found */
+static GstClockTime
+_find_keyframe_before (const gchar * uri, GstClockTime position)
+{
+  GstBuffer *buffer;
+  GstSample *sample = NULL;
+  GstElement *playbin, *sink;
+  GstClockTime keyframe = GST_CLOCK_TIME_NONE;
+
+  playbin = gst_element_factory_make ("playbin", NULL);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  if (!playbin || !sink) {
+    gst_clear_object (&playbin);
+    gst_clear_object (&sink);
+
+    return GST_CLOCK_TIME_NONE;
+  }
+
+  /* Only the video stream, GST_PLAY_FLAG_VIDEO */
+  g_object_set (playbin, "uri", uri, "video-sink", sink, "flags", 0x1, NULL);
+  if (gst_element_set_state (playbin, GST_STATE_PAUSED) ==
+      GST_STATE_CHANGE_FAILURE
+      || gst_element_get_state (playbin, NULL, NULL,
+          KEYFRAME_PROBE_TIMEOUT) != GST_STATE_CHANGE_SUCCESS)
+    goto done;
+
+  /* The first frame after a key unit seek is the keyframe */
+  if (!gst_element_seek_simple (playbin, GST_FORMAT_TIME,
+          GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT |
+          GST_SEEK_FLAG_SNAP_BEFORE, position)
+      || gst_element_get_state (playbin, NULL, NULL,
+          KEYFRAME_PROBE_TIMEOUT) != GST_STATE_CHANGE_SUCCESS)
+    goto done;
+
+  g_object_get (sink, "last-sample", &sample, NULL);
+  if (sample && (buffer = gst_sample_get_buffer (sample)))
+    keyframe = gst_segment_to_stream_time (gst_sample_get_segment (sample),
+        GST_FORMAT_TIME, GST_BUFFER_PTS (buffer));
+
+done:
+  gst_element_set_state (playbin, GST_STATE_NULL);
+  gst_object_unref (playbin);
+  if (sample)
+    gst_sample_unref (sample);
+
+  return keyframe;
+}
+
+/* Moves @boundary back onto a keyframe of the first video clip it cuts, if
+ * any, and if that keeps it after @min. The segment following the boundary
+ * then starts decoding that clip on a keyframe and, when smart rendering,
+ * can pass its first GOP through instead of encoding it again. */
+static GstClockTime
+_snap_to_keyframe (GESTimeline * timeline, GstClockTime boundary,
+    GstClockTime min)
+{
+  GList *tmp, *clips, *clip, *child;
+  GstClockTime res = boundary;
+  gboolean snapped = FALSE;
+
+  for (tmp = timeline->layers; tmp && !snapped; tmp = tmp->next) {
+    clips = ges_layer_get_clips (tmp->data);
+    for (clip = clips; clip && !snapped; clip = clip->next) {
+      GESClip *c = clip->data;
+      GstClockTime internal, keyframe, position;
+
+      if (!GES_IS_URI_CLIP (c) || ges_uri_clip_is_image (GES_URI_CLIP (c))
+          || _START (c) >= boundary || _END (c) <= boundary)
+        continue;
+
+      for (child = GES_CONTAINER_CHILDREN (c); child; child = child->next) {
+        if (GES_IS_VIDEO_SOURCE (child->data))
+          break;
+      }
+      if (!child)
+        continue;
+
+      /* Only the first cut video clip is considered */
+      snapped = TRUE;
+      internal = ges_clip_get_internal_time_from_timeline_time (c,
+          child->data, boundary, NULL);
+      if (!GST_CLOCK_TIME_IS_VALID (internal))
+        continue;
+
+      keyframe = _find_keyframe_before (ges_uri_clip_get_uri (GES_URI_CLIP
+              (c)), internal);
+      if (!GST_CLOCK_TIME_IS_VALID (keyframe) || keyframe < _INPOINT (c))
+        continue;
+
+      position = ges_clip_get_timeline_time_from_internal_time (c,
+          child->data, keyframe, NULL);
+      if (GST_CLOCK_TIME_IS_VALID (position) && position > min) {
+        GST_DEBUG_OBJECT (timeline, "Moving boundary %" GST_TIME_FORMAT
+            " to the keyframe of %" GES_FORMAT " at %" GST_TIME_FORMAT,
+            GST_TIME_ARGS (boundary), GES_ARGS (c), GST_TIME_ARGS (position));
+        res = position;
+      }
+    }
+    g_list_free_full (clips, gst_object_unref);
+  }
+
+  return res;
+}
+
+/* Splits the timeline in up to @n_segments ranges. Segments only end where
+ * a clip ends, so that rendering a range in isolation never produces a
+ * trailing gap (tracks do not have any while rendering), or on a keyframe
+ * of a video clip crossing that position, so that the sources starting the
+ * next range start decoding at a clip boundary or at a keyframe rather than
+ * in the middle of a GOP. */
+static GArray *
+_get_segment_boundaries (GESTimeline * timeline, guint n_segments)
+{
+  guint i, j = 0;
+  GList *tmp, *clips, *clip;
+  GstClockTime last = 0, duration = ges_timeline_get_duration (timeline);
+  GArray *edges = g_array_new (FALSE, FALSE, sizeof (GstClockTime));
+  GArray *boundaries = g_array_new (FALSE, FALSE, sizeof (GstClockTime));
+
+  for (tmp = timeline->layers; tmp; tmp = tmp->next) {
+    clips = ges_layer_get_clips (tmp->data);
+    for (clip = clips; clip; clip = clip->next) {
+      GstClockTime end = _END (clip->data);
+
+      if (end > 0 && end < duration)
+        g_array_append_val (edges, end);
+    }
+    g_list_free_full (clips, gst_object_unref);
+  }
+  g_array_sort (edges, (GCompareFunc) _compare_clock_times);
+
+  g_array_append_val (boundaries, last);
+  for (i = 1; i < n_segments && j < edges->len; i++) {
+    GstClockTime ideal = gst_util_uint64_scale (duration, i, n_segments);
+    GstClockTime best = GST_CLOCK_TIME_NONE;
+
+    for (; j < edges->len; j++) {
+      GstClockTime edge = g_array_index (edges, GstClockTime, j);
+
+      if (edge <= last)
+        continue;
+
+      if (!GST_CLOCK_TIME_IS_VALID (best) ||
+          ABS (GST_CLOCK_DIFF (edge, ideal)) <
+          ABS (GST_CLOCK_DIFF (best, ideal)))
+        best = edge;
+
+      if (edge >= ideal)
+        break;
+    }
+
+    if (GST_CLOCK_TIME_IS_VALID (best) && best > last) {
+      best = _snap_to_keyframe (timeline, best, last);
+      g_array_append_val (boundaries, best);
+      last = best;
+    }
+  }
+  g_array_append_val (boundaries, duration);
+  g_array_free (edges, TRUE);
+
+  return boundaries;
+}
+
+/* Creates an empty timeline with the same tracks and layers as @timeline */
+static GESTimeline *
+_new_timeline_like (GESTimeline * timeline)
+{
+  GList *tmp, *ttmp, *ctmp;
+  GESTimeline *copy = gst_object_ref_sink (ges_timeline_new ());
+
+  for (tmp = timeline->tracks; tmp; tmp = tmp->next) {
+    GESTrack *track, *orig = tmp->data;
+    GstCaps *caps = ges_track_get_restriction_caps (orig);
+
+    if (GES_IS_VIDEO_TRACK (orig))
+      track = GES_TRACK (ges_video_track_new ());
+    else if (GES_IS_AUDIO_TRACK (orig))
+      track = GES_TRACK (ges_audio_track_new ());
+    else
+      track = ges_track_new (orig->type,
+          gst_caps_copy (ges_track_get_caps (orig)));
+
+    ges_track_set_restriction_caps (track, caps);
+    ges_track_set_mixing (track, ges_track_get_mixing (orig));
+    ges_timeline_add_track (copy, track);
+    gst_caps_unref (caps);
+  }
+
+  for (tmp = timeline->layers; tmp; tmp = tmp->next) {
+    GList *inactive = NULL;
+    GESLayer *layer = ges_timeline_append_layer (copy);
+
+    ges_layer_set_auto_transition (layer,
+        ges_layer_get_auto_transition (tmp->data));
+
+    /* The tracks of the copy are in the same order */
+    for (ttmp = timeline->tracks, ctmp = copy->tracks; ttmp && ctmp;
+        ttmp = ttmp->next, ctmp = ctmp->next) {
+      if (!ges_layer_get_active_for_track (tmp->data, ttmp->data))
+        inactive = g_list_prepend (inactive, ctmp->data);
+    }
+
+    if (inactive)
+      ges_layer_set_active_for_tracks (layer, FALSE, inactive);
+    g_list_free (inactive);
+  }
+
+  return copy;
+}
+
+/* Pastes copies of the clips of @from starting in [@start, @stop[ into the
+ * same layers of @to, @start being moved to 0. The clips keep their
+ * relative positions, so each of them can be added on its own. */
+static gboolean
+_copy_clips (GESTimeline * from, GESTimeline * to, GstClockTime start,
+    GstClockTime stop)
+{
+  GList *tmp, *ltmp, *clips, *clip;
+  gboolean ret = TRUE;
+
+  for (tmp = from->layers, ltmp = to->layers; tmp && ltmp && ret;
+      tmp = tmp->next, ltmp = ltmp->next) {
+    GESLayer *layer = tmp->data;
+
+    clips = ges_layer_get_clips (layer);
+    for (clip = clips; clip && ret; clip = clip->next) {
+      GESTimelineElement *copy;
+
+      /* Auto transitions are created again along with the clips around
+       * them */
+      if (GES_IS_TRANSITION_CLIP (clip->data)
+          && ges_layer_get_auto_transition (layer))
+        continue;
+
+      if (_START (clip->data) < start || _START (clip->data) >= stop)
+        continue;
+
+      copy = gst_object_ref_sink (ges_timeline_element_copy (clip->data,
+              TRUE));
+      if (!ges_clip_paste_into_layer (GES_CLIP (copy), ltmp->data,
+              _START (clip->data) - start)) {
+        GST_ERROR_OBJECT (to, "Could not copy %" GES_FORMAT,
+            GES_ARGS (clip->data));
+        ret = FALSE;
+      }
+      gst_object_unref (copy);
+    }
+    g_list_free_full (clips, gst_object_unref);
+  }
+
+  return ret;
+}
+
+/* Copies @timeline in memory, with its clips split at each of the
+ * @boundaries */
+static GESTimeline *
+_copy_timeline_split (GESTimeline * timeline, GArray * boundaries)
+{
+  guint i;
+  GList *tmp, *clips, *clip;
+  gboolean ret = TRUE;
+  GESTimeline *copy = _new_timeline_like (timeline);
+
+  ret = _copy_clips (timeline, copy, 0, GST_CLOCK_TIME_NONE);
+  for (i = 1; boundaries && i + 1 < boundaries->len && ret; i++) {
+    GstClockTime boundary = g_array_index (boundaries, GstClockTime, i);
+
+    for (tmp = copy->layers; tmp && ret; tmp = tmp->next) {
+      clips = ges_layer_get_clips (tmp->data);
+      for (clip = clips; clip && ret; clip = clip->next) {
+        if (GES_IS_TRANSITION_CLIP (clip->data)
+            && ges_layer_get_auto_transition (tmp->data))
+          continue;
+
+        if (_START (clip->data) < boundary && _END (clip->data) > boundary
+            && !ges_clip_split (clip->data, boundary)) {
+          GST_ERROR_OBJECT (timeline, "Could not split %" GES_FORMAT,
+              GES_ARGS (clip->data));
+          ret = FALSE;
+        }
+      }
+      g_list_free_full (clips, gst_object_unref);
+    }
+  }
+
+  if (!ret)
+    gst_clear_object (&copy);
+
+  return copy;
+}
+
+/* Creates the timeline of [@start, @stop[ of @split, whose clips do not
+ * cross @start or @stop */
+static GESTimeline *
+_copy_timeline_segment (GESTimeline * split, GstClockTime start,
+    GstClockTime stop)
+{
+  GESTimeline *copy = _new_timeline_like (split);
+
+  if (!_copy_clips (split, copy, start, stop))
+    gst_clear_object (&copy);
+  else
+    ges_timeline_commit (copy);
+
+  return copy;
+}
+
+static GstBusSyncReply
+_render_bus_sync_handler (GstBus * bus, GstMessage * message,
+    RenderSync * sync)
+{
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_EOS:
+      g_mutex_lock (&sync->lock);
+      sync->n_running--;
+      g_cond_signal (&sync->cond);
+      g_mutex_unlock (&sync->lock);
+      break;
+    case GST_MESSAGE_ERROR:
+      g_mutex_lock (&sync->lock);
+      if (!sync->error)
+        gst_message_parse_error (message, &sync->error, NULL);
+      g_cond_signal (&sync->cond);
+      g_mutex_unlock (&sync->lock);
+      break;
+    default:
+      break;
+  }
+
+  /* Nobody is watching those busses */
+  return GST_BUS_DROP;
+}
+
+/* Runs all @pipelines concurrently until they are all EOS */
+static gboolean
+_run_render_pipelines (GPtrArray * pipelines, GError ** error)
+{
+  guint i;
+  GstBus *bus;
+  RenderSync sync;
+
+  g_mutex_init (&sync.lock);
+  g_cond_init (&sync.cond);
+  sync.n_running = pipelines->len;
+  sync.error = NULL;
+
+  for (i = 0; i < pipelines->len; i++) {
+    bus = gst_pipeline_get_bus (g_ptr_array_index (pipelines, i));
+    gst_bus_set_sync_handler (bus, (GstBusSyncHandler) _render_bus_sync_handler,
+        &sync, NULL);
+    gst_object_unref (bus);
+  }
+
+  for (i = 0; i < pipelines->len; i++) {
+    if (gst_element_set_state (g_ptr_array_index (pipelines, i),
+            GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+      g_mutex_lock (&sync.lock);
+      if (!sync.error)
+        sync.error = g_error_new (GST_CORE_ERROR, GST_CORE_ERROR_STATE_CHANGE,
+            "Could not start rendering");
+      g_mutex_unlock (&sync.lock);
+      break;
+    }
+  }
+
+  g_mutex_lock (&sync.lock);
+  while (sync.n_running && !sync.error)
+    g_cond_wait (&sync.cond, &sync.lock);
+  g_mutex_unlock (&sync.lock);
+
+  for (i = 0; i < pipelines->len; i++) {
+    gst_element_set_state (g_ptr_array_index (pipelines, i), GST_STATE_NULL);
+    bus = gst_pipeline_get_bus (g_ptr_array_index (pipelines, i));
+    gst_bus_set_sync_handler (bus, NULL, NULL, NULL);
+    gst_object_unref (bus);
+  }
+
+  g_mutex_clear (&sync.lock);
+  g_cond_clear (&sync.cond);
+
+  if (sync.error) {
+    g_propagate_error (error, sync.error);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+static GESPipeline *
+_create_render_pipeline (GESTimeline * timeline, const gchar * uri,
+    GstEncodingProfile * profile, GESPipelineFlags mode, GError ** error)
+{
+  gboolean res;
+  GESPipeline *pipeline = gst_object_ref_sink (ges_pipeline_new ());
+  GstEncodingProfile *copy = gst_encoding_profile_copy (profile);
+
+  res = ges_pipeline_set_timeline (pipeline, timeline) &&
+      ges_pipeline_set_render_settings (pipeline, uri, copy) &&
+      ges_pipeline_set_mode (pipeline, mode);
+  gst_encoding_profile_unref (copy);
+
+  if (!res) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+        "Could not setup rendering to %s", uri);
+    gst_object_unref (pipeline);
+
+    return NULL;
+  }
+
+  return pipeline;
+}
+
+/* Whether smart rendering can pass the streams of @info through to the
+ * output of @profile */
+static gboolean
+_profile_accepts_streams (GstEncodingProfile * profile,
+    GstDiscovererInfo * info)
+{
+  GList *streams, *tmp;
+  const GList *ptmp;
+  gboolean ret = TRUE;
+
+  if (!GST_IS_ENCODING_CONTAINER_PROFILE (profile))
+    return FALSE;
+
+  streams = gst_discoverer_info_get_stream_list (info);
+  for (tmp = streams; tmp && ret; tmp = tmp->next) {
+    GstCaps *caps;
+
+    if (GST_IS_DISCOVERER_CONTAINER_INFO (tmp->data))
+      continue;
+
+    ret = FALSE;
+    caps = gst_discoverer_stream_info_get_caps (tmp->data);
+    for (ptmp = gst_encoding_container_profile_get_profiles
+        (GST_ENCODING_CONTAINER_PROFILE (profile)); ptmp && !ret;
+        ptmp = ptmp->next) {
+      GstCaps *format = gst_encoding_profile_get_format (ptmp->data);
+
+      ret = caps && gst_caps_can_intersect (caps, format);
+      gst_caps_unref (format);
+    }
+    gst_clear_caps (&caps);
+  }
+  gst_discoverer_stream_info_list_free (streams);
+
+  return ret;
+}
+
+/* Whether the streams of @a and @b have the exact same caps, including their
+ * codec data, so that they can follow each other in a stream */
+static gboolean
+_streams_match (GstDiscovererInfo * a, GstDiscovererInfo * b)
+{
+  GList *astreams, *bstreams, *atmp, *btmp;
+  gboolean ret = TRUE;
+
+  astreams = gst_discoverer_info_get_stream_list (a);
+  bstreams = gst_discoverer_info_get_stream_list (b);
+  for (atmp = astreams, btmp = bstreams; atmp && btmp && ret;
+      atmp = atmp->next, btmp = btmp->next) {
+    GstCaps *acaps = gst_discoverer_stream_info_get_caps (atmp->data);
+    GstCaps *bcaps = gst_discoverer_stream_info_get_caps (btmp->data);
+
+    ret = acaps && bcaps && gst_caps_is_equal (acaps, bcaps);
+    gst_clear_caps (&acaps);
+    gst_clear_caps (&bcaps);
+  }
+  ret &= !atmp && !btmp;
+  gst_discoverer_stream_info_list_free (astreams);
+  gst_discoverer_stream_info_list_free (bstreams);
+
+  return ret;
+}
+
+/* Concatenates the rendered segments into @output_uri, smart rendering
+ * avoids encoding the segments again as long as they all have the same
+ * formats, matching the render settings. A warning is posted on @self
+ * otherwise. */
+static gboolean
+_concat_segments (GESPipeline * self, GPtrArray * segment_uris,
+    GArray * boundaries, const gchar * output_uri, GError ** error)
+{
+  guint i;
+  GList *tmp;
+  GESLayer *layer;
+  GESPipeline *pipeline;
+  GPtrArray *pipelines, *assets;
+  gboolean ret = FALSE, needs_encoding = FALSE;
+  GESTimeline *timeline = gst_object_ref_sink (ges_timeline_new ());
+
+  for (tmp = self->priv->timeline->tracks; tmp; tmp = tmp->next) {
+    GESTrack *track;
+    GstCaps *caps = ges_track_get_restriction_caps (tmp->data);
+
+    if (GES_IS_VIDEO_TRACK (tmp->data))
+      track = GES_TRACK (ges_video_track_new ());
+    else if (GES_IS_AUDIO_TRACK (tmp->data))
+      track = GES_TRACK (ges_audio_track_new ());
+    else
+      track = NULL;
+
+    if (track) {
+      ges_track_set_restriction_caps (track, caps);
+      ges_track_set_mixing (track, FALSE);
+      ges_timeline_add_track (timeline, track);
+    }
+    gst_caps_unref (caps);
+  }
+
+  layer = ges_timeline_append_layer (timeline);
+  assets = g_ptr_array_new_with_free_func (gst_object_unref);
+  for (i = 0; i < segment_uris->len; i++) {
+    GstClockTime start = g_array_index (boundaries, GstClockTime, i);
+    GstClockTime duration =
+        g_array_index (boundaries, GstClockTime, i + 1) - start;
+    GESUriClipAsset *asset =
+        ges_uri_clip_asset_request_sync (g_ptr_array_index (segment_uris, i),
+        error);
+
+    if (!asset)
+      goto done;
+
+    duration = MIN (duration, ges_uri_clip_asset_get_duration (asset));
+    if (!ges_layer_add_asset (layer, GES_ASSET (asset), start, 0, duration,
+            GES_TRACK_TYPE_UNKNOWN)) {
+      g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+          "Could not add segment %s", (gchar *) g_ptr_array_index
+          (segment_uris, i));
+      gst_object_unref (asset);
+      goto done;
+    }
+    g_ptr_array_add (assets, asset);
+
+    if (!needs_encoding) {
+      GstDiscovererInfo *info = ges_uri_clip_asset_get_info (asset);
+
+      needs_encoding = !_profile_accepts_streams (self->priv->profile, info)
+          || (i && !_streams_match (ges_uri_clip_asset_get_info
+              (g_ptr_array_index (assets, 0)), info));
+    }
+  }
+
+  if (needs_encoding) {
+    GST_ELEMENT_WARNING (self, STREAM, FORMAT,
+        ("The rendered segments are encoded again to be concatenated"),
+        ("The formats of the segments do not all match each other and the"
+            " render settings, they can not be passed through"));
+  }
+
+  pipeline = _create_render_pipeline (timeline, output_uri,
+      self->priv->profile, GES_PIPELINE_MODE_SMART_RENDER, error);
+  if (!pipeline)
+    goto done;
+
+  pipelines = g_ptr_array_new_with_free_func (gst_object_unref);
+  g_ptr_array_add (pipelines, pipeline);
+  ret = _run_render_pipelines (pipelines, error);
+  g_ptr_array_unref (pipelines);
+
+done:
+  g_ptr_array_unref (assets);
+  gst_object_unref (timeline);
+
+  return ret;
+}
+
+/* Regions of the timeline between consecutive clip starts and ends, which
+ * are rendered and cached independently: editing a clip only changes the
+ * content of the regions it overlaps, even if it shifts the others in
+ * time */
+static GArray *
+_get_cache_regions (GESTimeline * timeline)
+{
+  guint i;
+  GList *tmp, *clips = NULL;
+  GstClockTime edge = 0, duration = ges_timeline_get_duration (timeline);
+  GArray *edges = g_array_new (FALSE, FALSE, sizeof (GstClockTime));
+  GArray *boundaries = g_array_new (FALSE, FALSE, sizeof (GstClockTime));
+
+  for (tmp = timeline->layers; tmp; tmp = tmp->next)
+    clips = g_list_concat (clips, ges_layer_get_clips (tmp->data));
+
+  for (tmp = clips; tmp; tmp = tmp->next) {
+    GstClockTime start = _START (tmp->data), stop = _END (tmp->data);
+
+    g_array_append_val (edges, start);
+    g_array_append_val (edges, stop);
+  }
+  g_list_free_full (clips, gst_object_unref);
+  g_array_append_val (edges, duration);
+  g_array_sort (edges, (GCompareFunc) _compare_clock_times);
+
+  g_array_append_val (boundaries, edge);
+  for (i = 0; i < edges->len; i++) {
+    edge = g_array_index (edges, GstClockTime, i);
+
+    if (edge > g_array_index (boundaries, GstClockTime, boundaries->len - 1)
+        && edge <= duration)
+      g_array_append_val (boundaries, edge);
+  }
+  g_array_free (edges, TRUE);
+
+  return boundaries;
+}
+
+static void
+_checksum_caps (GChecksum * checksum, GstCaps * caps)
+{
+  gchar *str = caps ? gst_caps_to_string (caps) : NULL;
+
+  g_checksum_update (checksum, (const guchar *) (str ? str : "NULL"), -1);
+  g_free (str);
+}
+
+static void
+_checksum_profile (GChecksum * checksum, GstEncodingProfile * profile)
+{
+  const GList *tmp;
+  gchar *str;
+
+  _checksum_caps (checksum, gst_encoding_profile_get_format (profile));
+  _checksum_caps (checksum, gst_encoding_profile_get_restriction (profile));
+  str = g_strdup_printf ("%s:%s:%u",
+      GST_STR_NULL (gst_encoding_profile_get_preset (profile)),
+      GST_STR_NULL (gst_encoding_profile_get_preset_name (profile)),
+      gst_encoding_profile_get_presence (profile));
+  g_checksum_update (checksum, (const guchar *) str, -1);
+  g_free (str);
+
+  if (GST_IS_ENCODING_CONTAINER_PROFILE (profile)) {
+    for (tmp = gst_encoding_container_profile_get_profiles
+        (GST_ENCODING_CONTAINER_PROFILE (profile)); tmp; tmp = tmp->next)
+      _checksum_profile (checksum, tmp->data);
+  }
+}
+
+static void
+_checksum_string (GChecksum * checksum, gchar * str)
+{
+  g_checksum_update (checksum, (const guchar *) str, -1);
+  g_checksum_update (checksum, (const guchar *) "\n", 1);
+  g_free (str);
+}
+
+static void
+_checksum_media (GChecksum * checksum, GESAsset * asset)
+{
+  GStatBuf stat_buf;
+  gchar *location;
+  const gchar *id = ges_asset_get_id (asset);
+
+  _checksum_string (checksum, g_strdup_printf ("%s:%s",
+          g_type_name (ges_asset_get_extractable_type (asset)), id));
+
+  if (!gst_uri_is_valid (id) || !gst_uri_has_protocol (id, "file"))
+    return;
+
+  /* Media files changing on disk invalidate the regions using them */
+  location = gst_uri_get_location (id);
+  if (location && !g_stat (location, &stat_buf))
+    _checksum_string (checksum, g_strdup_printf ("%" G_GINT64_FORMAT ":%"
+            G_GINT64_FORMAT, (gint64) stat_buf.st_size,
+            (gint64) stat_buf.st_mtime));
+  g_free (location);
+}
+
+static void
+_checksum_bindings (GChecksum * checksum, GESTrackElement * element)
+{
+  GList *names, *name;
+  GHashTable *bindings = ges_track_element_get_all_control_bindings (element);
+
+  names = g_list_sort (g_hash_table_get_keys (bindings),
+      (GCompareFunc) g_strcmp0);
+  for (name = names; name; name = name->next) {
+    GstControlSource *source = NULL;
+    GstControlBinding *binding = g_hash_table_lookup (bindings, name->data);
+    GList *values, *value;
+    gboolean absolute = FALSE;
+    gint mode = -1;
+
+    g_object_get (binding, "control-source", &source, NULL);
+    if (GST_IS_DIRECT_CONTROL_BINDING (binding))
+      g_object_get (binding, "absolute", &absolute, NULL);
+    _checksum_string (checksum, g_strdup_printf ("%s:%s:%d",
+            (gchar *) name->data, G_OBJECT_TYPE_NAME (binding), absolute));
+
+    if (GST_IS_TIMED_VALUE_CONTROL_SOURCE (source)) {
+      if (GST_IS_INTERPOLATION_CONTROL_SOURCE (source))
+        g_object_get (source, "mode", &mode, NULL);
+      _checksum_string (checksum, g_strdup_printf ("mode:%d", mode));
+
+      values = gst_timed_value_control_source_get_all
+          (GST_TIMED_VALUE_CONTROL_SOURCE (source));
+      for (value = values; value; value = value->next) {
+        GstTimedValue *timed = value->data;
+
+        _checksum_string (checksum, g_strdup_printf ("%" G_GUINT64_FORMAT
+                ":%.17g", timed->timestamp, timed->value));
+      }
+      g_list_free (values);
+    }
+    gst_clear_object (&source);
+  }
+  g_list_free (names);
+}
+
+/* Hashes everything that determines the rendered content of [@start,
+ * @stop[, relatively to @start, together with the render settings: all the
+ * elements overlapping it, with their position relative to @start */
+static gchar *
+_compute_region_hash (GESPipeline * self, GstClockTime start,
+    GstClockTime stop)
+{
+  gchar *ret;
+  GList *tmp, *clips, *clip, *child;
+  guint layer_index = 0;
+  GESTimeline *timeline = self->priv->timeline;
+  GChecksum *checksum = g_checksum_new (G_CHECKSUM_SHA256);
+
+  _checksum_profile (checksum, self->priv->profile);
+  _checksum_string (checksum, g_strdup_printf ("%u:%" G_GUINT64_FORMAT,
+          self->priv->mode & (GES_PIPELINE_MODE_RENDER |
+              GES_PIPELINE_MODE_SMART_RENDER), stop - start));
+
+  for (tmp = timeline->tracks; tmp; tmp = tmp->next) {
+    _checksum_string (checksum, g_strdup_printf ("track:%d",
+            ges_track_get_track_type (tmp->data)));
+    _checksum_caps (checksum, GES_TRACK (tmp->data)->restriction_caps);
+  }
+
+  for (tmp = timeline->layers; tmp; tmp = tmp->next, layer_index++) {
+    GList *track;
+
+    /* Layers can be disabled in some tracks only */
+    for (track = timeline->tracks; track; track = track->next)
+      _checksum_string (checksum, g_strdup_printf ("layer:%u:%d",
+              layer_index, ges_layer_get_active_for_track (tmp->data,
+                  track->data)));
+
+    clips = ges_layer_get_clips (tmp->data);
+    for (clip = clips; clip; clip = clip->next) {
+      GESTimelineElement *element = clip->data;
+
+      if (element->start >= stop || _END (element) <= start)
+        continue;
+
+      _checksum_string (checksum, g_strdup_printf ("clip:%u:%s:%"
+              G_GINT64_FORMAT, layer_index, G_OBJECT_TYPE_NAME (element),
+              (gint64) (element->start - start)));
+      _checksum_string (checksum,
+          ges_util_serialize_properties (G_OBJECT (element), NULL, "name",
+              "start", "priority", NULL));
+      if (element->asset)
+        _checksum_media (checksum, element->asset);
+
+      for (child = GES_CONTAINER_CHILDREN (element); child;
+          child = child->next) {
+        GESTrack *track = ges_track_element_get_track (child->data);
+
+        _checksum_string (checksum, g_strdup_printf ("child:%s:%d:%d",
+                G_OBJECT_TYPE_NAME (child->data),
+                track ? g_list_index (timeline->tracks, track) : -1,
+                GES_IS_BASE_EFFECT (child->data) ?
+                ges_clip_get_top_effect_index (GES_CLIP (element),
+                    GES_BASE_EFFECT (child->data)) : -1));
+        _checksum_string (checksum,
+            ges_util_serialize_properties (child->data, NULL, "name", "start",
+                "priority", "track", NULL));
+        _checksum_string (checksum,
+            ges_util_serialize_children_properties (child->data));
+        _checksum_bindings (checksum, child->data);
+      }
+    }
+    g_list_free_full (clips, gst_object_unref);
+  }
+
+  ret = g_strdup (g_checksum_get_string (checksum));
+  g_checksum_free (checksum);
+
+  return ret;
+}
+
+typedef struct
+{
+  gchar *path;
+  gint64 size;
+  gint64 mtime;
+} CacheEntry;
+
+static gint
+_compare_cache_entries (const CacheEntry * a, const CacheEntry * b)
+{
+  return (a->mtime > b->mtime) - (a->mtime < b->mtime);
+}
+
+/* Removes the least recently used entries until the cache is small enough */
+static void
+_prune_render_cache (const gchar * directory, guint64 max_size)
+{
+  guint i;
+  GDir *dir;
+  const gchar *name;
+  guint64 size = 0;
+  GArray *entries;
+
+  if (!max_size || !(dir = g_dir_open (directory, 0, NULL)))
+    return;
+
+  entries = g_array_new (FALSE, FALSE, sizeof (CacheEntry));
+  while ((name = g_dir_read_name (dir))) {
+    GStatBuf stat_buf;
+    CacheEntry entry;
+
+    if (g_str_has_suffix (name, ".part"))
+      continue;
+
+    entry.path = g_build_filename (directory, name, NULL);
+    if (g_stat (entry.path, &stat_buf) || !S_ISREG (stat_buf.st_mode)) {
+      g_free (entry.path);
+      continue;
+    }
+
+    entry.size = stat_buf.st_size;
+    entry.mtime = stat_buf.st_mtime;
+    size += entry.size;
+    g_array_append_val (entries, entry);
+  }
+  g_dir_close (dir);
+
+  g_array_sort (entries, (GCompareFunc) _compare_cache_entries);
+  for (i = 0; i < entries->len; i++) {
+    CacheEntry *entry = &g_array_index (entries, CacheEntry, i);
+
+    if (size > max_size && !g_unlink (entry->path)) {
+      GST_DEBUG ("Removed %s from the render cache", entry->path);
+      size -= entry->size;
+    }
+    g_free (entry->path);
+  }
+  g_array_free (entries, TRUE);
+}
+
+/**
+ * ges_pipeline_set_render_cache:
+ * @pipeline: A #GESPipeline
+ * @directory: (allow-none): The directory where to keep rendered regions
+ * of the timeline, or %NULL to disable the cache
+ * @max_size: The size, in bytes, above which the least recently used
+ * regions are removed from @directory, or 0 for no limit
+ *
+ * Makes ges_pipeline_render_segmented() keep the encoded output of each
+ * region of the timeline between consecutive clip starts and ends in
+ * @directory, and reuse it in the next renders as long as nothing changed in
+ * that region (clips overlapping it, their in-points, effects, children
+ * properties, keyframes, media files or the layers being active in each
+ * track) nor in the render settings. Only the modified regions are then
+ * encoded again.
+ *
+ * Since: 1.20
+ */
+void
+ges_pipeline_set_render_cache (GESPipeline * pipeline,
+    const gchar * directory, guint64 max_size)
+{
+  g_return_if_fail (GES_IS_PIPELINE (pipeline));
+
+  g_free (pipeline->priv->render_cache_dir);
+  pipeline->priv->render_cache_dir = g_strdup (directory);
+  pipeline->priv->render_cache_max_size = max_size;
+}
+
+/**
+ * ges_pipeline_render_segmented:
+ * @pipeline: A #GESPipeline in #GST_STATE_NULL, with its render settings
+ * set and in #GES_PIPELINE_MODE_RENDER or #GES_PIPELINE_MODE_SMART_RENDER
+ * @n_segments: The maximum number of segments to render in parallel
+ * @error: (out) (allow-none): An error to be set in case something wrong
+ * happens or %NULL
+ *
+ * Renders the #GESPipeline:timeline of @pipeline with the render settings
+ * of @pipeline, splitting it in up to @n_segments time ranges that are
+ * each rendered by their own pipeline, in parallel, and then concatenated
+ * without being encoded again into the final output.
+ *
+ * Segments boundaries are placed where clips end, or on the previous
+ * keyframe of a video clip crossing that position, so less segments than
+ * requested might be used. Each segment is rendered from its own in-memory
+ * copy of the timeline, and @pipeline itself is not run. If the rendered
+ * segments can not be concatenated without being encoded again, a
+ * #GST_MESSAGE_WARNING is posted on the bus of @pipeline.
+ *
+ * If a render cache is set with ges_pipeline_set_render_cache(), the
+ * segments are instead all the regions between consecutive clip starts and
+ * ends, and only those which are not cached are rendered, @n_segments at a
+ * time.
+ *
+ * This call blocks until the rendering is done.
+ *
+ * Returns: %TRUE if the timeline was rendered, %FALSE otherwise.
+ *
+ * Since: 1.20
+ */
+gboolean
+ges_pipeline_render_segmented (GESPipeline * pipeline, guint n_segments,
+    GError ** error)
+{
+  guint i, j;
+  GArray *boundaries, *dirty;
+  GESPipelinePrivate *priv;
+  gchar *tmpdir, *filename, *output_uri = NULL;
+  GPtrArray *filenames, *segment_uris, *render_uris, *cached;
+  GESTimeline *split = NULL;
+  gboolean ret = FALSE;
+
+  g_return_val_if_fail (GES_IS_PIPELINE (pipeline), FALSE);
+  g_return_val_if_fail (n_segments > 0, FALSE);
+  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+  CHECK_THREAD (pipeline);
+
+  priv = pipeline->priv;
+  if (!priv->timeline || !IN_RENDERING_MODE (pipeline) || !priv->urisink) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+        "Render settings need to be set on the pipeline");
+
+    return FALSE;
+  }
+
+  if (priv->render_cache_dir &&
+      g_mkdir_with_parents (priv->render_cache_dir, 0755)) {
+    g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errno),
+        "Could not create the render cache directory %s",
+        priv->render_cache_dir);
+
+    return FALSE;
+  }
+
+  if (!(tmpdir = g_dir_make_tmp ("ges-render-XXXXXX", error)))
+    return FALSE;
+
+  filenames = g_ptr_array_new_with_free_func (g_free);
+  segment_uris = g_ptr_array_new_with_free_func (g_free);
+  /* Where each segment is rendered, and renamed from when it is cached */
+  render_uris = g_ptr_array_new_with_free_func (g_free);
+  cached = g_ptr_array_new_with_free_func (g_free);
+  dirty = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  if (priv->render_cache_dir)
+    boundaries = _get_cache_regions (priv->timeline);
+  else
+    boundaries = _get_segment_boundaries (priv->timeline, n_segments);
+
+  for (i = 0; i + 1 < boundaries->len; i++) {
+    gchar *hash = NULL, *name;
+
+    if (priv->render_cache_dir)
+      hash = _compute_region_hash (pipeline,
+          g_array_index (boundaries, GstClockTime, i),
+          g_array_index (boundaries, GstClockTime, i + 1));
+
+    if (hash) {
+      filename = g_build_filename (priv->render_cache_dir, hash, NULL);
+      g_ptr_array_add (segment_uris, gst_filename_to_uri (filename, NULL));
+
+      if (g_file_test (filename, G_FILE_TEST_IS_REGULAR)) {
+        GST_DEBUG_OBJECT (pipeline, "Region %u is cached as %s", i, hash);
+        /* Marks the entry as recently used */
+        g_utime (filename, NULL);
+        g_ptr_array_add (render_uris, NULL);
+        g_ptr_array_add (cached, NULL);
+        g_free (filename);
+        g_free (hash);
+        continue;
+      }
+
+      g_ptr_array_add (cached, filename);
+      filename = g_strconcat (g_ptr_array_index (cached, i), ".part", NULL);
+      g_ptr_array_add (render_uris, gst_filename_to_uri (filename, NULL));
+      g_free (hash);
+    } else {
+      name = g_strdup_printf ("segment-%u", i);
+      filename = g_build_filename (tmpdir, name, NULL);
+      g_ptr_array_add (segment_uris, gst_filename_to_uri (filename, NULL));
+      g_ptr_array_add (render_uris, gst_filename_to_uri (filename, NULL));
+      g_ptr_array_add (cached, NULL);
+      g_free (name);
+    }
+
+    g_ptr_array_add (filenames, filename);
+    g_array_append_val (dirty, i);
+  }
+
+  GST_INFO_OBJECT (pipeline, "Rendering %u segments out of %u", dirty->len,
+      boundaries->len - 1);
+
+  if (dirty->len
+      && !(split = _copy_timeline_split (priv->timeline, boundaries))) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+        "Could not split the timeline in segments");
+    goto done;
+  }
+
+  for (i = 0; i < dirty->len; i += n_segments) {
+    gboolean ok;
+    GPtrArray *pipelines =
+        g_ptr_array_new_with_free_func (gst_object_unref);
+
+    for (j = i; j < MIN (i + n_segments, dirty->len); j++) {
+      GESTimeline *timeline;
+      GESPipeline *worker;
+      guint segment = g_array_index (dirty, guint, j);
+
+      timeline = _copy_timeline_segment (split,
+          g_array_index (boundaries, GstClockTime, segment),
+          g_array_index (boundaries, GstClockTime, segment + 1));
+      if (!timeline) {
+        g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+            "Could not create the timeline of segment %u", segment);
+        break;
+      }
+
+      worker = _create_render_pipeline (timeline,
+          g_ptr_array_index (render_uris, segment), priv->profile,
+          priv->mode & (GES_PIPELINE_MODE_RENDER |
+              GES_PIPELINE_MODE_SMART_RENDER), error);
+      gst_object_unref (timeline);
+      if (!worker)
+        break;
+
+      g_ptr_array_add (pipelines, worker);
+    }
+
+    ok = j == MIN (i + n_segments, dirty->len) &&
+        _run_render_pipelines (pipelines, error);
+    g_ptr_array_unref (pipelines);
+    if (!ok)
+      goto done;
+
+    for (j = i; j < MIN (i + n_segments, dirty->len); j++) {
+      guint segment = g_array_index (dirty, guint, j);
+      const gchar *cache_path = g_ptr_array_index (cached, segment);
+      gchar *part;
+
+      if (!cache_path)
+        continue;
+
+      part = gst_uri_get_location (g_ptr_array_index (render_uris, segment));
+      if (g_rename (part, cache_path)) {
+        GST_WARNING_OBJECT (pipeline, "Could not cache %s: %s, using %s"
+            " directly", cache_path, g_strerror (errno), part);
+
+        /* The part file is removed with the other rendered segments */
+        g_free (g_ptr_array_index (segment_uris, segment));
+        g_ptr_array_index (segment_uris, segment) =
+            g_strdup (g_ptr_array_index (render_uris, segment));
+      }
+      g_free (part);
+    }
+  }
+
+  output_uri = gst_uri_handler_get_uri (GST_URI_HANDLER (priv->urisink));
+  ret = _concat_segments (pipeline, segment_uris, boundaries, output_uri,
+      error);
+
+  if (priv->render_cache_dir)
+    _prune_render_cache (priv->render_cache_dir,
+        priv->render_cache_max_size);
+
+done:
+  for (i = 0; i < filenames->len; i++) {
+    filename = g_ptr_array_index (filenames, i);
+    if (g_file_test (filename, G_FILE_TEST_EXISTS))
+      g_unlink (filename);
+  }
+  g_rmdir (tmpdir);
+
+  g_array_free (boundaries, TRUE);
+  g_array_free (dirty, TRUE);
+  g_ptr_array_unref (cached);
+  g_ptr_array_unref (render_uris);
+  g_ptr_array_unref (segment_uris);
+  g_ptr_array_unref (filenames);
+  gst_clear_object (&split);
+  g_free (output_uri);
+  g_free (tmpdir);
+
+  return ret;
+}
+
+/* Thumbnails */
+
+typedef struct
+{
+  GstClockTime timestamp;
+  guint index;
+} ThumbnailRequest;
+
+static gint
+_compare_thumbnail_requests (const ThumbnailRequest * a,
+    const ThumbnailRequest * b)
+{
+  return _compare_clock_times (&a->timestamp, &b->timestamp);
+}
+
+static GstElement *
+_make_image_encoder (GstCaps * caps)
+{
+  GList *factories, *encoders;
+  GstElement *encoder = NULL;
+
+  factories =
+      gst_element_factory_list_get_elements (GST_ELEMENT_FACTORY_TYPE_ENCODER |
+      GST_ELEMENT_FACTORY_TYPE_MEDIA_IMAGE, GST_RANK_MARGINAL);
+  encoders = gst_element_factory_list_filter (factories, caps, GST_PAD_SRC,
+      FALSE);
+  if (encoders)
+    encoder = gst_element_factory_create (encoders->data, NULL);
+
+  gst_plugin_feature_list_free (encoders);
+  gst_plugin_feature_list_free (factories);
+
+  return encoder;
+}
+
+/* Only keeps the first video track of @timeline, at the size set in @caps
+ * if any, so that the compositor directly outputs small frames */
+static GstElement *
+_create_thumbnail_pipeline (GESTimeline * timeline, GstCaps * caps,
+    GstElement ** sink, GError ** error)
+{
+  gint width, height;
+  GList *tmp, *tracks;
+  GESTrack *track = NULL;
+  GstCaps *raw_caps;
+  GstPad *srcpad, *sinkpad;
+  GstStructure *structure = NULL;
+  GstElement *pipeline = NULL, *convert, *scale, *filter, *encoder = NULL;
+
+  tracks = ges_timeline_get_tracks (timeline);
+  for (tmp = tracks; tmp; tmp = tmp->next) {
+    if (!track && ges_track_get_track_type (tmp->data) == GES_TRACK_TYPE_VIDEO)
+      track = tmp->data;
+    else
+      ges_timeline_remove_track (timeline, tmp->data);
+  }
+
+  if (!track) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+        "The timeline does not have any video track");
+    goto done;
+  }
+
+  if (!gst_caps_is_any (caps) && !gst_caps_is_empty (caps))
+    structure = gst_caps_get_structure (caps, 0);
+
+  if (structure && gst_structure_get_int (structure, "width", &width) &&
+      gst_structure_get_int (structure, "height", &height)) {
+    GstCaps *restriction = gst_caps_new_simple ("video/x-raw",
+        "width", G_TYPE_INT, width, "height", G_TYPE_INT, height, NULL);
+
+    ges_track_update_restriction_caps (track, restriction);
+    gst_caps_unref (restriction);
+  }
+
+  if (!structure || gst_structure_has_name (structure, "video/x-raw")) {
+    raw_caps = gst_caps_ref (caps);
+  } else {
+    raw_caps = gst_caps_new_empty_simple ("video/x-raw");
+    encoder = _make_image_encoder (caps);
+  }
+
+  convert = gst_element_factory_make ("videoconvert", NULL);
+  scale = gst_element_factory_make ("videoscale", NULL);
+  filter = gst_element_factory_make ("capsfilter", NULL);
+  *sink = gst_element_factory_make ("appsink", NULL);
+  if (!convert || !scale || !filter || !*sink ||
+      (!encoder && !gst_caps_is_subset (caps, raw_caps))) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_MISSING_PLUGIN,
+        "Missing elements to create thumbnails as %" GST_PTR_FORMAT, caps);
+    gst_clear_object (&convert);
+    gst_clear_object (&scale);
+    gst_clear_object (&filter);
+    gst_clear_object (&encoder);
+    gst_clear_object (sink);
+    gst_caps_unref (raw_caps);
+    goto done;
+  }
+
+  g_object_set (filter, "caps", raw_caps, NULL);
+  g_object_set (*sink, "caps", caps, "sync", FALSE, "enable-last-sample",
+      FALSE, NULL);
+  gst_caps_unref (raw_caps);
+
+  pipeline = gst_object_ref_sink (gst_pipeline_new ("ges-thumbnailer"));
+  gst_bin_add_many (GST_BIN (pipeline), GST_ELEMENT (timeline), convert,
+      scale, filter, *sink, NULL);
+  if (encoder) {
+    gst_bin_add (GST_BIN (pipeline), encoder);
+    gst_element_link_many (convert, scale, filter, encoder, *sink, NULL);
+  } else {
+    gst_element_link_many (convert, scale, filter, *sink, NULL);
+  }
+
+  srcpad = ges_timeline_get_pad_for_track (timeline, track);
+  sinkpad = gst_element_get_static_pad (convert, "sink");
+  if (!srcpad || GST_PAD_LINK_FAILED (gst_pad_link (srcpad, sinkpad))) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_NEGOTIATION,
+        "Could not link the video track");
+    gst_clear_object (&pipeline);
+  }
+  gst_object_unref (sinkpad);
+
+done:
+  g_list_free_full (tracks, gst_object_unref);
+
+  return pipeline;
+}
+
+#define THUMBNAIL_PREROLL_TIMEOUT (30 * GST_SECOND)
+
+static gboolean
+_wait_thumbnail_preroll (GstElement * pipeline, GError ** error)
+{
+  GstMessage *message;
+  gboolean ret = TRUE;
+  GstBus *bus = gst_element_get_bus (pipeline);
+
+  message = gst_bus_timed_pop_filtered (bus, THUMBNAIL_PREROLL_TIMEOUT,
+      GST_MESSAGE_ASYNC_DONE | GST_MESSAGE_ERROR);
+  if (!message) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_STATE_CHANGE,
+        "Timed out waiting for the thumbnailing pipeline to preroll");
+    ret = FALSE;
+  } else if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR) {
+    gst_message_parse_error (message, error, NULL);
+    ret = FALSE;
+  }
+  g_clear_pointer (&message, gst_message_unref);
+  gst_object_unref (bus);
+
+  return ret;
+}
+
+static void
+_timeline_commited_cb (GESTimeline * timeline, GESPipeline * self)
+{
+  /* Might be called from a streaming thread, the thumbnailer is only
+   * rebuilt from the thread of @self */
+  g_atomic_int_set (&self->priv->thumbnailer_stale, TRUE);
+}
+
+static void
+_clear_thumbnailer (GESPipeline * self)
+{
+  GESPipelinePrivate *priv = self->priv;
+
+  if (!priv->thumbnailer)
+    return;
+
+  g_signal_handlers_disconnect_by_func (priv->timeline,
+      _timeline_commited_cb, self);
+  gst_element_set_state (priv->thumbnailer, GST_STATE_NULL);
+  gst_clear_object (&priv->thumbnailer);
+  gst_clear_object (&priv->thumbnail_sink);
+  gst_clear_caps (&priv->thumbnail_caps);
+}
+
+/* Makes sure a prerolled thumbnailer producing @caps from the current state
+ * of the timeline exists. It is kept around between calls and only rebuilt
+ * when the requested caps change or the timeline got committed since it was
+ * created */
+static gboolean
+_ensure_thumbnailer (GESPipeline * self, GstCaps * caps, GError ** error)
+{
+  GESTimeline *timeline;
+  GstElement *pipeline, *sink = NULL;
+  GESPipelinePrivate *priv = self->priv;
+
+  if (priv->thumbnailer && (g_atomic_int_get (&priv->thumbnailer_stale) ||
+          !gst_caps_is_equal (caps, priv->thumbnail_caps))) {
+    GST_DEBUG_OBJECT (self, "Rebuilding the thumbnailer");
+    _clear_thumbnailer (self);
+  }
+
+  if (priv->thumbnailer)
+    return TRUE;
+
+  /* Connect before copying so that a commit happening meanwhile marks the
+   * new thumbnailer as stale */
+  g_atomic_int_set (&priv->thumbnailer_stale, FALSE);
+  g_signal_connect (priv->timeline, "commited",
+      G_CALLBACK (_timeline_commited_cb), self);
+
+  timeline = _copy_timeline_split (priv->timeline, NULL);
+  if (!timeline) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+        "Could not copy the timeline");
+    goto failed;
+  }
+  ges_timeline_set_use_generated_proxies (timeline, TRUE);
+  ges_timeline_commit (timeline);
+
+  pipeline = _create_thumbnail_pipeline (timeline, caps, &sink, error);
+  gst_object_unref (timeline);
+  if (!pipeline)
+    goto failed;
+
+  if (gst_element_set_state (pipeline, GST_STATE_PAUSED) ==
+      GST_STATE_CHANGE_FAILURE) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_STATE_CHANGE,
+        "Could not start the thumbnailing pipeline");
+    gst_element_set_state (pipeline, GST_STATE_NULL);
+    gst_object_unref (pipeline);
+    goto failed;
+  }
+
+  priv->thumbnailer = pipeline;
+  priv->thumbnail_sink = gst_object_ref (sink);
+  priv->thumbnail_caps = gst_caps_ref (caps);
+  priv->thumbnail_position = 0;
+  if (!_wait_thumbnail_preroll (pipeline, error)) {
+    _clear_thumbnailer (self);
+
+    return FALSE;
+  }
+
+  return TRUE;
+
+failed:
+  g_signal_handlers_disconnect_by_func (priv->timeline,
+      _timeline_commited_cb, self);
+
+  return FALSE;
+}
+
+/**
+ * ges_pipeline_get_thumbnails:
+ * @self: A #GESPipeline with a #GESPipeline:timeline
+ * @caps: (transfer none): The format of the thumbnails, for example
+ * "video/x-raw,format=RGB,width=160,height=90" or
+ * "image/jpeg,width=160,height=90"
+ * @timestamps: (array length=n_timestamps): The timeline positions of the
+ * thumbnails
+ * @n_timestamps: The number of thumbnails to get
+ * @flags: Extra flags of the seeks to each position, for example
+ * #GST_SEEK_FLAG_ACCURATE to get the exact frame at each position, or
+ * #GST_SEEK_FLAG_KEY_UNIT to get the closest keyframe faster
+ * @error: (out) (allow-none): An error to be set in case something wrong
+ * happens or %NULL
+ *
+ * Gets the frames of the timeline of @self at each of @timestamps. As
+ * opposed to ges_pipeline_get_thumbnail(), @self does not need to be
+ * previewing nor playing: the frames are produced by a private pipeline,
+ * from a copy of the timeline that only contains its first video track.
+ *
+ * That pipeline is kept prerolled between calls, so that getting more
+ * thumbnails in the same @caps only costs a seek per position. It is
+ * rebuilt after the timeline of @self gets committed or when @caps change,
+ * and released with @self.
+ *
+ * If @caps has a width and a height, the copy is composited directly at
+ * that size. The positions are visited in increasing order, so sorted
+ * @timestamps and frames shared by several positions are cheaper.
+ *
+ * This call blocks until all the thumbnails are produced.
+ *
+ * Returns: (transfer full) (element-type GstSample) (nullable): The samples
+ * in the order of @timestamps, or %NULL if an error happened.
+ *
+ * Since: 1.20
+ */
+GPtrArray *
+ges_pipeline_get_thumbnails (GESPipeline * self, GstCaps * caps,
+    const GstClockTime * timestamps, guint n_timestamps, GstSeekFlags flags,
+    GError ** error)
+{
+  guint i;
+  GESPipelinePrivate *priv;
+  ThumbnailRequest *requests;
+  GstSample *sample = NULL, **samples;
+  GPtrArray *ret = NULL;
+
+  g_return_val_if_fail (GES_IS_PIPELINE (self), NULL);
+  g_return_val_if_fail (GST_IS_CAPS (caps), NULL);
+  g_return_val_if_fail (timestamps || !n_timestamps, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+  CHECK_THREAD (self);
+
+  priv = self->priv;
+  if (!priv->timeline) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+        "No timeline set on the pipeline");
+
+    return NULL;
+  }
+
+  if (!n_timestamps)
+    return g_ptr_array_new_with_free_func ((GDestroyNotify) gst_sample_unref);
+
+  if (!_ensure_thumbnailer (self, caps, error))
+    return NULL;
+
+  requests = g_new (ThumbnailRequest, n_timestamps);
+  samples = g_new0 (GstSample *, n_timestamps);
+  for (i = 0; i < n_timestamps; i++) {
+    requests[i].timestamp = timestamps[i];
+    requests[i].index = i;
+  }
+  g_qsort_with_data (requests, n_timestamps, sizeof (ThumbnailRequest),
+      (GCompareDataFunc) _compare_thumbnail_requests, NULL);
+
+  for (i = 0; i < n_timestamps; i++) {
+    ThumbnailRequest *request = &requests[i];
+
+    if (request->timestamp != priv->thumbnail_position) {
+      g_clear_pointer (&sample, gst_sample_unref);
+      if (!gst_element_seek (priv->thumbnailer, 1.0, GST_FORMAT_TIME,
+              GST_SEEK_FLAG_FLUSH | flags, GST_SEEK_TYPE_SET,
+              request->timestamp, GST_SEEK_TYPE_NONE, GST_CLOCK_TIME_NONE)) {
+        g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_SEEK,
+            "Could not seek to %" GST_TIME_FORMAT,
+            GST_TIME_ARGS (request->timestamp));
+        break;
+      }
+
+      if (!_wait_thumbnail_preroll (priv->thumbnailer, error))
+        break;
+
+      priv->thumbnail_position = request->timestamp;
+    }
+
+    if (!sample)
+      g_signal_emit_by_name (priv->thumbnail_sink, "pull-preroll", &sample);
+
+    if (!sample) {
+      g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+          "No frame at %" GST_TIME_FORMAT,
+          GST_TIME_ARGS (request->timestamp));
+      break;
+    }
+
+    samples[request->index] = gst_sample_ref (sample);
+  }
+  g_clear_pointer (&sample, gst_sample_unref);
+
+  if (i == n_timestamps) {
+    ret = g_ptr_array_new_full (n_timestamps,
+        (GDestroyNotify) gst_sample_unref);
+    for (i = 0; i < n_timestamps; i++)
+      g_ptr_array_add (ret, samples[i]);
+  } else {
+    for (i = 0; i < n_timestamps; i++)
+      g_clear_pointer (&samples[i], gst_sample_unref);
+
+    /* The state of the thumbnailer is unknown after a failure */
+    _clear_thumbnailer (self);
+  }
+
+  g_free (requests);
+  g_free (samples);
+
+  return ret;
+}
+
+/**
+ * ges_pipeline_get_thumbnails_for_range:
+ * @self: A #GESPipeline with a #GESPipeline:timeline
+ * @caps: (transfer none): The format of the thumbnails
+ * @start: The position of the first thumbnail
+ * @stop: The position after which no thumbnail is taken, or
+ * #GST_CLOCK_TIME_NONE for the end of the timeline
+ * @interval: The time between two thumbnails
+ * @flags: Extra flags of the seeks to each position
+ * @error: (out) (allow-none): An error to be set in case something wrong
+ * happens or %NULL
+ *
+ * Gets the frames of the timeline of @self every @interval between
+ * @start and @stop, to create a filmstrip for example.
+ *
+ * @stop can only be #GST_CLOCK_TIME_NONE if @self has a
+ * #GESPipeline:timeline.
+ *
+ * See ges_pipeline_get_thumbnails().
+ *
+ * Returns: (transfer full) (element-type GstSample) (nullable): The samples
+ * in increasing time order, or %NULL if an error happened.
+ *
+ * Since: 1.20
+ */
+GPtrArray *
+ges_pipeline_get_thumbnails_for_range (GESPipeline * self, GstCaps * caps,
+    GstClockTime start, GstClockTime stop, GstClockTime interval,
+    GstSeekFlags flags, GError ** error)
+{
+  GPtrArray *ret;
+  GstClockTime position;
+  GArray *timestamps;
+
+  g_return_val_if_fail (GES_IS_PIPELINE (self), NULL);
+  g_return_val_if_fail (GST_CLOCK_TIME_IS_VALID (start), NULL);
+  g_return_val_if_fail (GST_CLOCK_TIME_IS_VALID (interval) && interval > 0,
+      NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  if (!self->priv->timeline) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+        "No timeline set on the pipeline");
+
+    return NULL;
+  }
+
+  if (!GST_CLOCK_TIME_IS_VALID (stop))
+    stop = ges_timeline_get_duration (self->priv->timeline);
+
+  timestamps = g_array_new (FALSE, FALSE, sizeof (GstClockTime));
+  for (position = start; position < stop; position += interval)
+    g_array_append_val (timestamps, position);
+
+  ret = ges_pipeline_get_thumbnails (self, caps,
+      (GstClockTime *) timestamps->data, timestamps->len, flags, error);
+  g_array_free (timestamps, TRUE);
+
+  return ret;
+}
+
+/**
+ * ges_pipeline_save_thumbnails:
+ * @self: A #GESPipeline with a #GESPipeline:timeline
+ * @width: The requested pixel width of the images, or -1 to use the native
+ * size
+ * @height: The requested pixel height of the images, or -1 to use the
+ * native size
+ * @format: The desired mime type (for example, "image/jpeg")
+ * @timestamps: (array length=n_timestamps): The timeline positions of the
+ * thumbnails
+ * @n_timestamps: The number of thumbnails to save
+ * @flags: Extra flags of the seeks to each position
+ * @location_template: The path to save the thumbnails to, where a printf
+ * style integer directive is replaced by the index of the thumbnail in
+ * @timestamps (for example, "thumbnail-%05d.jpg")
+ * @error: (out) (allow-none) (transfer full): An error to be set in case
+ * something goes wrong, or %NULL to ignore
+ *
+ * Saves the frames of the timeline of @self at each of @timestamps, in the
+ * specified dimensions and format.
+ *
+ * See ges_pipeline_get_thumbnails().
+ *
+ * Returns: %TRUE if all the thumbnails were saved.
+ *
+ * Since: 1.20
+ */
+gboolean
+ges_pipeline_save_thumbnails (GESPipeline * self, gint width, gint height,
+    const gchar * format, const GstClockTime * timestamps, guint n_timestamps,
+    GstSeekFlags flags, const gchar * location_template, GError ** error)
+{
+  guint i;
+  GstCaps *caps;
+  GPtrArray *samples;
+  gboolean res = TRUE;
+
+  g_return_val_if_fail (GES_IS_PIPELINE (self), FALSE);
+  g_return_val_if_fail (format, FALSE);
+  g_return_val_if_fail (location_template, FALSE);
+
+  caps = gst_caps_from_string (format);
+  if (!caps) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_NEGOTIATION,
+        "Invalid format %s", format);
+
+    return FALSE;
+  }
+
+  if (width > 0)
+    gst_caps_set_simple (caps, "width", G_TYPE_INT, width, NULL);
+
+  if (height > 0)
+    gst_caps_set_simple (caps, "height", G_TYPE_INT, height, NULL);
+
+  samples = ges_pipeline_get_thumbnails (self, caps, timestamps,
+      n_timestamps, flags, error);
+  gst_caps_unref (caps);
+  if (!samples)
+    return FALSE;
+
+  for (i = 0; i < samples->len && res; i++) {
+    GstMapInfo map_info;
+    GstBuffer *b = gst_sample_get_buffer (g_ptr_array_index (samples, i));
+    gchar *location = g_strdup_printf (location_template, i);
+
+    if (gst_buffer_map (b, &map_info, GST_MAP_READ)) {
+      res = g_file_set_contents (location, (const gchar *) map_info.data,
+          map_info.size, error);
+      gst_buffer_unmap (b, &map_info);
+    } else {
+      g_set_error (error, GST_RESOURCE_ERROR, GST_RESOURCE_ERROR_READ,
+          "Could not map the thumbnail for %s", location);
+      res = FALSE;
+    }
+    g_free (location);
+  }
+  g_ptr_array_unref (samples);
+
+  return res;
+}
@@ -76,6 +76,16 @@ gboolean ges_pipeline_set_mode (GESPipeline *pipeline,
 GES_API
 GESPipelineFlags ges_pipeline_get_mode (GESPipeline *pipeline);
 
+GES_API
+void ges_pipeline_set_render_cache (GESPipeline *pipeline,
+				    const gchar *directory,
+				    guint64 max_size);
+
+GES_API
+gboolean ges_pipeline_render_segmented (GESPipeline *pipeline,
+					 guint n_segments,
+					 GError **error);
+
 GES_API GstSample *
 ges_pipeline_get_thumbnail(GESPipeline *self, GstCaps *caps);
 
@@ -88,6 +98,21 @@ ges_pipeline_save_thumbnail(GESPipeline *self,
     int width, int height, const gchar *format, const gchar *location,
     GError **error);
 
+GES_API GPtrArray *
+ges_pipeline_get_thumbnails (GESPipeline *self, GstCaps *caps,
+    const GstClockTime *timestamps, guint n_timestamps, GstSeekFlags flags,
+    GError **error);
+
+GES_API GPtrArray *
+ges_pipeline_get_thumbnails_for_range (GESPipeline *self, GstCaps *caps,
+    GstClockTime start, GstClockTime stop, GstClockTime interval,
+    GstSeekFlags flags, GError **error);
+
+GES_API gboolean
+ges_pipeline_save_thumbnails (GESPipeline *self, gint width, gint height,
+    const gchar *format, const GstClockTime *timestamps, guint n_timestamps,
+    GstSeekFlags flags, const gchar *location_template, GError **error);
+
 GES_API GstElement *
 ges_pipeline_preview_get_video_sink (GESPipeline * self);
 
@@ -0,0 +1,1071 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Journal of the changes made to a timeline since it was last fully saved,
+ * used by ges_project_save_incremental().
+ *
+ * The journal watches the elements of the timeline and remembers which
+ * properties and children properties of which clips and track elements
+ * changed. Saving only appends the current values of those to a sidecar
+ * file next to the project (see ges_project_journal_get_uri()), one
+ * serialized GstStructure per line:
+ *
+ *   ges-journal, version=(int)1;
+ *   clip, name=(string)uriclip0, layer=(uint)1, properties=(string)"...";
+ *   track-element, clip=(string)uriclip0, track=(int)0, effect=(int)-1,
+ *       properties=(string)"...", children-properties=(string)"...";
+ *
+ * Clips are identified by their name, which is serialized by the
+ * formatters, and track elements by the index of their track in the
+ * timeline and, for effects, their top effect index.
+ *
+ * Structural changes (adding or removing layers, tracks, clips, track
+ * elements or groups, editing keyframes, ...) can not be expressed with
+ * those records, they make the journal request a full save instead, which
+ * also truncates the sidecar file. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "ges.h"
+#include "ges-internal.h"
+
+#define JOURNAL_VERSION 1
+
+/* Number of records after which the journal gets compacted into a full
+ * save of the project */
+#define JOURNAL_MAX_RECORDS 1000
+
+typedef struct
+{
+  GESTimelineElement *element;
+
+  /* GParamSpec -> NULL, properties changed since the last save */
+  GHashTable *properties;
+  GHashTable *children_properties;
+  gboolean layer_changed;
+  gboolean metas_changed;
+} JournalEntry;
+
+struct _GESProjectJournal
+{
+  GESProject *project;
+  GESTimeline *timeline;
+  gchar *uri;
+
+  /* GESTimelineElement -> JournalEntry */
+  GHashTable *entries;
+  /* JournalEntry, in the order the elements first changed */
+  GQueue queue;
+
+  guint n_records;
+  gboolean needs_full_save;
+};
+
+static const gchar *const clip_ignored_properties[] = {
+  "supported-formats", "rate", "priority", "uri", NULL
+};
+
+static const gchar *const track_element_ignored_properties[] = {
+  "start", "in-point", "duration", "priority", "locked", "name", NULL
+};
+
+/* Those are computed from the neighbouring clips */
+static const gchar *const auto_transition_ignored_properties[] = {
+  "start", "in-point", "duration", "max-duration", "priority", "layer", NULL
+};
+
+static void
+_entry_free (JournalEntry * entry)
+{
+  gst_object_unref (entry->element);
+  g_hash_table_unref (entry->properties);
+  g_hash_table_unref (entry->children_properties);
+  g_slice_free (JournalEntry, entry);
+}
+
+static JournalEntry *
+_get_entry (GESProjectJournal * journal, GESTimelineElement * element)
+{
+  JournalEntry *entry = g_hash_table_lookup (journal->entries, element);
+
+  if (entry)
+    return entry;
+
+  entry = g_slice_new0 (JournalEntry);
+  entry->element = gst_object_ref (element);
+  entry->properties = g_hash_table_new_full (NULL, NULL,
+      (GDestroyNotify) g_param_spec_unref, NULL);
+  entry->children_properties = g_hash_table_new_full (NULL, NULL,
+      (GDestroyNotify) g_param_spec_unref, NULL);
+
+  g_hash_table_insert (journal->entries, element, entry);
+  g_queue_push_tail (&journal->queue, entry);
+
+  return entry;
+}
+
+static void
+_clear_entries (GESProjectJournal * journal)
+{
+  g_hash_table_remove_all (journal->entries);
+  g_queue_clear_full (&journal->queue, (GDestroyNotify) _entry_free);
+}
+
+static void
+_request_full_save (GESProjectJournal * journal)
+{
+  if (journal->needs_full_save)
+    return;
+
+  GST_INFO_OBJECT (journal->project, "%s needs a full save", journal->uri);
+  journal->needs_full_save = TRUE;
+
+  /* Everything will be saved anyway */
+  _clear_entries (journal);
+}
+
+static gboolean
+_is_auto_transition (GESTimelineElement * element)
+{
+  GESLayer *layer;
+  gboolean auto_transition;
+
+  if (GES_IS_TRACK_ELEMENT (element))
+    element = element->parent;
+
+  if (!GES_IS_TRANSITION_CLIP (element))
+    return FALSE;
+
+  layer = ges_clip_get_layer (GES_CLIP (element));
+  if (!layer)
+    return FALSE;
+
+  auto_transition = ges_layer_get_auto_transition (layer);
+  gst_object_unref (layer);
+
+  return auto_transition;
+}
+
+static gboolean
+_property_is_serialized (GParamSpec * pspec, const gchar * const *ignored)
+{
+  if (!(pspec->flags & G_PARAM_WRITABLE) ||
+      !ges_util_can_serialize_spec (pspec))
+    return FALSE;
+
+  return !g_strv_contains (ignored, pspec->name);
+}
+
+static void
+_element_notify_cb (GESTimelineElement * element, GParamSpec * pspec,
+    GESProjectJournal * journal)
+{
+  if (journal->needs_full_save)
+    return;
+
+  /* Elements are identified by their names, and "vtype" is the ID of the
+   * asset of transition clips */
+  if ((GES_IS_CLIP (element) && (!g_strcmp0 (pspec->name, "name") ||
+              !g_strcmp0 (pspec->name, "vtype"))) ||
+      !g_strcmp0 (pspec->name, "serialize")) {
+    _request_full_save (journal);
+    return;
+  }
+
+  if (_is_auto_transition (element)) {
+    if (!g_strv_contains (auto_transition_ignored_properties, pspec->name))
+      _request_full_save (journal);
+    return;
+  }
+
+  if (GES_IS_CLIP (element)) {
+    if (!g_strcmp0 (pspec->name, "layer")) {
+      _get_entry (journal, element)->layer_changed = TRUE;
+      return;
+    }
+
+    if (!_property_is_serialized (pspec, clip_ignored_properties))
+      return;
+  } else if (!_property_is_serialized (pspec,
+          track_element_ignored_properties)) {
+    return;
+  }
+
+  g_hash_table_add (_get_entry (journal, element)->properties,
+      g_param_spec_ref (pspec));
+}
+
+static void
+_element_deep_notify_cb (GESTimelineElement * element, GObject * prop_object,
+    GParamSpec * pspec, GESProjectJournal * journal)
+{
+  if (journal->needs_full_save || !ges_util_can_serialize_spec (pspec))
+    return;
+
+  if (_is_auto_transition (element)) {
+    _request_full_save (journal);
+    return;
+  }
+
+  g_hash_table_add (_get_entry (journal, element)->children_properties,
+      g_param_spec_ref (pspec));
+}
+
+static void
+_element_notify_meta_cb (GESTimelineElement * element, const gchar * key,
+    const GValue * value, GESProjectJournal * journal)
+{
+  if (journal->needs_full_save)
+    return;
+
+  _get_entry (journal, element)->metas_changed = TRUE;
+}
+
+static void
+_settings_notify_cb (GObject * object, GParamSpec * pspec,
+    GESProjectJournal * journal)
+{
+  if ((pspec->flags & G_PARAM_WRITABLE) && ges_util_can_serialize_spec (pspec))
+    _request_full_save (journal);
+}
+
+static void
+_watch_control_source (GESProjectJournal * journal,
+    GstControlBinding * binding)
+{
+  GstControlSource *source;
+
+  if (!GST_IS_DIRECT_CONTROL_BINDING (binding))
+    return;
+
+  g_object_get (binding, "control-source", &source, NULL);
+  if (!GST_IS_TIMED_VALUE_CONTROL_SOURCE (source)) {
+    gst_clear_object (&source);
+    return;
+  }
+
+  g_signal_connect_swapped (source, "value-added",
+      G_CALLBACK (_request_full_save), journal);
+  g_signal_connect_swapped (source, "value-changed",
+      G_CALLBACK (_request_full_save), journal);
+  g_signal_connect_swapped (source, "value-removed",
+      G_CALLBACK (_request_full_save), journal);
+  gst_object_unref (source);
+}
+
+static void
+_unwatch_control_source (GESProjectJournal * journal,
+    GstControlBinding * binding)
+{
+  GstControlSource *source;
+
+  if (!GST_IS_DIRECT_CONTROL_BINDING (binding))
+    return;
+
+  g_object_get (binding, "control-source", &source, NULL);
+  if (source) {
+    g_signal_handlers_disconnect_by_data (source, journal);
+    gst_object_unref (source);
+  }
+}
+
+static void
+_control_binding_added_cb (GESTrackElement * element,
+    GstControlBinding * binding, GESProjectJournal * journal)
+{
+  _watch_control_source (journal, binding);
+  _request_full_save (journal);
+}
+
+static void
+_control_binding_removed_cb (GESTrackElement * element,
+    GstControlBinding * binding, GESProjectJournal * journal)
+{
+  _unwatch_control_source (journal, binding);
+  _request_full_save (journal);
+}
+
+static void
+_watch_track_element (GESProjectJournal * journal, GESTrackElement * element)
+{
+  GHashTableIter iter;
+  gpointer binding;
+
+  g_signal_connect (element, "notify", G_CALLBACK (_element_notify_cb),
+      journal);
+  g_signal_connect (element, "deep-notify",
+      G_CALLBACK (_element_deep_notify_cb), journal);
+  g_signal_connect (element, "notify-meta",
+      G_CALLBACK (_element_notify_meta_cb), journal);
+  g_signal_connect (element, "control-binding-added",
+      G_CALLBACK (_control_binding_added_cb), journal);
+  g_signal_connect (element, "control-binding-removed",
+      G_CALLBACK (_control_binding_removed_cb), journal);
+
+  g_hash_table_iter_init (&iter,
+      ges_track_element_get_all_control_bindings (element));
+  while (g_hash_table_iter_next (&iter, NULL, &binding))
+    _watch_control_source (journal, binding);
+}
+
+static void
+_unwatch_track_element (GESProjectJournal * journal,
+    GESTrackElement * element)
+{
+  GHashTableIter iter;
+  gpointer binding;
+
+  g_signal_handlers_disconnect_by_data (element, journal);
+
+  g_hash_table_iter_init (&iter,
+      ges_track_element_get_all_control_bindings (element));
+  while (g_hash_table_iter_next (&iter, NULL, &binding))
+    _unwatch_control_source (journal, binding);
+}
+
+static void
+_child_added_cb (GESClip * clip, GESTimelineElement * child,
+    GESProjectJournal * journal)
+{
+  _watch_track_element (journal, GES_TRACK_ELEMENT (child));
+
+  if (!_is_auto_transition (GES_TIMELINE_ELEMENT (clip)))
+    _request_full_save (journal);
+}
+
+static void
+_child_removed_cb (GESClip * clip, GESTimelineElement * child,
+    GESProjectJournal * journal)
+{
+  _unwatch_track_element (journal, GES_TRACK_ELEMENT (child));
+
+  if (!_is_auto_transition (GES_TIMELINE_ELEMENT (clip)))
+    _request_full_save (journal);
+}
+
+static void
+_watch_clip (GESProjectJournal * journal, GESClip * clip)
+{
+  GList *tmp;
+
+  g_signal_connect (clip, "notify", G_CALLBACK (_element_notify_cb), journal);
+  g_signal_connect (clip, "notify-meta",
+      G_CALLBACK (_element_notify_meta_cb), journal);
+  g_signal_connect (clip, "child-added", G_CALLBACK (_child_added_cb),
+      journal);
+  g_signal_connect (clip, "child-removed", G_CALLBACK (_child_removed_cb),
+      journal);
+
+  for (tmp = GES_CONTAINER_CHILDREN (clip); tmp; tmp = tmp->next)
+    _watch_track_element (journal, tmp->data);
+}
+
+static void
+_unwatch_clip (GESProjectJournal * journal, GESClip * clip)
+{
+  GList *tmp;
+
+  g_signal_handlers_disconnect_by_data (clip, journal);
+  for (tmp = GES_CONTAINER_CHILDREN (clip); tmp; tmp = tmp->next)
+    _unwatch_track_element (journal, tmp->data);
+}
+
+static void
+_clip_added_cb (GESLayer * layer, GESClip * clip, GESProjectJournal * journal)
+{
+  _watch_clip (journal, clip);
+
+  /* Auto transitions get recreated when replaying the moves of the clips */
+  if (!_is_auto_transition (GES_TIMELINE_ELEMENT (clip)))
+    _request_full_save (journal);
+}
+
+static void
+_clip_removed_cb (GESLayer * layer, GESClip * clip,
+    GESProjectJournal * journal)
+{
+  _unwatch_clip (journal, clip);
+
+  if (!GES_IS_TRANSITION_CLIP (clip) || !ges_layer_get_auto_transition (layer))
+    _request_full_save (journal);
+}
+
+static void
+_watch_layer (GESProjectJournal * journal, GESLayer * layer)
+{
+  GList *clips, *tmp;
+
+  g_signal_connect (layer, "notify", G_CALLBACK (_settings_notify_cb),
+      journal);
+  g_signal_connect_swapped (layer, "notify-meta",
+      G_CALLBACK (_request_full_save), journal);
+  g_signal_connect_swapped (layer, "active-changed",
+      G_CALLBACK (_request_full_save), journal);
+  g_signal_connect (layer, "clip-added", G_CALLBACK (_clip_added_cb),
+      journal);
+  g_signal_connect (layer, "clip-removed", G_CALLBACK (_clip_removed_cb),
+      journal);
+
+  clips = ges_layer_get_clips (layer);
+  for (tmp = clips; tmp; tmp = tmp->next)
+    _watch_clip (journal, tmp->data);
+  g_list_free_full (clips, gst_object_unref);
+}
+
+static void
+_unwatch_layer (GESProjectJournal * journal, GESLayer * layer)
+{
+  GList *clips, *tmp;
+
+  g_signal_handlers_disconnect_by_data (layer, journal);
+
+  clips = ges_layer_get_clips (layer);
+  for (tmp = clips; tmp; tmp = tmp->next)
+    _unwatch_clip (journal, tmp->data);
+  g_list_free_full (clips, gst_object_unref);
+}
+
+static void
+_layer_added_cb (GESTimeline * timeline, GESLayer * layer,
+    GESProjectJournal * journal)
+{
+  _watch_layer (journal, layer);
+  _request_full_save (journal);
+}
+
+static void
+_layer_removed_cb (GESTimeline * timeline, GESLayer * layer,
+    GESProjectJournal * journal)
+{
+  _unwatch_layer (journal, layer);
+  _request_full_save (journal);
+}
+
+static void
+_track_added_cb (GESTimeline * timeline, GESTrack * track,
+    GESProjectJournal * journal)
+{
+  g_signal_connect (track, "notify", G_CALLBACK (_settings_notify_cb),
+      journal);
+  g_signal_connect_swapped (track, "notify-meta",
+      G_CALLBACK (_request_full_save), journal);
+  _request_full_save (journal);
+}
+
+static void
+_track_removed_cb (GESTimeline * timeline, GESTrack * track,
+    GESProjectJournal * journal)
+{
+  g_signal_handlers_disconnect_by_data (track, journal);
+  _request_full_save (journal);
+}
+
+static void
+_timeline_weak_notify (GESProjectJournal * journal, GObject * timeline)
+{
+  GST_DEBUG_OBJECT (journal->project, "Timeline of %s is gone", journal->uri);
+
+  journal->timeline = NULL;
+  _request_full_save (journal);
+}
+
+static void
+_watch_timeline (GESProjectJournal * journal)
+{
+  GList *tmp;
+  GESTimeline *timeline = journal->timeline;
+
+  g_signal_connect (timeline, "notify", G_CALLBACK (_settings_notify_cb),
+      journal);
+  g_signal_connect_swapped (timeline, "notify-meta",
+      G_CALLBACK (_request_full_save), journal);
+  g_signal_connect (timeline, "layer-added", G_CALLBACK (_layer_added_cb),
+      journal);
+  g_signal_connect (timeline, "layer-removed",
+      G_CALLBACK (_layer_removed_cb), journal);
+  g_signal_connect (timeline, "track-added", G_CALLBACK (_track_added_cb),
+      journal);
+  g_signal_connect (timeline, "track-removed",
+      G_CALLBACK (_track_removed_cb), journal);
+  g_signal_connect_swapped (timeline, "group-added",
+      G_CALLBACK (_request_full_save), journal);
+  g_signal_connect_swapped (timeline, "group-removed",
+      G_CALLBACK (_request_full_save), journal);
+  g_object_weak_ref (G_OBJECT (timeline), (GWeakNotify) _timeline_weak_notify,
+      journal);
+
+  for (tmp = timeline->layers; tmp; tmp = tmp->next)
+    _watch_layer (journal, tmp->data);
+
+  for (tmp = timeline->tracks; tmp; tmp = tmp->next) {
+    g_signal_connect (tmp->data, "notify", G_CALLBACK (_settings_notify_cb),
+        journal);
+    g_signal_connect_swapped (tmp->data, "notify-meta",
+        G_CALLBACK (_request_full_save), journal);
+  }
+
+  g_signal_connect_swapped (journal->project, "asset-added",
+      G_CALLBACK (_request_full_save), journal);
+  g_signal_connect_swapped (journal->project, "asset-removed",
+      G_CALLBACK (_request_full_save), journal);
+  g_signal_connect_swapped (journal->project, "notify-meta",
+      G_CALLBACK (_request_full_save), journal);
+}
+
+static void
+_unwatch_timeline (GESProjectJournal * journal)
+{
+  GList *tmp;
+  GESTimeline *timeline = journal->timeline;
+
+  g_signal_handlers_disconnect_by_data (journal->project, journal);
+
+  if (!timeline)
+    return;
+
+  g_object_weak_unref (G_OBJECT (timeline),
+      (GWeakNotify) _timeline_weak_notify, journal);
+  g_signal_handlers_disconnect_by_data (timeline, journal);
+
+  for (tmp = timeline->layers; tmp; tmp = tmp->next)
+    _unwatch_layer (journal, tmp->data);
+
+  for (tmp = timeline->tracks; tmp; tmp = tmp->next)
+    g_signal_handlers_disconnect_by_data (tmp->data, journal);
+}
+
+/**************************************************************
+ *                     Writing the records                    *
+ **************************************************************/
+
+static gchar *
+_serialize_changed_properties (GObject * object, GHashTable * pspecs)
+{
+  gchar *ret;
+  GHashTableIter iter;
+  GParamSpec *pspec;
+  GstStructure *structure = gst_structure_new_empty ("properties");
+
+  g_hash_table_iter_init (&iter, pspecs);
+  while (g_hash_table_iter_next (&iter, (gpointer *) & pspec, NULL)) {
+    GValue val = G_VALUE_INIT;
+
+    g_value_init (&val, pspec->value_type);
+    g_object_get_property (object, pspec->name, &val);
+    gst_structure_set_value (structure, pspec->name, &val);
+    g_value_unset (&val);
+  }
+
+  ret = gst_structure_to_string (structure);
+  gst_structure_free (structure);
+
+  return ret;
+}
+
+static gchar *
+_serialize_changed_children_properties (GESTimelineElement * element,
+    GHashTable * pspecs)
+{
+  gchar *ret;
+  GHashTableIter iter;
+  GParamSpec *pspec;
+  GstStructure *structure = gst_structure_new_empty ("properties");
+
+  g_hash_table_iter_init (&iter, pspecs);
+  while (g_hash_table_iter_next (&iter, (gpointer *) & pspec, NULL)) {
+    GValue val = G_VALUE_INIT;
+    gchar *name = g_strdup_printf ("%s::%s", g_type_name (pspec->owner_type),
+        pspec->name);
+
+    g_value_init (&val, pspec->value_type);
+    ges_timeline_element_get_child_property_by_pspec (element, pspec, &val);
+    gst_structure_set_value (structure, name, &val);
+    g_value_unset (&val);
+    g_free (name);
+  }
+
+  ret = gst_structure_to_string (structure);
+  gst_structure_free (structure);
+
+  return ret;
+}
+
+static GstStructure *
+_clip_record (GESProjectJournal * journal, JournalEntry * entry)
+{
+  GstStructure *record;
+  GESClip *clip = GES_CLIP (entry->element);
+  GESLayer *layer = ges_clip_get_layer (clip);
+
+  record = gst_structure_new ("clip", "name", G_TYPE_STRING,
+      GES_TIMELINE_ELEMENT_NAME (clip), NULL);
+
+  if (entry->layer_changed && layer)
+    gst_structure_set (record, "layer", G_TYPE_UINT,
+        ges_layer_get_priority (layer), NULL);
+  gst_clear_object (&layer);
+
+  return record;
+}
+
+static GstStructure *
+_track_element_record (GESProjectJournal * journal, JournalEntry * entry)
+{
+  GESTrack *track;
+  gint track_index, effect_index = -1;
+  GESTrackElement *element = GES_TRACK_ELEMENT (entry->element);
+  GESTimelineElement *clip = entry->element->parent;
+
+  track = ges_track_element_get_track (element);
+  track_index = track ? g_list_index (journal->timeline->tracks, track) : -1;
+  if (!GES_IS_CLIP (clip) || track_index < 0)
+    return NULL;
+
+  if (GES_IS_BASE_EFFECT (element)) {
+    effect_index = ges_clip_get_top_effect_index (GES_CLIP (clip),
+        GES_BASE_EFFECT (element));
+    if (effect_index < 0)
+      return NULL;
+  }
+
+  return gst_structure_new ("track-element",
+      "clip", G_TYPE_STRING, GES_TIMELINE_ELEMENT_NAME (clip),
+      "track", G_TYPE_INT, track_index, "effect", G_TYPE_INT, effect_index,
+      NULL);
+}
+
+static gboolean
+_serialize_entry (GESProjectJournal * journal, JournalEntry * entry,
+    GString * str)
+{
+  gchar *tmp;
+  gboolean serialize;
+  GstStructure *record;
+  GESTimelineElement *element = entry->element;
+
+  /* Removed elements would have triggered a full save */
+  if (element->timeline != journal->timeline)
+    return TRUE;
+
+  g_object_get (GES_IS_CLIP (element) ? element : element->parent,
+      "serialize", &serialize, NULL);
+  if (!serialize)
+    return TRUE;
+
+  if (GES_IS_CLIP (element))
+    record = _clip_record (journal, entry);
+  else
+    record = _track_element_record (journal, entry);
+
+  if (!record)
+    return FALSE;
+
+  if (g_hash_table_size (entry->properties)) {
+    tmp = _serialize_changed_properties (G_OBJECT (element),
+        entry->properties);
+    gst_structure_set (record, "properties", G_TYPE_STRING, tmp, NULL);
+    g_free (tmp);
+  }
+
+  if (g_hash_table_size (entry->children_properties)) {
+    tmp = _serialize_changed_children_properties (element,
+        entry->children_properties);
+    gst_structure_set (record, "children-properties", G_TYPE_STRING, tmp,
+        NULL);
+    g_free (tmp);
+  }
+
+  if (entry->metas_changed) {
+    tmp = ges_meta_container_metas_to_string (GES_META_CONTAINER (element));
+    gst_structure_set (record, "metadatas", G_TYPE_STRING, tmp, NULL);
+    g_free (tmp);
+  }
+
+  tmp = gst_structure_to_string (record);
+  g_string_append (str, tmp);
+  g_string_append_c (str, '\n');
+  gst_structure_free (record);
+  g_free (tmp);
+
+  journal->n_records++;
+
+  return TRUE;
+}
+
+/**************************************************************
+ *                      Replaying records                     *
+ **************************************************************/
+
+static GESLayer *
+_get_layer (GESTimeline * timeline, guint priority)
+{
+  GList *tmp;
+
+  for (tmp = timeline->layers; tmp; tmp = tmp->next) {
+    if (ges_layer_get_priority (tmp->data) == priority)
+      return tmp->data;
+  }
+
+  return NULL;
+}
+
+static gboolean
+_set_child_property_foreach (GQuark field_id, const GValue * value,
+    GESTimelineElement * element)
+{
+  if (!ges_timeline_element_set_child_property (element,
+          g_quark_to_string (field_id), value))
+    GST_WARNING_OBJECT (element, "Could not set %s",
+        g_quark_to_string (field_id));
+
+  return TRUE;
+}
+
+static gboolean
+_apply_properties (GESTimelineElement * element, const GstStructure * record,
+    GError ** error)
+{
+  GstStructure *props;
+  const gchar *str;
+
+  if ((str = gst_structure_get_string (record, "properties"))) {
+    if (!(props = gst_structure_from_string (str, NULL)))
+      goto wrong_properties;
+
+    /* Make sure the in-point can be set before setting it */
+    if (gst_structure_has_field (props, "max-duration"))
+      ges_timeline_element_set_max_duration (element, GST_CLOCK_TIME_NONE);
+    if (gst_structure_has_field (props, "has-internal-source"))
+      g_object_set_property (G_OBJECT (element), "has-internal-source",
+          gst_structure_get_value (props, "has-internal-source"));
+
+    gst_structure_foreach (props,
+        (GstStructureForeachFunc) set_property_foreach, element);
+    gst_structure_free (props);
+  }
+
+  if ((str = gst_structure_get_string (record, "children-properties"))) {
+    if (!(props = gst_structure_from_string (str, NULL)))
+      goto wrong_properties;
+
+    gst_structure_foreach (props,
+        (GstStructureForeachFunc) _set_child_property_foreach, element);
+    gst_structure_free (props);
+  }
+
+  if ((str = gst_structure_get_string (record, "metadatas")))
+    ges_meta_container_add_metas_from_string (GES_META_CONTAINER (element),
+        str);
+
+  return TRUE;
+
+wrong_properties:
+  g_set_error (error, GES_ERROR, GES_ERROR_FORMATTER_MALFORMED_INPUT_FILE,
+      "Wrong properties '%s' in journal record", str);
+
+  return FALSE;
+}
+
+static GESTimelineElement *
+_find_track_element (GESTimeline * timeline, GESClip * clip,
+    gint track_index, gint effect_index)
+{
+  GList *tmp;
+  GESTrack *track = g_list_nth_data (timeline->tracks, track_index);
+
+  if (!track)
+    return NULL;
+
+  for (tmp = GES_CONTAINER_CHILDREN (clip); tmp; tmp = tmp->next) {
+    GESTrackElement *child = tmp->data;
+
+    if (ges_track_element_get_track (child) != track)
+      continue;
+
+    if (effect_index < 0 && !GES_IS_BASE_EFFECT (child))
+      return tmp->data;
+
+    if (effect_index >= 0 && GES_IS_BASE_EFFECT (child) &&
+        ges_clip_get_top_effect_index (clip, GES_BASE_EFFECT (child)) ==
+        effect_index)
+      return tmp->data;
+  }
+
+  return NULL;
+}
+
+static gboolean
+_replay_record (GESTimeline * timeline, const GstStructure * record,
+    GError ** error)
+{
+  gboolean ret;
+  guint layer_prio;
+  GESTimelineElement *element, *clip = NULL;
+  gint track_index, effect_index;
+  const gchar *clip_name = gst_structure_get_string (record,
+      gst_structure_has_name (record, "clip") ? "name" : "clip");
+
+  if (!clip_name || !(clip = ges_timeline_get_element (timeline, clip_name))
+      || !GES_IS_CLIP (clip)) {
+    g_set_error (error, GES_ERROR, GES_ERROR_FORMATTER_MALFORMED_INPUT_FILE,
+        "No clip named %s for journal record", clip_name);
+    gst_clear_object (&clip);
+
+    return FALSE;
+  }
+
+  if (gst_structure_has_name (record, "clip")) {
+    if (gst_structure_get_uint (record, "layer", &layer_prio)) {
+      GESLayer *layer = _get_layer (timeline, layer_prio);
+
+      if (!layer || !ges_clip_move_to_layer (GES_CLIP (clip), layer))
+        GST_WARNING_OBJECT (clip, "Could not move to layer %u", layer_prio);
+    }
+    ret = _apply_properties (clip, record, error);
+    gst_object_unref (clip);
+
+    return ret;
+  }
+
+  if (!gst_structure_get_int (record, "track", &track_index) ||
+      !gst_structure_get_int (record, "effect", &effect_index) ||
+      !(element = _find_track_element (timeline, GES_CLIP (clip),
+              track_index, effect_index))) {
+    g_set_error (error, GES_ERROR, GES_ERROR_FORMATTER_MALFORMED_INPUT_FILE,
+        "No track element for journal record of %s", clip_name);
+    gst_object_unref (clip);
+
+    return FALSE;
+  }
+
+  ret = _apply_properties (element, record, error);
+  gst_object_unref (clip);
+
+  return ret;
+}
+
+/**************************************************************
+ *                        Internal API                        *
+ **************************************************************/
+
+gchar *
+ges_project_journal_get_uri (const gchar * uri)
+{
+  return g_strconcat (uri, ".journal", NULL);
+}
+
+GESProjectJournal *
+ges_project_journal_new (GESProject * project, GESTimeline * timeline,
+    const gchar * uri)
+{
+  GESProjectJournal *journal = g_slice_new0 (GESProjectJournal);
+
+  journal->project = project;
+  journal->timeline = timeline;
+  journal->uri = g_strdup (uri);
+  journal->entries = g_hash_table_new (NULL, NULL);
+  g_queue_init (&journal->queue);
+
+  _watch_timeline (journal);
+
+  return journal;
+}
+
+void
+ges_project_journal_free (GESProjectJournal * journal)
+{
+  _unwatch_timeline (journal);
+  _clear_entries (journal);
+  g_hash_table_unref (journal->entries);
+  g_free (journal->uri);
+
+  g_slice_free (GESProjectJournal, journal);
+}
+
+gboolean
+ges_project_journal_matches (GESProjectJournal * journal,
+    GESTimeline * timeline, const gchar * uri)
+{
+  return journal->timeline == timeline && !g_strcmp0 (journal->uri, uri);
+}
+
+/* Called after @journal->timeline has been fully saved */
+void
+ges_project_journal_reset (GESProjectJournal * journal)
+{
+  _clear_entries (journal);
+  journal->n_records = 0;
+  journal->needs_full_save = FALSE;
+}
+
+gboolean
+ges_project_journal_needs_full_save (GESProjectJournal * journal)
+{
+  return journal->needs_full_save || !journal->timeline ||
+      journal->n_records >= JOURNAL_MAX_RECORDS;
+}
+
+/* Appends the changes since the last save to the sidecar file */
+gboolean
+ges_project_journal_append (GESProjectJournal * journal, GError ** error)
+{
+  GList *tmp;
+  GFile *file;
+  gchar *journal_uri;
+  GOutputStream *stream;
+  gboolean ret = TRUE;
+  GString *str = g_string_new (NULL);
+
+  g_return_val_if_fail (!ges_project_journal_needs_full_save (journal), FALSE);
+
+  if (!journal->n_records)
+    g_string_append_printf (str, "ges-journal, version=(int)%d;\n",
+        JOURNAL_VERSION);
+
+  for (tmp = journal->queue.head; tmp; tmp = tmp->next) {
+    if (!_serialize_entry (journal, tmp->data, str)) {
+      GST_INFO_OBJECT (journal->project, "Can not journal changes on %"
+          GES_FORMAT, GES_ARGS (((JournalEntry *) tmp->data)->element));
+      _request_full_save (journal);
+      g_string_free (str, TRUE);
+
+      return TRUE;
+    }
+  }
+  _clear_entries (journal);
+
+  if (!str->len) {
+    g_string_free (str, TRUE);
+
+    return TRUE;
+  }
+
+  journal_uri = ges_project_journal_get_uri (journal->uri);
+  file = g_file_new_for_uri (journal_uri);
+  stream = G_OUTPUT_STREAM (g_file_append_to (file, G_FILE_CREATE_NONE, NULL,
+          error));
+  if (!stream || !g_output_stream_write_all (stream, str->str, str->len,
+          NULL, NULL, error) || !g_output_stream_close (stream, NULL, error)) {
+    /* The sidecar might now end with a partial record, start over */
+    _request_full_save (journal);
+    ret = FALSE;
+  } else {
+    GST_DEBUG_OBJECT (journal->project, "Appended %" G_GSIZE_FORMAT
+        " bytes to %s", str->len, journal_uri);
+  }
+
+  g_clear_object (&stream);
+  g_object_unref (file);
+  g_string_free (str, TRUE);
+  g_free (journal_uri);
+
+  return ret;
+}
+
+/* Removes the sidecar file of @uri, if any */
+void
+ges_project_journal_discard (const gchar * uri)
+{
+  GError *err = NULL;
+  gchar *journal_uri = ges_project_journal_get_uri (uri);
+  GFile *file = g_file_new_for_uri (journal_uri);
+
+  if (!g_file_delete (file, NULL, &err)) {
+    if (!g_error_matches (err, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
+      GST_WARNING ("Could not remove %s: %s", journal_uri, err->message);
+    g_error_free (err);
+  }
+
+  g_object_unref (file);
+  g_free (journal_uri);
+}
+
+/* Replays the records of the sidecar file of @uri, if any, on @timeline
+ * after the project itself has been loaded into it */
+gboolean
+ges_project_journal_replay (GESTimeline * timeline, const gchar * uri,
+    GError ** error)
+{
+  gint version;
+  gsize length;
+  gchar *contents, **lines;
+  guint i, n_lines, n_records = 0;
+  GError *err = NULL;
+  gchar *journal_uri = ges_project_journal_get_uri (uri);
+  GFile *file = g_file_new_for_uri (journal_uri);
+  gboolean ret = TRUE;
+
+  if (!g_file_load_contents (file, NULL, &contents, &length, NULL, &err)) {
+    GST_LOG ("No journal to replay at %s: %s", journal_uri, err->message);
+    g_error_free (err);
+    goto done;
+  }
+
+  lines = g_strsplit (contents, "\n", -1);
+  n_lines = g_strv_length (lines);
+  /* The last record is incomplete if we got interrupted while appending
+   * it, in which case it is not followed by a newline */
+  if (n_lines)
+    n_lines--;
+
+  for (i = 0; i < n_lines; i++) {
+    GstStructure *record = gst_structure_from_string (lines[i], NULL);
+
+    if (!record) {
+      g_set_error (error, GES_ERROR, GES_ERROR_FORMATTER_MALFORMED_INPUT_FILE,
+          "Invalid record at line %u of %s", i + 1, journal_uri);
+      ret = FALSE;
+      break;
+    }
+
+    if (i == 0) {
+      if (!gst_structure_has_name (record, "ges-journal") ||
+          !gst_structure_get_int (record, "version", &version) ||
+          version > JOURNAL_VERSION) {
+        g_set_error (error, GES_ERROR,
+            GES_ERROR_FORMATTER_MALFORMED_INPUT_FILE,
+            "%s is not a supported journal", journal_uri);
+        ret = FALSE;
+      }
+    } else if (!_replay_record (timeline, record, error)) {
+      ret = FALSE;
+    } else {
+      n_records++;
+    }
+    gst_structure_free (record);
+
+    if (!ret)
+      break;
+  }
+
+  GST_INFO_OBJECT (timeline, "Replayed %u records from %s", n_records,
+      journal_uri);
+
+  g_strfreev (lines);
+  g_free (contents);
+
+done:
+  g_object_unref (file);
+  g_free (journal_uri);
+
+  return ret;
+}
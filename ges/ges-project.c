@@ -85,6 +85,14 @@ struct _GESProjectPrivate
   gchar *uri;
 
   GList *encoding_profiles;
+
+  /* Changes since the last save of ges_project_save_incremental() */
+  GESProjectJournal *journal;
+
+  /* Set by ges_project_set_proxy_generation() */
+  GESProxyGenerator *proxy_generator;
+
+  gboolean streaming_load;
 };
 
 typedef struct EmitLoadedInIdle
@@ -128,6 +136,7 @@ enum
 {
   PROP_0,
   PROP_URI,
+  PROP_STREAMING_LOAD,
   PROP_LAST,
 };
 
@@ -165,6 +174,12 @@ ges_project_add_formatter (GESProject * project, GESFormatter * formatter)
   gst_object_ref_sink (formatter);
 }
 
+gboolean
+ges_project_get_streaming_load (GESProject * project)
+{
+  return project->priv->streaming_load;
+}
+
 static void
 ges_project_remove_formatter (GESProject * project, GESFormatter * formatter)
 {
@@ -419,6 +434,7 @@ _dispose (GObject * object)
 {
   GESProjectPrivate *priv = GES_PROJECT (object)->priv;
 
+  g_clear_pointer (&priv->proxy_generator, ges_proxy_generator_free);
   if (priv->assets)
     g_hash_table_unref (priv->assets);
   if (priv->loading_assets)
@@ -427,6 +443,7 @@ _dispose (GObject * object)
     g_hash_table_unref (priv->loaded_with_error);
   if (priv->formatter_asset)
     gst_object_unref (priv->formatter_asset);
+  g_clear_pointer (&priv->journal, ges_project_journal_free);
 
   while (priv->formatters)
     ges_project_remove_formatter (GES_PROJECT (object), priv->formatters->data);
@@ -456,6 +473,9 @@ _get_property (GESProject * project, guint property_id,
     case PROP_URI:
       g_value_set_string (value, priv->uri);
       break;
+    case PROP_STREAMING_LOAD:
+      g_value_set_boolean (value, priv->streaming_load);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (project, property_id, pspec);
   }
@@ -469,6 +489,9 @@ _set_property (GESProject * project, guint property_id,
     case PROP_URI:
       project->priv->uri = g_value_dup_string (value);
       break;
+    case PROP_STREAMING_LOAD:
+      project->priv->streaming_load = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (project, property_id, pspec);
   }
@@ -494,6 +517,24 @@ ges_project_class_init (GESProjectClass * klass)
   _properties[PROP_URI] = g_param_spec_string ("uri", "URI",
       "uri of the project", NULL, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
 
+  /**
+   * GESProject:streaming-load:
+   *
+   * Whether the formatters able to do so should read and parse the project
+   * file in chunks, in a single pass, instead of loading it in memory and
+   * parsing it twice. Assets are then requested as soon as they are parsed
+   * and clips are added as soon as their asset is loaded, which lowers the
+   * memory usage and the loading time of big projects.
+   *
+   * This has to be set before the timeline is extracted from the project.
+   *
+   * Since: 1.20
+   */
+  _properties[PROP_STREAMING_LOAD] =
+      g_param_spec_boolean ("streaming-load", "Streaming load",
+      "Load the project file in a single streaming pass", FALSE,
+      G_PARAM_READWRITE);
+
   g_object_class_install_properties (object_class, PROP_LAST, _properties);
 
   /**
@@ -764,6 +805,17 @@ ges_project_set_loaded (GESProject * project, GESFormatter * formatter,
         error);
   }
 
+  if (!error && project->priv->uri) {
+    GError *err = NULL;
+
+    if (!ges_project_journal_replay (formatter->timeline, project->priv->uri,
+            &err)) {
+      GST_ERROR_OBJECT (project, "Could not replay the journal: %s",
+          err->message);
+      g_error_free (err);
+    }
+  }
+
   GST_INFO_OBJECT (project, "Emit project loaded");
   if (GST_STATE (formatter->timeline) < GST_STATE_PAUSED) {
     timeline_fill_gaps (formatter->timeline);
@@ -1128,6 +1180,14 @@ ges_project_save (GESProject * project, GESTimeline * timeline,
   if (ret && project->priv->uri == NULL)
     ges_project_set_uri (project, uri);
 
+  if (ret) {
+    /* The journal of @uri applies to the previous full save */
+    ges_project_journal_discard (uri);
+    if (project->priv->journal &&
+        ges_project_journal_matches (project->priv->journal, timeline, uri))
+      ges_project_journal_reset (project->priv->journal);
+  }
+
 out:
   if (formatter_asset)
     gst_object_unref (formatter_asset);
@@ -1136,6 +1196,111 @@ out:
   return ret;
 }
 
+/**
+ * ges_project_save_incremental:
+ * @project: A #GESProject to save
+ * @timeline: The #GESTimeline to save, it must have been extracted from @project
+ * @uri: The uri where to save @project and @timeline
+ * @formatter_asset: (transfer full) (allow-none): The formatter asset to
+ * use or %NULL, see ges_project_save()
+ * @error: (out) (allow-none): An error to be set in case something wrong happens or %NULL
+ *
+ * Saves @timeline to @uri like ges_project_save() the first time it is
+ * called, and then only appends the properties of the clips and track
+ * elements that changed since the previous call to a journal file next to
+ * @uri, which makes it suitable for frequent autosaves of big timelines.
+ *
+ * The project is fully saved again, and the journal truncated, when a
+ * change can not be journaled (adding or removing elements, editing
+ * keyframes, ...) or once the journal grew too big. Loading the project
+ * replays the journal on top of the last full save. Saving @timeline to
+ * @uri with ges_project_save() also truncates the journal.
+ *
+ * Returns: %TRUE if the project could be saved, %FALSE otherwize
+ *
+ * Since: 1.20
+ */
+gboolean
+ges_project_save_incremental (GESProject * project, GESTimeline * timeline,
+    const gchar * uri, GESAsset * formatter_asset, GError ** error)
+{
+  GESProjectPrivate *priv;
+
+  g_return_val_if_fail (GES_IS_PROJECT (project), FALSE);
+  g_return_val_if_fail (GES_IS_TIMELINE (timeline), FALSE);
+  g_return_val_if_fail (uri, FALSE);
+  g_return_val_if_fail ((error == NULL || *error == NULL), FALSE);
+
+  priv = project->priv;
+  if (priv->journal
+      && !ges_project_journal_matches (priv->journal, timeline, uri))
+    g_clear_pointer (&priv->journal, ges_project_journal_free);
+
+  if (priv->journal && !ges_project_journal_needs_full_save (priv->journal)) {
+    if (formatter_asset)
+      gst_object_unref (formatter_asset);
+
+    GST_DEBUG_OBJECT (project, "Journaling changes to %s", uri);
+    return ges_project_journal_append (priv->journal, error);
+  }
+
+  if (!ges_project_save (project, timeline, uri, formatter_asset, TRUE, error))
+    return FALSE;
+
+  if (!priv->journal)
+    priv->journal = ges_project_journal_new (project, timeline, uri);
+
+  return TRUE;
+}
+
+/**
+ * ges_project_set_proxy_generation:
+ * @project: A #GESProject
+ * @min_height: The video height from which media files get a proxy, or 0
+ * @min_bitrate: The video bitrate, in bits per second, from which media
+ * files get a proxy, or 0
+ * @proxy_height: The height of the generated proxies, or 0 to stop
+ * generating proxies
+ *
+ * Makes @project create proxies for its #GESUriClipAsset-s, present and
+ * future, which have a video stream taller than @proxy_height and either
+ * at least @min_height pixels high or with at least a @min_bitrate
+ * bitrate.
+ *
+ * Proxies are Motion JPEG (intra only) and raw audio Matroska files,
+ * written next to the original files and reused if they already exist.
+ * They are transcoded by a pool of background threads, then added to
+ * @project and set as the #GESAsset:proxy of their original asset in the
+ * thread-default #GMainContext of the caller, which needs to be running.
+ *
+ * The clips keep their original asset: when their sources get started, a
+ * #GESPipeline in preview mode makes them decode the generated proxies,
+ * and the original media files in render mode.
+ *
+ * Since: 1.20
+ */
+void
+ges_project_set_proxy_generation (GESProject * project, gint min_height,
+    guint min_bitrate, gint proxy_height)
+{
+  GESProjectPrivate *priv;
+
+  g_return_if_fail (GES_IS_PROJECT (project));
+
+  priv = project->priv;
+  if (proxy_height <= 0) {
+    g_clear_pointer (&priv->proxy_generator, ges_proxy_generator_free);
+
+    return;
+  }
+
+  if (!priv->proxy_generator)
+    priv->proxy_generator = ges_proxy_generator_new (project);
+
+  ges_proxy_generator_configure (priv->proxy_generator, min_height,
+      min_bitrate, proxy_height);
+}
+
 /**
  * ges_project_new:
  * @uri: (allow-none): The uri to be set after creating the project.
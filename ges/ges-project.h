@@ -91,6 +91,17 @@ gboolean  ges_project_save         (GESProject * project,
                                     gboolean overwrite,
                                     GError **error);
 GES_API
+gboolean  ges_project_save_incremental (GESProject * project,
+                                        GESTimeline * timeline,
+                                        const gchar *uri,
+                                        GESAsset * formatter_asset,
+                                        GError **error);
+GES_API
+void      ges_project_set_proxy_generation (GESProject * project,
+                                            gint min_height,
+                                            guint min_bitrate,
+                                            gint proxy_height);
+GES_API
 gboolean  ges_project_load         (GESProject * project,
                                     GESTimeline * timeline,
                                     GError **error);
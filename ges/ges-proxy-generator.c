@@ -0,0 +1,412 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Generation of the proxies of the media files of a project, see
+ * ges_project_set_proxy_generation().
+ *
+ * Each #GESUriClipAsset of the project which is big enough gets
+ * transcoded, in a thread of a pool, to a Motion JPEG (intra only, so
+ * that seeking is cheap) and raw audio matroska file next to the original
+ * media: "<original>.<height>p.proxy.mkv". The file is first written with
+ * a ".part" suffix so that only complete proxies are ever picked up.
+ *
+ * Once transcoded, the proxy asset is requested from the thread of the
+ * project, added to the project and set as the proxy of the original
+ * asset. It is also marked with the GES_META_GENERATED_PROXY meta so that
+ * the uri sources know they have to decode the original when rendering,
+ * including the ones of clips created from the proxy itself, which is what
+ * requesting the asset of the original then returns. Proxies which already
+ * exist on disk are reused without transcoding. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <glib/gstdio.h>
+#include <gst/pbutils/pbutils.h>
+
+#include "ges.h"
+#include "ges-internal.h"
+
+GST_DEBUG_CATEGORY_STATIC (ges_proxy_generator_debug);
+#undef GST_CAT_DEFAULT
+#define GST_CAT_DEFAULT ges_proxy_generator_debug
+
+struct _GESProxyGenerator
+{
+  GESProject *project;
+  GMainContext *context;
+  GThreadPool *pool;
+
+  gint min_height;
+  guint min_bitrate;
+  gint proxy_height;
+
+  /* Asset IDs being transcoded, protected by lock */
+  GHashTable *pending;
+  GMutex lock;
+
+  gint stopping;
+};
+
+typedef struct
+{
+  GWeakRef project;
+  GESAsset *asset;
+  gchar *proxy_uri;
+  gint height;
+  gboolean transcode;
+} ProxyJob;
+
+static void
+_free_job (ProxyJob * job)
+{
+  g_weak_ref_clear (&job->project);
+  gst_object_unref (job->asset);
+  g_free (job->proxy_uri);
+  g_free (job);
+}
+
+static gboolean
+_needs_proxy (GESProxyGenerator * self, GESAsset * asset)
+{
+  GList *tmp, *streams;
+  GstDiscovererInfo *info;
+  gboolean ret = FALSE;
+
+  if (!GES_IS_URI_CLIP_ASSET (asset) || ges_asset_get_proxy (asset) ||
+      ges_asset_get_proxy_target (asset) ||
+      ges_uri_clip_asset_is_image (GES_URI_CLIP_ASSET (asset)))
+    return FALSE;
+
+  info = ges_uri_clip_asset_get_info (GES_URI_CLIP_ASSET (asset));
+  if (!info)
+    return FALSE;
+
+  streams = gst_discoverer_info_get_video_streams (info);
+  for (tmp = streams; tmp && !ret; tmp = tmp->next) {
+    GstDiscovererVideoInfo *vinfo = tmp->data;
+    gint height = gst_discoverer_video_info_get_height (vinfo);
+
+    if (height <= self->proxy_height)
+      continue;
+
+    ret = (self->min_height > 0 && height >= self->min_height) ||
+        (self->min_bitrate > 0 &&
+        MAX (gst_discoverer_video_info_get_bitrate (vinfo),
+            gst_discoverer_video_info_get_max_bitrate (vinfo)) >=
+        self->min_bitrate);
+  }
+  gst_discoverer_stream_info_list_free (streams);
+
+  return ret;
+}
+
+static GstEncodingProfile *
+_create_proxy_profile (gint height)
+{
+  GstCaps *caps, *restriction;
+  GstEncodingContainerProfile *container;
+  GstEncodingVideoProfile *video;
+
+  caps = gst_caps_new_empty_simple ("video/x-matroska");
+  container = gst_encoding_container_profile_new ("proxy", NULL, caps, NULL);
+  gst_caps_unref (caps);
+
+  caps = gst_caps_new_empty_simple ("image/jpeg");
+  restriction = gst_caps_new_simple ("video/x-raw", "height", G_TYPE_INT,
+      height, NULL);
+  video = gst_encoding_video_profile_new (caps, NULL, restriction, 0);
+  gst_encoding_container_profile_add_profile (container,
+      (GstEncodingProfile *) video);
+  gst_caps_unref (restriction);
+  gst_caps_unref (caps);
+
+  caps = gst_caps_new_empty_simple ("audio/x-raw");
+  gst_encoding_container_profile_add_profile (container,
+      (GstEncodingProfile *) gst_encoding_audio_profile_new (caps, NULL, NULL,
+          0));
+  gst_caps_unref (caps);
+
+  return (GstEncodingProfile *) container;
+}
+
+static void
+_decodebin_pad_added_cb (GstElement * decodebin, GstPad * pad,
+    GstElement * encodebin)
+{
+  GstPad *sinkpad = NULL;
+  GstCaps *caps = gst_pad_query_caps (pad, NULL);
+
+  g_signal_emit_by_name (encodebin, "request-pad", caps, &sinkpad);
+  gst_caps_unref (caps);
+
+  if (!sinkpad) {
+    GST_INFO_OBJECT (decodebin, "Not keeping %" GST_PTR_FORMAT
+        " in the proxy", pad);
+    return;
+  }
+
+  if (GST_PAD_LINK_FAILED (gst_pad_link (pad, sinkpad)))
+    GST_WARNING_OBJECT (decodebin, "Could not link %" GST_PTR_FORMAT, pad);
+  gst_object_unref (sinkpad);
+}
+
+/* Runs in a thread of the pool */
+static gboolean
+_transcode (GESProxyGenerator * self, const gchar * uri,
+    const gchar * location, gint height, GError ** error)
+{
+  GstBus *bus;
+  GstMessage *message;
+  GstEncodingProfile *profile;
+  GstElement *pipeline, *decodebin, *encodebin, *sink;
+  gboolean ret = FALSE;
+
+  decodebin = gst_element_factory_make ("uridecodebin", NULL);
+  encodebin = gst_element_factory_make ("encodebin", NULL);
+  sink = gst_element_factory_make ("filesink", NULL);
+  if (!decodebin || !encodebin || !sink) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_MISSING_PLUGIN,
+        "Missing elements to transcode %s", uri);
+    gst_clear_object (&decodebin);
+    gst_clear_object (&encodebin);
+    gst_clear_object (&sink);
+
+    return FALSE;
+  }
+
+  profile = _create_proxy_profile (height);
+  g_object_set (decodebin, "uri", uri, NULL);
+  g_object_set (encodebin, "profile", profile, NULL);
+  g_object_set (sink, "location", location, NULL);
+  gst_encoding_profile_unref (profile);
+
+  pipeline = gst_object_ref_sink (gst_pipeline_new (NULL));
+  gst_bin_add_many (GST_BIN (pipeline), decodebin, encodebin, sink, NULL);
+  gst_element_link (encodebin, sink);
+  g_signal_connect (decodebin, "pad-added",
+      G_CALLBACK (_decodebin_pad_added_cb), encodebin);
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+  if (gst_element_set_state (pipeline, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_STATE_CHANGE,
+        "Could not start transcoding %s", uri);
+  } else {
+    /* Polling so that freeing the generator interrupts the transcoding */
+    do {
+      message = gst_bus_timed_pop_filtered (bus, 100 * GST_MSECOND,
+          GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+    } while (!message && !g_atomic_int_get (&self->stopping));
+
+    if (!message) {
+      g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+          "Transcoding of %s interrupted", uri);
+    } else {
+      if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+        gst_message_parse_error (message, error, NULL);
+      else
+        ret = TRUE;
+      gst_message_unref (message);
+    }
+  }
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+
+  return ret;
+}
+
+static void
+_proxy_loaded_cb (GESAsset * source, GAsyncResult * res, ProxyJob * job)
+{
+  GError *error = NULL;
+  GESProject *project = g_weak_ref_get (&job->project);
+  GESAsset *proxy = ges_asset_request_finish (res, &error);
+
+  if (!proxy) {
+    GST_WARNING_OBJECT (job->asset, "Could not load proxy %s: %s",
+        job->proxy_uri, error->message);
+    g_error_free (error);
+    goto done;
+  }
+
+  ges_meta_container_set_boolean (GES_META_CONTAINER (proxy),
+      GES_META_GENERATED_PROXY, TRUE);
+  if (project)
+    ges_project_add_asset (project, proxy);
+
+  if (ges_asset_set_proxy (job->asset, proxy))
+    GST_INFO_OBJECT (job->asset, "Now proxied by %s", job->proxy_uri);
+  gst_object_unref (proxy);
+
+done:
+  gst_clear_object (&project);
+  _free_job (job);
+}
+
+static gboolean
+_request_proxy_in_idle (ProxyJob * job)
+{
+  ges_asset_request_async (GES_TYPE_URI_CLIP, job->proxy_uri, NULL,
+      (GAsyncReadyCallback) _proxy_loaded_cb, job);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Runs in a thread of the pool */
+static void
+_run_job (ProxyJob * job, GESProxyGenerator * self)
+{
+  GSource *source;
+  GError *error = NULL;
+  gchar *location, *part_location;
+  gboolean ret = !g_atomic_int_get (&self->stopping);
+
+  if (ret && job->transcode) {
+    location = gst_uri_get_location (job->proxy_uri);
+    part_location = g_strconcat (location, ".part", NULL);
+
+    GST_INFO_OBJECT (job->asset, "Transcoding proxy %s", job->proxy_uri);
+    ret = _transcode (self, ges_asset_get_id (job->asset), part_location,
+        job->height, &error);
+    if (!ret) {
+      GST_WARNING_OBJECT (job->asset, "Could not transcode proxy: %s",
+          error ? error->message : "unknown error");
+      g_clear_error (&error);
+      g_unlink (part_location);
+    } else if (g_rename (part_location, location)) {
+      GST_WARNING_OBJECT (job->asset, "Could not rename %s to %s",
+          part_location, location);
+      g_unlink (part_location);
+      ret = FALSE;
+    }
+
+    g_free (part_location);
+    g_free (location);
+  }
+
+  g_mutex_lock (&self->lock);
+  g_hash_table_remove (self->pending, ges_asset_get_id (job->asset));
+  g_mutex_unlock (&self->lock);
+
+  if (!ret) {
+    _free_job (job);
+    return;
+  }
+
+  /* Assets are requested from the thread of the project */
+  source = g_idle_source_new ();
+  g_source_set_callback (source, (GSourceFunc) _request_proxy_in_idle, job,
+      NULL);
+  g_source_attach (source, self->context);
+  g_source_unref (source);
+}
+
+static void
+_asset_added_cb (GESProject * project, GESAsset * asset,
+    GESProxyGenerator * self)
+{
+  ges_proxy_generator_add_asset (self, asset);
+}
+
+GESProxyGenerator *
+ges_proxy_generator_new (GESProject * project)
+{
+  GESProxyGenerator *self = g_new0 (GESProxyGenerator, 1);
+
+  if (!ges_proxy_generator_debug)
+    GST_DEBUG_CATEGORY_INIT (ges_proxy_generator_debug, "gesproxygenerator",
+        GST_DEBUG_FG_YELLOW, "GES proxy generation");
+
+  self->project = project;
+  self->context = g_main_context_ref_thread_default ();
+  self->pending = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+      NULL);
+  g_mutex_init (&self->lock);
+  self->pool = g_thread_pool_new ((GFunc) _run_job, self,
+      MAX (1, g_get_num_processors () / 2), FALSE, NULL);
+
+  g_signal_connect (project, "asset-added", G_CALLBACK (_asset_added_cb),
+      self);
+
+  return self;
+}
+
+void
+ges_proxy_generator_free (GESProxyGenerator * self)
+{
+  g_signal_handlers_disconnect_by_data (self->project, self);
+
+  /* Queued jobs are skipped and running transcodings interrupted */
+  g_atomic_int_set (&self->stopping, TRUE);
+  g_thread_pool_free (self->pool, FALSE, TRUE);
+  g_hash_table_unref (self->pending);
+  g_mutex_clear (&self->lock);
+  g_main_context_unref (self->context);
+  g_free (self);
+}
+
+void
+ges_proxy_generator_configure (GESProxyGenerator * self, gint min_height,
+    guint min_bitrate, gint proxy_height)
+{
+  GList *tmp, *assets;
+
+  self->min_height = min_height;
+  self->min_bitrate = min_bitrate;
+  self->proxy_height = proxy_height;
+
+  assets = ges_project_list_assets (self->project, GES_TYPE_URI_CLIP);
+  for (tmp = assets; tmp; tmp = tmp->next)
+    ges_proxy_generator_add_asset (self, tmp->data);
+  g_list_free_full (assets, gst_object_unref);
+}
+
+void
+ges_proxy_generator_add_asset (GESProxyGenerator * self, GESAsset * asset)
+{
+  ProxyJob *job;
+  gchar *location;
+  gboolean pending;
+  const gchar *id = ges_asset_get_id (asset);
+
+  if (self->proxy_height <= 0 || !gst_uri_has_protocol (id, "file") ||
+      !_needs_proxy (self, asset))
+    return;
+
+  g_mutex_lock (&self->lock);
+  pending = !g_hash_table_add (self->pending, g_strdup (id));
+  g_mutex_unlock (&self->lock);
+  if (pending)
+    return;
+
+  job = g_new0 (ProxyJob, 1);
+  g_weak_ref_init (&job->project, self->project);
+  job->asset = gst_object_ref (asset);
+  job->height = self->proxy_height;
+  job->proxy_uri = g_strdup_printf ("%s.%dp.proxy.mkv", id, job->height);
+
+  location = gst_uri_get_location (job->proxy_uri);
+  job->transcode = !g_file_test (location, G_FILE_TEST_EXISTS);
+  g_free (location);
+
+  g_thread_pool_push (self->pool, job, NULL);
+}
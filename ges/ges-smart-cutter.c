@@ -0,0 +1,1137 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Smart cutting
+ *
+ * When rendering smartly, the uri sources expose the encoded streams of their
+ * files so that they get muxed without being decoded. Encoded video can only
+ * be decoded starting from a keyframe though, so the in-point and the
+ * out-point of a source not being on keyframes used to mean decoding and
+ * encoding the whole source again. When GESTimeline:smart-cut is set, the
+ * encoded video streams of the sources go through a GESSmartCutter instead,
+ * which handles them one GOP (a keyframe and the frames following it up to the
+ * next keyframe) at a time:
+ *
+ *  - GOPs fully inside the segment are pushed as they are,
+ *  - GOPs fully outside of it are dropped,
+ *  - GOPs crossing the edges of the segment are decoded, clipped to the
+ *    segment and encoded again with an encoder producing the format of the
+ *    stream.
+ *
+ * Open GOPs, which reference the frames of the previous GOP, are encoded again
+ * when the previous GOP was not pushed as it was. If no decoder or encoder can
+ * handle the stream, the GOPs are pushed as they are.
+ *
+ * The encoded GOPs are pushed with the caps of the stream, so they need to
+ * match them: the first GOP pushed for some caps is always encoded again to
+ * check that the encoder produces the same codec_data, level, profile, etc.
+ * When the encoded GOPs do not match, the whole stream is encoded again,
+ * without draining the encoder between the GOPs, and pushed with the caps of
+ * the encoder.
+ *
+ * Streams without codec_data, like H.264 and H.265 in MPEG-TS, carry their
+ * parameter sets in-band. The encoded GOPs get theirs repeated on each
+ * keyframe by the parser, and a GOP is only passed through when its keyframe
+ * carries the parameter sets of the stream, or when the ones last pushed are
+ * the ones of the stream. Otherwise it is encoded again, so a stream only
+ * sending its parameter sets once is encoded again from the first cut point.
+ *
+ * Streams with codec_data, like H.264 in MP4 or Matroska (stream-format=avc),
+ * are not spliced: the encoder generates its own codec_data, which does not
+ * match the one of the stream, so they are always encoded again entirely.
+ *
+ * The encoded GOPs do not have B-frames, their DTS are shifted by the
+ * decoding delay of the stream so that the DTS of the GOPs passed through
+ * after them keep increasing. When the DTS of a frame still does not follow
+ * the one previously pushed, it and the DTS of the frames pushed along with
+ * it are shifted forward.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "ges-internal.h"
+
+GST_DEBUG_CATEGORY_STATIC (ges_smart_cutter_debug);
+#define GST_CAT_DEFAULT ges_smart_cutter_debug
+
+G_DECLARE_FINAL_TYPE (GESSmartCutter, ges_smart_cutter, GES, SMART_CUTTER,
+    GstElement);
+
+struct _GESSmartCutter
+{
+  GstElement parent;
+
+  GstPad *sinkpad;
+  GstPad *srcpad;
+
+  GstSegment segment;
+  /* The caps of the stream, the fields the re-encoded frames need to match
+   * and the caps last pushed downstream */
+  GstCaps *caps;
+  GstCaps *encoding_caps;
+  GstCaps *output_caps;
+
+  /* Buffers and serialized events of the current GOP */
+  GQueue gop;
+  gboolean in_gop;
+  /* Whether the previous GOP was dropped or encoded again */
+  gboolean previous_altered;
+
+  /* decoder ! videoconvert ! encoder [! parser], run from the streaming
+   * thread between internal_srcpad and internal_sinkpad */
+  GstElement *chain;
+  GstElement *encoder;
+  GstPad *internal_srcpad;
+  GstPad *internal_sinkpad;
+  GQueue encoded;
+  GstCaps *encoded_caps;
+  gboolean cannot_reencode;
+  /* Whether the chain got the events of the current segment and was not
+   * drained since */
+  gboolean chain_started;
+
+  /* Whether it was checked that the encoded GOPs match the caps of the
+   * stream, and whether the whole stream is encoded again as they don't */
+  gboolean splice_checked;
+  gboolean reencode_all;
+
+  /* Whether the parameter sets last pushed in-band are the ones of the
+   * stream, see _gop_is_decodable() */
+  gboolean stream_parameter_sets;
+
+  /* The largest PTS - DTS of the stream, the last DTS pushed and the shift
+   * applied to the DTS of the frames being pushed */
+  GstClockTime dts_delay;
+  GstClockTime last_dts;
+  GstClockTime dts_shift;
+
+  /* Counted since the creation of the element */
+  gint passed_gops;
+  gint reencoded_gops;
+  gint dropped_gops;
+};
+
+enum
+{
+  PROP_0,
+  PROP_PASSED_GOPS,
+  PROP_REENCODED_GOPS,
+  PROP_DROPPED_GOPS,
+};
+
+#define GES_TYPE_SMART_CUTTER (ges_smart_cutter_get_type())
+G_DEFINE_TYPE (GESSmartCutter, ges_smart_cutter, GST_TYPE_ELEMENT);
+
+static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK, GST_PAD_ALWAYS, GST_STATIC_CAPS_ANY);
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC, GST_PAD_ALWAYS, GST_STATIC_CAPS_ANY);
+
+/* The fields of the caps the re-encoded frames need to match for the passed
+ * through GOPs to keep being decodable in the same stream */
+static const gchar *const encoding_fields[] = {
+  "width", "height", "framerate", "pixel-aspect-ratio", "profile", "level",
+  "stream-format", "alignment", NULL
+};
+
+/* The properties setting the bitrate of the common encoders, in bit/s
+ * divided by @divider */
+static const struct
+{
+  const gchar *factory;
+  const gchar *property;
+  guint divider;
+} bitrate_properties[] = {
+  {"x264enc", "bitrate", 1000},
+  {"x265enc", "bitrate", 1000},
+  {"openh264enc", "bitrate", 1},
+  {"vp8enc", "target-bitrate", 1},
+  {"vp9enc", "target-bitrate", 1},
+};
+
+static gboolean
+_keep_encoding_field (GQuark field_id, GValue * value, gpointer udata)
+{
+  return g_strv_contains (encoding_fields, g_quark_to_string (field_id));
+}
+
+static GstCaps *
+_get_encoding_caps (const GstCaps * caps)
+{
+  GstStructure *structure =
+      gst_structure_copy (gst_caps_get_structure (caps, 0));
+
+  gst_structure_filter_and_map_in_place (structure,
+      (GstStructureFilterMapFunc) _keep_encoding_field, NULL);
+
+  return gst_caps_new_full (structure, NULL);
+}
+
+static void
+_set_int_property (GstElement * element, const gchar * name, gint value)
+{
+  GValue int_value = G_VALUE_INIT, prop_value = G_VALUE_INIT;
+  GParamSpec *pspec =
+      g_object_class_find_property (G_OBJECT_GET_CLASS (element), name);
+
+  if (!pspec)
+    return;
+
+  g_value_init (&int_value, G_TYPE_INT);
+  g_value_set_int (&int_value, value);
+  g_value_init (&prop_value, pspec->value_type);
+  if (g_value_transform (&int_value, &prop_value))
+    g_object_set_property (G_OBJECT (element), name, &prop_value);
+
+  g_value_unset (&int_value);
+  g_value_unset (&prop_value);
+}
+
+static GstElement *
+_make_element_for_caps (GstElementFactoryListType type, GstCaps * caps,
+    GstPadDirection direction)
+{
+  GList *factories, *filtered, *tmp;
+  GstElement *element = NULL;
+
+  factories = gst_element_factory_list_get_elements (type, GST_RANK_MARGINAL);
+  filtered = gst_element_factory_list_filter (factories, caps, direction,
+      FALSE);
+  filtered = g_list_sort (filtered, gst_plugin_feature_rank_compare_func);
+
+  for (tmp = filtered; tmp && !element; tmp = tmp->next)
+    element = gst_element_factory_create (tmp->data, NULL);
+
+  gst_plugin_feature_list_free (filtered);
+  gst_plugin_feature_list_free (factories);
+
+  return element;
+}
+
+/*************************
+ *   Re-encoding chain   *
+ *************************/
+static GstFlowReturn
+_encoded_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  GESSmartCutter *self = gst_pad_get_element_private (pad);
+
+  g_queue_push_tail (&self->encoded, buffer);
+
+  return GST_FLOW_OK;
+}
+
+static gboolean
+_encoded_event (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  GESSmartCutter *self = gst_pad_get_element_private (pad);
+
+  if (GST_EVENT_TYPE (event) == GST_EVENT_CAPS) {
+    GstCaps *caps;
+
+    gst_event_parse_caps (event, &caps);
+    gst_caps_replace (&self->encoded_caps, caps);
+  }
+  gst_event_unref (event);
+
+  return TRUE;
+}
+
+static gboolean
+_encoded_query (GstPad * pad, GstObject * parent, GstQuery * query)
+{
+  GESSmartCutter *self = gst_pad_get_element_private (pad);
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_CAPS:
+    {
+      GstCaps *filter, *caps;
+
+      gst_query_parse_caps (query, &filter);
+      if (filter)
+        caps = gst_caps_intersect_full (filter, self->encoding_caps,
+            GST_CAPS_INTERSECT_FIRST);
+      else
+        caps = gst_caps_ref (self->encoding_caps);
+      gst_query_set_caps_result (query, caps);
+      gst_caps_unref (caps);
+
+      return TRUE;
+    }
+    case GST_QUERY_ACCEPT_CAPS:
+      gst_query_set_accept_caps_result (query, TRUE);
+
+      return TRUE;
+    default:
+      return gst_pad_query_default (pad, parent, query);
+  }
+}
+
+static void
+_teardown_chain (GESSmartCutter * self)
+{
+  if (!self->chain)
+    return;
+
+  gst_element_set_state (self->chain, GST_STATE_NULL);
+  gst_pad_set_active (self->internal_srcpad, FALSE);
+  gst_pad_set_active (self->internal_sinkpad, FALSE);
+  gst_object_unref (self->chain);
+  self->chain = NULL;
+  self->encoder = NULL;
+  self->chain_started = FALSE;
+
+  g_queue_clear_full (&self->encoded, (GDestroyNotify) gst_buffer_unref);
+  gst_clear_caps (&self->encoded_caps);
+}
+
+static gboolean
+_setup_chain (GESSmartCutter * self)
+{
+  gboolean linked;
+  GstPad *pad;
+  GstElement *decoder, *converter, *encoder, *parser, *last;
+
+  if (self->chain)
+    return TRUE;
+
+  if (self->cannot_reencode)
+    return FALSE;
+
+  decoder = _make_element_for_caps (GST_ELEMENT_FACTORY_TYPE_DECODER |
+      GST_ELEMENT_FACTORY_TYPE_MEDIA_VIDEO, self->caps, GST_PAD_SINK);
+  encoder = _make_element_for_caps (GST_ELEMENT_FACTORY_TYPE_ENCODER |
+      GST_ELEMENT_FACTORY_TYPE_MEDIA_VIDEO, self->encoding_caps, GST_PAD_SRC);
+  parser = _make_element_for_caps (GST_ELEMENT_FACTORY_TYPE_PARSER,
+      self->encoding_caps, GST_PAD_SINK);
+  converter = gst_element_factory_make ("videoconvert", NULL);
+
+  if (!decoder || !encoder || !converter) {
+    GST_WARNING_OBJECT (self, "Can't encode %" GST_PTR_FORMAT " again"
+        " (decoder: %" GST_PTR_FORMAT ", encoder: %" GST_PTR_FORMAT
+        "), GOPs will be pushed as they are", self->caps, decoder, encoder);
+    gst_clear_object (&decoder);
+    gst_clear_object (&encoder);
+    gst_clear_object (&parser);
+    gst_clear_object (&converter);
+    self->cannot_reencode = TRUE;
+
+    return FALSE;
+  }
+
+  /* The re-encoded frames are followed by frames that were encoded
+   * separately, make sure they do not get reordered */
+  _set_int_property (encoder, "bframes", 0);
+  _set_int_property (encoder, "b-adapt", FALSE);
+  _set_int_property (encoder, "b-pyramid", FALSE);
+  /* Without codec_data, the decoders only get the parameter sets of the
+   * encoded GOPs in-band */
+  if (parser)
+    _set_int_property (parser, "config-interval", -1);
+
+  self->chain = gst_object_ref_sink (gst_bin_new (NULL));
+  self->encoder = encoder;
+  gst_bin_add_many (GST_BIN (self->chain), decoder, converter, encoder, NULL);
+  linked = gst_element_link_many (decoder, converter, encoder, NULL);
+  last = encoder;
+  if (parser) {
+    gst_bin_add (GST_BIN (self->chain), parser);
+    if (gst_element_link (encoder, parser))
+      last = parser;
+  }
+
+  gst_pad_set_active (self->internal_srcpad, TRUE);
+  gst_pad_set_active (self->internal_sinkpad, TRUE);
+
+  pad = gst_element_get_static_pad (decoder, "sink");
+  linked &= gst_pad_link (self->internal_srcpad, pad) == GST_PAD_LINK_OK;
+  gst_object_unref (pad);
+
+  pad = gst_element_get_static_pad (last, "src");
+  linked &= gst_pad_link (pad, self->internal_sinkpad) == GST_PAD_LINK_OK;
+  gst_object_unref (pad);
+
+  if (!linked) {
+    GST_WARNING_OBJECT (self, "Could not link the re-encoding chain for %"
+        GST_PTR_FORMAT ", GOPs will be pushed as they are", self->caps);
+    _teardown_chain (self);
+    self->cannot_reencode = TRUE;
+
+    return FALSE;
+  }
+
+  GST_INFO_OBJECT (self, "Re-encoding GOPs with %" GST_PTR_FORMAT " and %"
+      GST_PTR_FORMAT, decoder, encoder);
+
+  return TRUE;
+}
+
+static void
+_set_bitrate (GESSmartCutter * self, guint64 bytes, GstClockTime duration)
+{
+  guint i;
+  guint64 bitrate;
+  GstElementFactory *factory = gst_element_get_factory (self->encoder);
+
+  if (!factory || !duration || !GST_CLOCK_TIME_IS_VALID (duration))
+    return;
+
+  bitrate = gst_util_uint64_scale (bytes * 8, GST_SECOND, duration);
+  for (i = 0; i < G_N_ELEMENTS (bitrate_properties); i++) {
+    if (g_strcmp0 (GST_OBJECT_NAME (factory), bitrate_properties[i].factory))
+      continue;
+
+    _set_int_property (self->encoder, bitrate_properties[i].property,
+        (gint) MIN (bitrate / bitrate_properties[i].divider, G_MAXINT));
+    break;
+  }
+}
+
+/*************************
+ *     GOPs handling     *
+ *************************/
+static void
+_clear_gop (GESSmartCutter * self)
+{
+  g_queue_clear_full (&self->gop, (GDestroyNotify) gst_mini_object_unref);
+  self->in_gop = FALSE;
+}
+
+static void
+_gop_get_range (GESSmartCutter * self, GstClockTime * start,
+    GstClockTime * stop, guint64 * bytes, gboolean * open)
+{
+  GList *tmp;
+  GstClockTime keyframe_ts = GST_CLOCK_TIME_NONE;
+
+  *start = *stop = GST_CLOCK_TIME_NONE;
+  *bytes = 0;
+  *open = FALSE;
+  for (tmp = self->gop.head; tmp; tmp = tmp->next) {
+    GstBuffer *buffer;
+    GstClockTime ts, end;
+
+    if (!GST_IS_BUFFER (tmp->data))
+      continue;
+
+    buffer = tmp->data;
+    *bytes += gst_buffer_get_size (buffer);
+    ts = GST_BUFFER_PTS_IS_VALID (buffer) ? GST_BUFFER_PTS (buffer) :
+        GST_BUFFER_DTS (buffer);
+    if (!GST_CLOCK_TIME_IS_VALID (ts))
+      continue;
+
+    /* Frames presented before the keyframe reference the previous GOP */
+    if (!GST_CLOCK_TIME_IS_VALID (keyframe_ts))
+      keyframe_ts = ts;
+    else if (ts < keyframe_ts)
+      *open = TRUE;
+
+    end = ts + (GST_BUFFER_DURATION_IS_VALID (buffer) ?
+        GST_BUFFER_DURATION (buffer) : 1);
+    if (!GST_CLOCK_TIME_IS_VALID (*start) || ts < *start)
+      *start = ts;
+    if (!GST_CLOCK_TIME_IS_VALID (*stop) || end > *stop)
+      *stop = end;
+  }
+}
+
+static void
+_ensure_output_caps (GESSmartCutter * self, GstCaps * caps)
+{
+  if (self->output_caps && gst_caps_is_equal (self->output_caps, caps))
+    return;
+
+  GST_DEBUG_OBJECT (self, "Pushing caps %" GST_PTR_FORMAT, caps);
+  gst_caps_replace (&self->output_caps, caps);
+  gst_pad_push_event (self->srcpad, gst_event_new_caps (caps));
+}
+
+/* Pushes @buffer downstream. When its DTS does not follow the one last
+ * pushed, it and the DTS of the buffers pushed along with it are shifted
+ * forward so that they keep increasing */
+static GstFlowReturn
+_push_buffer (GESSmartCutter * self, GstBuffer * buffer)
+{
+  GstClockTime dts = GST_BUFFER_DTS (buffer);
+
+  if (!GST_CLOCK_TIME_IS_VALID (dts))
+    return gst_pad_push (self->srcpad, buffer);
+
+  dts += self->dts_shift;
+  if (GST_CLOCK_TIME_IS_VALID (self->last_dts) && dts <= self->last_dts) {
+    GstClockTime next_dts = self->last_dts +
+        (GST_BUFFER_DURATION_IS_VALID (buffer) ?
+        GST_BUFFER_DURATION (buffer) : 1);
+
+    self->dts_shift += next_dts - dts;
+    dts = next_dts;
+  }
+
+  if (dts != GST_BUFFER_DTS (buffer)) {
+    GST_LOG_OBJECT (self, "Shifting DTS %" GST_TIME_FORMAT " to %"
+        GST_TIME_FORMAT, GST_TIME_ARGS (GST_BUFFER_DTS (buffer)),
+        GST_TIME_ARGS (dts));
+    buffer = gst_buffer_make_writable (buffer);
+    GST_BUFFER_DTS (buffer) = dts;
+  }
+  self->last_dts = dts;
+
+  return gst_pad_push (self->srcpad, buffer);
+}
+
+/* Whether the keyframe of the GOP carries the in-band parameter sets
+ * needed to decode it, which is always the case for the streams with
+ * codec_data or without parameter sets */
+static gboolean
+_gop_has_parameter_sets (GESSmartCutter * self)
+{
+  GList *tmp;
+  GstMapInfo map;
+  gsize i;
+  gboolean h265;
+  guint64 found = 0, needed;
+  GstBuffer *keyframe = NULL;
+  const GstStructure *structure = gst_caps_get_structure (self->caps, 0);
+
+  if (gst_structure_has_field (structure, "codec_data"))
+    return TRUE;
+
+  if (gst_structure_has_name (structure, "video/x-h264")) {
+    h265 = FALSE;
+    /* SPS and PPS */
+    needed = (1 << 7) | (1 << 8);
+  } else if (gst_structure_has_name (structure, "video/x-h265")) {
+    h265 = TRUE;
+    /* VPS, SPS and PPS */
+    needed = ((guint64) 1 << 32) | ((guint64) 1 << 33) | ((guint64) 1 << 34);
+  } else {
+    return TRUE;
+  }
+
+  for (tmp = self->gop.head; tmp && !keyframe; tmp = tmp->next) {
+    if (GST_IS_BUFFER (tmp->data))
+      keyframe = tmp->data;
+  }
+
+  if (!keyframe || !gst_buffer_map (keyframe, &map, GST_MAP_READ))
+    return FALSE;
+
+  /* Look for the types of the NAL units following the start codes */
+  for (i = 0; i + 3 < map.size && (found & needed) != needed; i++) {
+    guint type;
+
+    if (map.data[i] || map.data[i + 1] || map.data[i + 2] != 1)
+      continue;
+
+    type = h265 ? (map.data[i + 3] >> 1) & 0x3f : map.data[i + 3] & 0x1f;
+    found |= (guint64) 1 << type;
+  }
+  gst_buffer_unmap (keyframe, &map);
+
+  return (found & needed) == needed;
+}
+
+/* Whether the GOP can be decoded when passed through, after the parameter
+ * sets last pushed */
+static gboolean
+_gop_is_decodable (GESSmartCutter * self)
+{
+  if (self->stream_parameter_sets || _gop_has_parameter_sets (self))
+    return TRUE;
+
+  GST_DEBUG_OBJECT (self, "The GOP does not carry the parameter sets of the"
+      " stream, which were not pushed again since the frames encoded again");
+
+  return FALSE;
+}
+
+/* Pushes the events of the GOP and, unless @drop, its buffers */
+static GstFlowReturn
+_push_gop (GESSmartCutter * self, gboolean drop)
+{
+  GstMiniObject *object;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  if (!drop) {
+    _ensure_output_caps (self, self->caps);
+    if (_gop_has_parameter_sets (self))
+      self->stream_parameter_sets = TRUE;
+  }
+
+  self->dts_shift = 0;
+  while ((object = g_queue_pop_head (&self->gop))) {
+    if (GST_IS_EVENT (object))
+      gst_pad_push_event (self->srcpad, GST_EVENT (object));
+    else if (drop || ret != GST_FLOW_OK)
+      gst_mini_object_unref (object);
+    else
+      ret = _push_buffer (self, GST_BUFFER (object));
+  }
+
+  return ret;
+}
+
+/* Stops the re-encoding chain, after pushing its pending frames to
+ * self->encoded if @drain */
+static void
+_stop_chain (GESSmartCutter * self, gboolean drain)
+{
+  if (!self->chain_started)
+    return;
+
+  if (drain)
+    gst_pad_push_event (self->internal_srcpad, gst_event_new_eos ());
+  gst_element_set_state (self->chain, GST_STATE_READY);
+  self->chain_started = FALSE;
+}
+
+/* Pushes the buffers of the GOP through the re-encoding chain, starting it
+ * if needed. When @drain, the chain is stopped afterwards and self->encoded
+ * holds all the frames of the GOP encoded again. */
+static GstFlowReturn
+_encode_gop (GESSmartCutter * self, guint64 bytes, GstClockTime duration,
+    gboolean drain)
+{
+  GList *tmp;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  if (!self->chain_started) {
+    _set_bitrate (self, bytes, duration);
+    if (gst_element_set_state (self->chain, GST_STATE_PLAYING) ==
+        GST_STATE_CHANGE_FAILURE) {
+      GST_WARNING_OBJECT (self, "Could not start the re-encoding chain");
+      _teardown_chain (self);
+      self->cannot_reencode = TRUE;
+
+      return GST_FLOW_NOT_SUPPORTED;
+    }
+
+    /* The decoder clips the frames to the segment */
+    gst_clear_caps (&self->encoded_caps);
+    gst_pad_push_event (self->internal_srcpad,
+        gst_event_new_stream_start ("ges-smart-cutter"));
+    gst_pad_push_event (self->internal_srcpad,
+        gst_event_new_caps (self->caps));
+    gst_pad_push_event (self->internal_srcpad,
+        gst_event_new_segment (&self->segment));
+    self->chain_started = TRUE;
+  }
+
+  for (tmp = self->gop.head; tmp && ret == GST_FLOW_OK; tmp = tmp->next) {
+    if (GST_IS_BUFFER (tmp->data))
+      ret = gst_pad_push (self->internal_srcpad, gst_buffer_ref (tmp->data));
+  }
+
+  /* Returned once the frames get past the end of the segment */
+  if (ret == GST_FLOW_EOS)
+    ret = GST_FLOW_OK;
+
+  if (drain || ret != GST_FLOW_OK)
+    _stop_chain (self, ret == GST_FLOW_OK);
+
+  if (ret == GST_FLOW_OK && drain && !self->encoded_caps)
+    ret = GST_FLOW_NOT_NEGOTIATED;
+
+  return ret;
+}
+
+/* Whether the encoded frames can be pushed with the caps of the stream,
+ * between GOPs passed through */
+static gboolean
+_can_splice (GESSmartCutter * self)
+{
+  guint i;
+  const GstStructure *structure, *encoded_structure;
+
+  structure = gst_caps_get_structure (self->caps, 0);
+  encoded_structure = gst_caps_get_structure (self->encoded_caps, 0);
+  if (!gst_structure_has_name (encoded_structure,
+          gst_structure_get_name (structure)))
+    return FALSE;
+
+  for (i = 0; encoding_fields[i]; i++) {
+    const GValue *value = gst_structure_get_value (structure,
+        encoding_fields[i]);
+    const GValue *encoded_value = gst_structure_get_value (encoded_structure,
+        encoding_fields[i]);
+
+    if (value && (!encoded_value
+            || gst_value_compare (value, encoded_value) != GST_VALUE_EQUAL))
+      return FALSE;
+  }
+
+  /* The parameter sets of the passed through GOPs, encoders generate their
+   * own codec_data so this only matches when encoding the same way */
+  if (gst_structure_has_field (structure, "codec_data")) {
+    const GValue *value = gst_structure_get_value (structure, "codec_data");
+    const GValue *encoded_value = gst_structure_get_value (encoded_structure,
+        "codec_data");
+
+    return encoded_value
+        && gst_value_compare (value, encoded_value) == GST_VALUE_EQUAL;
+  }
+
+  return TRUE;
+}
+
+/* Called with the frames of a GOP encoded again in self->encoded */
+static void
+_check_splice (GESSmartCutter * self)
+{
+  self->splice_checked = TRUE;
+  self->reencode_all = !_can_splice (self);
+
+  if (self->reencode_all)
+    GST_INFO_OBJECT (self, "Encoded caps %" GST_PTR_FORMAT " do not match %"
+        GST_PTR_FORMAT ", encoding the whole stream again", self->encoded_caps,
+        self->caps);
+}
+
+/* Pushes the frames encoded again, with the caps of the stream unless the
+ * whole stream is encoded again */
+static GstFlowReturn
+_push_encoded (GESSmartCutter * self)
+{
+  GstBuffer *buffer;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  if (g_queue_is_empty (&self->encoded))
+    return GST_FLOW_OK;
+
+  GST_LOG_OBJECT (self, "Pushing %u frames encoded again",
+      self->encoded.length);
+  _ensure_output_caps (self,
+      self->reencode_all ? self->encoded_caps : self->caps);
+  /* The encoded frames carry the parameter sets of the encoder */
+  self->stream_parameter_sets = FALSE;
+  self->dts_shift = 0;
+  while ((buffer = g_queue_pop_head (&self->encoded))) {
+    if (ret != GST_FLOW_OK) {
+      gst_buffer_unref (buffer);
+      continue;
+    }
+
+    /* Decoded as early as the frames of the stream would have been */
+    if (!self->reencode_all && self->dts_delay
+        && GST_BUFFER_PTS_IS_VALID (buffer)) {
+      GstClockTime pts = GST_BUFFER_PTS (buffer);
+
+      buffer = gst_buffer_make_writable (buffer);
+      GST_BUFFER_DTS (buffer) =
+          pts > self->dts_delay ? pts - self->dts_delay : 0;
+    }
+    ret = _push_buffer (self, buffer);
+  }
+
+  return ret;
+}
+
+static GstFlowReturn
+_reencode_gop (GESSmartCutter * self, guint64 bytes, GstClockTime duration)
+{
+  GstMiniObject *object;
+  GstFlowReturn ret;
+
+  if (!_setup_chain (self))
+    return _push_gop (self, FALSE);
+
+  ret = _encode_gop (self, bytes, duration, !self->reencode_all);
+  if (ret == GST_FLOW_OK && !self->splice_checked) {
+    _check_splice (self);
+    if (self->reencode_all) {
+      g_queue_clear_full (&self->encoded, (GDestroyNotify) gst_buffer_unref);
+      ret = _encode_gop (self, bytes, duration, FALSE);
+    }
+  }
+
+  if (ret != GST_FLOW_OK) {
+    GST_WARNING_OBJECT (self, "Could not encode GOP again (%s), pushing it"
+        " as it is", gst_flow_get_name (ret));
+    g_queue_clear_full (&self->encoded, (GDestroyNotify) gst_buffer_unref);
+
+    return _push_gop (self, FALSE);
+  }
+
+  while ((object = g_queue_pop_head (&self->gop))) {
+    if (GST_IS_EVENT (object))
+      gst_pad_push_event (self->srcpad, GST_EVENT (object));
+    else
+      gst_mini_object_unref (object);
+  }
+
+  return _push_encoded (self);
+}
+
+/* Whether the current GOP, fully inside the segment, can be passed through.
+ * The first GOP pushed for some caps is encoded again anyway, to check that
+ * the GOPs crossing the edges of the segment can be mixed with it. */
+static gboolean
+_can_pass_gop (GESSmartCutter * self, guint64 bytes, GstClockTime duration)
+{
+  if (!_gop_is_decodable (self))
+    return FALSE;
+
+  if (!self->splice_checked && _setup_chain (self)) {
+    if (_encode_gop (self, bytes, duration, TRUE) == GST_FLOW_OK)
+      _check_splice (self);
+    self->splice_checked = TRUE;
+    g_queue_clear_full (&self->encoded, (GDestroyNotify) gst_buffer_unref);
+  }
+
+  return !self->reencode_all;
+}
+
+static GstFlowReturn
+_finish_gop (GESSmartCutter * self)
+{
+  guint64 bytes;
+  gboolean open;
+  GstClockTime start, stop;
+  GstSegment *segment = &self->segment;
+  GstFlowReturn ret;
+
+  if (g_queue_is_empty (&self->gop)) {
+    self->in_gop = FALSE;
+
+    return GST_FLOW_OK;
+  }
+
+  _gop_get_range (self, &start, &stop, &bytes, &open);
+  if (!GST_CLOCK_TIME_IS_VALID (start)) {
+    GST_DEBUG_OBJECT (self, "GOP without timestamps, pushing it as it is");
+    ret = _push_gop (self, FALSE);
+    self->previous_altered = FALSE;
+  } else if (stop <= segment->start || (GST_CLOCK_TIME_IS_VALID (segment->stop)
+          && start >= segment->stop)) {
+    GST_LOG_OBJECT (self, "Dropping GOP %" GST_TIME_FORMAT " - %"
+        GST_TIME_FORMAT, GST_TIME_ARGS (start), GST_TIME_ARGS (stop));
+    ret = _push_gop (self, TRUE);
+    self->previous_altered = TRUE;
+    g_atomic_int_inc (&self->dropped_gops);
+  } else if (start >= segment->start && (!GST_CLOCK_TIME_IS_VALID
+          (segment->stop) || stop <= segment->stop)
+      && !(open && self->previous_altered)
+      && _can_pass_gop (self, bytes, stop - start)) {
+    GST_LOG_OBJECT (self, "Passing GOP %" GST_TIME_FORMAT " - %"
+        GST_TIME_FORMAT " through", GST_TIME_ARGS (start),
+        GST_TIME_ARGS (stop));
+    ret = _push_gop (self, FALSE);
+    self->previous_altered = FALSE;
+    g_atomic_int_inc (&self->passed_gops);
+  } else {
+    GST_DEBUG_OBJECT (self, "Encoding GOP %" GST_TIME_FORMAT " - %"
+        GST_TIME_FORMAT " again (open: %d)", GST_TIME_ARGS (start),
+        GST_TIME_ARGS (stop), open);
+    ret = _reencode_gop (self, bytes, stop - start);
+    self->previous_altered = TRUE;
+    g_atomic_int_inc (&self->reencoded_gops);
+  }
+  self->in_gop = FALSE;
+
+  return ret;
+}
+
+/* Finishes the current GOP and drains the re-encoding chain when the whole
+ * stream is encoded again */
+static GstFlowReturn
+_finish_stream (GESSmartCutter * self)
+{
+  GstFlowReturn ret = _finish_gop (self);
+
+  if (!self->chain_started)
+    return ret;
+
+  _stop_chain (self, ret == GST_FLOW_OK);
+  if (ret == GST_FLOW_OK)
+    return _push_encoded (self);
+
+  g_queue_clear_full (&self->encoded, (GDestroyNotify) gst_buffer_unref);
+
+  return ret;
+}
+
+static gboolean
+_is_cutting (GESSmartCutter * self)
+{
+  return self->caps && self->segment.format == GST_FORMAT_TIME
+      && self->segment.rate > 0;
+}
+
+static GstFlowReturn
+ges_smart_cutter_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  GESSmartCutter *self = GES_SMART_CUTTER (parent);
+
+  if (!_is_cutting (self))
+    return gst_pad_push (self->srcpad, buffer);
+
+  if (GST_BUFFER_PTS_IS_VALID (buffer) && GST_BUFFER_DTS_IS_VALID (buffer)
+      && GST_BUFFER_PTS (buffer) > GST_BUFFER_DTS (buffer))
+    self->dts_delay = MAX (self->dts_delay,
+        GST_BUFFER_PTS (buffer) - GST_BUFFER_DTS (buffer));
+
+  if (!GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT)) {
+    ret = _finish_gop (self);
+    self->in_gop = TRUE;
+  } else if (!self->in_gop) {
+    GST_DEBUG_OBJECT (self, "Dropping %" GST_PTR_FORMAT " as it does not"
+        " follow a keyframe", buffer);
+    gst_buffer_unref (buffer);
+
+    return GST_FLOW_OK;
+  }
+
+  g_queue_push_tail (&self->gop, buffer);
+
+  return ret;
+}
+
+static void
+_set_caps (GESSmartCutter * self, GstCaps * caps)
+{
+  GstCaps *encoding_caps = _get_encoding_caps (caps);
+
+  if (!self->encoding_caps
+      || !gst_caps_is_equal (encoding_caps, self->encoding_caps)) {
+    _teardown_chain (self);
+    self->cannot_reencode = FALSE;
+  }
+
+  /* The encoded GOPs need to be checked against the new codec_data, and the
+   * new parameter sets pushed */
+  if (!self->caps || !gst_caps_is_equal (caps, self->caps)) {
+    self->splice_checked = self->reencode_all = FALSE;
+    self->stream_parameter_sets = FALSE;
+  }
+
+  gst_caps_replace (&self->caps, caps);
+  gst_caps_replace (&self->output_caps, caps);
+  gst_caps_replace (&self->encoding_caps, encoding_caps);
+  gst_caps_unref (encoding_caps);
+}
+
+static gboolean
+ges_smart_cutter_sink_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  GESSmartCutter *self = GES_SMART_CUTTER (parent);
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_FLUSH_STOP:
+      _clear_gop (self);
+      _stop_chain (self, FALSE);
+      g_queue_clear_full (&self->encoded, (GDestroyNotify) gst_buffer_unref);
+      gst_segment_init (&self->segment, GST_FORMAT_UNDEFINED);
+      self->last_dts = GST_CLOCK_TIME_NONE;
+      break;
+    case GST_EVENT_CAPS:
+    {
+      GstCaps *caps;
+
+      _finish_stream (self);
+      gst_event_parse_caps (event, &caps);
+      _set_caps (self, caps);
+      break;
+    }
+    case GST_EVENT_SEGMENT:
+      _finish_stream (self);
+      gst_event_copy_segment (event, &self->segment);
+      /* An open GOP can't reference frames from before the seek */
+      self->previous_altered = TRUE;
+      self->last_dts = GST_CLOCK_TIME_NONE;
+      break;
+    case GST_EVENT_STREAM_START:
+    case GST_EVENT_SEGMENT_DONE:
+    case GST_EVENT_EOS:
+      _finish_stream (self);
+      break;
+    default:
+      if (GST_EVENT_IS_SERIALIZED (event) && self->in_gop) {
+        g_queue_push_tail (&self->gop, event);
+
+        return TRUE;
+      }
+      break;
+  }
+
+  return gst_pad_event_default (pad, parent, event);
+}
+
+static void
+_reset (GESSmartCutter * self)
+{
+  GST_INFO_OBJECT (self, "GOPs passed through: %d, encoded again: %d,"
+      " dropped: %d", g_atomic_int_get (&self->passed_gops),
+      g_atomic_int_get (&self->reencoded_gops),
+      g_atomic_int_get (&self->dropped_gops));
+
+  _clear_gop (self);
+  _teardown_chain (self);
+  gst_segment_init (&self->segment, GST_FORMAT_UNDEFINED);
+  gst_clear_caps (&self->caps);
+  gst_clear_caps (&self->encoding_caps);
+  gst_clear_caps (&self->output_caps);
+  self->cannot_reencode = FALSE;
+  self->splice_checked = self->reencode_all = FALSE;
+  self->stream_parameter_sets = FALSE;
+  self->dts_delay = 0;
+  self->last_dts = GST_CLOCK_TIME_NONE;
+  self->dts_shift = 0;
+}
+
+static GstStateChangeReturn
+ges_smart_cutter_change_state (GstElement * element,
+    GstStateChange transition)
+{
+  GstStateChangeReturn ret;
+  GESSmartCutter *self = GES_SMART_CUTTER (element);
+
+  ret = GST_ELEMENT_CLASS (ges_smart_cutter_parent_class)->change_state
+      (element, transition);
+
+  if (transition == GST_STATE_CHANGE_PAUSED_TO_READY)
+    _reset (self);
+
+  return ret;
+}
+
+static void
+ges_smart_cutter_get_property (GObject * object, guint property_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GESSmartCutter *self = GES_SMART_CUTTER (object);
+
+  switch (property_id) {
+    case PROP_PASSED_GOPS:
+      g_value_set_int (value, g_atomic_int_get (&self->passed_gops));
+      break;
+    case PROP_REENCODED_GOPS:
+      g_value_set_int (value, g_atomic_int_get (&self->reencoded_gops));
+      break;
+    case PROP_DROPPED_GOPS:
+      g_value_set_int (value, g_atomic_int_get (&self->dropped_gops));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+  }
+}
+
+static void
+ges_smart_cutter_finalize (GObject * object)
+{
+  GESSmartCutter *self = GES_SMART_CUTTER (object);
+
+  _reset (self);
+  gst_object_unref (self->internal_srcpad);
+  gst_object_unref (self->internal_sinkpad);
+
+  G_OBJECT_CLASS (ges_smart_cutter_parent_class)->finalize (object);
+}
+
+static void
+ges_smart_cutter_class_init (GESSmartCutterClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+
+  GST_DEBUG_CATEGORY_INIT (ges_smart_cutter_debug, "gessmartcutter", 0,
+      "GES smart cutter");
+
+  object_class->get_property = ges_smart_cutter_get_property;
+  object_class->finalize = ges_smart_cutter_finalize;
+
+  g_object_class_install_property (object_class, PROP_PASSED_GOPS,
+      g_param_spec_int ("passed-gops", "Passed GOPs",
+          "Number of GOPs passed through", 0, G_MAXINT, 0,
+          G_PARAM_READABLE));
+  g_object_class_install_property (object_class, PROP_REENCODED_GOPS,
+      g_param_spec_int ("reencoded-gops", "Re-encoded GOPs",
+          "Number of GOPs encoded again", 0, G_MAXINT, 0, G_PARAM_READABLE));
+  g_object_class_install_property (object_class, PROP_DROPPED_GOPS,
+      g_param_spec_int ("dropped-gops", "Dropped GOPs",
+          "Number of GOPs outside of the segment", 0, G_MAXINT, 0,
+          G_PARAM_READABLE));
+
+  gst_element_class_add_static_pad_template (element_class, &sink_template);
+  gst_element_class_add_static_pad_template (element_class, &src_template);
+  gst_element_class_set_static_metadata (element_class,
+      "GES smart cutter", "Filter/Editor/Video",
+      "Only encodes again the GOPs crossing the edges of the segment",
+      "GStreamer maintainers <gstreamer-devel@lists.freedesktop.org>");
+
+  element_class->change_state =
+      GST_DEBUG_FUNCPTR (ges_smart_cutter_change_state);
+}
+
+static void
+ges_smart_cutter_init (GESSmartCutter * self)
+{
+  self->sinkpad = gst_pad_new_from_static_template (&sink_template, "sink");
+  gst_pad_set_chain_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (ges_smart_cutter_chain));
+  gst_pad_set_event_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (ges_smart_cutter_sink_event));
+  GST_PAD_SET_PROXY_CAPS (self->sinkpad);
+  gst_element_add_pad (GST_ELEMENT (self), self->sinkpad);
+
+  self->srcpad = gst_pad_new_from_static_template (&src_template, "src");
+  GST_PAD_SET_PROXY_CAPS (self->srcpad);
+  gst_element_add_pad (GST_ELEMENT (self), self->srcpad);
+
+  self->internal_srcpad =
+      gst_object_ref_sink (gst_pad_new ("internal_src", GST_PAD_SRC));
+  self->internal_sinkpad =
+      gst_object_ref_sink (gst_pad_new ("internal_sink", GST_PAD_SINK));
+  gst_pad_set_element_private (self->internal_sinkpad, self);
+  gst_pad_set_chain_function (self->internal_sinkpad,
+      GST_DEBUG_FUNCPTR (_encoded_chain));
+  gst_pad_set_event_function (self->internal_sinkpad,
+      GST_DEBUG_FUNCPTR (_encoded_event));
+  gst_pad_set_query_function (self->internal_sinkpad,
+      GST_DEBUG_FUNCPTR (_encoded_query));
+
+  gst_segment_init (&self->segment, GST_FORMAT_UNDEFINED);
+  g_queue_init (&self->gop);
+  g_queue_init (&self->encoded);
+  self->last_dts = GST_CLOCK_TIME_NONE;
+}
+
+/* Whether @caps are encoded video that a smart cutter can cut */
+gboolean
+ges_smart_cutter_can_cut (const GstCaps * caps)
+{
+  const gchar *name;
+
+  if (!caps || gst_caps_is_empty (caps) || gst_caps_is_any (caps))
+    return FALSE;
+
+  name = gst_structure_get_name (gst_caps_get_structure (caps, 0));
+
+  return g_str_has_prefix (name, "video/") && g_strcmp0 (name, "video/x-raw");
+}
+
+GstElement *
+ges_smart_cutter_new (void)
+{
+  return g_object_new (GES_TYPE_SMART_CUTTER, NULL);
+}
@@ -25,6 +25,12 @@
 #include "ges-internal.h"
 #include "ges-smart-video-mixer.h"
 #include <gst/base/base.h>
+#include <gst/video/video.h>
+#include <string.h>
+
+/* Values of GstCompositorOperator */
+#define COMPOSITOR_OPERATOR_SOURCE 0
+#define COMPOSITOR_OPERATOR_OVER 1
 
 #define GES_TYPE_SMART_MIXER_PAD             (ges_smart_mixer_pad_get_type ())
 typedef struct _GESSmartMixerPad GESSmartMixerPad;
@@ -129,6 +135,20 @@ typedef struct _PadInfos
   GESSmartMixer *self;
   GstPad *mixer_pad;
   GstPad *ghostpad;
+
+  /* The "operator" enum type of mixer_pad, if it has one */
+  GType operator_type;
+
+  /* Values last set on mixer_pad, only accessed from the streaming thread
+   * of the mixer */
+  gboolean applied;
+  gdouble alpha;
+  guint zorder;
+  gint posx;
+  gint posy;
+  gint width;
+  gint height;
+  gint operator;
 } PadInfos;
 
 static void
@@ -201,13 +221,118 @@ ges_smart_mixer_get_mixer_pad (GESSmartMixer * self, GstPad ** mixerpad)
   return sinkpad;
 }
 
+typedef struct
+{
+  GESSmartMixer *self;
+  gint out_width;
+  gint out_height;
+
+  /* Highest zorder of the pads completely covering the output */
+  gboolean has_occluder;
+  guint occluder_zorder;
+} SyncData;
+
+/* Whether the frame of @sample hides everything below it in the output */
+static gboolean
+positioner_meta_is_occluding (GstFramePositionerMeta * meta,
+    GstSample * sample, SyncData * data)
+{
+  GstVideoInfo info;
+  GstCaps *caps = gst_sample_get_caps (sample);
+
+  if (meta->posx > 0 || meta->posy > 0 ||
+      meta->posx + meta->width < data->out_width ||
+      meta->posy + meta->height < data->out_height)
+    return FALSE;
+
+  if (meta->operator == COMPOSITOR_OPERATOR_SOURCE)
+    return TRUE;
+
+  if (meta->operator != COMPOSITOR_OPERATOR_OVER || meta->alpha < 1.0 ||
+      !caps || !gst_video_info_from_caps (&info, caps))
+    return FALSE;
+
+  return !GST_VIDEO_INFO_HAS_ALPHA (&info);
+}
+
+#define MAX_PAD_PROPERTIES 7
+
+typedef struct
+{
+  guint n;
+  const gchar *names[MAX_PAD_PROPERTIES];
+  GValue values[MAX_PAD_PROPERTIES];
+} PadProperties;
+
+static GValue *
+pad_properties_add (PadProperties * props, const gchar * name, GType type)
+{
+  GValue *value = &props->values[props->n];
+
+  props->names[props->n++] = name;
+  memset (value, 0, sizeof (GValue));
+
+  return g_value_init (value, type);
+}
+
+/* Only sets the properties of the mixer pad that changed since the previous
+ * frame, all at once. Setting them one by one with g_object_set() for each
+ * pad of each frame is costly with many layers. @zorder is not set if
+ * negative and only @alpha is set if @meta is %NULL. */
+static void
+pad_infos_apply (PadInfos * info, gdouble alpha, gint zorder,
+    GstFramePositionerMeta * meta)
+{
+  guint i;
+  PadProperties props;
+
+  props.n = 0;
+  if (!info->applied || info->alpha != alpha)
+    g_value_set_double (pad_properties_add (&props, "alpha", G_TYPE_DOUBLE),
+        info->alpha = alpha);
+
+  if (zorder >= 0 && (!info->applied || info->zorder != zorder))
+    g_value_set_uint (pad_properties_add (&props, "zorder", G_TYPE_UINT),
+        info->zorder = zorder);
+
+  if (meta) {
+    if (!info->applied || info->posx != meta->posx)
+      g_value_set_int (pad_properties_add (&props, "xpos", G_TYPE_INT),
+          info->posx = meta->posx);
+    if (!info->applied || info->posy != meta->posy)
+      g_value_set_int (pad_properties_add (&props, "ypos", G_TYPE_INT),
+          info->posy = meta->posy);
+    if (!info->applied || info->width != meta->width)
+      g_value_set_int (pad_properties_add (&props, "width", G_TYPE_INT),
+          info->width = meta->width);
+    if (!info->applied || info->height != meta->height)
+      g_value_set_int (pad_properties_add (&props, "height", G_TYPE_INT),
+          info->height = meta->height);
+    if (info->operator_type &&
+        (!info->applied || info->operator != meta->operator))
+      g_value_set_enum (pad_properties_add (&props, "operator",
+              info->operator_type), info->operator = meta->operator);
+    info->applied = TRUE;
+  }
+
+  if (!props.n)
+    return;
+
+  GST_LOG_OBJECT (info->mixer_pad, "Setting %u properties", props.n);
+  g_object_setv (G_OBJECT (info->mixer_pad), props.n, props.names,
+      props.values);
+  for (i = 0; i < props.n; i++)
+    g_value_unset (&props.values[i]);
+}
+
 static void
-set_pad_properties_from_positioner_meta (GstPad * mixer_pad, GstSample * sample,
-    GESSmartMixerPad * ghost)
+set_pad_properties_from_positioner_meta (PadInfos * info, GstSample * sample,
+    SyncData * data)
 {
   GstFramePositionerMeta *meta;
   GstBuffer *buf = gst_sample_get_buffer (sample);
-  GESSmartMixer *self = GES_SMART_MIXER (GST_OBJECT_PARENT (ghost));
+  GESSmartMixerPad *ghost = GES_SMART_MIXER_PAD (info->ghostpad);
+  GESSmartMixer *self = info->self;
 
   meta =
       (GstFramePositionerMeta *) gst_buffer_get_meta (buf,
@@ -219,11 +344,15 @@ set_pad_properties_from_positioner_meta (GstPad * mixer_pad, GstSample * sample,
   }
 
   if (!self->is_transition) {
-    g_object_set (mixer_pad, "alpha", meta->alpha,
-        "zorder", meta->zorder, NULL);
+    pad_infos_apply (info, meta->alpha, meta->zorder, meta);
+
+    if (data->out_width && positioner_meta_is_occluding (meta, sample, data)
+        && (!data->has_occluder || meta->zorder > data->occluder_zorder)) {
+      data->has_occluder = TRUE;
+      data->occluder_zorder = meta->zorder;
+    }
   } else {
     gint64 stream_time;
-    gdouble transalpha;
 
     stream_time = gst_segment_to_stream_time (gst_sample_get_segment (sample),
         GST_FORMAT_TIME, GST_BUFFER_PTS (buf));
@@ -233,13 +362,8 @@ set_pad_properties_from_positioner_meta (GstPad * mixer_pad, GstSample * sample,
     if (GST_CLOCK_TIME_IS_VALID (stream_time))
       gst_object_sync_values (GST_OBJECT (ghost), stream_time);
 
-    g_object_get (ghost, "alpha", &transalpha, NULL);
-    g_object_set (mixer_pad, "alpha", meta->alpha * transalpha, NULL);
+    pad_infos_apply (info, meta->alpha * ghost->alpha, -1, meta);
   }
-
-  g_object_set (mixer_pad, "xpos", meta->posx, "ypos",
-      meta->posy, "width", meta->width, "height", meta->height,
-      "operator", meta->operator, NULL);
 }
 
 /****************************************************
@@ -251,6 +375,7 @@ _request_new_pad (GstElement * element, GstPadTemplate * templ,
 {
   PadInfos *infos = pad_infos_new ();
   GESSmartMixer *self = GES_SMART_MIXER (element);
+  GParamSpec *pspec;
   GstPad *ghost;
 
   infos->mixer_pad = gst_element_request_pad (self->mixer,
@@ -265,6 +390,10 @@ _request_new_pad (GstElement * element, GstPadTemplate * templ,
   }
 
   infos->self = self;
+  pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (infos->mixer_pad),
+      "operator");
+  if (pspec)
+    infos->operator_type = G_PARAM_SPEC_VALUE_TYPE (pspec);
 
   ghost = g_object_new (ges_smart_mixer_pad_get_type (), "name", name,
       "direction", GST_PAD_DIRECTION (infos->mixer_pad), NULL);
@@ -336,8 +465,9 @@ _release_pad (GstElement * element, GstPad * pad)
 
 static gboolean
 compositor_sync_properties_with_meta (GstElement * compositor,
-    GstPad * sinkpad, GESSmartMixer * self)
+    GstPad * sinkpad, SyncData * data)
 {
+  GESSmartMixer *self = data->self;
   PadInfos *info = ges_smart_mixer_find_pad_info (self, sinkpad);
   GstSample *sample;
 
@@ -351,8 +481,7 @@ compositor_sync_properties_with_meta (GstElement * compositor,
       GST_AGGREGATOR_PAD (sinkpad));
 
   if (sample) {
-    set_pad_properties_from_positioner_meta (sinkpad,
-        sample, GES_SMART_MIXER_PAD (info->ghostpad));
+    set_pad_properties_from_positioner_meta (info, sample, data);
     gst_sample_unref (sample);
   } else {
     GST_INFO_OBJECT (sinkpad, "No sample set!");
@@ -362,13 +491,54 @@ compositor_sync_properties_with_meta (GstElement * compositor,
   return TRUE;
 }
 
+/* Pads with an alpha of 0 are neither converted nor blended by the
+ * compositor. The alpha of all pads is set again from their positioner
+ * meta for each output frame, so culled pads come back by themselves. */
+static gboolean
+compositor_cull_occluded_pad (GstElement * compositor, GstPad * sinkpad,
+    SyncData * data)
+{
+  PadInfos *info = ges_smart_mixer_find_pad_info (data->self, sinkpad);
+
+  if (info && info->applied && info->zorder < data->occluder_zorder) {
+    GST_LOG_OBJECT (sinkpad, "Occluded by zorder %u, skipping it",
+        data->occluder_zorder);
+    pad_infos_apply (info, 0.0, -1, NULL);
+  }
+  g_clear_pointer (&info, pad_infos_unref);
+
+  return TRUE;
+}
+
 static void
 ges_smart_mixer_samples_selected_cb (GstElement * compositor,
     GstSegment * segment, GstClockTime pts, GstClockTime dts,
     GstClockTime duration, GstStructure * info, GESSmartMixer * self)
 {
+  SyncData data = { self, 0, 0, FALSE, 0 };
+  GESTimeline *timeline = self->track ?
+      ges_track_get_timeline (self->track) : NULL;
+
+  if (self->can_cull && timeline && timeline_get_occlusion_culling (timeline)) {
+    GstCaps *caps = gst_pad_get_current_caps (GST_AGGREGATOR_SRC_PAD
+        (compositor));
+
+    if (caps) {
+      GstStructure *structure = gst_caps_get_structure (caps, 0);
+
+      if (!gst_structure_get_int (structure, "width", &data.out_width) ||
+          !gst_structure_get_int (structure, "height", &data.out_height))
+        data.out_width = data.out_height = 0;
+      gst_caps_unref (caps);
+    }
+  }
+
   gst_element_foreach_sink_pad (compositor,
-      (GstElementForeachPadFunc) compositor_sync_properties_with_meta, self);
+      (GstElementForeachPadFunc) compositor_sync_properties_with_meta, &data);
+
+  if (data.has_occluder)
+    gst_element_foreach_sink_pad (compositor,
+        (GstElementForeachPadFunc) compositor_cull_occluded_pad, &data);
 }
 
 /****************************************************
@@ -418,6 +588,7 @@ ges_smart_mixer_constructed (GObject * obj)
   }
 
   g_object_set (mixer, "background", 1, "emit-signals", TRUE, NULL);
+  self->can_cull = GST_IS_AGGREGATOR (mixer);
   g_signal_connect (mixer, "samples-selected",
       G_CALLBACK (ges_smart_mixer_samples_selected_cb), self);
   gst_object_unref (mixer);
@@ -479,6 +650,9 @@ ges_smart_mixer_new (GESTrack * track)
 {
   GESSmartMixer *self = g_object_new (GES_TYPE_SMART_MIXER, NULL);
 
+  /* The track owns the composition holding the mixer */
+  self->track = track;
+
   /* FIXME Make mixer smart and let it properly negotiate caps! */
   return GST_ELEMENT (self);
 }
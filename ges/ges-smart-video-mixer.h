@@ -55,6 +55,14 @@ struct _GESSmartMixer
   GstCaps *caps;
   gboolean is_transition;
 
+  /* The track the mixer composites, NULL in transitions */
+  GESTrack *track;
+
+  /* Whether GES drives the pads of a real compositor, so that pads hidden
+   * by an opaque full frame pad above them can be skipped when the
+   * GESTimeline:occlusion-culling of the timeline of the track is set */
+  gboolean can_cull;
+
   gpointer _ges_reserved[GES_PADDING];
 };
 
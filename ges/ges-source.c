@@ -39,42 +39,491 @@ struct _GESSourcePrivate
   GstElement *first_converter;
   GstElement *last_converter;
   GstPad *ghostpad;
+  GstElement *smart_cutter;
 
   gboolean is_rendering_smartly;
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (GESSource, ges_source, GES_TYPE_TRACK_ELEMENT);
 
+static void _set_ghost_pad_target (GESSource * self, GstPad * srcpad,
+    GstElement * element);
+
 /******************************
  *   Internal helper methods  *
  ******************************/
+static void
+link_element (GstElement * prev, GstElement * element)
+{
+  if (!gst_element_link_pads_full (prev, "src", element, "sink",
+          GST_PAD_LINK_CHECK_NOTHING)) {
+    if (!gst_element_link (prev, element)) {
+      g_error ("Could not link %s and %s", GST_OBJECT_NAME (prev),
+          GST_OBJECT_NAME (element));
+    }
+  }
+}
+
+/*
+ * Lazy sources
+ *
+ * With big timelines, the conversion elements of the sources add up to a
+ * lot of memory even though only the few sources around the playhead are
+ * used at a time. When the #GESTimeline:warm-sources of a timeline is not
+ * the default, the elements created with ges_source_make_converter() for
+ * the sources added to it are released and only instantiated again when
+ * the composition prerolls the source. The elements holding some state,
+ * like the ones exposing children properties, are always kept. By default,
+ * the sources are built right away and keep all their elements.
+ *
+ * The converters of a source are kept when it stops being used so that the
+ * next stacks can reuse them right away. At most #GESTimeline:warm-sources
+ * unused sources of a timeline are kept warm. Going over that limit marks
+ * the least recently used ones, which then release their converters
+ * asynchronously, with their own state lock taken, so that it can not race
+ * with them being used again.
+ */
+typedef struct
+{
+  /* Only set for converters */
+  GstElementFactory *factory;
+  gchar *name;
+
+  GstElement *element;
+} LazyElement;
+
+struct _GESWarmSources
+{
+  gint refcount;
+
+  /* Idle GESLazySourceBin-s, least recently used first */
+  GQueue idle;
+  guint max;
+};
+
+/* Protects the GESWarmSources and the idle state of the lazy source bins */
+G_LOCK_DEFINE_STATIC (lazy_sources);
+
+static GQuark
+_converter_quark (void)
+{
+  return g_quark_from_static_string ("ges-source-converter");
+}
+
+static void
+_lazy_element_clear (LazyElement * lazy)
+{
+  gst_clear_object (&lazy->factory);
+  g_clear_pointer (&lazy->name, g_free);
+  gst_clear_object (&lazy->element);
+}
+
+G_DECLARE_FINAL_TYPE (GESLazySourceBin, ges_lazy_source_bin, GES,
+    LAZY_SOURCE_BIN, GstBin);
+
+struct _GESLazySourceBin
+{
+  GstBin parent;
+
+  /* NULL once the source has been disposed */
+  GESSource *source;
+  GstElement *sub_element;
+  GArray *elements;
+
+  /* Protected by the lazy_sources lock */
+  gboolean built;
+  gboolean release_pending;
+  GESWarmSources *warm;
+  GList *idle_link;
+};
+
+#define GES_TYPE_LAZY_SOURCE_BIN (ges_lazy_source_bin_get_type())
+G_DEFINE_TYPE (GESLazySourceBin, ges_lazy_source_bin, GST_TYPE_BIN);
+
+static void
+_lazy_source_bin_build (GESLazySourceBin * self)
+{
+  guint i;
+  GstPad *srcpad;
+  GstElement *prev = NULL;
+  GESSourcePrivate *priv = self->source->priv;
+
+  GST_DEBUG_OBJECT (self->source, "Building converters");
+  for (i = 0; i < self->elements->len; i++) {
+    LazyElement *lazy = &g_array_index (self->elements, LazyElement, i);
+
+    if (!lazy->element) {
+      lazy->element = gst_object_ref_sink (gst_element_factory_create
+          (lazy->factory, lazy->name));
+      gst_bin_add (GST_BIN (self), lazy->element);
+    }
+
+    if (prev) {
+      /* Links between elements that are always kept stay in place */
+      srcpad = gst_element_get_static_pad (prev, "src");
+      if (!srcpad || !gst_pad_is_linked (srcpad))
+        link_element (prev, lazy->element);
+      gst_clear_object (&srcpad);
+    }
+    prev = lazy->element;
+  }
+
+  if (prev) {
+    priv->first_converter =
+        gst_object_ref (g_array_index (self->elements, LazyElement,
+            0).element);
+    priv->last_converter = gst_object_ref (prev);
+  }
+
+  srcpad = gst_element_get_static_pad (self->sub_element, "src");
+  if (srcpad) {
+    _set_ghost_pad_target (self->source, srcpad, self->sub_element);
+    gst_object_unref (srcpad);
+  }
+}
+
+/* With the state lock of @self */
+static void
+_lazy_source_bin_release (GESLazySourceBin * self, GESSource * source)
+{
+  guint i;
+  GstPad *srcpad, *peer;
+
+  GST_DEBUG_OBJECT (source, "Releasing converters");
+  gst_ghost_pad_set_target (GST_GHOST_PAD (source->priv->ghostpad), NULL);
+
+  srcpad = gst_element_get_static_pad (self->sub_element, "src");
+  if (srcpad && (peer = gst_pad_get_peer (srcpad))) {
+    gst_pad_unlink (srcpad, peer);
+    gst_object_unref (peer);
+  }
+  gst_clear_object (&srcpad);
+
+  for (i = 0; i < self->elements->len; i++) {
+    LazyElement *lazy = &g_array_index (self->elements, LazyElement, i);
+
+    if (!lazy->factory || !lazy->element)
+      continue;
+
+    gst_element_set_state (lazy->element, GST_STATE_NULL);
+    gst_bin_remove (GST_BIN (self), lazy->element);
+    gst_clear_object (&lazy->element);
+  }
+
+  gst_clear_object (&source->priv->first_converter);
+  gst_clear_object (&source->priv->last_converter);
+}
+
+/* Called from the thread pool of GStreamer for the bins marked by
+ * _warm_sources_evict() */
+static void
+_lazy_source_bin_release_cb (GstElement * element, gpointer udata)
+{
+  GESSource *source = NULL;
+  GESLazySourceBin *self = GES_LAZY_SOURCE_BIN (element);
+
+  /* No state change can happen meanwhile, a bin being used again before
+   * getting here simply keeps its converters */
+  GST_STATE_LOCK (element);
+  G_LOCK (lazy_sources);
+  if (self->release_pending && self->built && self->source &&
+      GST_STATE (element) <= GST_STATE_READY) {
+    self->built = FALSE;
+    source = gst_object_ref (self->source);
+  }
+  self->release_pending = FALSE;
+  G_UNLOCK (lazy_sources);
+
+  if (source) {
+    _lazy_source_bin_release (self, source);
+    gst_object_unref (source);
+  }
+  GST_STATE_UNLOCK (element);
+}
+
+/* With the lazy_sources lock, returns the bins that got marked */
+static GList *
+_warm_sources_evict (GESWarmSources * warm)
+{
+  GList *evicted = NULL;
+
+  while (warm->idle.length > warm->max) {
+    GESLazySourceBin *oldest = g_queue_pop_head (&warm->idle);
+
+    oldest->idle_link = NULL;
+    oldest->warm = NULL;
+    oldest->release_pending = TRUE;
+    evicted = g_list_prepend (evicted, gst_object_ref (oldest));
+  }
+
+  return evicted;
+}
+
+static void
+_release_evicted (GList * evicted)
+{
+  GList *tmp;
+
+  for (tmp = evicted; tmp; tmp = tmp->next)
+    gst_element_call_async (tmp->data, _lazy_source_bin_release_cb, NULL,
+        NULL);
+  g_list_free_full (evicted, gst_object_unref);
+}
+
+/* With the lazy_sources lock */
+static void
+_lazy_source_bin_unset_idle (GESLazySourceBin * self)
+{
+  if (self->idle_link) {
+    g_queue_delete_link (&self->warm->idle, self->idle_link);
+    self->idle_link = NULL;
+    self->warm = NULL;
+  }
+}
+
+GESWarmSources *
+ges_warm_sources_new (void)
+{
+  GESWarmSources *warm = g_new0 (GESWarmSources, 1);
+
+  warm->refcount = 1;
+  warm->max = G_MAXUINT;
+  g_queue_init (&warm->idle);
+
+  return warm;
+}
+
+GESWarmSources *
+ges_warm_sources_ref (GESWarmSources * warm)
+{
+  g_atomic_int_inc (&warm->refcount);
+
+  return warm;
+}
+
+void
+ges_warm_sources_unref (GESWarmSources * warm)
+{
+  GList *tmp;
+
+  if (!g_atomic_int_dec_and_test (&warm->refcount))
+    return;
+
+  /* The idle bins just stay warm */
+  G_LOCK (lazy_sources);
+  for (tmp = warm->idle.head; tmp; tmp = tmp->next) {
+    GESLazySourceBin *bin = tmp->data;
+
+    bin->idle_link = NULL;
+    bin->warm = NULL;
+  }
+  g_queue_clear (&warm->idle);
+  G_UNLOCK (lazy_sources);
+
+  g_free (warm);
+}
+
+void
+ges_warm_sources_set_max (GESWarmSources * warm, guint max)
+{
+  GList *evicted;
+
+  G_LOCK (lazy_sources);
+  warm->max = max;
+  evicted = _warm_sources_evict (warm);
+  G_UNLOCK (lazy_sources);
+
+  _release_evicted (evicted);
+}
+
+guint
+ges_warm_sources_get_max (GESWarmSources * warm)
+{
+  guint max;
+
+  G_LOCK (lazy_sources);
+  max = warm->max;
+  G_UNLOCK (lazy_sources);
+
+  return max;
+}
+
+static void
+_lazy_source_bin_set_idle (GESLazySourceBin * self)
+{
+  GList *evicted;
+  GESTimeline *timeline;
+  GESWarmSources *warm = NULL;
+
+  G_LOCK (lazy_sources);
+  if (self->source
+      && (timeline = GES_TIMELINE_ELEMENT_GET_TIMELINE (self->source)))
+    warm = timeline_get_warm_sources (timeline);
+
+  if (!warm || !self->built || self->idle_link) {
+    G_UNLOCK (lazy_sources);
+    g_clear_pointer (&warm, ges_warm_sources_unref);
+
+    return;
+  }
+
+  g_queue_push_tail (&warm->idle, self);
+  self->idle_link = warm->idle.tail;
+  self->warm = warm;
+  evicted = _warm_sources_evict (warm);
+  G_UNLOCK (lazy_sources);
+
+  _release_evicted (evicted);
+  ges_warm_sources_unref (warm);
+}
+
+static GstStateChangeReturn
+ges_lazy_source_bin_change_state (GstElement * element,
+    GstStateChange transition)
+{
+  GstStateChangeReturn ret;
+  GESLazySourceBin *self = GES_LAZY_SOURCE_BIN (element);
+
+  if (transition == GST_STATE_CHANGE_READY_TO_PAUSED) {
+    gboolean built;
+
+    G_LOCK (lazy_sources);
+    _lazy_source_bin_unset_idle (self);
+    self->release_pending = FALSE;
+    built = self->built;
+    self->built = TRUE;
+    G_UNLOCK (lazy_sources);
+
+    if (!built && self->source)
+      _lazy_source_bin_build (self);
+  }
+
+  ret = GST_ELEMENT_CLASS (ges_lazy_source_bin_parent_class)->change_state
+      (element, transition);
+
+  if (transition == GST_STATE_CHANGE_PAUSED_TO_READY)
+    _lazy_source_bin_set_idle (self);
+
+  return ret;
+}
+
+static void
+ges_lazy_source_bin_dispose (GObject * object)
+{
+  GESLazySourceBin *self = GES_LAZY_SOURCE_BIN (object);
+
+  G_LOCK (lazy_sources);
+  _lazy_source_bin_unset_idle (self);
+  self->source = NULL;
+  G_UNLOCK (lazy_sources);
+
+  G_OBJECT_CLASS (ges_lazy_source_bin_parent_class)->dispose (object);
+}
+
+static void
+ges_lazy_source_bin_finalize (GObject * object)
+{
+  GESLazySourceBin *self = GES_LAZY_SOURCE_BIN (object);
+
+  g_array_unref (self->elements);
+
+  G_OBJECT_CLASS (ges_lazy_source_bin_parent_class)->finalize (object);
+}
+
+static void
+ges_lazy_source_bin_class_init (GESLazySourceBinClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+
+  object_class->dispose = ges_lazy_source_bin_dispose;
+  object_class->finalize = ges_lazy_source_bin_finalize;
+
+  element_class->change_state =
+      GST_DEBUG_FUNCPTR (ges_lazy_source_bin_change_state);
+}
+
+static void
+ges_lazy_source_bin_init (GESLazySourceBin * self)
+{
+  self->elements = g_array_new (FALSE, TRUE, sizeof (LazyElement));
+  g_array_set_clear_func (self->elements,
+      (GDestroyNotify) _lazy_element_clear);
+}
+
 static GstElement *
-link_elements (GstElement * bin, GPtrArray * elements)
+lazy_source_bin_new (GESSource * source, const gchar * bin_name,
+    GstElement * sub_element, GPtrArray * elements)
 {
-  GstElement *element, *prev = NULL, *first = NULL;
-  gint i;
+  guint i;
+  GESLazySourceBin *self = g_object_new (GES_TYPE_LAZY_SOURCE_BIN,
+      "name", bin_name, NULL);
 
+  self->source = source;
+  self->sub_element = sub_element;
   for (i = 0; i < elements->len; i++) {
-    element = elements->pdata[i];
+    LazyElement lazy = { NULL, };
+    GstElement *element = elements->pdata[i];
+
     if (!element)
       continue;
 
-    gst_bin_add (GST_BIN (bin), element);
-    if (prev) {
-      if (!gst_element_link_pads_full (prev, "src", element, "sink",
-              GST_PAD_LINK_CHECK_NOTHING)) {
-        if (!gst_element_link (prev, element)) {
-          g_error ("Could not link %s and %s", GST_OBJECT_NAME (prev),
-              GST_OBJECT_NAME (element));
-        }
-      }
+    if (g_object_get_qdata (G_OBJECT (element), _converter_quark ())) {
+      lazy.factory = gst_object_ref (gst_element_get_factory (element));
+      lazy.name = gst_object_get_name (GST_OBJECT (element));
+      gst_object_unref (gst_object_ref_sink (element));
+    } else {
+      lazy.element = gst_object_ref (element);
+      gst_bin_add (GST_BIN (self), element);
     }
-    prev = element;
-    if (first == NULL)
-      first = element;
+    g_array_append_val (self->elements, lazy);
+  }
+
+  return GST_ELEMENT (self);
+}
+
+/* Makes the encoded video streams exposed when rendering smartly go through
+ * a smart cutter so that only the GOPs around the edges of the source get
+ * encoded again, returns the pad to target */
+static GstPad *
+_plug_smart_cutter (GESSource * self, GstPad * srcpad)
+{
+  GstCaps *caps;
+  GstPad *sinkpad;
+  gboolean can_cut;
+  GESSourcePrivate *priv = self->priv;
+  GESTimeline *timeline = GES_TIMELINE_ELEMENT_GET_TIMELINE (self);
+
+  if (!timeline || !timeline_get_smart_cut (timeline))
+    return srcpad;
+
+  caps = gst_pad_get_current_caps (srcpad);
+  if (!caps)
+    caps = gst_pad_query_caps (srcpad, NULL);
+  can_cut = ges_smart_cutter_can_cut (caps);
+  gst_caps_unref (caps);
+
+  if (!can_cut)
+    return srcpad;
+
+  /* Reused when the sub element exposes its pads again */
+  if (!priv->smart_cutter) {
+    priv->smart_cutter = gst_object_ref (ges_smart_cutter_new ());
+    gst_bin_add (GST_BIN (priv->topbin), priv->smart_cutter);
+    gst_element_sync_state_with_parent (priv->smart_cutter);
+  }
+
+  sinkpad = gst_element_get_static_pad (priv->smart_cutter, "sink");
+  if (gst_pad_link (srcpad, sinkpad) != GST_PAD_LINK_OK) {
+    GST_WARNING_OBJECT (self, "Could not link %" GST_PTR_FORMAT " to the"
+        " smart cutter", srcpad);
+    gst_object_unref (sinkpad);
+
+    return srcpad;
   }
+  gst_object_unref (sinkpad);
 
-  return prev;
+  return gst_element_get_static_pad (priv->smart_cutter, "src");
 }
 
 static void
@@ -128,24 +577,46 @@ _set_ghost_pad_target (GESSource * self, GstPad * srcpad, GstElement * element)
     gst_object_unref (converter_src);
     gst_object_unref (sinkpad);
   } else {
-    if (!gst_ghost_pad_set_target (GST_GHOST_PAD (priv->ghostpad), srcpad))
+    GstPad *target = srcpad;
+
+    if (priv->is_rendering_smartly)
+      target = _plug_smart_cutter (self, srcpad);
+
+    if (!gst_ghost_pad_set_target (GST_GHOST_PAD (priv->ghostpad), target))
       GST_ERROR_OBJECT (self, "Could not set ghost target");
+
+    if (target != srcpad)
+      gst_object_unref (target);
   }
 
   gst_element_no_more_pads (element);
 }
 
+/* Creates an element of the conversion chain to pass to
+ * ges_source_create_topbin(). Such elements must not hold any state as, with
+ * lazy sources, they are only instantiated while the source is used. */
+GstElement *
+ges_source_make_converter (const gchar * factory_name, const gchar * name)
+{
+  GstElement *element = gst_element_factory_make (factory_name, name);
+
+  if (element)
+    g_object_set_qdata (G_OBJECT (element), _converter_quark (),
+        GINT_TO_POINTER (TRUE));
+
+  return element;
+}
+
 /* @elements: (transfer-full) */
 GstElement *
 ges_source_create_topbin (GESSource * source, const gchar * bin_name,
     GstElement * sub_element, GPtrArray * elements)
 {
-  GstElement *last;
   GstElement *bin;
   GstPad *sub_srcpad;
   GESSourcePrivate *priv = source->priv;
 
-  bin = gst_bin_new (bin_name);
+  bin = lazy_source_bin_new (source, bin_name, sub_element, elements);
   if (!gst_bin_add (GST_BIN (bin), sub_element)) {
     GST_ERROR_OBJECT (source, "Could not add sub element: %" GST_PTR_FORMAT,
         sub_element);
@@ -158,20 +629,14 @@ ges_source_create_topbin (GESSource * source, const gchar * bin_name,
   gst_pad_set_active (priv->ghostpad, TRUE);
   gst_element_add_pad (bin, priv->ghostpad);
   priv->topbin = gst_object_ref (bin);
-  last = link_elements (bin, elements);
-  if (last) {
-    gint i = 0;
 
-    while (!elements->pdata[i])
-      i++;
-
-    priv->first_converter = gst_object_ref (elements->pdata[i]);
-    priv->last_converter = gst_object_ref (last);
-  }
+  /* Links the converters and targets a static pad of the sub element, see
+   * ges_source_release_converters() */
+  GES_LAZY_SOURCE_BIN (bin)->built = TRUE;
+  _lazy_source_bin_build (GES_LAZY_SOURCE_BIN (bin));
 
   sub_srcpad = gst_element_get_static_pad (sub_element, "src");
   if (sub_srcpad) {
-    _set_ghost_pad_target (source, sub_srcpad, sub_element);
     gst_object_unref (sub_srcpad);
   } else {
     GST_INFO_OBJECT (source, "Waiting for pad added");
@@ -183,6 +648,99 @@ ges_source_create_topbin (GESSource * source, const gchar * bin_name,
   return bin;
 }
 
+/* Called when @source gets added to @timeline: if the number of warm sources
+ * of @timeline is limited, the converters of @source are released until it
+ * gets prerolled */
+void
+ges_source_release_converters (GESSource * source, GESTimeline * timeline)
+{
+  guint max;
+  GESWarmSources *warm;
+  GESLazySourceBin *bin;
+
+  if (!source->priv->topbin)
+    return;
+
+  warm = timeline_get_warm_sources (timeline);
+  max = ges_warm_sources_get_max (warm);
+  ges_warm_sources_unref (warm);
+  if (max == G_MAXUINT)
+    return;
+
+  bin = GES_LAZY_SOURCE_BIN (source->priv->topbin);
+  G_LOCK (lazy_sources);
+  bin->release_pending = TRUE;
+  G_UNLOCK (lazy_sources);
+
+  /* Does nothing if the source is being used */
+  _lazy_source_bin_release_cb (GST_ELEMENT (bin), NULL);
+}
+
+/* Replaces the sub element of @source by @sub_element, only possible while
+ * the source is not used */
+gboolean
+ges_source_replace_sub_element (GESSource * source, GstElement * sub_element)
+{
+  gboolean built;
+  GstPad *srcpad, *peer;
+  GESLazySourceBin *bin;
+  GstElement *old_element;
+  gboolean ret = FALSE;
+  GESSourcePrivate *priv = source->priv;
+
+  g_return_val_if_fail (priv->topbin, FALSE);
+
+  /* Can not race with the converters being released */
+  bin = GES_LAZY_SOURCE_BIN (priv->topbin);
+  GST_STATE_LOCK (bin);
+  if (GST_STATE (bin) > GST_STATE_READY
+      || GST_STATE_PENDING (bin) > GST_STATE_READY) {
+    GST_INFO_OBJECT (source, "Can not replace the sub element while used");
+    goto done;
+  }
+
+  if (!gst_bin_add (GST_BIN (bin), sub_element)) {
+    GST_ERROR_OBJECT (source, "Could not add sub element: %" GST_PTR_FORMAT,
+        sub_element);
+    goto done;
+  }
+
+  old_element = bin->sub_element;
+  g_signal_handlers_disconnect_by_func (old_element, _set_ghost_pad_target,
+      source);
+  srcpad = gst_element_get_static_pad (old_element, "src");
+  if (srcpad && (peer = gst_pad_get_peer (srcpad))) {
+    gst_pad_unlink (srcpad, peer);
+    gst_object_unref (peer);
+  }
+  if (srcpad && !priv->first_converter)
+    gst_ghost_pad_set_target (GST_GHOST_PAD (priv->ghostpad), NULL);
+  gst_clear_object (&srcpad);
+  gst_element_set_state (old_element, GST_STATE_NULL);
+  gst_bin_remove (GST_BIN (bin), old_element);
+
+  bin->sub_element = sub_element;
+
+  G_LOCK (lazy_sources);
+  built = bin->built;
+  G_UNLOCK (lazy_sources);
+
+  srcpad = gst_element_get_static_pad (sub_element, "src");
+  if (!srcpad) {
+    g_signal_connect_swapped (sub_element, "pad-added",
+        G_CALLBACK (_set_ghost_pad_target), source);
+  } else {
+    if (built)
+      _set_ghost_pad_target (source, srcpad, sub_element);
+    gst_object_unref (srcpad);
+  }
+  ret = TRUE;
+
+done:
+  GST_STATE_UNLOCK (bin);
+
+  return ret;
+}
 
 void
 ges_source_set_rendering_smartly (GESSource * source,
@@ -213,8 +771,15 @@ ges_source_dispose (GObject * object)
 {
   GESSourcePrivate *priv = GES_SOURCE (object)->priv;
 
+  if (priv->topbin) {
+    G_LOCK (lazy_sources);
+    GES_LAZY_SOURCE_BIN (priv->topbin)->source = NULL;
+    G_UNLOCK (lazy_sources);
+  }
+
   gst_clear_object (&priv->first_converter);
   gst_clear_object (&priv->last_converter);
+  gst_clear_object (&priv->smart_cutter);
   gst_clear_object (&priv->topbin);
   gst_clear_object (&priv->ghostpad);
 
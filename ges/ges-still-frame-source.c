@@ -0,0 +1,882 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Still frames
+ *
+ * Sources with a static content, like titles and images, used to run their
+ * whole rendering chain for every frame, or for every clip in the case of
+ * images. Their source element is wrapped in a GESStillFrameBin which, each
+ * time it prerolls, follows the #GESTimeline:still-frames property of the
+ * timeline of the source. When it is set, the regular chain gets replaced
+ * by a GESStillFrameSource: the element rendering the content, the
+ * renderer, lives in a private pipeline where it renders a single frame at
+ * the negotiated caps, and that frame is then pushed for the whole segment.
+ *
+ * Frames are cached process wide, keyed on the caps and on the values of
+ * the properties of the renderer elements, so that clips with the same
+ * content share a single buffer and only the first one renders it. A frame
+ * stays cached as long as a source uses it.
+ *
+ * The frame is rendered again whenever a property of the renderer changes,
+ * including through keyframes: the control bindings of the renderer
+ * elements are synced at the time of each outgoing frame. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/base/gstpushsrc.h>
+#include <gst/video/video.h>
+
+#include "ges-internal.h"
+#include "ges-track-element.h"
+#include "ges-video-source.h"
+
+/* Maximum time to wait for the renderer to preroll */
+#define RENDER_TIMEOUT (10 * GST_SECOND)
+
+G_LOCK_DEFINE_STATIC (still_frames);
+/* Cache key -> GstBuffer */
+static GHashTable *still_frames = NULL;
+
+G_DECLARE_FINAL_TYPE (GESStillFrameSource, ges_still_frame_source, GES,
+    STILL_FRAME_SOURCE, GstPushSrc);
+
+struct _GESStillFrameSource
+{
+  GstPushSrc parent;
+
+  /* The GESTrackElement the source belongs to */
+  GWeakRef owner;
+
+  /* renderer ! capsfilter ! fakesink */
+  GstElement *pipeline;
+  GstElement *renderer;
+  GstElement *capsfilter;
+  GstElement *sink;
+
+  /* Set when a property of the renderer changed */
+  gint dirty;
+
+  GstVideoInfo info;
+  gchar *key;
+  GstBuffer *frame;
+
+  GstClockTime seek_position;
+  gboolean needs_seek;
+  gint64 n_frames;
+};
+
+#define GES_TYPE_STILL_FRAME_SOURCE (ges_still_frame_source_get_type())
+G_DEFINE_TYPE (GESStillFrameSource, ges_still_frame_source, GST_TYPE_PUSH_SRC);
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC, GST_PAD_ALWAYS, GST_STATIC_CAPS ("video/x-raw(ANY)"));
+
+static gboolean
+_remove_unused_frame (gpointer key, GstBuffer * frame, gpointer udata)
+{
+  return GST_MINI_OBJECT_REFCOUNT_VALUE (frame) == 1;
+}
+
+static GstBuffer *
+_still_frames_lookup (const gchar * key)
+{
+  GstBuffer *frame = NULL;
+
+  G_LOCK (still_frames);
+  if (still_frames)
+    frame = g_hash_table_lookup (still_frames, key);
+  if (frame)
+    gst_buffer_ref (frame);
+  G_UNLOCK (still_frames);
+
+  return frame;
+}
+
+static void
+_still_frames_insert (const gchar * key, GstBuffer * frame)
+{
+  G_LOCK (still_frames);
+  if (!still_frames)
+    still_frames = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+        (GDestroyNotify) gst_buffer_unref);
+
+  /* Only the sources using a frame keep it alive */
+  g_hash_table_foreach_remove (still_frames, (GHRFunc) _remove_unused_frame,
+      NULL);
+  g_hash_table_insert (still_frames, g_strdup (key), gst_buffer_ref (frame));
+  G_UNLOCK (still_frames);
+}
+
+static void
+_foreach_renderer_element (GESStillFrameSource * self, GFunc func,
+    gpointer udata)
+{
+  GstIterator *it;
+  GValue item = G_VALUE_INIT;
+  gboolean done = FALSE;
+
+  if (!GST_IS_BIN (self->renderer)) {
+    func (self->renderer, udata);
+    return;
+  }
+
+  it = gst_bin_iterate_elements (GST_BIN (self->renderer));
+  while (!done) {
+    switch (gst_iterator_next (it, &item)) {
+      case GST_ITERATOR_OK:
+        func (g_value_get_object (&item), udata);
+        g_value_reset (&item);
+        break;
+      case GST_ITERATOR_RESYNC:
+        gst_iterator_resync (it);
+        break;
+      default:
+        done = TRUE;
+        break;
+    }
+  }
+  g_value_unset (&item);
+  gst_iterator_free (it);
+}
+
+static void
+_append_properties (GstElement * element, GString * key)
+{
+  guint i, n_pspecs;
+  GParamSpec **pspecs =
+      g_object_class_list_properties (G_OBJECT_GET_CLASS (element), &n_pspecs);
+
+  g_string_append_printf (key, "|%s", G_OBJECT_TYPE_NAME (element));
+  for (i = 0; i < n_pspecs; i++) {
+    gchar *serialized;
+    GValue value = G_VALUE_INIT;
+    GParamSpec *pspec = pspecs[i];
+
+    /* Skip the name and the parent */
+    if ((pspec->flags & G_PARAM_READWRITE) != G_PARAM_READWRITE ||
+        pspec->flags & G_PARAM_CONSTRUCT_ONLY ||
+        pspec->owner_type == GST_TYPE_OBJECT)
+      continue;
+
+    g_value_init (&value, pspec->value_type);
+    g_object_get_property (G_OBJECT (element), pspec->name, &value);
+    serialized = gst_value_serialize (&value);
+    if (serialized)
+      g_string_append_printf (key, " %s=%s", pspec->name, serialized);
+    g_free (serialized);
+    g_value_unset (&value);
+  }
+
+  g_free (pspecs);
+}
+
+static gchar *
+_compute_key (GESStillFrameSource * self, GstCaps * caps)
+{
+  gchar *caps_str = gst_caps_to_string (caps);
+  GString *key = g_string_new (caps_str);
+
+  g_free (caps_str);
+  _foreach_renderer_element (self, (GFunc) _append_properties, key);
+
+  return g_string_free (key, FALSE);
+}
+
+static void
+_sync_values (GstElement * element, GstClockTime * stream_time)
+{
+  if (gst_object_has_active_control_bindings (GST_OBJECT (element)))
+    gst_object_sync_values (GST_OBJECT (element), *stream_time);
+}
+
+static void
+_disable_control_bindings (GstElement * element, GList ** disabled)
+{
+  if (gst_object_has_active_control_bindings (GST_OBJECT (element))) {
+    gst_object_set_control_bindings_disabled (GST_OBJECT (element), TRUE);
+    *disabled = g_list_prepend (*disabled, gst_object_ref (element));
+  }
+}
+
+static void
+_enable_control_bindings (GstObject * object)
+{
+  gst_object_set_control_bindings_disabled (object, FALSE);
+  gst_object_unref (object);
+}
+
+/* Called from the streaming thread */
+static GstBuffer *
+_render (GESStillFrameSource * self, GstCaps * caps)
+{
+  GstBus *bus;
+  GstMessage *message;
+  GstSample *sample = NULL;
+  GstBuffer *frame = NULL;
+  GList *disabled = NULL;
+
+  GST_DEBUG_OBJECT (self, "Rendering frame with %" GST_PTR_FORMAT, caps);
+
+  /* The values have been synced at the time of the frame, the renderer
+   * elements would sync them again at the time of their own buffers */
+  _foreach_renderer_element (self, (GFunc) _disable_control_bindings,
+      &disabled);
+  g_object_set (self->capsfilter, "caps", caps, NULL);
+
+  bus = gst_element_get_bus (self->pipeline);
+  if (gst_element_set_state (self->pipeline,
+          GST_STATE_PAUSED) == GST_STATE_CHANGE_FAILURE) {
+    message = gst_bus_pop_filtered (bus, GST_MESSAGE_ERROR);
+  } else {
+    message = gst_bus_timed_pop_filtered (bus, RENDER_TIMEOUT,
+        GST_MESSAGE_ASYNC_DONE | GST_MESSAGE_ERROR);
+  }
+
+  if (message && GST_MESSAGE_TYPE (message) == GST_MESSAGE_ASYNC_DONE)
+    g_object_get (self->sink, "last-sample", &sample, NULL);
+
+  if (sample && gst_sample_get_buffer (sample)) {
+    /* Do not keep a buffer of the pool of the renderer around */
+    frame = gst_buffer_copy_deep (gst_sample_get_buffer (sample));
+  } else {
+    GError *err = NULL;
+    gchar *debug = NULL;
+
+    if (message && GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+      gst_message_parse_error (message, &err, &debug);
+
+    GST_ELEMENT_ERROR (self, STREAM, FAILED, (NULL),
+        ("Could not render frame: %s (%s)", err ? err->message :
+            message ? "no frame" : "timed out", GST_STR_NULL (debug)));
+    g_clear_error (&err);
+    g_free (debug);
+  }
+
+  gst_clear_message (&message);
+  if (sample)
+    gst_sample_unref (sample);
+
+  gst_element_set_state (self->pipeline, GST_STATE_READY);
+  while ((message = gst_bus_pop (bus)))
+    gst_message_unref (message);
+  gst_object_unref (bus);
+
+  g_list_free_full (disabled, (GDestroyNotify) _enable_control_bindings);
+
+  return frame;
+}
+
+static gboolean
+_update_frame (GESStillFrameSource * self, GstClockTime stream_time)
+{
+  gchar *key;
+  GstCaps *caps;
+  GstBuffer *frame;
+
+  if (GST_CLOCK_TIME_IS_VALID (stream_time))
+    _foreach_renderer_element (self, (GFunc) _sync_values, &stream_time);
+
+  if (self->frame && !g_atomic_int_compare_and_exchange (&self->dirty, TRUE,
+          FALSE))
+    return TRUE;
+
+  caps = gst_pad_get_current_caps (GST_BASE_SRC_PAD (self));
+  if (!caps)
+    return FALSE;
+
+  key = _compute_key (self, caps);
+  if (!g_strcmp0 (key, self->key)) {
+    g_free (key);
+    gst_caps_unref (caps);
+
+    return TRUE;
+  }
+
+  frame = _still_frames_lookup (key);
+  if (frame) {
+    GST_DEBUG_OBJECT (self, "Reusing cached frame");
+  } else {
+    frame = _render (self, caps);
+    if (frame)
+      _still_frames_insert (key, frame);
+  }
+  gst_caps_unref (caps);
+
+  if (!frame) {
+    g_free (key);
+
+    return FALSE;
+  }
+
+  gst_clear_buffer (&self->frame);
+  self->frame = frame;
+  g_free (self->key);
+  self->key = key;
+
+  return TRUE;
+}
+
+static GstFlowReturn
+ges_still_frame_source_create (GstPushSrc * src, GstBuffer ** buffer)
+{
+  GstClockTime pts, duration = GST_CLOCK_TIME_NONE;
+  GESStillFrameSource *self = GES_STILL_FRAME_SOURCE (src);
+  GstSegment *segment = &GST_BASE_SRC (src)->segment;
+  gint fps_n = GST_VIDEO_INFO_FPS_N (&self->info);
+  gint fps_d = GST_VIDEO_INFO_FPS_D (&self->info);
+
+  if (self->needs_seek) {
+    self->n_frames = fps_n ? gst_util_uint64_scale (self->seek_position,
+        fps_n, fps_d * GST_SECOND) : 0;
+    self->needs_seek = FALSE;
+  }
+
+  if (self->n_frames < 0 || (!fps_n && self->n_frames > 0))
+    return GST_FLOW_EOS;
+
+  pts = fps_n ? gst_util_uint64_scale (self->n_frames, fps_d * GST_SECOND,
+      fps_n) : 0;
+  if (fps_n)
+    duration = gst_util_uint64_scale (self->n_frames + 1, fps_d * GST_SECOND,
+        fps_n) - pts;
+
+  if (segment->rate >= 0.0) {
+    if (GST_CLOCK_TIME_IS_VALID (segment->stop) && pts >= segment->stop)
+      return GST_FLOW_EOS;
+  } else if (GST_CLOCK_TIME_IS_VALID (duration)
+      && pts + duration <= segment->start) {
+    return GST_FLOW_EOS;
+  }
+
+  if (!_update_frame (self, gst_segment_to_stream_time (segment,
+              GST_FORMAT_TIME, pts)))
+    return GST_FLOW_ERROR;
+
+  /* Only the metadata gets copied, the memory is shared */
+  *buffer = gst_buffer_copy (self->frame);
+  GST_BUFFER_PTS (*buffer) = pts;
+  GST_BUFFER_DTS (*buffer) = GST_CLOCK_TIME_NONE;
+  GST_BUFFER_DURATION (*buffer) = duration;
+  GST_BUFFER_OFFSET (*buffer) = self->n_frames;
+  GST_BUFFER_OFFSET_END (*buffer) = self->n_frames + 1;
+
+  if (segment->rate >= 0.0)
+    self->n_frames++;
+  else
+    self->n_frames--;
+
+  return GST_FLOW_OK;
+}
+
+static GstCaps *
+ges_still_frame_source_get_caps (GstBaseSrc * src, GstCaps * filter)
+{
+  GstCaps *caps;
+  GESStillFrameSource *self = GES_STILL_FRAME_SOURCE (src);
+  GstPad *pad = gst_element_get_static_pad (self->renderer, "src");
+
+  caps = gst_pad_query_caps (pad, filter);
+  gst_object_unref (pad);
+
+  return caps;
+}
+
+static GstCaps *
+ges_still_frame_source_fixate (GstBaseSrc * src, GstCaps * caps)
+{
+  GstStructure *structure;
+  gint width = DEFAULT_WIDTH, height = DEFAULT_HEIGHT;
+  gint fps_n = DEFAULT_FRAMERATE_N, fps_d = DEFAULT_FRAMERATE_D;
+  GESStillFrameSource *self = GES_STILL_FRAME_SOURCE (src);
+  GESTrackElement *owner = g_weak_ref_get (&self->owner);
+
+  /* Render at the natural size of the source if it has one, at the size of
+   * the track otherwise */
+  if (owner) {
+    GESTrack *track = ges_track_element_get_track (owner);
+    gboolean has_natural_size = GES_IS_VIDEO_SOURCE (owner)
+        && ges_video_source_get_natural_size (GES_VIDEO_SOURCE (owner), &width,
+        &height);
+
+    if (track) {
+      GstCaps *restriction = ges_track_get_restriction_caps (track);
+
+      if (restriction && !gst_caps_is_empty (restriction)) {
+        GstStructure *rstructure = gst_caps_get_structure (restriction, 0);
+
+        if (!has_natural_size) {
+          gst_structure_get_int (rstructure, "width", &width);
+          gst_structure_get_int (rstructure, "height", &height);
+        }
+        gst_structure_get_fraction (rstructure, "framerate", &fps_n, &fps_d);
+      }
+      gst_clear_caps (&restriction);
+    }
+    gst_object_unref (owner);
+  }
+
+  caps = gst_caps_truncate (gst_caps_make_writable (caps));
+  structure = gst_caps_get_structure (caps, 0);
+  gst_structure_fixate_field_nearest_int (structure, "width", width);
+  gst_structure_fixate_field_nearest_int (structure, "height", height);
+  gst_structure_fixate_field_nearest_fraction (structure, "framerate", fps_n,
+      fps_d);
+  if (gst_structure_has_field (structure, "pixel-aspect-ratio"))
+    gst_structure_fixate_field_nearest_fraction (structure,
+        "pixel-aspect-ratio", 1, 1);
+
+  return GST_BASE_SRC_CLASS (ges_still_frame_source_parent_class)->fixate (src,
+      caps);
+}
+
+static gboolean
+ges_still_frame_source_set_caps (GstBaseSrc * src, GstCaps * caps)
+{
+  GESStillFrameSource *self = GES_STILL_FRAME_SOURCE (src);
+
+  if (!gst_video_info_from_caps (&self->info, caps)) {
+    GST_ERROR_OBJECT (self, "Invalid caps %" GST_PTR_FORMAT, caps);
+    return FALSE;
+  }
+
+  g_atomic_int_set (&self->dirty, TRUE);
+  /* Frame numbers depend on the framerate */
+  self->seek_position = src->segment.position;
+  self->needs_seek = TRUE;
+
+  return TRUE;
+}
+
+static gboolean
+ges_still_frame_source_do_seek (GstBaseSrc * src, GstSegment * segment)
+{
+  GESStillFrameSource *self = GES_STILL_FRAME_SOURCE (src);
+
+  segment->time = segment->start;
+
+  /* The caps might not be known yet */
+  self->seek_position = segment->position;
+  self->needs_seek = TRUE;
+
+  return TRUE;
+}
+
+static gboolean
+ges_still_frame_source_is_seekable (GstBaseSrc * src)
+{
+  return TRUE;
+}
+
+static gboolean
+ges_still_frame_source_stop (GstBaseSrc * src)
+{
+  GESStillFrameSource *self = GES_STILL_FRAME_SOURCE (src);
+
+  gst_element_set_state (self->pipeline, GST_STATE_NULL);
+  gst_video_info_init (&self->info);
+
+  return TRUE;
+}
+
+static void
+_renderer_deep_notify_cb (GstObject * renderer, GstObject * object,
+    GParamSpec * pspec, GESStillFrameSource * self)
+{
+  /* Whether the value actually changed is checked against the cache key
+   * before the next frame gets pushed */
+  g_atomic_int_set (&self->dirty, TRUE);
+}
+
+static void
+ges_still_frame_source_dispose (GObject * object)
+{
+  GESStillFrameSource *self = GES_STILL_FRAME_SOURCE (object);
+
+  if (self->pipeline) {
+    g_signal_handlers_disconnect_by_func (self->renderer,
+        _renderer_deep_notify_cb, self);
+    gst_element_set_state (self->pipeline, GST_STATE_NULL);
+    gst_clear_object (&self->pipeline);
+  }
+
+  gst_clear_buffer (&self->frame);
+
+  G_OBJECT_CLASS (ges_still_frame_source_parent_class)->dispose (object);
+}
+
+static void
+ges_still_frame_source_finalize (GObject * object)
+{
+  GESStillFrameSource *self = GES_STILL_FRAME_SOURCE (object);
+
+  g_weak_ref_clear (&self->owner);
+  g_free (self->key);
+
+  G_OBJECT_CLASS (ges_still_frame_source_parent_class)->finalize (object);
+}
+
+static void
+ges_still_frame_source_class_init (GESStillFrameSourceClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstBaseSrcClass *basesrc_class = GST_BASE_SRC_CLASS (klass);
+  GstPushSrcClass *pushsrc_class = GST_PUSH_SRC_CLASS (klass);
+
+  object_class->dispose = ges_still_frame_source_dispose;
+  object_class->finalize = ges_still_frame_source_finalize;
+
+  gst_element_class_add_static_pad_template (element_class, &src_template);
+  gst_element_class_set_static_metadata (element_class,
+      "GES still frame source", "Source/Video",
+      "Pushes a single cached frame rendered by its renderer",
+      "GStreamer maintainers <gstreamer-devel@lists.freedesktop.org>");
+
+  basesrc_class->get_caps = ges_still_frame_source_get_caps;
+  basesrc_class->fixate = ges_still_frame_source_fixate;
+  basesrc_class->set_caps = ges_still_frame_source_set_caps;
+  basesrc_class->do_seek = ges_still_frame_source_do_seek;
+  basesrc_class->is_seekable = ges_still_frame_source_is_seekable;
+  basesrc_class->stop = ges_still_frame_source_stop;
+  pushsrc_class->create = ges_still_frame_source_create;
+}
+
+static void
+ges_still_frame_source_init (GESStillFrameSource * self)
+{
+  g_weak_ref_init (&self->owner, NULL);
+  gst_video_info_init (&self->info);
+  self->needs_seek = TRUE;
+
+  gst_base_src_set_format (GST_BASE_SRC (self), GST_FORMAT_TIME);
+}
+
+/* @owner: The #GESTrackElement the source is created for
+ * @renderer: The element rendering the frame, with an always "src" pad,
+ * which gets added to the private pipeline of the source
+ *
+ * Returns: (transfer floating): A source pushing the frame rendered by
+ * @renderer
+ */
+static GstElement *
+_still_frame_source_new (GESTrackElement * owner, GstElement * renderer)
+{
+  GESStillFrameSource *self =
+      g_object_new (GES_TYPE_STILL_FRAME_SOURCE, NULL);
+
+  g_weak_ref_set (&self->owner, owner);
+
+  self->pipeline = gst_object_ref_sink (gst_pipeline_new (NULL));
+  self->renderer = renderer;
+  self->capsfilter = gst_element_factory_make ("capsfilter", NULL);
+  self->sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (self->sink, "sync", FALSE, "enable-last-sample", TRUE, NULL);
+
+  gst_bin_add_many (GST_BIN (self->pipeline), renderer, self->capsfilter,
+      self->sink, NULL);
+  gst_element_link_pads_full (renderer, "src", self->capsfilter, "sink",
+      GST_PAD_LINK_CHECK_NOTHING);
+  gst_element_link (self->capsfilter, self->sink);
+
+  g_signal_connect (renderer, "deep-notify",
+      G_CALLBACK (_renderer_deep_notify_cb), self);
+
+  return GST_ELEMENT (self);
+}
+
+/* Gives the renderer back, @self must be stopped */
+static void
+_still_frame_source_release_renderer (GESStillFrameSource * self)
+{
+  g_signal_handlers_disconnect_by_func (self->renderer,
+      _renderer_deep_notify_cb, self);
+  gst_element_set_state (self->pipeline, GST_STATE_NULL);
+  gst_element_unlink (self->renderer, self->capsfilter);
+  gst_bin_remove (GST_BIN (self->pipeline), self->renderer);
+  gst_clear_object (&self->pipeline);
+}
+
+G_DECLARE_FINAL_TYPE (GESStillFrameBin, ges_still_frame_bin, GES,
+    STILL_FRAME_BIN, GstBin);
+
+struct _GESStillFrameBin
+{
+  GstBin parent;
+
+  GWeakRef owner;
+  GstPad *ghostpad;
+
+  /* The regular chain and the renderer of the still frame, which can be
+   * the same element. Only one of the regular chain and the still frame
+   * source is in the bin at a time */
+  GstElement *element;
+  GstElement *renderer;
+  GstElement *still;
+};
+
+#define GES_TYPE_STILL_FRAME_BIN (ges_still_frame_bin_get_type())
+G_DEFINE_TYPE (GESStillFrameBin, ges_still_frame_bin, GST_TYPE_BIN);
+
+static void
+_still_frame_bin_set_target (GESStillFrameBin * self, GstElement * element)
+{
+  GstPad *pad = gst_element_get_static_pad (element, "src");
+
+  /* Elements with sometimes pads get targeted from _element_pad_added_cb */
+  if (pad) {
+    gst_ghost_pad_set_target (GST_GHOST_PAD (self->ghostpad), pad);
+    gst_object_unref (pad);
+  }
+}
+
+static void
+_element_pad_added_cb (GstElement * element, GstPad * pad,
+    GESStillFrameBin * self)
+{
+  GstPad *target;
+  GESSourceClass *source_klass;
+  GESTrackElement *owner = g_weak_ref_get (&self->owner);
+
+  if (!owner || !GST_PAD_IS_SRC (pad))
+    goto done;
+
+  target = gst_ghost_pad_get_target (GST_GHOST_PAD (self->ghostpad));
+  if (target) {
+    gst_object_unref (target);
+    goto done;
+  }
+
+  source_klass = GES_SOURCE_GET_CLASS (owner);
+  if (source_klass->select_pad
+      && !source_klass->select_pad (GES_SOURCE (owner), pad))
+    goto done;
+
+  gst_ghost_pad_set_target (GST_GHOST_PAD (self->ghostpad), pad);
+
+done:
+  gst_clear_object (&owner);
+}
+
+static void
+_element_pad_removed_cb (GstElement * element, GstPad * pad,
+    GESStillFrameBin * self)
+{
+  GstPad *target = gst_ghost_pad_get_target (GST_GHOST_PAD (self->ghostpad));
+
+  if (target == pad)
+    gst_ghost_pad_set_target (GST_GHOST_PAD (self->ghostpad), NULL);
+  gst_clear_object (&target);
+}
+
+/* Called when prerolling, before the children change their state */
+static void
+_still_frame_bin_update (GESStillFrameBin * self)
+{
+  GESTimeline *timeline;
+  gboolean use_still;
+  GESTrackElement *owner = g_weak_ref_get (&self->owner);
+
+  if (!owner)
+    return;
+
+  timeline = GES_TIMELINE_ELEMENT_GET_TIMELINE (owner);
+  use_still = timeline && timeline_get_still_frames (timeline);
+  if (use_still == (self->still != NULL)) {
+    gst_object_unref (owner);
+    return;
+  }
+
+  GST_DEBUG_OBJECT (owner, "%s still frames",
+      use_still ? "Using" : "Not using");
+  gst_ghost_pad_set_target (GST_GHOST_PAD (self->ghostpad), NULL);
+  if (use_still) {
+    gst_element_set_state (self->element, GST_STATE_NULL);
+    gst_bin_remove (GST_BIN (self), self->element);
+
+    self->still =
+        gst_object_ref (_still_frame_source_new (owner, self->renderer));
+    gst_bin_add (GST_BIN (self), self->still);
+    _still_frame_bin_set_target (self, self->still);
+  } else {
+    gst_element_set_state (self->still, GST_STATE_NULL);
+    gst_bin_remove (GST_BIN (self), self->still);
+    _still_frame_source_release_renderer (GES_STILL_FRAME_SOURCE
+        (self->still));
+    gst_clear_object (&self->still);
+
+    gst_bin_add (GST_BIN (self), self->element);
+    _still_frame_bin_set_target (self, self->element);
+  }
+
+  gst_object_unref (owner);
+}
+
+static GstStateChangeReturn
+ges_still_frame_bin_change_state (GstElement * element,
+    GstStateChange transition)
+{
+  if (transition == GST_STATE_CHANGE_READY_TO_PAUSED)
+    _still_frame_bin_update (GES_STILL_FRAME_BIN (element));
+
+  return GST_ELEMENT_CLASS (ges_still_frame_bin_parent_class)->change_state
+      (element, transition);
+}
+
+static void
+ges_still_frame_bin_dispose (GObject * object)
+{
+  GESStillFrameBin *self = GES_STILL_FRAME_BIN (object);
+
+  if (self->element)
+    g_signal_handlers_disconnect_by_data (self->element, self);
+
+  if (self->still) {
+    gst_element_set_state (self->still, GST_STATE_NULL);
+    _still_frame_source_release_renderer (GES_STILL_FRAME_SOURCE
+        (self->still));
+    gst_clear_object (&self->still);
+  }
+
+  gst_clear_object (&self->element);
+  gst_clear_object (&self->renderer);
+
+  G_OBJECT_CLASS (ges_still_frame_bin_parent_class)->dispose (object);
+}
+
+static void
+ges_still_frame_bin_finalize (GObject * object)
+{
+  GESStillFrameBin *self = GES_STILL_FRAME_BIN (object);
+
+  g_weak_ref_clear (&self->owner);
+
+  G_OBJECT_CLASS (ges_still_frame_bin_parent_class)->finalize (object);
+}
+
+static void
+ges_still_frame_bin_class_init (GESStillFrameBinClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+
+  object_class->dispose = ges_still_frame_bin_dispose;
+  object_class->finalize = ges_still_frame_bin_finalize;
+
+  element_class->change_state =
+      GST_DEBUG_FUNCPTR (ges_still_frame_bin_change_state);
+}
+
+static void
+ges_still_frame_bin_init (GESStillFrameBin * self)
+{
+  g_weak_ref_init (&self->owner, NULL);
+}
+
+/* @owner: The #GESTrackElement the source is created for
+ * @element: (transfer floating): The regular source element
+ * @renderer: (transfer floating) (nullable): The element rendering the
+ * still frame, with an always "src" pad, @element if %NULL
+ *
+ * Returns: (transfer floating): A bin exposing the output of @element, or
+ * the frame rendered once by @renderer when the timeline of @owner has
+ * #GESTimeline:still-frames set
+ */
+GstElement *
+ges_still_frame_bin_new (GESTrackElement * owner, GstElement * element,
+    GstElement * renderer)
+{
+  GESStillFrameBin *self = g_object_new (GES_TYPE_STILL_FRAME_BIN, NULL);
+
+  g_weak_ref_set (&self->owner, owner);
+  self->element = gst_object_ref_sink (element);
+  self->renderer = renderer ? gst_object_ref_sink (renderer) :
+      gst_object_ref (element);
+
+  self->ghostpad = gst_ghost_pad_new_no_target ("src", GST_PAD_SRC);
+  gst_element_add_pad (GST_ELEMENT (self), self->ghostpad);
+
+  g_signal_connect (element, "pad-added", G_CALLBACK (_element_pad_added_cb),
+      self);
+  g_signal_connect (element, "pad-removed",
+      G_CALLBACK (_element_pad_removed_cb), self);
+  gst_bin_add (GST_BIN (self), element);
+  _still_frame_bin_set_target (self, element);
+
+  return GST_ELEMENT (self);
+}
+
+/* Whether @pad is exposed by a GESStillFrameBin, which already selected the
+ * pad of its element */
+gboolean
+ges_still_frame_bin_owns_pad (GstPad * pad)
+{
+  gboolean res;
+  GstObject *parent = gst_pad_get_parent (pad);
+
+  res = parent && GES_IS_STILL_FRAME_BIN (parent);
+  gst_clear_object (&parent);
+
+  return res;
+}
+
+static void
+_image_pad_added_cb (GstElement * decodebin, GstPad * pad, GstElement * scale)
+{
+  GstPad *sinkpad = gst_element_get_static_pad (scale, "sink");
+
+  if (!gst_pad_is_linked (sinkpad) &&
+      GST_PAD_LINK_FAILED (gst_pad_link (pad, sinkpad)))
+    GST_INFO_OBJECT (decodebin, "Could not link %" GST_PTR_FORMAT, pad);
+  gst_object_unref (sinkpad);
+}
+
+/* Like ges_still_frame_bin_new(), with the still frame being the first
+ * frame of the video stream of @uri */
+GstElement *
+ges_still_frame_bin_new_for_uri (GESTrackElement * owner,
+    GstElement * element, const gchar * uri)
+{
+  GstPad *pad;
+  GstCaps *caps;
+  GstElement *bin, *decodebin, *scale, *convert;
+
+  bin = gst_bin_new ("still-image-renderer");
+  decodebin = gst_element_factory_make ("uridecodebin", NULL);
+  scale = gst_element_factory_make ("videoscale", NULL);
+  convert = gst_element_factory_make ("videoconvert", NULL);
+
+  caps = gst_caps_from_string ("video/x-raw(ANY)");
+  g_object_set (decodebin, "uri", uri, "caps", caps, "expose-all-streams",
+      FALSE, NULL);
+  gst_caps_unref (caps);
+  g_object_set (scale, "add-borders", TRUE, NULL);
+
+  gst_bin_add_many (GST_BIN (bin), decodebin, scale, convert, NULL);
+  gst_element_link_pads_full (scale, "src", convert, "sink",
+      GST_PAD_LINK_CHECK_NOTHING);
+  g_signal_connect (decodebin, "pad-added", G_CALLBACK (_image_pad_added_cb),
+      scale);
+
+  pad = gst_element_get_static_pad (convert, "src");
+  gst_element_add_pad (bin, gst_ghost_pad_new ("src", pad));
+  gst_object_unref (pad);
+
+  return ges_still_frame_bin_new (owner, element, bin);
+}
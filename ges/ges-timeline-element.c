@@ -1119,6 +1119,9 @@ ges_timeline_element_set_start (GESTimelineElement * self, GstClockTime start)
       return FALSE;
     if (res == TRUE) {
       self->start = start;
+      if (self->timeline)
+        timeline_tree_update_element_position (timeline_get_tree
+            (self->timeline), self);
       g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_START]);
     }
 
@@ -1287,6 +1290,9 @@ ges_timeline_element_set_duration (GESTimelineElement * self,
       return FALSE;
     if (res == TRUE) {
       self->duration = duration;
+      if (self->timeline)
+        timeline_tree_update_element_position (timeline_get_tree
+            (self->timeline), self);
       g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_DURATION]);
     }
 
@@ -69,6 +69,8 @@ typedef struct _EditData
   ElementEditMode mode;
 } EditData;
 
+typedef struct _TreeIndex TreeIndex;
+
 typedef struct _PositionData
 {
   guint32 layer_priority;
@@ -80,6 +82,8 @@ typedef struct _PositionData
 struct _TreeIterationData
 {
   GNode *root;
+  /* the index of root */
+  TreeIndex *index;
   gboolean res;
   /* an error to set */
   GError **error;
@@ -107,6 +111,7 @@ struct _TreeIterationData
   GList *neighbours;
 } tree_iteration_data_init = {
    .root = NULL,
+   .index = NULL,
    .res = TRUE,
    .element = NULL,
    .pos_data = NULL,
@@ -177,6 +182,7 @@ timeline_tree_init_debug (void)
 {
   GST_DEBUG_CATEGORY_INIT (tree_debug, "gestree",
       GST_DEBUG_FG_YELLOW, "timeline tree");
+  tree_index_quark = g_quark_from_static_string ("ges-timeline-tree-index");
 }
 
 
@@ -202,10 +208,394 @@ timeline_tree_debug (GNode * root)
       (GNodeTraverseFunc) print_node, NULL);
 }
 
+/****************************************************
+ *                  Interval index                  *
+ ****************************************************/
+
+/* Sources are indexed per track in a treap ordered by (start, element)
+ * where each node is augmented with the maximum end of its sub-tree,
+ * so that the sources whose [start, end] range intersects a given
+ * time range can be found in O(log n + k). The layer is checked on the
+ * returned candidates since it is derived from the parent clip and can
+ * change without the source being notified.
+ *
+ * The index also maps every tracked element to its GNode so we do not
+ * need to search the whole tree to find it. */
+
+typedef struct _IntervalNode IntervalNode;
+
+struct _IntervalNode
+{
+  GESTimelineElement *element;
+  GESTrack *track;
+
+  /* the key used to sort the node, which are the values of the element
+   * when it was last indexed */
+  GstClockTime start;
+  GstClockTime end;
+
+  /* the maximum end found in the sub-tree rooted at this node */
+  GstClockTime max_end;
+  guint32 weight;
+
+  IntervalNode *left;
+  IntervalNode *right;
+};
+
+struct _TreeIndex
+{
+  /* GESTrack * (can be NULL) -> IntervalNode * */
+  GHashTable *tracks;
+  /* GESTimelineElement * -> GNode * */
+  GHashTable *nodes;
+  /* GESSource * -> IntervalNode * */
+  GHashTable *sources;
+  /* Set of GESSource * that have been given a GESMarkerList meta */
+  GHashTable *marker_sources;
+};
+
+typedef gboolean (*IntervalForeachFunc) (GESTimelineElement * element,
+    gpointer user_data);
+
+static GQuark tree_index_quark;
+
+static GstClockTime
+_saturated_end (GESTimelineElement * element)
+{
+  if (!GST_CLOCK_TIME_IS_VALID (element->duration)
+      || element->duration >= G_MAXUINT64 - element->start)
+    return G_MAXUINT64;
+
+  return element->start + element->duration;
+}
+
+static gint
+interval_node_compare (IntervalNode * a, IntervalNode * b)
+{
+  if (a->start != b->start)
+    return a->start < b->start ? -1 : 1;
+
+  if (a->element == b->element)
+    return 0;
+
+  return (guintptr) a->element < (guintptr) b->element ? -1 : 1;
+}
+
+static void
+interval_node_update (IntervalNode * node)
+{
+  node->max_end = node->end;
+  if (node->left && node->left->max_end > node->max_end)
+    node->max_end = node->left->max_end;
+  if (node->right && node->right->max_end > node->max_end)
+    node->max_end = node->right->max_end;
+}
+
+static IntervalNode *
+interval_node_rotate_right (IntervalNode * node)
+{
+  IntervalNode *left = node->left;
+
+  node->left = left->right;
+  interval_node_update (node);
+  left->right = node;
+  interval_node_update (left);
+
+  return left;
+}
+
+static IntervalNode *
+interval_node_rotate_left (IntervalNode * node)
+{
+  IntervalNode *right = node->right;
+
+  node->right = right->left;
+  interval_node_update (node);
+  right->left = node;
+  interval_node_update (right);
+
+  return right;
+}
+
+static IntervalNode *
+interval_node_insert (IntervalNode * root, IntervalNode * node)
+{
+  if (!root) {
+    node->left = node->right = NULL;
+    interval_node_update (node);
+
+    return node;
+  }
+
+  if (interval_node_compare (node, root) < 0) {
+    root->left = interval_node_insert (root->left, node);
+    if (root->left->weight > root->weight)
+      return interval_node_rotate_right (root);
+  } else {
+    root->right = interval_node_insert (root->right, node);
+    if (root->right->weight > root->weight)
+      return interval_node_rotate_left (root);
+  }
+  interval_node_update (root);
+
+  return root;
+}
+
+/* all the nodes in @left are sorted before the nodes in @right */
+static IntervalNode *
+interval_node_merge (IntervalNode * left, IntervalNode * right)
+{
+  if (!left)
+    return right;
+  if (!right)
+    return left;
+
+  if (left->weight > right->weight) {
+    left->right = interval_node_merge (left->right, right);
+    interval_node_update (left);
+
+    return left;
+  }
+
+  right->left = interval_node_merge (left, right->left);
+  interval_node_update (right);
+
+  return right;
+}
+
+static IntervalNode *
+interval_node_remove (IntervalNode * root, IntervalNode * node)
+{
+  if (!root)
+    return NULL;
+
+  if (root == node)
+    return interval_node_merge (node->left, node->right);
+
+  if (interval_node_compare (node, root) < 0)
+    root->left = interval_node_remove (root->left, node);
+  else
+    root->right = interval_node_remove (root->right, node);
+  interval_node_update (root);
+
+  return root;
+}
+
+/* calls @func for each node with start <= @last and end >= @first, until
+ * @func returns TRUE */
+static gboolean
+interval_node_foreach_in_range (IntervalNode * node, GstClockTime first,
+    GstClockTime last, IntervalForeachFunc func, gpointer user_data)
+{
+  while (node) {
+    if (node->max_end < first)
+      return FALSE;
+
+    if (interval_node_foreach_in_range (node->left, first, last, func,
+            user_data))
+      return TRUE;
+
+    /* everything to the right starts after @last */
+    if (node->start > last)
+      return FALSE;
+
+    if (node->end >= first && func (node->element, user_data))
+      return TRUE;
+
+    node = node->right;
+  }
+
+  return FALSE;
+}
+
+static TreeIndex *
+tree_index_get (GNode * root)
+{
+  TreeIndex *index = g_object_get_qdata (root->data, tree_index_quark);
+
+  return index;
+}
+
+static void
+tree_index_free (TreeIndex * index)
+{
+  g_hash_table_unref (index->tracks);
+  g_hash_table_unref (index->nodes);
+  g_hash_table_unref (index->sources);
+  g_hash_table_unref (index->marker_sources);
+  g_free (index);
+}
+
+static TreeIndex *
+tree_index_get_or_create (GNode * root)
+{
+  TreeIndex *index = tree_index_get (root);
+
+  if (index)
+    return index;
+
+  index = g_new0 (TreeIndex, 1);
+  index->tracks = g_hash_table_new (NULL, NULL);
+  index->nodes = g_hash_table_new (NULL, NULL);
+  index->sources = g_hash_table_new_full (NULL, NULL, NULL, g_free);
+  index->marker_sources = g_hash_table_new (NULL, NULL);
+  g_object_set_qdata_full (root->data, tree_index_quark, index,
+      (GDestroyNotify) tree_index_free);
+
+  return index;
+}
+
+static void
+tree_index_insert_source (TreeIndex * index, IntervalNode * inode)
+{
+  GESTimelineElement *element = inode->element;
+  IntervalNode *track_root;
+
+  inode->track = ges_track_element_get_track (GES_TRACK_ELEMENT (element));
+  inode->start = element->start;
+  inode->end = _saturated_end (element);
+
+  track_root = g_hash_table_lookup (index->tracks, inode->track);
+  g_hash_table_insert (index->tracks, inode->track,
+      interval_node_insert (track_root, inode));
+}
+
+static void
+tree_index_remove_source (TreeIndex * index, IntervalNode * inode)
+{
+  IntervalNode *track_root =
+      g_hash_table_lookup (index->tracks, inode->track);
+
+  track_root = interval_node_remove (track_root, inode);
+  if (track_root)
+    g_hash_table_insert (index->tracks, inode->track, track_root);
+  else
+    g_hash_table_remove (index->tracks, inode->track);
+}
+
+/* calls @func for every source in @track whose [start, end] range
+ * intersects [@first, @last] */
+static gboolean
+tree_index_foreach_in_track (TreeIndex * index, GESTrack * track,
+    GstClockTime first, GstClockTime last, IntervalForeachFunc func,
+    gpointer user_data)
+{
+  IntervalNode *track_root;
+
+  if (!index)
+    return FALSE;
+
+  track_root = g_hash_table_lookup (index->tracks, track);
+  return interval_node_foreach_in_range (track_root, first, last, func,
+      user_data);
+}
+
+/* same as tree_index_foreach_in_track, for all the tracks */
+static gboolean
+tree_index_foreach_in_range (TreeIndex * index, GstClockTime first,
+    GstClockTime last, IntervalForeachFunc func, gpointer user_data)
+{
+  GHashTableIter iter;
+  gpointer value;
+
+  if (!index)
+    return FALSE;
+
+  g_hash_table_iter_init (&iter, index->tracks);
+  while (g_hash_table_iter_next (&iter, NULL, &value)) {
+    if (interval_node_foreach_in_range (value, first, last, func, user_data))
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+static void
+check_marker_list_meta (const GESMetaContainer * container, const gchar * key,
+    const GValue * value, TreeIndex * index)
+{
+  if (G_VALUE_HOLDS_OBJECT (value)
+      && GES_IS_MARKER_LIST (g_value_get_object (value)))
+    g_hash_table_add (index->marker_sources, (gpointer) container);
+}
+
+static void
+source_notify_meta_cb (GESMetaContainer * container, const gchar * key,
+    const GValue * value, GNode * root)
+{
+  TreeIndex *index = tree_index_get (root);
+
+  /* a source is never removed from the marker sources while it is tracked
+   * since the marker list flags are checked when snapping anyway */
+  if (index && value)
+    check_marker_list_meta (container, key, value, index);
+}
+
+static void
+tree_index_track_source (GNode * root, GESTimelineElement * element)
+{
+  TreeIndex *index = tree_index_get_or_create (root);
+  IntervalNode *inode = g_new0 (IntervalNode, 1);
+
+  inode->element = element;
+  inode->weight = g_random_int ();
+  tree_index_insert_source (index, inode);
+  g_hash_table_insert (index->sources, element, inode);
+
+  ges_meta_container_foreach (GES_META_CONTAINER (element),
+      (GESMetaForeachFunc) check_marker_list_meta, index);
+  g_signal_connect (element, "notify-meta",
+      G_CALLBACK (source_notify_meta_cb), root);
+}
+
+static void
+tree_index_stop_tracking_source (GNode * root, GESTimelineElement * element)
+{
+  TreeIndex *index = tree_index_get (root);
+  IntervalNode *inode = g_hash_table_lookup (index->sources, element);
+
+  g_signal_handlers_disconnect_by_func (element, source_notify_meta_cb, root);
+  g_hash_table_remove (index->marker_sources, element);
+  if (inode) {
+    tree_index_remove_source (index, inode);
+    g_hash_table_remove (index->sources, element);
+  }
+}
+
+/* Must be called whenever the start, duration or track of a tracked
+ * element changes */
+void
+timeline_tree_update_element_position (GNode * root,
+    GESTimelineElement * element)
+{
+  TreeIndex *index = tree_index_get (root);
+  IntervalNode *inode;
+
+  if (!index)
+    return;
+
+  inode = g_hash_table_lookup (index->sources, element);
+  if (!inode)
+    return;
+
+  if (inode->start == element->start && inode->end == _saturated_end (element)
+      && inode->track ==
+      ges_track_element_get_track (GES_TRACK_ELEMENT (element)))
+    return;
+
+  tree_index_remove_source (index, inode);
+  tree_index_insert_source (index, inode);
+}
+
 static GNode *
 find_node (GNode * root, gpointer element)
 {
-  return g_node_find (root, G_IN_ORDER, G_TRAVERSE_ALL, element);
+  TreeIndex *index = tree_index_get (root);
+
+  if (!index)
+    return NULL;
+
+  return g_hash_table_lookup (index->nodes, element);
 }
 
 static void
@@ -230,6 +620,7 @@ timeline_tree_track_element (GNode * root, GESTimelineElement * element)
   GNode *node;
   GNode *parent;
   GESTimelineElement *toplevel;
+  TreeIndex *index = tree_index_get_or_create (root);
 
   if (find_node (root, element)) {
     return;
@@ -251,6 +642,10 @@ timeline_tree_track_element (GNode * root, GESTimelineElement * element)
     node = g_node_prepend_data (parent, element);
   }
 
+  g_hash_table_insert (index->nodes, element, node);
+  if (GES_IS_SOURCE (element))
+    tree_index_track_source (root, element);
+
   if (GES_IS_CONTAINER (element)) {
     GList *tmp;
 
@@ -274,8 +669,6 @@ timeline_tree_stop_tracking_element (GNode * root, GESTimelineElement * element)
 {
   GNode *node = find_node (root, element);
 
-  node = find_node (root, element);
-
   /* Move children to the parent */
   while (node->children) {
     GNode *tmp = node->children;
@@ -288,6 +681,10 @@ timeline_tree_stop_tracking_element (GNode * root, GESTimelineElement * element)
   g_signal_handlers_disconnect_by_func (element, timeline_element_parent_cb,
       root);
 
+  if (GES_IS_SOURCE (element))
+    tree_index_stop_tracking_source (root, element);
+  g_hash_table_remove (tree_index_get (root)->nodes, element);
+
   g_node_destroy (node);
   timeline_update_duration (root->data);
 }
@@ -500,9 +897,8 @@ find_marker_snap (const GESMetaContainer * container, const gchar * key,
 }
 
 static gboolean
-find_snap (GNode * node, TreeIterationData * data)
+find_snap (GESTimelineElement * element, TreeIterationData * data)
 {
-  GESTimelineElement *element = node->data;
   GESTrackElement *track_el, *moving;
 
   /* Only snap to sources */
@@ -528,15 +924,48 @@ find_snap (GNode * node, TreeIterationData * data)
   return FALSE;
 }
 
+static gboolean
+find_edge_snap (GESTimelineElement * element, TreeIterationData * data)
+{
+  /* sources with markers are handled separately since their markers can
+   * be found outside of their edges */
+  if (g_hash_table_contains (data->index->marker_sources, element))
+    return FALSE;
+
+  return find_snap (element, data);
+}
+
 static void
 find_snap_for_element (GESTrackElement * element, GstClockTime position,
     gboolean negative, TreeIterationData * data)
 {
+  GstClockTime distance = data->snap->distance;
+  GHashTableIter iter;
+  gpointer key;
+
   data->element = GES_TIMELINE_ELEMENT (element);
   data->position = position;
   data->negative = negative;
-  g_node_traverse (data->root, G_IN_ORDER, G_TRAVERSE_LEAVES, -1,
-      (GNodeTraverseFunc) find_snap, data);
+
+  if (!data->index)
+    return;
+
+  /* only the sources with an edge within the snapping distance can be
+   * snapped to */
+  if (negative) {
+    if (position <= distance)
+      tree_index_foreach_in_range (data->index, 0, distance - position,
+          (IntervalForeachFunc) find_edge_snap, data);
+  } else {
+    tree_index_foreach_in_range (data->index,
+        position > distance ? position - distance : 0,
+        distance >= G_MAXUINT64 - position ? G_MAXUINT64 : position + distance,
+        (IntervalForeachFunc) find_edge_snap, data);
+  }
+
+  g_hash_table_iter_init (&iter, data->index->marker_sources);
+  while (g_hash_table_iter_next (&iter, &key, NULL))
+    find_snap (key, data);
 }
 
 /* find up to one source at the edge */
@@ -586,6 +1015,7 @@ timeline_tree_snap (GNode * root, GESTimelineElement * element,
 
   /* get the sources we can snap to */
   data.root = root;
+  data.index = tree_index_get (root);
   data.moving = moving;
   data.sources = NULL;
   data.snap = snap;
@@ -744,9 +1174,9 @@ set_triple_overlap_error (GError ** error, GESTimelineElement * first,
   cmp_track
 
 static gboolean
-check_overlap_with_element (GNode * node, TreeIterationData * data)
+check_overlap_with_element (GESTimelineElement * e, TreeIterationData * data)
 {
-  GESTimelineElement *e = node->data, *cmp = data->element;
+  GESTimelineElement *cmp = data->element;
   GstClockTime start, end, cmp_start, cmp_end;
   guint32 layer_prio, cmp_layer_prio;
   GESTrack *track, *cmp_track;
@@ -886,36 +1316,69 @@ error:
   return TRUE;
 }
 
-/* check and find the overlaps with the element at node */
 static gboolean
-check_all_overlaps_with_element (GNode * node, TreeIterationData * data)
+check_overlap_with_static_element (GESTimelineElement * e,
+    TreeIterationData * data)
 {
-  GESTimelineElement *element = node->data;
-  if (GES_IS_SOURCE (element)) {
-    data->element = element;
-    data->overlaping_on_start = NULL;
-    data->overlaping_on_end = NULL;
-    data->overlap_start_final_time = GST_CLOCK_TIME_NONE;
-    data->overlap_end_first_time = GST_CLOCK_TIME_NONE;
-    if (data->moving)
-      data->pos_data = g_hash_table_lookup (data->moving, element);
-    else
-      data->pos_data = NULL;
-
-    g_node_traverse (data->root, G_IN_ORDER, G_TRAVERSE_LEAVES, -1,
-        (GNodeTraverseFunc) check_overlap_with_element, data);
+  /* moving elements are checked at their new position */
+  if (data->moving && g_hash_table_contains (data->moving, e))
+    return FALSE;
 
-    return !data->res;
-  }
-  return FALSE;
+  return check_overlap_with_element (e, data);
 }
 
+/* check and find the overlaps with @element */
 static gboolean
-check_moving_overlaps (GNode * node, TreeIterationData * data)
+check_all_overlaps_with_element (GESTimelineElement * element,
+    TreeIterationData * data)
 {
-  if (g_hash_table_contains (data->moving, node->data))
-    return check_all_overlaps_with_element (node, data);
-  return FALSE;
+  GstClockTime start, end;
+  GESTrack *track;
+  GHashTableIter iter;
+  gpointer key;
+
+  if (!GES_IS_SOURCE (element))
+    return FALSE;
+
+  data->element = element;
+  data->overlaping_on_start = NULL;
+  data->overlaping_on_end = NULL;
+  data->overlap_start_final_time = GST_CLOCK_TIME_NONE;
+  data->overlap_end_first_time = GST_CLOCK_TIME_NONE;
+  if (data->moving)
+    data->pos_data = g_hash_table_lookup (data->moving, element);
+  else
+    data->pos_data = NULL;
+
+  /* sources that are not in a track can not overlap */
+  track = ges_track_element_get_track (GES_TRACK_ELEMENT (element));
+  if (!track)
+    return FALSE;
+
+  if (data->pos_data) {
+    start = data->pos_data->start;
+    end = data->pos_data->end;
+  } else {
+    start = element->start;
+    end = start + element->duration;
+  }
+
+  /* only look at the sources of the track that are currently found in
+   * ]start, end[ */
+  if (end > 0 && start < G_MAXUINT64
+      && tree_index_foreach_in_track (data->index, track, start + 1, end - 1,
+          (IntervalForeachFunc) check_overlap_with_static_element, data))
+    return TRUE;
+
+  if (data->moving) {
+    g_hash_table_iter_init (&iter, data->moving);
+    while (g_hash_table_iter_next (&iter, &key, NULL)) {
+      if (check_overlap_with_element (key, data))
+        return TRUE;
+    }
+  }
+
+  return !data->res;
 }
 
 /* whether the elements in moving can be moved to their corresponding
@@ -925,15 +1388,21 @@ timeline_tree_can_move_elements (GNode * root, GHashTable * moving,
     GError ** error)
 {
   TreeIterationData data = tree_iteration_data_init;
+  GHashTableIter iter;
+  gpointer key;
+
   data.moving = moving;
   data.root = root;
+  data.index = tree_index_get (root);
   data.res = TRUE;
   data.error = error;
-  /* sufficient to check the leaves, which is all the track elements or
-   * empty clips
-   * should also be sufficient to only check the moving elements */
-  g_node_traverse (root, G_IN_ORDER, G_TRAVERSE_LEAVES, -1,
-      (GNodeTraverseFunc) check_moving_overlaps, &data);
+  /* sufficient to check the moving elements, which are all track elements
+   * or empty clips */
+  g_hash_table_iter_init (&iter, moving);
+  while (g_hash_table_iter_next (&iter, &key, NULL)) {
+    if (check_all_overlaps_with_element (key, &data))
+      break;
+  }
 
   return data.res;
 }
@@ -1818,6 +2287,28 @@ done:
   return ret;
 }
 
+/* whether the @elements, which were added to the timeline without being
+ * checked, respect the timeline configuration rules */
+gboolean
+timeline_tree_can_add_elements (GNode * root, GPtrArray * elements,
+    GError ** error)
+{
+  guint i;
+  TreeIterationData data = tree_iteration_data_init;
+
+  data.root = root;
+  data.index = tree_index_get (root);
+  data.res = TRUE;
+  data.error = error;
+  /* all the elements are already at their position in the index */
+  for (i = 0; i < elements->len; i++) {
+    if (check_all_overlaps_with_element (elements->pdata[i], &data))
+      break;
+  }
+
+  return data.res;
+}
+
 /********************************************
  *         Perform Element Edit             *
  ********************************************/
@@ -2252,11 +2743,11 @@ is_descendant (GESTimelineElement * element, GESTimelineElement * ancestor)
 }
 
 static gboolean
-find_neighbour (GNode * node, TreeIterationData * data)
+find_neighbour (GESTimelineElement * element, TreeIterationData * data)
 {
   GList *tmp;
   gboolean in_same_track = FALSE;
-  GESTimelineElement *edge_element, *element = node->data;
+  GESTimelineElement *edge_element;
 
   if (!GES_IS_SOURCE (element))
     return FALSE;
@@ -2311,8 +2802,9 @@ timeline_tree_roll (GNode * root, GESTimelineElement * element,
     GError ** error)
 {
   gboolean res = TRUE;
-  GList *tmp;
+  GList *tmp, *tracks = NULL;
   GNode *node;
+  TreeIndex *index;
   TreeIterationData data = tree_iteration_data_init;
   GHashTable *edits = new_edit_table ();
   GHashTable *moving = new_position_table ();
@@ -2371,8 +2863,19 @@ timeline_tree_roll (GNode * root, GESTimelineElement * element,
   data.edge = (edge == GES_EDGE_END) ? GES_EDGE_START : GES_EDGE_END;
   data.neighbours = NULL;
 
-  g_node_traverse (root, G_PRE_ORDER, G_TRAVERSE_LEAVES, -1,
-      (GNodeTraverseFunc) find_neighbour, &data);
+  /* only the sources touching the position can be neighbours */
+  index = tree_index_get (root);
+  for (tmp = data.sources; tmp; tmp = tmp->next) {
+    GESTrack *track = ges_track_element_get_track (tmp->data);
+
+    if (g_list_find (tracks, track))
+      continue;
+
+    tracks = g_list_prepend (tracks, track);
+    tree_index_foreach_in_track (index, track, data.position, data.position,
+        (IntervalForeachFunc) find_neighbour, &data);
+  }
+  g_list_free (tracks);
 
   for (tmp = data.neighbours; tmp; tmp = tmp->next) {
     GESTimelineElement *clip = tmp->data;
@@ -2473,7 +2976,8 @@ create_transitions (GNode * node,
 
   GST_LOG (node->data, "Checking for overlaps");
   data.root = g_node_get_root (node);
-  check_all_overlaps_with_element (node, &data);
+  data.index = tree_index_get (data.root);
+  check_all_overlaps_with_element (node->data, &data);
 
   if (data.overlaping_on_start)
     create_transition_if_needed (timeline,
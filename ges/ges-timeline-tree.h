@@ -9,6 +9,9 @@ void timeline_tree_track_element          (GNode *root,
 void timeline_tree_stop_tracking_element  (GNode *root,
                                            GESTimelineElement *element);
 
+void timeline_tree_update_element_position (GNode *root,
+                                           GESTimelineElement *element);
+
 gboolean timeline_tree_can_move_element   (GNode *root,
                                            GESTimelineElement *element,
                                            guint32 priority,
@@ -16,6 +19,10 @@ gboolean timeline_tree_can_move_element   (GNode *root,
                                            GstClockTime duration,
                                            GError ** error);
 
+gboolean timeline_tree_can_add_elements   (GNode *root,
+                                           GPtrArray *elements,
+                                           GError ** error);
+
 gboolean timeline_tree_ripple             (GNode *root,
                                            GESTimelineElement *element,
                                            gint64 layer_priority_offset,
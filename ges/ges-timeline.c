@@ -194,6 +194,10 @@ struct _GESTimelinePrivate
   /* Avoid sorting layers when we are actually resyncing them ourself */
   gboolean resyncing_layers;
   GList *auto_transitions;
+  /* The auto-transitions indexed by their sources and transition clip */
+  GHashTable *auto_transitions_by_previous;
+  GHashTable *auto_transitions_by_next;
+  GHashTable *auto_transitions_by_clip;
 
   /* Last snapping  properties */
   GstClockTime last_snap_ts;
@@ -211,6 +215,11 @@ struct _GESTimelinePrivate
   gboolean has_any_track_selection_error;
   /* error set for non-programming/usage errors */
   GError *track_selection_error;
+
+  /* Nesting level of ges_timeline_begin_bulk_add() and the sources added
+   * since the outermost one */
+  guint bulk_adding;
+  GPtrArray *bulk_added;
   GList *groups;
 
   guint stream_start_group_id;
@@ -225,6 +234,21 @@ struct _GESTimelinePrivate
   /* For ges_timeline_commit_sync */
   GMutex commited_lock;
   GCond commited_cond;
+  gboolean commit_done;
+
+  /* What needs to be updated on next commit: with commit_all everything
+   * is, otherwise only the dirty layers are resynced, the auto-transitions
+   * are only looked for around the dirty sources and only the dirty tracks
+   * are committed. The stream collection is only rebuilt when the tracks
+   * changed */
+  gboolean commit_all;
+  gboolean tracks_changed;
+  GHashTable *dirty_layers;
+  GHashTable *dirty_sources;
+
+  /* For GESTimeline:coalesce-commits */
+  gboolean coalesce_commits;
+  GSource *commit_source;
 
   GThread *valid_thread;
   gboolean disposed;
@@ -232,6 +256,25 @@ struct _GESTimelinePrivate
   GstStreamCollection *stream_collection;
 
   gboolean rendering_smartly;
+  gboolean use_generated_proxies;
+
+  /* For GESTimeline:decoder-pool-size */
+  GESDecoderPool *decoder_pool;
+
+  /* GESTimeline:occlusion-culling, read from the streaming threads */
+  gint occlusion_culling;
+
+  /* For GESTimeline:warm-sources */
+  GESWarmSources *warm_sources;
+
+  /* GESTimeline:still-frames, read from the streaming threads */
+  gint still_frames;
+
+  /* GESTimeline:native-transitions, read from the streaming threads */
+  gint native_transitions;
+
+  /* GESTimeline:smart-cut, read from the streaming threads */
+  gint smart_cut;
 };
 
 /* private structure to contain our track-related information */
@@ -243,9 +286,13 @@ typedef struct
   GstPad *pad;                  /* Pad from the track */
   GstPad *ghostpad;
   gulong track_element_added_sigid;
+  gulong track_changed_sigid;
 
   gulong probe_id;
   GstStream *stream;
+
+  /* Whether the track needs to be committed */
+  gboolean dirty;
 } TrackPrivate;
 
 enum
@@ -255,6 +302,13 @@ enum
   PROP_AUTO_TRANSITION,
   PROP_SNAPPING_DISTANCE,
   PROP_UPDATE,
+  PROP_COALESCE_COMMITS,
+  PROP_DECODER_POOL_SIZE,
+  PROP_OCCLUSION_CULLING,
+  PROP_WARM_SOURCES,
+  PROP_STILL_FRAMES,
+  PROP_NATIVE_TRANSITIONS,
+  PROP_SMART_CUT,
   PROP_LAST
 };
 
@@ -347,6 +401,33 @@ ges_timeline_get_property (GObject * object, guint property_id,
     case PROP_SNAPPING_DISTANCE:
       g_value_set_uint64 (value, timeline->priv->snapping_distance);
       break;
+    case PROP_COALESCE_COMMITS:
+      g_value_set_boolean (value, timeline->priv->coalesce_commits);
+      break;
+    case PROP_DECODER_POOL_SIZE:
+      g_value_set_uint (value,
+          ges_decoder_pool_get_size (timeline->priv->decoder_pool));
+      break;
+    case PROP_OCCLUSION_CULLING:
+      g_value_set_boolean (value,
+          g_atomic_int_get (&timeline->priv->occlusion_culling));
+      break;
+    case PROP_WARM_SOURCES:
+      g_value_set_uint (value,
+          ges_warm_sources_get_max (timeline->priv->warm_sources));
+      break;
+    case PROP_STILL_FRAMES:
+      g_value_set_boolean (value,
+          g_atomic_int_get (&timeline->priv->still_frames));
+      break;
+    case PROP_NATIVE_TRANSITIONS:
+      g_value_set_boolean (value,
+          g_atomic_int_get (&timeline->priv->native_transitions));
+      break;
+    case PROP_SMART_CUT:
+      g_value_set_boolean (value,
+          g_atomic_int_get (&timeline->priv->smart_cut));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
   }
@@ -365,6 +446,35 @@ ges_timeline_set_property (GObject * object, guint property_id,
     case PROP_SNAPPING_DISTANCE:
       timeline->priv->snapping_distance = g_value_get_uint64 (value);
       break;
+    case PROP_COALESCE_COMMITS:
+      timeline->priv->coalesce_commits = g_value_get_boolean (value);
+      if (!timeline->priv->coalesce_commits && timeline->priv->commit_source)
+        ges_timeline_commit (timeline);
+      break;
+    case PROP_DECODER_POOL_SIZE:
+      ges_decoder_pool_set_size (timeline->priv->decoder_pool,
+          g_value_get_uint (value));
+      break;
+    case PROP_OCCLUSION_CULLING:
+      g_atomic_int_set (&timeline->priv->occlusion_culling,
+          g_value_get_boolean (value));
+      break;
+    case PROP_WARM_SOURCES:
+      ges_warm_sources_set_max (timeline->priv->warm_sources,
+          g_value_get_uint (value));
+      break;
+    case PROP_STILL_FRAMES:
+      g_atomic_int_set (&timeline->priv->still_frames,
+          g_value_get_boolean (value));
+      break;
+    case PROP_NATIVE_TRANSITIONS:
+      g_atomic_int_set (&timeline->priv->native_transitions,
+          g_value_get_boolean (value));
+      break;
+    case PROP_SMART_CUT:
+      g_atomic_int_set (&timeline->priv->smart_cut,
+          g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
   }
@@ -410,12 +520,24 @@ ges_timeline_dispose (GObject * object)
   g_list_free_full (priv->groups, gst_object_unref);
 
   g_list_free_full (priv->auto_transitions, gst_object_unref);
+  priv->auto_transitions = NULL;
+  g_hash_table_remove_all (priv->auto_transitions_by_previous);
+  g_hash_table_remove_all (priv->auto_transitions_by_next);
+  g_hash_table_remove_all (priv->auto_transitions_by_clip);
+
+  if (priv->commit_source) {
+    g_source_destroy (priv->commit_source);
+    g_clear_pointer (&priv->commit_source, g_source_unref);
+  }
+  g_hash_table_remove_all (priv->dirty_layers);
+  g_hash_table_remove_all (priv->dirty_sources);
 
   g_hash_table_unref (priv->all_elements);
   gst_object_unref (priv->stream_collection);
 
   gst_clear_object (&priv->auto_transition_track);
   gst_clear_object (&priv->new_track);
+  g_clear_pointer (&priv->bulk_added, g_ptr_array_unref);
   g_clear_error (&priv->track_selection_error);
   priv->track_selection_error = NULL;
 
@@ -429,6 +551,13 @@ ges_timeline_finalize (GObject * object)
 
   g_rec_mutex_clear (&tl->priv->dyn_mutex);
   g_node_destroy (tl->priv->tree);
+  g_hash_table_unref (tl->priv->dirty_layers);
+  g_hash_table_unref (tl->priv->dirty_sources);
+  g_hash_table_unref (tl->priv->auto_transitions_by_previous);
+  g_hash_table_unref (tl->priv->auto_transitions_by_next);
+  g_hash_table_unref (tl->priv->auto_transitions_by_clip);
+  ges_decoder_pool_unref (tl->priv->decoder_pool);
+  ges_warm_sources_unref (tl->priv->warm_sources);
 
   G_OBJECT_CLASS (ges_timeline_parent_class)->finalize (object);
 }
@@ -641,6 +770,142 @@ ges_timeline_class_init (GESTimelineClass * klass)
   g_object_class_install_property (object_class, PROP_SNAPPING_DISTANCE,
       properties[PROP_SNAPPING_DISTANCE]);
 
+  /**
+   * GESTimeline:coalesce-commits:
+   *
+   * Whether ges_timeline_commit() should only schedule the commit of the
+   * pending changes, so that all the commits requested during one
+   * iteration of the thread-default #GMainContext result in a single
+   * commit. This is useful when committing after each small change, for
+   * example while scrubbing.
+   *
+   * ges_timeline_commit_sync() always commits right away, including the
+   * pending changes of a scheduled commit.
+   *
+   * Since: 1.20
+   */
+  properties[PROP_COALESCE_COMMITS] =
+      g_param_spec_boolean ("coalesce-commits", "Coalesce commits",
+      "Merge the commits requested during a main loop iteration", FALSE,
+      G_PARAM_READWRITE);
+  g_object_class_install_property (object_class, PROP_COALESCE_COMMITS,
+      properties[PROP_COALESCE_COMMITS]);
+
+  /**
+   * GESTimeline:decoder-pool-size:
+   *
+   * The maximum number of idle decoders the timeline keeps around so that
+   * the sources of a media file which are played one after the other can
+   * reuse the decoders of the previous ones instead of setting up new ones.
+   * 0 means that no decoder is reused.
+   *
+   * See ges_timeline_get_decoder_pool_stats().
+   *
+   * Since: 1.20
+   */
+  properties[PROP_DECODER_POOL_SIZE] =
+      g_param_spec_uint ("decoder-pool-size", "Decoder pool size",
+      "Maximum number of idle decoders kept around for reuse", 0, G_MAXUINT,
+      0, G_PARAM_READWRITE);
+  g_object_class_install_property (object_class, PROP_DECODER_POOL_SIZE,
+      properties[PROP_DECODER_POOL_SIZE]);
+
+  /**
+   * GESTimeline:occlusion-culling:
+   *
+   * Whether the video tracks skip the layers which are completely hidden
+   * by an opaque frame covering the whole output above them, instead of
+   * converting and blending them for nothing. This speeds up timelines
+   * with many stacked layers. It only applies when the video compositor
+   * used by GES is a #GstAggregator, like `compositor`.
+   *
+   * Since: 1.20
+   */
+  properties[PROP_OCCLUSION_CULLING] =
+      g_param_spec_boolean ("occlusion-culling", "Occlusion culling",
+      "Skip the layers hidden by an opaque full frame above them", FALSE,
+      G_PARAM_READWRITE);
+  g_object_class_install_property (object_class, PROP_OCCLUSION_CULLING,
+      properties[PROP_OCCLUSION_CULLING]);
+
+  /**
+   * GESTimeline:warm-sources:
+   *
+   * The maximum number of unused sources which keep their conversion
+   * elements around. When set, the conversion elements of the sources added
+   * to the timeline afterwards are only created once the sources start being
+   * played, and the ones of the least recently used sources above this limit
+   * get released again, which lowers the memory used by big timelines at the
+   * cost of setting them up again when the sources are played again. The
+   * default creates them right away and keeps them all.
+   *
+   * Since: 1.20
+   */
+  properties[PROP_WARM_SOURCES] =
+      g_param_spec_uint ("warm-sources", "Warm sources",
+      "Maximum number of unused sources keeping their conversion elements",
+      0, G_MAXUINT, G_MAXUINT, G_PARAM_READWRITE);
+  g_object_class_install_property (object_class, PROP_WARM_SOURCES,
+      properties[PROP_WARM_SOURCES]);
+
+  /**
+   * GESTimeline:still-frames:
+   *
+   * Whether the sources with a static content, like titles and images,
+   * render a single frame which is then pushed for their whole duration,
+   * instead of rendering every frame. The frames are shared between the
+   * sources with the same content, and rendered again when the properties
+   * of a source change. Changing it applies to the sources prerolled
+   * afterwards.
+   *
+   * Since: 1.20
+   */
+  properties[PROP_STILL_FRAMES] =
+      g_param_spec_boolean ("still-frames", "Still frames",
+      "Render the sources with a static content only once", FALSE,
+      G_PARAM_READWRITE);
+  g_object_class_install_property (object_class, PROP_STILL_FRAMES,
+      properties[PROP_STILL_FRAMES]);
+
+  /**
+   * GESTimeline:native-transitions:
+   *
+   * Whether the transitions blend their two inputs with a single dedicated
+   * element, instead of converting them and mixing them with the generic
+   * `smptealpha`, `compositor`, `volume` and `audiomixer` elements. A
+   * transition only does so when its type is supported by the dedicated
+   * element and when the inputs can be blended in the format they already
+   * have, as set by the restriction caps of its track. Changing it applies
+   * to the transitions prerolled afterwards.
+   *
+   * Since: 1.20
+   */
+  properties[PROP_NATIVE_TRANSITIONS] =
+      g_param_spec_boolean ("native-transitions", "Native transitions",
+      "Blend the transitions with dedicated elements when possible", FALSE,
+      G_PARAM_READWRITE);
+  g_object_class_install_property (object_class, PROP_NATIVE_TRANSITIONS,
+      properties[PROP_NATIVE_TRANSITIONS]);
+
+  /**
+   * GESTimeline:smart-cut:
+   *
+   * Whether the sources rendered in #GES_PIPELINE_MODE_SMART_RENDER cut
+   * their encoded video streams GOP by GOP: only the GOPs crossing their
+   * in-point and out-point get decoded and encoded again, instead of the
+   * whole source when those are not on keyframes. When the encoded GOPs can
+   * not be mixed with the ones of the stream, the stream is encoded again as
+   * a whole. Changing it applies to the sources prerolled afterwards.
+   *
+   * Since: 1.20
+   */
+  properties[PROP_SMART_CUT] =
+      g_param_spec_boolean ("smart-cut", "Smart cut",
+      "Only encode again the GOPs crossing the edges of the sources when "
+      "rendering smartly", FALSE, G_PARAM_READWRITE);
+  g_object_class_install_property (object_class, PROP_SMART_CUT,
+      properties[PROP_SMART_CUT]);
+
   /**
    * GESTimeline::track-added:
    * @timeline: The #GESTimeline
@@ -906,6 +1171,17 @@ ges_timeline_init (GESTimeline * self)
   priv->stream_start_group_id = -1;
   priv->stream_collection = gst_stream_collection_new (NULL);
 
+  priv->auto_transitions_by_previous = g_hash_table_new (NULL, NULL);
+  priv->auto_transitions_by_next = g_hash_table_new (NULL, NULL);
+  priv->auto_transitions_by_clip = g_hash_table_new (NULL, NULL);
+
+  priv->commit_all = TRUE;
+  priv->dirty_layers = g_hash_table_new (NULL, NULL);
+  priv->dirty_sources =
+      g_hash_table_new_full (NULL, NULL, gst_object_unref, NULL);
+  priv->decoder_pool = ges_decoder_pool_new ();
+  priv->warm_sources = ges_warm_sources_new ();
+
   g_signal_connect_after (self, "select-tracks-for-object",
       G_CALLBACK (select_tracks_for_object_default), NULL);
 
@@ -954,15 +1230,27 @@ _resync_layers (GESTimeline * timeline)
 void
 timeline_update_duration (GESTimeline * timeline)
 {
-  GstClockTime duration = timeline_tree_get_duration (timeline->priv->tree);
+  GstClockTime duration;
+
+  /* Computing it walks the whole tree, only do it once for bulk adds */
+  if (timeline->priv->bulk_adding)
+    return;
+
+  duration = timeline_tree_get_duration (timeline->priv->tree);
 
   if (timeline->priv->duration != duration) {
+    GList *tmp;
+
     GST_DEBUG ("track duration : %" GST_TIME_FORMAT " current : %"
         GST_TIME_FORMAT, GST_TIME_ARGS (duration),
         GST_TIME_ARGS (timeline->priv->duration));
 
     timeline->priv->duration = duration;
 
+    /* The gap at the end of the tracks needs to be updated */
+    for (tmp = timeline->priv->priv_tracks; tmp; tmp = tmp->next)
+      ((TrackPrivate *) tmp->data)->dirty = TRUE;
+
     g_object_notify_by_pspec (G_OBJECT (timeline), properties[PROP_DURATION]);
   }
 }
@@ -975,6 +1263,49 @@ custom_find_track (TrackPrivate * tr_priv, GESTrack * track)
   return -1;
 }
 
+static void
+_remove_from_index (GHashTable * index, gpointer key,
+    GESAutoTransition * auto_transition)
+{
+  if (g_hash_table_lookup (index, key) == auto_transition)
+    g_hash_table_remove (index, key);
+}
+
+/* Returns whether @auto_transition was indexed */
+gboolean
+ges_timeline_unindex_auto_transition (GESTimeline * timeline,
+    GESAutoTransition * auto_transition)
+{
+  GESTimelinePrivate *priv = timeline->priv;
+
+  if (g_hash_table_lookup (priv->auto_transitions_by_clip,
+          auto_transition->transition_clip) != auto_transition)
+    return FALSE;
+
+  _remove_from_index (priv->auto_transitions_by_previous,
+      auto_transition->previous_source, auto_transition);
+  _remove_from_index (priv->auto_transitions_by_next,
+      auto_transition->next_source, auto_transition);
+  g_hash_table_remove (priv->auto_transitions_by_clip,
+      auto_transition->transition_clip);
+
+  return TRUE;
+}
+
+void
+ges_timeline_index_auto_transition (GESTimeline * timeline,
+    GESAutoTransition * auto_transition)
+{
+  GESTimelinePrivate *priv = timeline->priv;
+
+  g_hash_table_insert (priv->auto_transitions_by_previous,
+      auto_transition->previous_source, auto_transition);
+  g_hash_table_insert (priv->auto_transitions_by_next,
+      auto_transition->next_source, auto_transition);
+  g_hash_table_insert (priv->auto_transitions_by_clip,
+      auto_transition->transition_clip, auto_transition);
+}
+
 static void
 _destroy_auto_transition_cb (GESAutoTransition * auto_transition,
     GESTimeline * timeline)
@@ -987,8 +1318,11 @@ _destroy_auto_transition_cb (GESAutoTransition * auto_transition,
   g_signal_handlers_disconnect_by_func (auto_transition,
       _destroy_auto_transition_cb, timeline);
 
+  LOCK_DYN (timeline);
+  ges_timeline_unindex_auto_transition (timeline, auto_transition);
   priv->auto_transitions =
       g_list_remove (priv->auto_transitions, auto_transition);
+  UNLOCK_DYN (timeline);
   gst_object_unref (auto_transition);
 }
 
@@ -1041,8 +1375,11 @@ ges_timeline_create_transition (GESTimeline * timeline,
   g_signal_connect (auto_transition, "destroy-me",
       G_CALLBACK (_destroy_auto_transition_cb), timeline);
 
+  LOCK_DYN (timeline);
   timeline->priv->auto_transitions =
       g_list_prepend (timeline->priv->auto_transitions, auto_transition);
+  ges_timeline_index_auto_transition (timeline, auto_transition);
+  UNLOCK_DYN (timeline);
 
   return auto_transition;
 }
@@ -1052,54 +1389,41 @@ ges_timeline_find_auto_transition (GESTimeline * timeline,
     GESTrackElement * prev, GESTrackElement * next,
     GstClockTime transition_duration)
 {
-  GList *tmp;
+  GESAutoTransition *auto_trans =
+      g_hash_table_lookup (timeline->priv->auto_transitions_by_previous, prev);
 
-  for (tmp = timeline->priv->auto_transitions; tmp; tmp = tmp->next) {
-    GESAutoTransition *auto_trans = (GESAutoTransition *) tmp->data;
+  if (!auto_trans)
+    auto_trans =
+        g_hash_table_lookup (timeline->priv->auto_transitions_by_next, next);
 
-    /* We already have a transition linked to one of the elements we want to
-     * find a transition for */
-    if (auto_trans->previous_source == prev || auto_trans->next_source == next) {
-      if (auto_trans->previous_source != prev
-          || auto_trans->next_source != next) {
-        GST_ERROR_OBJECT (timeline, "Failed creating auto transition, "
-            " trying to have 3 clips overlapping, rolling back");
-      }
-
-      return auto_trans;
-    }
+  /* We already have a transition linked to one of the elements we want to
+   * find a transition for */
+  if (auto_trans && (auto_trans->previous_source != prev
+          || auto_trans->next_source != next)) {
+    GST_ERROR_OBJECT (timeline, "Failed creating auto transition, "
+        " trying to have 3 clips overlapping, rolling back");
   }
 
-  return NULL;
+  return auto_trans;
 }
 
 GESAutoTransition *
 ges_timeline_get_auto_transition_at_edge (GESTimeline * timeline,
     GESTrackElement * source, GESEdge edge)
 {
-  GList *tmp, *auto_transitions;
   GESAutoTransition *ret = NULL;
 
   LOCK_DYN (timeline);
-  auto_transitions = g_list_copy_deep (timeline->priv->auto_transitions,
-      (GCopyFunc) gst_object_ref, NULL);
-  UNLOCK_DYN (timeline);
-
-  for (tmp = auto_transitions; tmp; tmp = tmp->next) {
-    GESAutoTransition *auto_trans = (GESAutoTransition *) tmp->data;
-
-    /* We already have a transition linked to one of the elements we want to
-     * find a transition for */
-    if (edge == GES_EDGE_END && auto_trans->previous_source == source) {
-      ret = gst_object_ref (auto_trans);
-      break;
-    } else if (edge == GES_EDGE_START && auto_trans->next_source == source) {
-      ret = gst_object_ref (auto_trans);
-      break;
-    }
-  }
+  if (edge == GES_EDGE_END)
+    ret = g_hash_table_lookup (timeline->priv->auto_transitions_by_previous,
+        source);
+  else if (edge == GES_EDGE_START)
+    ret = g_hash_table_lookup (timeline->priv->auto_transitions_by_next,
+        source);
 
-  g_list_free_full (auto_transitions, gst_object_unref);
+  if (ret)
+    gst_object_ref (ret);
+  UNLOCK_DYN (timeline);
 
   return ret;
 }
@@ -1259,7 +1583,7 @@ _edit_auto_transition (GESTimeline * timeline, GESTimelineElement * element,
     gint64 new_layer_priority, GESEditMode mode, GESEdge edge,
     GstClockTime position, GError ** error)
 {
-  GList *tmp;
+  GESAutoTransition *auto_transition;
   guint32 layer_prio = ges_timeline_element_get_layer_priority (element);
   GESLayer *layer = ges_timeline_get_layer (timeline, layer_prio);
 
@@ -1269,9 +1593,11 @@ _edit_auto_transition (GESTimeline * timeline, GESTimelineElement * element,
   }
 
   gst_object_unref (layer);
-  for (tmp = timeline->priv->auto_transitions; tmp; tmp = tmp->next) {
+  auto_transition =
+      g_hash_table_lookup (timeline->priv->auto_transitions_by_clip,
+      GES_IS_CLIP (element) ? element : element->parent);
+  if (auto_transition) {
     GESTimelineElement *replace;
-    GESAutoTransition *auto_transition = tmp->data;
 
     if (GES_TIMELINE_ELEMENT (auto_transition->transition) == element ||
         GES_TIMELINE_ELEMENT (auto_transition->transition_clip) == element) {
@@ -1570,6 +1896,70 @@ ges_timeline_set_moving_track_elements (GESTimeline * timeline, gboolean moving)
   }
 }
 
+/* Until the matching ges_timeline_end_bulk_add(), the sources added to the
+ * tracks are neither checked against the timeline configuration rules nor
+ * get auto-transitions, and the duration of the timeline is not updated.
+ * This is all done once when the outermost bulk add ends. */
+void
+ges_timeline_begin_bulk_add (GESTimeline * timeline)
+{
+  GESTimelinePrivate *priv = timeline->priv;
+
+  if (!priv->bulk_adding++)
+    priv->bulk_added = g_ptr_array_new_with_free_func (gst_object_unref);
+}
+
+/* Returns FALSE if some of the sources added since
+ * ges_timeline_begin_bulk_add() break the timeline configuration rules, in
+ * which case it is the responsibility of the caller to remove them */
+gboolean
+ges_timeline_end_bulk_add (GESTimeline * timeline, GError ** error)
+{
+  guint i;
+  GPtrArray *added;
+  gboolean ret = TRUE;
+  GESTimelinePrivate *priv = timeline->priv;
+
+  g_return_val_if_fail (priv->bulk_adding, FALSE);
+
+  if (--priv->bulk_adding)
+    return TRUE;
+
+  added = priv->bulk_added;
+  priv->bulk_added = NULL;
+  timeline_update_duration (timeline);
+
+  GST_DEBUG_OBJECT (timeline, "Checking %u sources added in bulk", added->len);
+  if (!timeline_tree_can_add_elements (priv->tree, added, error)) {
+    GST_INFO_OBJECT (timeline, "Sources added in bulk break the timeline "
+        "configuration rules");
+    ret = FALSE;
+    goto done;
+  }
+
+  for (i = 0; i < added->len; i++) {
+    GESTrackElement *source = added->pdata[i];
+
+    /* might have been removed in the meantime */
+    if (ges_track_element_get_track (source)
+        && GES_TIMELINE_ELEMENT_TIMELINE (source) == timeline)
+      timeline_tree_create_transitions_for_track_element (priv->tree, source,
+          ges_timeline_find_auto_transition);
+  }
+
+done:
+  g_ptr_array_unref (added);
+
+  return ret;
+}
+
+/* accepts NULL */
+gboolean
+ges_timeline_is_bulk_adding (GESTimeline * timeline)
+{
+  return timeline && timeline->priv->bulk_adding;
+}
+
 void
 ges_timeline_set_track_selection_error (GESTimeline * timeline,
     gboolean was_error, GError * error)
@@ -1692,11 +2082,23 @@ clip_track_element_removed_cb (GESClip * clip,
   }
 }
 
+static void
+track_changed_cb (GESTrack * track, GParamSpec * arg G_GNUC_UNUSED,
+    TrackPrivate * tr_priv)
+{
+  tr_priv->dirty = TRUE;
+}
+
 static void
 track_element_added_cb (GESTrack * track, GESTrackElement * element,
     GESTimeline * timeline)
 {
-  if (GES_IS_SOURCE (element))
+  if (!GES_IS_SOURCE (element))
+    return;
+
+  if (timeline->priv->bulk_adding)
+    g_ptr_array_add (timeline->priv->bulk_added, gst_object_ref (element));
+  else
     timeline_tree_create_transitions_for_track_element (timeline->priv->tree,
         element, ges_timeline_find_auto_transition);
 }
@@ -1841,6 +2243,7 @@ layer_active_changed_cb (GESLayer * layer, gboolean active G_GNUC_UNUSED,
     GPtrArray * tracks G_GNUC_UNUSED, GESTimeline * timeline)
 {
   timeline_tree_reset_layer_active (timeline->priv->tree, layer);
+  timeline->priv->commit_all = TRUE;
 }
 
 static void
@@ -1849,24 +2252,14 @@ layer_auto_transition_changed_cb (GESLayer * layer,
 {
   GList *tmp, *clips;
 
+  timeline->priv->commit_all = TRUE;
   timeline_tree_create_transitions (timeline->priv->tree,
       _create_auto_transition_from_transitions);
   clips = ges_layer_get_clips (layer);
   for (tmp = clips; tmp; tmp = tmp->next) {
     if (GES_IS_TRANSITION_CLIP (tmp->data)) {
-      GList *tmpautotrans;
-      gboolean found = FALSE;
-
-      for (tmpautotrans = timeline->priv->auto_transitions; tmpautotrans;
-          tmpautotrans = tmpautotrans->next) {
-        if (GES_AUTO_TRANSITION (tmpautotrans->data)->transition_clip ==
-            tmp->data) {
-          found = TRUE;
-          break;
-        }
-      }
-
-      if (!found) {
+      if (!g_hash_table_contains (timeline->priv->auto_transitions_by_clip,
+              tmp->data)) {
         GST_ERROR_OBJECT (timeline,
             "Transition %s could not be wrapped into an auto transition"
             " REMOVING it", GES_TIMELINE_ELEMENT_NAME (tmp->data));
@@ -1928,6 +2321,7 @@ layer_priority_changed_cb (GESLayer * layer,
 
   timeline->layers = g_list_sort (timeline->layers, (GCompareFunc)
       sort_layers);
+  timeline->priv->commit_all = TRUE;
 }
 
 void
@@ -2091,8 +2485,13 @@ timeline_add_element (GESTimeline * timeline, GESTimelineElement * element)
   if (GES_IS_SOURCE (element)) {
     ges_source_set_rendering_smartly (GES_SOURCE (element),
         timeline->priv->rendering_smartly);
+    ges_source_release_converters (GES_SOURCE (element), timeline);
   }
 
+  if (GES_IS_TRACK_ELEMENT (element))
+    timeline_track_element_changed (timeline, GES_TRACK_ELEMENT (element),
+        ges_track_element_get_track (GES_TRACK_ELEMENT (element)));
+
   return TRUE;
 }
 
@@ -2101,6 +2500,7 @@ timeline_remove_element (GESTimeline * timeline, GESTimelineElement * element)
 {
   if (g_hash_table_remove (timeline->priv->all_elements, element->name)) {
     timeline_tree_stop_tracking_element (timeline->priv->tree, element);
+    g_hash_table_remove (timeline->priv->dirty_sources, element);
 
     return TRUE;
   }
@@ -2108,6 +2508,46 @@ timeline_remove_element (GESTimeline * timeline, GESTimelineElement * element)
   return FALSE;
 }
 
+/* Records that @track needs to be committed on next commit */
+void
+timeline_track_changed (GESTimeline * timeline, GESTrack * track)
+{
+  GList *tmp = g_list_find_custom (timeline->priv->priv_tracks, track,
+      (GCompareFunc) custom_find_track);
+
+  if (tmp)
+    ((TrackPrivate *) tmp->data)->dirty = TRUE;
+}
+
+/* Records that @element changed in a way that its @track needs to be
+ * committed, the priorities of its layer resynced and its
+ * auto-transitions updated on next commit */
+void
+timeline_track_element_changed (GESTimeline * timeline,
+    GESTrackElement * element, GESTrack * track)
+{
+  GESTimelinePrivate *priv = timeline->priv;
+  GESTimelineElement *parent = GES_TIMELINE_ELEMENT_PARENT (element);
+
+  if (priv->disposed)
+    return;
+
+  if (track)
+    timeline_track_changed (timeline, track);
+
+  if (GES_IS_CLIP (parent)) {
+    GESLayer *layer = ges_clip_get_layer (GES_CLIP (parent));
+
+    if (layer) {
+      g_hash_table_add (priv->dirty_layers, layer);
+      gst_object_unref (layer);
+    }
+  }
+
+  if (GES_IS_SOURCE (element))
+    g_hash_table_add (priv->dirty_sources, gst_object_ref (element));
+}
+
 void
 timeline_fill_gaps (GESTimeline * timeline)
 {
@@ -2152,6 +2592,58 @@ ges_timeline_get_smart_rendering (GESTimeline * timeline)
   return timeline->priv->rendering_smartly;
 }
 
+/* Whether the uri sources decode the proxies generated for their media
+ * files, read when they go to PAUSED */
+void
+ges_timeline_set_use_generated_proxies (GESTimeline * timeline,
+    gboolean use_generated_proxies)
+{
+  g_atomic_int_set (&timeline->priv->use_generated_proxies,
+      use_generated_proxies);
+}
+
+gboolean
+ges_timeline_get_use_generated_proxies (GESTimeline * timeline)
+{
+  return g_atomic_int_get (&timeline->priv->use_generated_proxies);
+}
+
+GESDecoderPool *
+timeline_get_decoder_pool (GESTimeline * timeline)
+{
+  return ges_decoder_pool_ref (timeline->priv->decoder_pool);
+}
+
+gboolean
+timeline_get_occlusion_culling (GESTimeline * timeline)
+{
+  return g_atomic_int_get (&timeline->priv->occlusion_culling);
+}
+
+GESWarmSources *
+timeline_get_warm_sources (GESTimeline * timeline)
+{
+  return ges_warm_sources_ref (timeline->priv->warm_sources);
+}
+
+gboolean
+timeline_get_still_frames (GESTimeline * timeline)
+{
+  return g_atomic_int_get (&timeline->priv->still_frames);
+}
+
+gboolean
+timeline_get_native_transitions (GESTimeline * timeline)
+{
+  return g_atomic_int_get (&timeline->priv->native_transitions);
+}
+
+gboolean
+timeline_get_smart_cut (GESTimeline * timeline)
+{
+  return g_atomic_int_get (&timeline->priv->smart_cut);
+}
+
 /**** API *****/
 /**
  * ges_timeline_new:
@@ -2384,6 +2876,7 @@ ges_timeline_add_layer (GESTimeline * timeline, GESLayer * layer)
   gst_object_ref_sink (layer);
   timeline->layers = g_list_insert_sorted (timeline->layers, layer,
       (GCompareFunc) sort_layers);
+  timeline->priv->commit_all = TRUE;
 
   /* Inform the layer that it belongs to a new timeline */
   ges_layer_set_timeline (layer, timeline);
@@ -2453,6 +2946,8 @@ ges_timeline_remove_layer (GESTimeline * timeline, GESLayer * layer)
       timeline);
 
   timeline->layers = g_list_remove (timeline->layers, layer);
+  g_hash_table_remove (timeline->priv->dirty_layers, layer);
+  timeline->priv->commit_all = TRUE;
   ges_layer_set_timeline (layer, NULL);
   /* FIXME: we should resync the layer priorities */
 
@@ -2519,6 +3014,9 @@ ges_timeline_add_track (GESTimeline * timeline, GESTrack * track)
   tr_priv->track = track;
   tr_priv->track_element_added_sigid = g_signal_connect (track,
       "track-element-added", G_CALLBACK (track_element_added_cb), timeline);
+  /* Changing it adds or removes the mixer from the composition */
+  tr_priv->track_changed_sigid = g_signal_connect (track,
+      "notify::mixing", G_CALLBACK (track_changed_cb), tr_priv);
 
   update_stream_object (tr_priv);
   gst_stream_collection_add_stream (timeline->priv->stream_collection,
@@ -2528,6 +3026,8 @@ ges_timeline_add_track (GESTimeline * timeline, GESTrack * track)
   timeline->priv->priv_tracks = g_list_append (timeline->priv->priv_tracks,
       tr_priv);
   timeline->tracks = g_list_append (timeline->tracks, track);
+  timeline->priv->commit_all = TRUE;
+  timeline->priv->tracks_changed = TRUE;
 
   /* Inform the track that it's currently being used by ourself */
   ges_track_set_timeline (track, timeline);
@@ -2616,6 +3116,8 @@ ges_timeline_remove_track (GESTimeline * timeline, GESTrack * track)
   }
 
   timeline->tracks = g_list_remove (timeline->tracks, track);
+  timeline->priv->commit_all = TRUE;
+  timeline->priv->tracks_changed = TRUE;
   ges_track_set_timeline (track, NULL);
 
   /* Remove ghost pad */
@@ -2638,6 +3140,7 @@ ges_timeline_remove_track (GESTimeline * timeline, GESTrack * track)
   }
 
   g_signal_handler_disconnect (track, tr_priv->track_element_added_sigid);
+  g_signal_handler_disconnect (track, tr_priv->track_changed_sigid);
 
   /* set track state to NULL */
   gst_element_set_state (GST_ELEMENT (track), GST_STATE_NULL);
@@ -2781,51 +3284,112 @@ track_commited_cb (GESTrack * track, GESTimeline * timeline)
 static gboolean
 ges_timeline_commit_unlocked (GESTimeline * timeline)
 {
-  GList *tmp;
+  GList *tmp, *tracks = NULL;
+  GHashTable *sources;
+  GHashTableIter iter;
+  gpointer source;
   gboolean res = TRUE;
+  GESTimelinePrivate *priv = timeline->priv;
+  gboolean commit_all = priv->commit_all;
+  gboolean collection_changed = priv->tracks_changed;
 
-  GST_DEBUG_OBJECT (timeline, "commiting changes");
+  GST_DEBUG_OBJECT (timeline, "commiting changes%s",
+      commit_all ? "" : " of the dirty layers and tracks");
+
+  if (priv->commit_source) {
+    g_source_destroy (priv->commit_source);
+    g_clear_pointer (&priv->commit_source, g_source_unref);
+  }
+
+  /* Sources changed while creating the transitions will be checked
+   * again on next commit */
+  sources = priv->dirty_sources;
+  priv->dirty_sources =
+      g_hash_table_new_full (NULL, NULL, gst_object_unref, NULL);
+  if (commit_all) {
+    timeline_tree_create_transitions (priv->tree,
+        ges_timeline_find_auto_transition);
+  } else {
+    g_hash_table_iter_init (&iter, sources);
+    while (g_hash_table_iter_next (&iter, &source, NULL)) {
+      if (GES_TIMELINE_ELEMENT_TIMELINE (source) == timeline)
+        timeline_tree_create_transitions_for_track_element (priv->tree,
+            source, ges_timeline_find_auto_transition);
+    }
+  }
+  g_hash_table_unref (sources);
 
-  timeline_tree_create_transitions (timeline->priv->tree,
-      ges_timeline_find_auto_transition);
   for (tmp = timeline->layers; tmp; tmp = tmp->next) {
     GESLayer *layer = tmp->data;
 
     /* Ensure clip priorities are correct after an edit */
-    ges_layer_resync_priorities (layer);
+    if (commit_all || g_hash_table_contains (priv->dirty_layers, layer))
+      ges_layer_resync_priorities (layer);
   }
+  g_hash_table_remove_all (priv->dirty_layers);
+  priv->commit_all = FALSE;
+  priv->tracks_changed = FALSE;
 
-  timeline->priv->expected_commited =
-      g_list_length (timeline->priv->priv_tracks);
+  LOCK_DYN (timeline);
+  for (tmp = timeline->tracks; tmp; tmp = tmp->next) {
+    TrackPrivate *tr_priv =
+        g_list_find_custom (priv->priv_tracks, tmp->data,
+        (GCompareFunc) custom_find_track)->data;
 
-  if (timeline->priv->expected_commited == 0) {
-    g_signal_emit (timeline, ges_timeline_signals[COMMITED], 0);
-  } else {
-    GstStreamCollection *collection = gst_stream_collection_new (NULL);
+    if (update_stream_object (tr_priv))
+      collection_changed = TRUE;
 
-    LOCK_DYN (timeline);
-    for (tmp = timeline->tracks; tmp; tmp = tmp->next) {
-      TrackPrivate *tr_priv =
-          g_list_find_custom (timeline->priv->priv_tracks, tmp->data,
-          (GCompareFunc) custom_find_track)->data;
+    if (commit_all || tr_priv->dirty) {
+      tr_priv->dirty = FALSE;
+      tracks = g_list_prepend (tracks, tr_priv->track);
+    }
+  }
 
-      update_stream_object (tr_priv);
+  if (collection_changed) {
+    GstStreamCollection *collection = gst_stream_collection_new (NULL);
+
+    for (tmp = priv->priv_tracks; tmp; tmp = tmp->next)
       gst_stream_collection_add_stream (collection,
-          gst_object_ref (tr_priv->stream));
+          gst_object_ref (((TrackPrivate *) tmp->data)->stream));
+
+    gst_object_unref (priv->stream_collection);
+    priv->stream_collection = collection;
+  }
+
+  priv->expected_commited = g_list_length (tracks);
+  if (!tracks) {
+    GST_DEBUG_OBJECT (timeline, "No track to commit");
+  } else {
+    tracks = g_list_reverse (tracks);
+    for (tmp = tracks; tmp; tmp = tmp->next) {
       g_signal_connect (tmp->data, "commited", G_CALLBACK (track_commited_cb),
           timeline);
       if (!ges_track_commit (GES_TRACK (tmp->data)))
         res = FALSE;
     }
+  }
+  UNLOCK_DYN (timeline);
 
-    gst_object_unref (timeline->priv->stream_collection);
-    timeline->priv->stream_collection = collection;
-    UNLOCK_DYN (timeline);
+  if (!tracks) {
+    g_signal_emit (timeline, ges_timeline_signals[COMMITED], 0);
+    res = FALSE;
   }
+  g_list_free (tracks);
 
   return res;
 }
 
+static gboolean
+coalesced_commit_cb (GESTimeline * timeline)
+{
+  GST_DEBUG_OBJECT (timeline, "Committing the coalesced changes");
+
+  g_clear_pointer (&timeline->priv->commit_source, g_source_unref);
+  ges_timeline_commit (timeline);
+
+  return G_SOURCE_REMOVE;
+}
+
 /**
  * ges_timeline_commit:
  * @timeline: A #GESTimeline
@@ -2850,6 +3414,11 @@ ges_timeline_commit_unlocked (GESTimeline * timeline)
  * usually triggered by a corresponding state changes in a containing
  * #GESPipeline.
  *
+ * Only the tracks and layers affected by the changes made since the last
+ * commit are updated. If #GESTimeline:coalesce-commits is set, the commit
+ * is only scheduled on the thread-default #GMainContext, and %TRUE is
+ * returned.
+ *
  * Returns: %TRUE if pending changes were committed, or %FALSE if nothing
  * needed to be committed.
  */
@@ -2861,6 +3430,23 @@ ges_timeline_commit (GESTimeline * timeline)
 
   g_return_val_if_fail (GES_IS_TIMELINE (timeline), FALSE);
 
+  if (timeline->priv->coalesce_commits) {
+    if (!timeline->priv->commit_source) {
+      GMainContext *context = g_main_context_ref_thread_default ();
+
+      GST_DEBUG_OBJECT (timeline, "Scheduling commit");
+      timeline->priv->commit_source = g_idle_source_new ();
+      g_source_set_priority (timeline->priv->commit_source,
+          G_PRIORITY_DEFAULT);
+      g_source_set_callback (timeline->priv->commit_source,
+          (GSourceFunc) coalesced_commit_cb, timeline, NULL);
+      g_source_attach (timeline->priv->commit_source, context);
+      g_main_context_unref (context);
+    }
+
+    return TRUE;
+  }
+
   LOCK_DYN (timeline);
   ret = ges_timeline_commit_unlocked (timeline);
   UNLOCK_DYN (timeline);
@@ -2879,6 +3465,7 @@ static void
 commited_cb (GESTimeline * timeline)
 {
   g_mutex_lock (&timeline->priv->commited_lock);
+  timeline->priv->commit_done = TRUE;
   g_cond_signal (&timeline->priv->commited_cond);
   g_mutex_unlock (&timeline->priv->commited_lock);
 }
@@ -2919,10 +3506,16 @@ ges_timeline_commit_sync (GESTimeline * timeline)
         g_signal_connect (timeline, "commited", (GCallback) commited_cb, NULL);
 
     g_mutex_lock (&timeline->priv->commited_lock);
+    timeline->priv->commit_done = FALSE;
+    g_mutex_unlock (&timeline->priv->commited_lock);
 
+    /* "commited" is emitted right away if no track needs to be committed */
     ret = ges_timeline_commit_unlocked (timeline);
-    g_cond_wait (&timeline->priv->commited_cond,
-        &timeline->priv->commited_lock);
+
+    g_mutex_lock (&timeline->priv->commited_lock);
+    while (!timeline->priv->commit_done)
+      g_cond_wait (&timeline->priv->commited_cond,
+          &timeline->priv->commited_lock);
     g_mutex_unlock (&timeline->priv->commited_lock);
     g_signal_handler_disconnect (timeline, handler_id);
   }
@@ -3334,3 +3927,25 @@ ges_timeline_get_frame_at (GESTimeline * self, GstClockTime timestamp)
 
   return gst_util_uint64_scale (timestamp, fps_n, fps_d * GST_SECOND);
 }
+
+/**
+ * ges_timeline_get_decoder_pool_stats:
+ * @timeline: The #GESTimeline
+ * @hits: (out) (optional): The number of times a source reused an idle
+ * decoder
+ * @misses: (out) (optional): The number of times a source had to set up a
+ * new decoder while the pool was enabled
+ *
+ * Gets how well the decoders kept around because of
+ * #GESTimeline:decoder-pool-size are reused.
+ *
+ * Since: 1.20
+ */
+void
+ges_timeline_get_decoder_pool_stats (GESTimeline * timeline, guint * hits,
+    guint * misses)
+{
+  g_return_if_fail (GES_IS_TIMELINE (timeline));
+
+  ges_decoder_pool_get_stats (timeline->priv->decoder_pool, hits, misses);
+}
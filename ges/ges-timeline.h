@@ -156,4 +156,9 @@ GES_API
 GESFrameNumber ges_timeline_get_frame_at (GESTimeline *self,
                                           GstClockTime timestamp);
 
+GES_API
+void ges_timeline_get_decoder_pool_stats (GESTimeline *timeline,
+                                          guint *hits,
+                                          guint *misses);
+
 G_END_DECLS
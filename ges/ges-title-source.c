@@ -234,7 +234,7 @@ ges_title_source_create_source (GESSource * source)
   ges_track_element_add_children_props (GES_TRACK_ELEMENT (source), background,
       NULL, NULL, bg_props);
 
-  return topbin;
+  return ges_still_frame_bin_new (GES_TRACK_ELEMENT (source), topbin, NULL);
 }
 
 /**
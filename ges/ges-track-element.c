@@ -566,11 +566,90 @@ interpolate_values_for_position (GstTimedValue * first_value,
   return value_at_pos;
 }
 
+/* The keyframes of timed value control sources are kept sorted in a
+ * GSequence, a balanced tree, so they are looked up with binary searches
+ * instead of copying them all to a list. */
+
+/* Returns the first keyframe at or after @timestamp, or the end iter.
+ * Must be called with the control source lock held */
+static GSequenceIter *
+_keyframe_iter_from (GstTimedValueControlSource * source,
+    GstClockTime timestamp)
+{
+  GSequenceIter *iter =
+      gst_timed_value_control_source_find_control_point_iter (source,
+      timestamp);
+
+  if (!iter)
+    return g_sequence_get_begin_iter (source->values);
+
+  if (((GstTimedValue *) g_sequence_get (iter))->timestamp < timestamp)
+    iter = g_sequence_iter_next (iter);
+
+  return iter;
+}
+
+/* Copies the keyframe at @iter to @value, returns %NULL if there is none.
+ * Must be called with the control source lock held */
+static GstTimedValue *
+_copy_keyframe (GSequenceIter * iter, GstTimedValue * value)
+{
+  if (!iter || g_sequence_iter_is_end (iter))
+    return NULL;
+
+  *value = *(GstTimedValue *) g_sequence_get (iter);
+
+  return value;
+}
+
+/* Removes the keyframes of @source in [@start, @stop), @stop being
+ * possibly GST_CLOCK_TIME_NONE, and returns how many were removed */
+static guint
+_unset_keyframes (GstTimedValueControlSource * source, GstClockTime start,
+    GstClockTime stop)
+{
+  guint i, n_removed;
+  GArray *timestamps;
+  GSequenceIter *iter, *stop_iter;
+
+  if (GST_CLOCK_TIME_IS_VALID (stop) && stop <= start)
+    return 0;
+
+  timestamps = g_array_new (FALSE, FALSE, sizeof (GstClockTime));
+
+  GST_TIMED_VALUE_CONTROL_SOURCE_LOCK (source);
+  if (source->values) {
+    iter = _keyframe_iter_from (source, start);
+    stop_iter = GST_CLOCK_TIME_IS_VALID (stop) ?
+        _keyframe_iter_from (source, stop) :
+        g_sequence_get_end_iter (source->values);
+
+    for (; iter != stop_iter; iter = g_sequence_iter_next (iter)) {
+      GstClockTime timestamp = ((GstTimedValue *) g_sequence_get (iter))->
+          timestamp;
+
+      g_array_append_val (timestamps, timestamp);
+    }
+  }
+  GST_TIMED_VALUE_CONTROL_SOURCE_UNLOCK (source);
+
+  /* Unsetting takes the lock and notifies the removal of each value */
+  for (i = 0; i < timestamps->len; i++)
+    gst_timed_value_control_source_unset (source,
+        g_array_index (timestamps, GstClockTime, i));
+
+  n_removed = timestamps->len;
+  g_array_free (timestamps, TRUE);
+
+  return n_removed;
+}
+
 static void
 _update_control_source (GstTimedValueControlSource * source, gboolean absolute,
     GstClockTime inpoint, GstClockTime outpoint)
 {
-  GList *values, *tmp;
+  GSequenceIter *iter, *begin, *last_iter;
+  GstTimedValue first_value, next_value, prev_value, last_value;
   GstTimedValue *last, *first, *prev = NULL, *next = NULL;
   gfloat value_at_pos;
 
@@ -579,25 +658,29 @@ _update_control_source (GstTimedValueControlSource * source, gboolean absolute,
     return;
   }
 
-  values = gst_timed_value_control_source_get_all (source);
-
-  if (g_list_length (values) == 0)
+  GST_TIMED_VALUE_CONTROL_SOURCE_LOCK (source);
+  if (!source->values || !source->nvalues) {
+    GST_TIMED_VALUE_CONTROL_SOURCE_UNLOCK (source);
     return;
+  }
 
-  first = values->data;
-
-  for (tmp = values->next; tmp; tmp = tmp->next) {
-    next = tmp->data;
-
-    if (next->timestamp == inpoint) {
-      /* just leave this value in place */
-      first = NULL;
-      break;
-    }
-    if (next->timestamp > inpoint)
-      break;
+  /* The first keyframe gets moved to the in-point, with the value
+   * interpolated from the first keyframe after the in-point */
+  begin = g_sequence_get_begin_iter (source->values);
+  first = _copy_keyframe (begin, &first_value);
+  iter = _keyframe_iter_from (source, inpoint);
+  if (iter == begin) {
+    next = _copy_keyframe (g_sequence_iter_next (begin), &next_value);
+  } else if (g_sequence_iter_is_end (iter)) {
+    if (source->nvalues > 1)
+      next = _copy_keyframe (g_sequence_iter_prev (iter), &next_value);
+  } else if (((GstTimedValue *) g_sequence_get (iter))->timestamp == inpoint) {
+    /* just leave this value in place */
+    first = NULL;
+  } else {
+    next = _copy_keyframe (iter, &next_value);
   }
-  g_list_free (values);
+  GST_TIMED_VALUE_CONTROL_SOURCE_UNLOCK (source);
 
   if (first) {
     value_at_pos =
@@ -607,22 +690,30 @@ _update_control_source (GstTimedValueControlSource * source, gboolean absolute,
   }
 
   if (GST_CLOCK_TIME_IS_VALID (outpoint)) {
-    values = gst_timed_value_control_source_get_all (source);
-
-    last = g_list_last (values)->data;
-
-    for (tmp = g_list_last (values)->prev; tmp; tmp = tmp->prev) {
-      prev = tmp->data;
-
-      if (prev->timestamp == outpoint) {
-        /* leave this value in place */
-        last = NULL;
-        break;
+    GST_TIMED_VALUE_CONTROL_SOURCE_LOCK (source);
+    /* Same for the last keyframe and the out-point */
+    last_iter = g_sequence_iter_prev (g_sequence_get_end_iter (source->values));
+    last = _copy_keyframe (last_iter, &last_value);
+    if (source->nvalues > 1) {
+      if (last->timestamp <= outpoint) {
+        prev = _copy_keyframe (g_sequence_iter_prev (last_iter), &prev_value);
+      } else {
+        iter = gst_timed_value_control_source_find_control_point_iter (source,
+            outpoint);
+
+        if (!iter) {
+          prev = _copy_keyframe (g_sequence_get_begin_iter (source->values),
+              &prev_value);
+        } else if (((GstTimedValue *) g_sequence_get (iter))->timestamp ==
+            outpoint) {
+          /* leave this value in place */
+          last = NULL;
+        } else {
+          prev = _copy_keyframe (iter, &prev_value);
+        }
       }
-      if (prev->timestamp < outpoint)
-        break;
     }
-    g_list_free (values);
+    GST_TIMED_VALUE_CONTROL_SOURCE_UNLOCK (source);
 
     if (last) {
       value_at_pos =
@@ -633,16 +724,9 @@ _update_control_source (GstTimedValueControlSource * source, gboolean absolute,
     }
   }
 
-  values = gst_timed_value_control_source_get_all (source);
-
-  for (tmp = values; tmp; tmp = tmp->next) {
-    GstTimedValue *value = tmp->data;
-    if (value->timestamp < inpoint)
-      gst_timed_value_control_source_unset (source, value->timestamp);
-    else if (GST_CLOCK_TIME_IS_VALID (outpoint) && value->timestamp > outpoint)
-      gst_timed_value_control_source_unset (source, value->timestamp);
-  }
-  g_list_free (values);
+  _unset_keyframes (source, 0, inpoint);
+  if (GST_CLOCK_TIME_IS_VALID (outpoint))
+    _unset_keyframes (source, outpoint + 1, GST_CLOCK_TIME_NONE);
 }
 
 static void
@@ -679,6 +763,16 @@ _update_control_bindings (GESTrackElement * self, GstClockTime inpoint,
   }
 }
 
+/* Lets the timeline know that the nleobject has changes to commit */
+static void
+_nleobject_changed (GESTrackElement * self)
+{
+  GESTimeline *timeline = GES_TIMELINE_ELEMENT_TIMELINE (self);
+
+  if (timeline)
+    timeline_track_element_changed (timeline, self, self->priv->track);
+}
+
 static gboolean
 _set_start (GESTimelineElement * element, GstClockTime start)
 {
@@ -687,6 +781,7 @@ _set_start (GESTimelineElement * element, GstClockTime start)
   g_return_val_if_fail (object->priv->nleobject, FALSE);
 
   g_object_set (object->priv->nleobject, "start", start, NULL);
+  _nleobject_changed (object);
 
   return TRUE;
 }
@@ -756,6 +851,7 @@ _set_inpoint (GESTimelineElement * element, GstClockTime inpoint)
   }
 
   g_object_set (object->priv->nleobject, "inpoint", inpoint, NULL);
+  _nleobject_changed (object);
 
   ges_track_element_update_outpoint_full (object, inpoint, element->duration);
 
@@ -771,6 +867,7 @@ _set_duration (GESTimelineElement * element, GstClockTime duration)
   g_return_val_if_fail (priv->nleobject, FALSE);
 
   g_object_set (priv->nleobject, "duration", duration, NULL);
+  _nleobject_changed (object);
 
   ges_track_element_update_outpoint_full (object, element->inpoint, duration);
 
@@ -838,6 +935,7 @@ _set_priority (GESTimelineElement * element, guint32 priority)
   }
 
   g_object_set (object->priv->nleobject, "priority", priority, NULL);
+  _nleobject_changed (object);
 
   return TRUE;
 }
@@ -884,6 +982,7 @@ ges_track_element_set_active (GESTrackElement * object, gboolean active)
 
   g_object_set (object->priv->nleobject, "active",
       active & object->priv->layer_active, NULL);
+  _nleobject_changed (object);
 
   object->active = active;
   if (GES_TRACK_ELEMENT_GET_CLASS (object)->active_changed)
@@ -1196,6 +1295,7 @@ ges_track_element_set_track (GESTrackElement * object, GESTrack * track,
     GError ** error)
 {
   GESTimelineElement *parent = GES_TIMELINE_ELEMENT_PARENT (object);
+  GESTimeline *timeline = GES_TIMELINE_ELEMENT_TIMELINE (object);
 
   g_return_val_if_fail (object->priv->nleobject, FALSE);
 
@@ -1210,7 +1310,13 @@ ges_track_element_set_track (GESTrackElement * object, GESTrack * track,
     return FALSE;
   }
 
+  /* The track the element is leaving needs to be committed too */
+  _nleobject_changed (object);
   object->priv->track = track;
+  if (timeline)
+    timeline_tree_update_element_position (timeline_get_tree (timeline),
+        GES_TIMELINE_ELEMENT (object));
+  _nleobject_changed (object);
 
   if (object->priv->track) {
     ges_track_element_set_track_type (object, track->type);
@@ -1232,6 +1338,7 @@ ges_track_element_set_layer_active (GESTrackElement * element, gboolean active)
   element->priv->layer_active = active;
   g_object_set (element->priv->nleobject, "active", active & element->active,
       NULL);
+  _nleobject_changed (element);
 }
 
 /**
@@ -2034,6 +2141,125 @@ ges_track_element_clamp_control_source (GESTrackElement * object,
   gst_object_unref (source);
 }
 
+/* Returns: (transfer full) (nullable): The timed value control source
+ * bound to @property_name */
+static GstTimedValueControlSource *
+_get_timed_value_control_source (GESTrackElement * object,
+    const gchar * property_name, gboolean * absolute)
+{
+  GstControlBinding *binding;
+  GstControlSource *source;
+
+  binding = ges_track_element_get_control_binding (object, property_name);
+  if (!binding) {
+    GST_WARNING_OBJECT (object, "No control binding for %s", property_name);
+    return NULL;
+  }
+
+  g_object_get (binding, "control-source", &source, "absolute", absolute,
+      NULL);
+
+  if (!GST_IS_TIMED_VALUE_CONTROL_SOURCE (source)) {
+    GST_WARNING_OBJECT (object, "The control source for %s is not a timed "
+        "value control source", property_name);
+    gst_clear_object (&source);
+    return NULL;
+  }
+
+  return GST_TIMED_VALUE_CONTROL_SOURCE (source);
+}
+
+/**
+ * ges_track_element_set_control_values:
+ * @object: A #GESTrackElement
+ * @property_name: The name of the child property to set keyframes for
+ * @timestamps: (array length=n_values): The times of the keyframes, in
+ * the internal time coordinates of @object
+ * @values: (array length=n_values): The values of the keyframes
+ * @n_values: The number of keyframes to set
+ *
+ * Sets keyframes on the #GstTimedValueControlSource bound to the specified
+ * child property with ges_track_element_set_control_source().
+ *
+ * If #GESTrackElement:auto-clamp-control-sources is %TRUE, the control
+ * source is then clamped, as done by
+ * ges_track_element_clamp_control_source(), once for all the keyframes.
+ *
+ * Returns: %TRUE if the keyframes could be set, %FALSE if
+ * @property_name does not have a #GstTimedValueControlSource.
+ *
+ * Since: 1.20
+ */
+gboolean
+ges_track_element_set_control_values (GESTrackElement * object,
+    const gchar * property_name, const GstClockTime * timestamps,
+    const gdouble * values, guint n_values)
+{
+  guint i;
+  gboolean absolute;
+  GstTimedValueControlSource *source;
+
+  g_return_val_if_fail (GES_IS_TRACK_ELEMENT (object), FALSE);
+  g_return_val_if_fail (property_name, FALSE);
+  g_return_val_if_fail (n_values == 0 || (timestamps && values), FALSE);
+
+  source = _get_timed_value_control_source (object, property_name, &absolute);
+  if (!source)
+    return FALSE;
+
+  for (i = 0; i < n_values; i++)
+    gst_timed_value_control_source_set (source, timestamps[i], values[i]);
+
+  if (object->priv->auto_clamp_control_sources &&
+      !object->priv->freeze_control_sources)
+    _update_control_source (source, absolute, _INPOINT (object),
+        object->priv->outpoint);
+  gst_object_unref (source);
+
+  return TRUE;
+}
+
+/**
+ * ges_track_element_unset_control_values:
+ * @object: A #GESTrackElement
+ * @property_name: The name of the child property to remove keyframes for
+ * @start: The time of the first keyframe to remove, in the internal time
+ * coordinates of @object
+ * @stop: The time up to which keyframes are removed, excluded, or
+ * #GST_CLOCK_TIME_NONE to remove all the keyframes from @start
+ *
+ * Removes the keyframes lying between @start and @stop from the
+ * #GstTimedValueControlSource bound to the specified child property with
+ * ges_track_element_set_control_source(). The range is found with binary
+ * searches, so that removing a few keyframes from a control source with
+ * many of them is cheap.
+ *
+ * Returns: The number of removed keyframes.
+ *
+ * Since: 1.20
+ */
+guint
+ges_track_element_unset_control_values (GESTrackElement * object,
+    const gchar * property_name, GstClockTime start, GstClockTime stop)
+{
+  guint n_removed;
+  gboolean absolute;
+  GstTimedValueControlSource *source;
+
+  g_return_val_if_fail (GES_IS_TRACK_ELEMENT (object), 0);
+  g_return_val_if_fail (property_name, 0);
+  g_return_val_if_fail (GST_CLOCK_TIME_IS_VALID (start), 0);
+
+  source = _get_timed_value_control_source (object, property_name, &absolute);
+  if (!source)
+    return 0;
+
+  n_removed = _unset_keyframes (source, start, stop);
+  gst_object_unref (source);
+
+  return n_removed;
+}
+
 /**
  * ges_track_element_set_auto_clamp_control_sources:
  * @object: A #GESTrackElement
@@ -192,6 +192,19 @@ GES_API void
 ges_track_element_clamp_control_source        (GESTrackElement * object,
                                                const gchar * property_name);
 
+GES_API gboolean
+ges_track_element_set_control_values          (GESTrackElement * object,
+                                               const gchar * property_name,
+                                               const GstClockTime * timestamps,
+                                               const gdouble * values,
+                                               guint n_values);
+
+GES_API guint
+ges_track_element_unset_control_values        (GESTrackElement * object,
+                                               const gchar * property_name,
+                                               GstClockTime start,
+                                               GstClockTime stop);
+
 GES_API void
 ges_track_element_set_auto_clamp_control_sources (GESTrackElement * object,
                                                   gboolean auto_clamp);
@@ -73,6 +73,14 @@ typedef struct
   GESTrack *track;
 } Gap;
 
+/* A range of time that needs to be filled by a Gap */
+typedef struct
+{
+  GstClockTime start;
+  GstClockTime duration;
+  gboolean filled;
+} GapRange;
+
 struct _GESTrackPrivate
 {
   /*< private > */
@@ -204,11 +212,52 @@ free_gap (Gap * gap)
   g_slice_free (Gap, gap);
 }
 
+static void
+gap_set_range (Gap * gap, GstClockTime start, GstClockTime duration)
+{
+  GST_DEBUG_OBJECT (gap->track, "Moving gap with start %" GST_TIME_FORMAT
+      " duration %" GST_TIME_FORMAT " to start %" GST_TIME_FORMAT
+      " duration %" GST_TIME_FORMAT, GST_TIME_ARGS (gap->start),
+      GST_TIME_ARGS (gap->duration), GST_TIME_ARGS (start),
+      GST_TIME_ARGS (duration));
+
+  gap->start = start;
+  gap->duration = duration;
+  g_object_set (gap->nleobj, "start", start, "duration", duration, NULL);
+}
+
+static gint
+compare_gap_start (Gap * a, Gap * b)
+{
+  if (a->start < b->start)
+    return -1;
+  if (a->start > b->start)
+    return 1;
+  return 0;
+}
+
+static void
+add_gap_range (GArray * ranges, GstClockTime start, GstClockTime duration)
+{
+  GapRange range;
+
+  range.start = start;
+  range.duration = duration;
+  range.filled = FALSE;
+  g_array_append_val (ranges, range);
+}
+
+/* Gaps whose range did not change are kept as is, and gaps that are not
+ * needed anymore are moved to fill the new gaps, so that the composition
+ * only gets objects added or removed when the number of gaps changes */
 static inline void
 update_gaps (GESTrack * track)
 {
   Gap *gap;
-  GList *gaps;
+  guint i;
+  GList *tmp, *old_gaps, *unused_gaps = NULL;
+  GArray *ranges;
+  GPtrArray *layers = NULL;
   GSequenceIter *it;
 
   GESTrackElement *trackelement;
@@ -222,10 +271,15 @@ update_gaps (GESTrack * track)
     return;
   }
 
-  gaps = priv->gaps;
-  priv->gaps = NULL;
+  /* layers are sorted by priority, and their priority is their index */
+  if (priv->timeline) {
+    layers = g_ptr_array_sized_new (g_list_length (priv->timeline->layers));
+    for (tmp = priv->timeline->layers; tmp; tmp = tmp->next)
+      g_ptr_array_add (layers, tmp->data);
+  }
 
-  /* 1- And recalculate gaps */
+  /* 1- Compute the gaps */
+  ranges = g_array_new (FALSE, FALSE, sizeof (GapRange));
   for (it = g_sequence_get_begin_iter (priv->trackelements_by_start);
       g_sequence_iter_is_end (it) == FALSE; it = g_sequence_iter_next (it)) {
     trackelement = g_sequence_get (it);
@@ -233,11 +287,12 @@ update_gaps (GESTrack * track)
     if (!ges_track_element_is_active (trackelement))
       continue;
 
-    if (priv->timeline) {
+    if (layers) {
       guint32 layer_prio = GES_TIMELINE_ELEMENT_LAYER_PRIORITY (trackelement);
 
       if (layer_prio != GES_TIMELINE_ELEMENT_NO_LAYER_PRIORITY) {
-        GESLayer *layer = g_list_nth_data (priv->timeline->layers, layer_prio);
+        GESLayer *layer = layer_prio < layers->len ?
+            g_ptr_array_index (layers, layer_prio) : NULL;
 
         if (!ges_layer_get_active_for_track (layer, track))
           continue;
@@ -247,27 +302,18 @@ update_gaps (GESTrack * track)
     start = _START (trackelement);
     end = start + _DURATION (trackelement);
 
-    if (start > duration) {
-      /* 2- Fill gap */
-      gap = gap_new (track, duration, start - duration);
-
-      if (G_LIKELY (gap != NULL))
-        priv->gaps = g_list_prepend (priv->gaps, gap);
-    }
+    if (start > duration)
+      add_gap_range (ranges, duration, start - duration);
 
     duration = MAX (duration, end);
   }
 
-  /* 3- Add a gap at the end of the timeline if needed */
+  /* 2- Add a gap at the end of the timeline if needed */
   if (priv->timeline) {
     g_object_get (priv->timeline, "duration", &timeline_duration, NULL);
 
     if (duration < timeline_duration) {
-      gap = gap_new (track, duration, timeline_duration - duration);
-
-      if (G_LIKELY (gap != NULL)) {
-        priv->gaps = g_list_prepend (priv->gaps, gap);
-      }
+      add_gap_range (ranges, duration, timeline_duration - duration);
 
       /* FIXME: here the duration is set to the duration of the timeline,
        * but elsewhere it is set to the duration of the composition. Are
@@ -278,12 +324,62 @@ update_gaps (GESTrack * track)
 
   if (!track->priv->last_gap_disabled) {
     GST_DEBUG_OBJECT (track, "Adding a one second gap at the end");
-    gap = gap_new (track, timeline_duration, 1);
-    priv->gaps = g_list_prepend (priv->gaps, gap);
+    add_gap_range (ranges, timeline_duration, 1);
+  }
+
+  /* 3- Keep the gaps that did not change, both lists are sorted by start */
+  old_gaps = priv->gaps;
+  priv->gaps = NULL;
+  tmp = old_gaps;
+  for (i = 0; i < ranges->len; i++) {
+    GapRange *range = &g_array_index (ranges, GapRange, i);
+
+    for (; tmp && ((Gap *) tmp->data)->start < range->start; tmp = tmp->next)
+      unused_gaps = g_list_prepend (unused_gaps, tmp->data);
+
+    if (tmp && ((Gap *) tmp->data)->start == range->start) {
+      gap = tmp->data;
+      tmp = tmp->next;
+
+      if (gap->duration == range->duration) {
+        priv->gaps = g_list_prepend (priv->gaps, gap);
+        range->filled = TRUE;
+
+        continue;
+      }
+
+      unused_gaps = g_list_prepend (unused_gaps, gap);
+    }
+  }
+  for (; tmp; tmp = tmp->next)
+    unused_gaps = g_list_prepend (unused_gaps, tmp->data);
+  g_list_free (old_gaps);
+
+  /* 4- Fill the new gaps, reusing the unused ones first */
+  for (i = 0; i < ranges->len; i++) {
+    GapRange *range = &g_array_index (ranges, GapRange, i);
+
+    if (range->filled)
+      continue;
+
+    if (unused_gaps) {
+      gap = unused_gaps->data;
+      unused_gaps = g_list_delete_link (unused_gaps, unused_gaps);
+      gap_set_range (gap, range->start, range->duration);
+    } else {
+      gap = gap_new (track, range->start, range->duration);
+    }
+
+    if (G_LIKELY (gap != NULL))
+      priv->gaps = g_list_prepend (priv->gaps, gap);
   }
+  priv->gaps = g_list_sort (priv->gaps, (GCompareFunc) compare_gap_start);
 
-  /* 4- Remove old gaps */
-  g_list_free_full (gaps, (GDestroyNotify) free_gap);
+  /* 5- Remove the gaps that are not needed anymore */
+  g_list_free_full (unused_gaps, (GDestroyNotify) free_gap);
+  g_array_unref (ranges);
+  if (layers)
+    g_ptr_array_unref (layers);
 }
 
 void
@@ -1019,6 +1115,10 @@ ges_track_set_restriction_caps (GESTrack * track, const GstCaps * caps)
       !ges_timeline_get_smart_rendering (track->priv->timeline))
     g_object_set (priv->capsfilter, "caps", caps, NULL);
 
+  /* The gaps are created with the restriction caps */
+  if (priv->timeline)
+    timeline_track_changed (priv->timeline, track);
+
   g_object_notify (G_OBJECT (track), "restriction-caps");
 }
 
@@ -1225,8 +1325,8 @@ ges_track_add_element_full (GESTrack * track, GESTrackElement * object,
   timeline = track->priv->timeline;
   ges_timeline_element_set_timeline (el, timeline);
   /* check that we haven't broken the timeline configuration by adding this
-   * element to the track */
-  if (timeline
+   * element to the track, bulk adds are checked once they end */
+  if (timeline && !ges_timeline_is_bulk_adding (timeline)
       && !timeline_tree_can_move_element (timeline_get_tree (timeline), el,
           GES_TIMELINE_ELEMENT_LAYER_PRIORITY (el), el->start, el->duration,
           error)) {
@@ -0,0 +1,1418 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Transition mixers
+ *
+ * Transitions used to be bins of generic elements: two converters, a
+ * smptealpha and a compositor for video; three converters, two volumes,
+ * two resamplers and an audiomixer for audio. When their timeline has
+ * #GESTimeline:native-transitions set, GESVideoTransition and
+ * GESAudioTransition use the single elements implemented here instead.
+ * They never convert their inputs: they are only used when the inputs can
+ * be blended in the format they already have, which is decided by a
+ * GESTransitionBin each time the transition prerolls.
+ *
+ * Both elements have a controllable "position" property going from 0.0,
+ * where only the first requested sink pad is visible or audible, to 1.0,
+ * where only the second one is.
+ *
+ * The video blending works on 8 bits per component formats, the sinks
+ * only accepting the format of the output, which the converters ending
+ * the GES video sources produce. Crossfades blend eight bytes at a time in
+ * a 64 bits word, wipes use a mask computed once per wipe type and size.
+ * Input frames which are not already covering the whole output, as
+ * positioned by their #GstFramePositionerMeta, are first placed into a
+ * full frame. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+#include <string.h>
+
+#include <gst/audio/audio.h>
+#include <gst/audio/gstaudioaggregator.h>
+#include <gst/video/video.h>
+#include <gst/video/gstvideoaggregator.h>
+
+#include "ges-internal.h"
+#include "ges-enums.h"
+#include "gstframepositioner.h"
+
+GST_DEBUG_CATEGORY_STATIC (ges_transition_mixer_debug);
+#define GST_CAT_DEFAULT ges_transition_mixer_debug
+
+#define VIDEO_FORMATS "{ AYUV, ARGB, BGRA, ABGR, RGBA, xRGB, RGBx, xBGR, " \
+    "BGRx, Y444, Y42B, I420, YV12, NV12, NV21 }"
+
+#define AUDIO_FORMATS "{ " GST_AUDIO_NE (F32) ", " GST_AUDIO_NE (S32) ", " \
+    GST_AUDIO_NE (S16) " }"
+
+/* Weights are expressed in 1/256th so that blending a byte fits 16 bits */
+#define WEIGHT_ONE 256
+
+enum
+{
+  PROP_0,
+  PROP_POSITION,
+  PROP_TYPE,
+  PROP_INVERT,
+  PROP_BORDER,
+};
+
+/* Returns the value of the "position" property of @object at @stream_time,
+ * reading it from its control binding if it has one */
+static gdouble
+_position_at (GstObject * object, gdouble position, GstClockTime stream_time)
+{
+  GValue *value;
+  GstControlBinding *binding;
+
+  if (!GST_CLOCK_TIME_IS_VALID (stream_time))
+    return position;
+
+  binding = gst_object_get_control_binding (object, "position");
+  if (!binding)
+    return position;
+
+  value = gst_control_binding_get_value (binding, stream_time);
+  if (value) {
+    position = g_value_get_double (value);
+    g_value_unset (value);
+    g_free (value);
+  }
+  gst_object_unref (binding);
+
+  return CLAMP (position, 0.0, 1.0);
+}
+
+/* Whether @pad is the first requested sink pad of @element */
+static gboolean
+_is_first_sink_pad (GstElement * element, GstPad * pad)
+{
+  gboolean first;
+
+  GST_OBJECT_LOCK (element);
+  first = element->sinkpads && element->sinkpads->data == pad;
+  GST_OBJECT_UNLOCK (element);
+
+  return first;
+}
+
+/****************************************************
+ *               GESVideoTransitionMixer            *
+ ****************************************************/
+
+typedef struct
+{
+  /* Converts an input frame to a full output frame */
+  GstVideoConverter *convert;
+  GstVideoInfo convert_info;
+  gint x, y, width, height;
+  gdouble alpha;
+
+  GstBuffer *canvas;
+  GstVideoFrame canvas_frame;
+  gboolean canvas_mapped;
+} VideoInput;
+
+G_DECLARE_FINAL_TYPE (GESVideoTransitionMixer, ges_video_transition_mixer,
+    GES, VIDEO_TRANSITION_MIXER, GstVideoAggregator);
+
+struct _GESVideoTransitionMixer
+{
+  GstVideoAggregator parent;
+
+  /* Protected by the object lock */
+  gdouble position;
+  GESVideoStandardTransitionType type;
+  gboolean invert;
+  gint border;
+
+  /* Only accessed from the streaming thread */
+  VideoInput inputs[2];
+
+  /* Wipe value of each pixel, from 0 to G_MAXUINT16 */
+  guint16 *mask;
+  GESVideoStandardTransitionType mask_type;
+  gboolean mask_invert;
+  gint mask_width;
+  gint mask_height;
+
+  /* Weight of the second input for each pixel */
+  guint16 *weights;
+};
+
+#define GES_TYPE_VIDEO_TRANSITION_MIXER (ges_video_transition_mixer_get_type())
+G_DEFINE_TYPE (GESVideoTransitionMixer, ges_video_transition_mixer,
+    GST_TYPE_VIDEO_AGGREGATOR);
+
+static GstStaticPadTemplate video_src_template =
+GST_STATIC_PAD_TEMPLATE ("src", GST_PAD_SRC, GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (VIDEO_FORMATS)));
+
+static GstStaticPadTemplate video_sink_template =
+GST_STATIC_PAD_TEMPLATE ("sink_%u", GST_PAD_SINK, GST_PAD_REQUEST,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (VIDEO_FORMATS)));
+
+gboolean
+ges_video_transition_mixer_supports_type (GESVideoStandardTransitionType type)
+{
+  switch (type) {
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE:
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BAR_WIPE_LR:
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BAR_WIPE_TB:
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BOX_WIPE_TL:
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BOX_WIPE_TR:
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BOX_WIPE_BR:
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BOX_WIPE_BL:
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_FOUR_BOX_WIPE_CI:
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_FOUR_BOX_WIPE_CO:
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BARNDOOR_V:
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BARNDOOR_H:
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BOX_WIPE_TC:
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BOX_WIPE_RC:
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BOX_WIPE_BC:
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BOX_WIPE_LC:
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_IRIS_RECT:
+      return TRUE;
+    default:
+      return FALSE;
+  }
+}
+
+/* Whether @s has a single, fixed, format accepted by @template */
+static gboolean
+_has_format_of (GstStaticPadTemplate * template, const GstStructure * s)
+{
+  gboolean res;
+  GstCaps *format_caps, *template_caps;
+  const GValue *format = gst_structure_get_value (s, "format");
+
+  if (!format || !G_VALUE_HOLDS_STRING (format))
+    return FALSE;
+
+  template_caps = gst_static_pad_template_get_caps (template);
+  format_caps = gst_caps_new_simple (gst_structure_get_name (s), "format",
+      G_TYPE_STRING, g_value_get_string (format), NULL);
+  res = gst_caps_can_intersect (format_caps, template_caps);
+  gst_caps_unref (format_caps);
+  gst_caps_unref (template_caps);
+
+  return res;
+}
+
+/* Whether the frames of a track with @caps as restriction caps can be
+ * blended as they are. Without any format in @caps, the sinks make the
+ * sources produce one of the formats which can be blended */
+gboolean
+ges_video_transition_mixer_can_blend (const GstCaps * caps)
+{
+  GstCapsFeatures *features;
+  const GstStructure *structure;
+
+  if (!caps || gst_caps_is_any (caps))
+    return TRUE;
+
+  if (gst_caps_is_empty (caps))
+    return FALSE;
+
+  features = gst_caps_get_features (caps, 0);
+  if (features && !gst_caps_features_is_any (features) &&
+      !gst_caps_features_is_equal (features,
+          GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY))
+    return FALSE;
+
+  structure = gst_caps_get_structure (caps, 0);
+  if (!gst_structure_has_field (structure, "format"))
+    return TRUE;
+
+  return _has_format_of (&video_src_template, structure);
+}
+
+/* Returns the progress, from 0 to 1, at which the pixel at (@x, @y), in
+ * normalized coordinates, switches to the second input for @type, following
+ * the descriptions of the SMPTE wipe codes */
+static gdouble
+_wipe_value (GESVideoStandardTransitionType type, gdouble x, gdouble y)
+{
+  switch (type) {
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BAR_WIPE_LR:
+      return x;
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BAR_WIPE_TB:
+      return y;
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BOX_WIPE_TL:
+      return MAX (x, y);
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BOX_WIPE_TR:
+      return MAX (1.0 - x, y);
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BOX_WIPE_BR:
+      return MAX (1.0 - x, 1.0 - y);
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BOX_WIPE_BL:
+      return MAX (x, 1.0 - y);
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_FOUR_BOX_WIPE_CI:
+      return MAX (1.0 - fabs (2.0 * x - 1.0), 1.0 - fabs (2.0 * y - 1.0));
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_FOUR_BOX_WIPE_CO:
+      x = 2.0 * x - floor (2.0 * x);
+      y = 2.0 * y - floor (2.0 * y);
+      return MAX (fabs (2.0 * x - 1.0), fabs (2.0 * y - 1.0));
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BARNDOOR_V:
+      return fabs (2.0 * x - 1.0);
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BARNDOOR_H:
+      return fabs (2.0 * y - 1.0);
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BOX_WIPE_TC:
+      return MAX (fabs (2.0 * x - 1.0), y);
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BOX_WIPE_RC:
+      return MAX (fabs (2.0 * y - 1.0), 1.0 - x);
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BOX_WIPE_BC:
+      return MAX (fabs (2.0 * x - 1.0), 1.0 - y);
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_BOX_WIPE_LC:
+      return MAX (fabs (2.0 * y - 1.0), x);
+    case GES_VIDEO_STANDARD_TRANSITION_TYPE_IRIS_RECT:
+      return MAX (fabs (2.0 * x - 1.0), fabs (2.0 * y - 1.0));
+    default:
+      g_assert_not_reached ();
+      return 0.0;
+  }
+}
+
+static void
+_update_mask (GESVideoTransitionMixer * self,
+    GESVideoStandardTransitionType type, gboolean invert, gint width,
+    gint height)
+{
+  gint x, y;
+
+  if (self->mask && self->mask_type == type && self->mask_invert == invert &&
+      self->mask_width == width && self->mask_height == height)
+    return;
+
+  GST_DEBUG_OBJECT (self, "Computing mask for type %d, %dx%d", type, width,
+      height);
+
+  if (self->mask_width != width || self->mask_height != height) {
+    g_free (self->mask);
+    g_free (self->weights);
+    self->mask = g_new (guint16, width * height);
+    self->weights = g_new (guint16, width * height);
+  }
+
+  for (y = 0; y < height; y++) {
+    guint16 *row = self->mask + y * width;
+    gdouble ny = (y + 0.5) / height;
+
+    for (x = 0; x < width; x++) {
+      gdouble value = _wipe_value (type, (x + 0.5) / width, ny);
+
+      /* smptealpha, as used by GESVideoTransition, runs the wipes in their
+       * natural direction when inverted */
+      if (!invert)
+        value = 1.0 - value;
+      row[x] = (guint16) CLAMP (value * G_MAXUINT16 + 0.5, 0, G_MAXUINT16);
+    }
+  }
+
+  self->mask_type = type;
+  self->mask_invert = invert;
+  self->mask_width = width;
+  self->mask_height = height;
+}
+
+/* Computes the weight of the second input for each pixel, the border being
+ * a soft edge of @border mask values */
+static void
+_update_weights (GESVideoTransitionMixer * self, gdouble position,
+    gint border)
+{
+  gint i, n_pixels = self->mask_width * self->mask_height;
+
+  if (border <= 0) {
+    guint threshold = (guint) (position * (G_MAXUINT16 + 1));
+
+    for (i = 0; i < n_pixels; i++)
+      self->weights[i] = self->mask[i] < threshold ? WEIGHT_ONE : 0;
+  } else {
+    gint64 edge = (gint64) (position * ((gint64) G_MAXUINT16 + 1 + border));
+
+    for (i = 0; i < n_pixels; i++) {
+      gint64 weight = (edge - self->mask[i]) * WEIGHT_ONE / border;
+
+      self->weights[i] = CLAMP (weight, 0, WEIGHT_ONE);
+    }
+  }
+}
+
+/* Blends eight bytes of @a and @b at once, @wa + @wb being WEIGHT_ONE so
+ * that each 16 bits lane can not overflow */
+static inline guint64
+_blend_word (guint64 a, guint64 b, guint64 wa, guint64 wb)
+{
+  const guint64 low_bytes = G_GUINT64_CONSTANT (0x00ff00ff00ff00ff);
+  guint64 low, high;
+
+  low = (((a & low_bytes) * wa + (b & low_bytes) * wb) >> 8) & low_bytes;
+  high = (((a >> 8) & low_bytes) * wa + ((b >> 8) & low_bytes) * wb)
+      & ~low_bytes;
+
+  return low | high;
+}
+
+static void
+_blend_row (guint8 * out, const guint8 * a, const guint8 * b, gsize n_bytes,
+    guint weight)
+{
+  gsize i = 0;
+  guint64 wa = WEIGHT_ONE - weight, wb = weight;
+
+  for (; i + sizeof (guint64) <= n_bytes; i += sizeof (guint64)) {
+    guint64 wa_word, wb_word, out_word;
+
+    /* memcpy() keeps the unaligned accesses well defined and compiles to
+     * plain loads and stores */
+    memcpy (&wa_word, a + i, sizeof (guint64));
+    memcpy (&wb_word, b + i, sizeof (guint64));
+    out_word = _blend_word (wa_word, wb_word, wa, wb);
+    memcpy (out + i, &out_word, sizeof (guint64));
+  }
+
+  for (; i < n_bytes; i++)
+    out[i] = (a[i] * wa + b[i] * wb) >> 8;
+}
+
+static void
+_crossfade (GstVideoFrame * out, GstVideoFrame * a, GstVideoFrame * b,
+    guint weight)
+{
+  guint plane, comp, row;
+  const GstVideoFormatInfo *finfo = out->info.finfo;
+
+  for (plane = 0; plane < GST_VIDEO_FRAME_N_PLANES (out); plane++) {
+    gsize n_bytes;
+    guint n_rows;
+    guint8 *out_data = GST_VIDEO_FRAME_PLANE_DATA (out, plane);
+    const guint8 *a_data = GST_VIDEO_FRAME_PLANE_DATA (a, plane);
+    const guint8 *b_data = GST_VIDEO_FRAME_PLANE_DATA (b, plane);
+
+    for (comp = 0; GST_VIDEO_FORMAT_INFO_PLANE (finfo, comp) != plane; comp++);
+
+    n_bytes = GST_VIDEO_FRAME_COMP_WIDTH (out, comp) *
+        GST_VIDEO_FRAME_COMP_PSTRIDE (out, comp);
+    n_rows = GST_VIDEO_FRAME_COMP_HEIGHT (out, comp);
+
+    for (row = 0; row < n_rows; row++) {
+      guint8 *o = out_data + row * GST_VIDEO_FRAME_PLANE_STRIDE (out, plane);
+      const guint8 *pa = a_data + row * GST_VIDEO_FRAME_PLANE_STRIDE (a, plane);
+      const guint8 *pb = b_data + row * GST_VIDEO_FRAME_PLANE_STRIDE (b, plane);
+
+      if (weight == 0)
+        memcpy (o, pa, n_bytes);
+      else if (weight == WEIGHT_ONE)
+        memcpy (o, pb, n_bytes);
+      else
+        _blend_row (o, pa, pb, n_bytes, weight);
+    }
+  }
+}
+
+static void
+_wipe (GstVideoFrame * out, GstVideoFrame * a, GstVideoFrame * b,
+    const guint16 * weights)
+{
+  guint comp;
+  gint x, y, width = GST_VIDEO_FRAME_WIDTH (out);
+  const GstVideoFormatInfo *finfo = out->info.finfo;
+
+  for (comp = 0; comp < GST_VIDEO_FRAME_N_COMPONENTS (out); comp++) {
+    guint w_sub = GST_VIDEO_FORMAT_INFO_W_SUB (finfo, comp);
+    guint h_sub = GST_VIDEO_FORMAT_INFO_H_SUB (finfo, comp);
+    gint pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (out, comp);
+    gint comp_width = GST_VIDEO_FRAME_COMP_WIDTH (out, comp);
+    gint comp_height = GST_VIDEO_FRAME_COMP_HEIGHT (out, comp);
+
+    for (y = 0; y < comp_height; y++) {
+      const guint16 *w = weights + (y << h_sub) * width;
+      guint8 *o = GST_VIDEO_FRAME_COMP_DATA (out, comp) +
+          y * GST_VIDEO_FRAME_COMP_STRIDE (out, comp);
+      const guint8 *pa = GST_VIDEO_FRAME_COMP_DATA (a, comp) +
+          y * GST_VIDEO_FRAME_COMP_STRIDE (a, comp);
+      const guint8 *pb = GST_VIDEO_FRAME_COMP_DATA (b, comp) +
+          y * GST_VIDEO_FRAME_COMP_STRIDE (b, comp);
+
+      for (x = 0; x < comp_width; x++) {
+        guint weight = w[x << w_sub];
+        gint offset = x * pstride;
+
+        o[offset] = (pa[offset] * (WEIGHT_ONE - weight) +
+            pb[offset] * weight) >> 8;
+      }
+    }
+  }
+}
+
+/* Fills @frame with transparent black */
+static void
+_fill_transparent (GstVideoFrame * frame)
+{
+  guint comp;
+  gint x, y;
+  const GstVideoFormatInfo *finfo = frame->info.finfo;
+
+  for (comp = 0; comp < GST_VIDEO_FRAME_N_COMPONENTS (frame); comp++) {
+    gint pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (frame, comp);
+    guint8 value = GST_VIDEO_FORMAT_INFO_IS_YUV (finfo) &&
+        (comp == GST_VIDEO_COMP_U || comp == GST_VIDEO_COMP_V) ? 128 : 0;
+
+    for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (frame, comp); y++) {
+      guint8 *data = GST_VIDEO_FRAME_COMP_DATA (frame, comp) +
+          y * GST_VIDEO_FRAME_COMP_STRIDE (frame, comp);
+
+      for (x = 0; x < GST_VIDEO_FRAME_COMP_WIDTH (frame, comp); x++)
+        data[x * pstride] = value;
+    }
+  }
+}
+
+static void
+_video_input_clear (VideoInput * input)
+{
+  if (input->canvas_mapped) {
+    gst_video_frame_unmap (&input->canvas_frame);
+    input->canvas_mapped = FALSE;
+  }
+  g_clear_pointer (&input->convert, gst_video_converter_free);
+  gst_clear_buffer (&input->canvas);
+}
+
+/* Sets @placed to a frame of @pad covering the whole output, which is
+ * @frame if it already does and is in the output format, or transparent if
+ * @pad has no frame.
+ *
+ * Returns: %FALSE if the frame could not be placed */
+static gboolean
+_video_input_place (GESVideoTransitionMixer * self, VideoInput * input,
+    GstVideoAggregatorPad * pad, GstVideoFrame * frame,
+    GstVideoFrame ** placed)
+{
+  GstVideoInfo *out_info = &GST_VIDEO_AGGREGATOR (self)->info;
+  gint out_width = GST_VIDEO_INFO_WIDTH (out_info);
+  gint out_height = GST_VIDEO_INFO_HEIGHT (out_info);
+  gint x = 0, y = 0, width = 0, height = 0;
+  gdouble alpha = 1.0;
+  gint x0, y0, x1, y1;
+
+  if (frame) {
+    GstBuffer *buffer = gst_video_aggregator_pad_get_current_buffer (pad);
+    GstFramePositionerMeta *meta = buffer ? (GstFramePositionerMeta *)
+        gst_buffer_get_meta (buffer,
+        gst_frame_positioner_meta_api_get_type ()) : NULL;
+
+    width = GST_VIDEO_FRAME_WIDTH (frame);
+    height = GST_VIDEO_FRAME_HEIGHT (frame);
+    if (meta) {
+      x = meta->posx;
+      y = meta->posy;
+      width = meta->width;
+      height = meta->height;
+      alpha = meta->alpha;
+    }
+
+    if (x == 0 && y == 0 && width == out_width && height == out_height &&
+        GST_VIDEO_FRAME_WIDTH (frame) == out_width &&
+        GST_VIDEO_FRAME_HEIGHT (frame) == out_height && alpha >= 1.0 &&
+        GST_VIDEO_FRAME_FORMAT (frame) == GST_VIDEO_INFO_FORMAT (out_info)) {
+      *placed = frame;
+
+      return TRUE;
+    }
+  }
+
+  if (!input->canvas) {
+    input->canvas = gst_buffer_new_allocate (NULL,
+        GST_VIDEO_INFO_SIZE (out_info), NULL);
+  }
+  if (!gst_video_frame_map (&input->canvas_frame, out_info, input->canvas,
+          GST_MAP_READWRITE)) {
+    GST_ERROR_OBJECT (self, "Could not map canvas");
+
+    return FALSE;
+  }
+  input->canvas_mapped = TRUE;
+  *placed = &input->canvas_frame;
+
+  x0 = MAX (x, 0);
+  y0 = MAX (y, 0);
+  x1 = MIN (x + width, out_width);
+  y1 = MIN (y + height, out_height);
+
+  if (!frame || x1 <= x0 || y1 <= y0 || alpha <= 0.0) {
+    _fill_transparent (&input->canvas_frame);
+
+    return TRUE;
+  }
+
+  if (!input->convert || input->x != x || input->y != y ||
+      input->width != width || input->height != height ||
+      input->alpha != alpha ||
+      !gst_video_info_is_equal (&input->convert_info, &frame->info)) {
+    gint src_width = GST_VIDEO_FRAME_WIDTH (frame);
+    gint src_height = GST_VIDEO_FRAME_HEIGHT (frame);
+    GstStructure *config;
+
+    GST_DEBUG_OBJECT (pad, "Placing %dx%d frames at %dx%d+%d+%d (alpha %f)",
+        src_width, src_height, width, height, x, y, alpha);
+
+    config = gst_structure_new ("GESVideoTransitionMixer",
+        GST_VIDEO_CONVERTER_OPT_SRC_X, G_TYPE_INT,
+        (gint) gst_util_uint64_scale_int (x0 - x, src_width, width),
+        GST_VIDEO_CONVERTER_OPT_SRC_Y, G_TYPE_INT,
+        (gint) gst_util_uint64_scale_int (y0 - y, src_height, height),
+        GST_VIDEO_CONVERTER_OPT_SRC_WIDTH, G_TYPE_INT,
+        (gint) gst_util_uint64_scale_int (x1 - x0, src_width, width),
+        GST_VIDEO_CONVERTER_OPT_SRC_HEIGHT, G_TYPE_INT,
+        (gint) gst_util_uint64_scale_int (y1 - y0, src_height, height),
+        GST_VIDEO_CONVERTER_OPT_DEST_X, G_TYPE_INT, x0,
+        GST_VIDEO_CONVERTER_OPT_DEST_Y, G_TYPE_INT, y0,
+        GST_VIDEO_CONVERTER_OPT_DEST_WIDTH, G_TYPE_INT, x1 - x0,
+        GST_VIDEO_CONVERTER_OPT_DEST_HEIGHT, G_TYPE_INT, y1 - y0,
+        GST_VIDEO_CONVERTER_OPT_FILL_BORDER, G_TYPE_BOOLEAN, TRUE,
+        GST_VIDEO_CONVERTER_OPT_BORDER_ARGB, G_TYPE_UINT, 0,
+        GST_VIDEO_CONVERTER_OPT_ALPHA_MODE, GST_TYPE_VIDEO_ALPHA_MODE,
+        GST_VIDEO_ALPHA_MODE_MULT,
+        GST_VIDEO_CONVERTER_OPT_ALPHA_VALUE, G_TYPE_DOUBLE, alpha, NULL);
+
+    g_clear_pointer (&input->convert, gst_video_converter_free);
+    input->convert = gst_video_converter_new (&frame->info, out_info, config);
+    input->convert_info = frame->info;
+    input->x = x;
+    input->y = y;
+    input->width = width;
+    input->height = height;
+    input->alpha = alpha;
+  }
+
+  gst_video_converter_frame (input->convert, frame, &input->canvas_frame);
+
+  return TRUE;
+}
+
+static GstFlowReturn
+ges_video_transition_mixer_aggregate_frames (GstVideoAggregator * vagg,
+    GstBuffer * outbuf)
+{
+  GList *l;
+  guint i, n_inputs = 0;
+  GstVideoFrame out_frame;
+  GstVideoFrame *frames[2] = { NULL, NULL };
+  GstVideoAggregatorPad *pads[2] = { NULL, NULL };
+  GESVideoTransitionMixer *self = GES_VIDEO_TRANSITION_MIXER (vagg);
+  GstSegment *segment = &GST_AGGREGATOR_PAD (GST_AGGREGATOR_SRC_PAD (vagg))->
+      segment;
+  GESVideoStandardTransitionType type;
+  gdouble position;
+  gboolean invert;
+  gint border;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  gst_object_sync_values (GST_OBJECT (self),
+      gst_segment_to_stream_time (segment, GST_FORMAT_TIME,
+          GST_BUFFER_PTS (outbuf)));
+
+  GST_OBJECT_LOCK (self);
+  position = self->position;
+  type = self->type;
+  invert = self->invert;
+  border = self->border;
+  for (l = GST_ELEMENT (self)->sinkpads; l && n_inputs < 2; l = l->next) {
+    pads[n_inputs] = gst_object_ref (l->data);
+    frames[n_inputs] =
+        gst_video_aggregator_pad_get_prepared_frame (GST_VIDEO_AGGREGATOR_PAD
+        (l->data));
+    n_inputs++;
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  if (!gst_video_frame_map (&out_frame, &vagg->info, outbuf, GST_MAP_WRITE)) {
+    GST_ERROR_OBJECT (self, "Could not map output buffer");
+    for (i = 0; i < n_inputs; i++)
+      gst_object_unref (pads[i]);
+
+    return GST_FLOW_ERROR;
+  }
+
+  for (i = 0; i < 2; i++) {
+    if (!_video_input_place (self, &self->inputs[i], pads[i], frames[i],
+            &frames[i]))
+      goto map_failed;
+  }
+
+  if (type == GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE) {
+    _crossfade (&out_frame, frames[0], frames[1],
+        (guint) (position * WEIGHT_ONE + 0.5));
+  } else {
+    _update_mask (self, type, invert, GST_VIDEO_FRAME_WIDTH (&out_frame),
+        GST_VIDEO_FRAME_HEIGHT (&out_frame));
+    _update_weights (self, position, border);
+    _wipe (&out_frame, frames[0], frames[1], self->weights);
+  }
+
+done:
+  gst_video_frame_unmap (&out_frame);
+  for (i = 0; i < 2; i++) {
+    if (self->inputs[i].canvas_mapped) {
+      gst_video_frame_unmap (&self->inputs[i].canvas_frame);
+      self->inputs[i].canvas_mapped = FALSE;
+    }
+  }
+  for (i = 0; i < n_inputs; i++)
+    gst_object_unref (pads[i]);
+
+  return ret;
+
+map_failed:
+  ret = GST_FLOW_ERROR;
+  goto done;
+}
+
+/* The caps accepted by the sinks: the output format, or the first format
+ * downstream accepts if it is not negotiated yet, so that both inputs end
+ * up in the same format, with any size and framerate */
+static GstCaps *
+_video_sink_caps (GESVideoTransitionMixer * self, GstCaps * filter)
+{
+  guint i;
+  GstCaps *caps, *template_caps;
+  GstPad *srcpad = GST_AGGREGATOR_SRC_PAD (self);
+
+  caps = gst_pad_get_current_caps (srcpad);
+  if (!caps) {
+    template_caps = gst_pad_get_pad_template_caps (srcpad);
+    caps = gst_pad_peer_query_caps (srcpad, template_caps);
+    gst_caps_unref (template_caps);
+  }
+
+  caps = gst_caps_truncate (caps);
+  caps = gst_caps_make_writable (caps);
+  for (i = 0; i < gst_caps_get_size (caps); i++) {
+    GstStructure *s = gst_caps_get_structure (caps, i);
+
+    gst_structure_fixate_field (s, "format");
+    gst_structure_set (s, "width", GST_TYPE_INT_RANGE, 1, G_MAXINT,
+        "height", GST_TYPE_INT_RANGE, 1, G_MAXINT,
+        "framerate", GST_TYPE_FRACTION_RANGE, 0, 1, G_MAXINT, 1, NULL);
+    gst_structure_remove_fields (s, "pixel-aspect-ratio", "colorimetry",
+        "chroma-site", NULL);
+  }
+
+  if (filter) {
+    GstCaps *tmp = gst_caps_intersect_full (filter, caps,
+        GST_CAPS_INTERSECT_FIRST);
+
+    gst_caps_unref (caps);
+    caps = tmp;
+  }
+
+  return caps;
+}
+
+static gboolean
+ges_video_transition_mixer_sink_query (GstAggregator * agg,
+    GstAggregatorPad * pad, GstQuery * query)
+{
+  GstCaps *caps, *sink_caps;
+  GESVideoTransitionMixer *self = GES_VIDEO_TRANSITION_MIXER (agg);
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_CAPS:
+      gst_query_parse_caps (query, &caps);
+      sink_caps = _video_sink_caps (self, caps);
+      gst_query_set_caps_result (query, sink_caps);
+      gst_caps_unref (sink_caps);
+
+      return TRUE;
+    case GST_QUERY_ACCEPT_CAPS:
+      gst_query_parse_accept_caps (query, &caps);
+      sink_caps = _video_sink_caps (self, NULL);
+      gst_query_set_accept_caps_result (query,
+          gst_caps_can_intersect (caps, sink_caps));
+      gst_caps_unref (sink_caps);
+
+      return TRUE;
+    default:
+      return
+          GST_AGGREGATOR_CLASS
+          (ges_video_transition_mixer_parent_class)->sink_query (agg, pad,
+          query);
+  }
+}
+
+/* Outputs the format of the inputs */
+static GstCaps *
+ges_video_transition_mixer_update_caps (GstVideoAggregator * vagg,
+    GstCaps * caps)
+{
+  GList *l;
+  GstCaps *format_caps, *res;
+  GstVideoFormat format = GST_VIDEO_FORMAT_UNKNOWN;
+
+  GST_OBJECT_LOCK (vagg);
+  for (l = GST_ELEMENT (vagg)->sinkpads; l; l = l->next) {
+    GstVideoInfo *info = &GST_VIDEO_AGGREGATOR_PAD (l->data)->info;
+
+    if (!info->finfo || GST_VIDEO_INFO_FORMAT (info) ==
+        GST_VIDEO_FORMAT_UNKNOWN)
+      continue;
+
+    if (format == GST_VIDEO_FORMAT_UNKNOWN) {
+      format = GST_VIDEO_INFO_FORMAT (info);
+    } else if (format != GST_VIDEO_INFO_FORMAT (info)) {
+      /* Only possible if downstream changed its caps in between, the
+       * frames of this input then get converted when placed */
+      GST_WARNING_OBJECT (l->data, "Input in %s instead of %s",
+          gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (info)),
+          gst_video_format_to_string (format));
+    }
+  }
+  GST_OBJECT_UNLOCK (vagg);
+
+  if (format == GST_VIDEO_FORMAT_UNKNOWN)
+    return gst_caps_ref (caps);
+
+  format_caps = gst_caps_new_simple ("video/x-raw", "format", G_TYPE_STRING,
+      gst_video_format_to_string (format), NULL);
+  res = gst_caps_intersect (caps, format_caps);
+  gst_caps_unref (format_caps);
+
+  return res;
+}
+
+static gboolean
+ges_video_transition_mixer_negotiated_src_caps (GstAggregator * agg,
+    GstCaps * caps)
+{
+  GESVideoTransitionMixer *self = GES_VIDEO_TRANSITION_MIXER (agg);
+
+  /* The canvases are allocated for the output format */
+  _video_input_clear (&self->inputs[0]);
+  _video_input_clear (&self->inputs[1]);
+
+  return
+      GST_AGGREGATOR_CLASS
+      (ges_video_transition_mixer_parent_class)->negotiated_src_caps (agg,
+      caps);
+}
+
+static gboolean
+ges_video_transition_mixer_stop (GstAggregator * agg)
+{
+  GESVideoTransitionMixer *self = GES_VIDEO_TRANSITION_MIXER (agg);
+
+  _video_input_clear (&self->inputs[0]);
+  _video_input_clear (&self->inputs[1]);
+
+  return GST_AGGREGATOR_CLASS (ges_video_transition_mixer_parent_class)->stop
+      (agg);
+}
+
+static void
+ges_video_transition_mixer_get_property (GObject * object, guint property_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GESVideoTransitionMixer *self = GES_VIDEO_TRANSITION_MIXER (object);
+
+  GST_OBJECT_LOCK (self);
+  switch (property_id) {
+    case PROP_POSITION:
+      g_value_set_double (value, self->position);
+      break;
+    case PROP_TYPE:
+      g_value_set_enum (value, self->type);
+      break;
+    case PROP_INVERT:
+      g_value_set_boolean (value, self->invert);
+      break;
+    case PROP_BORDER:
+      g_value_set_int (value, self->border);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
+static void
+ges_video_transition_mixer_set_property (GObject * object, guint property_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GESVideoTransitionMixer *self = GES_VIDEO_TRANSITION_MIXER (object);
+
+  GST_OBJECT_LOCK (self);
+  switch (property_id) {
+    case PROP_POSITION:
+      self->position = g_value_get_double (value);
+      break;
+    case PROP_TYPE:
+      /* GESTransitionBin uses the bin based transition for the others */
+      if (ges_video_transition_mixer_supports_type (g_value_get_enum (value)))
+        self->type = g_value_get_enum (value);
+      else
+        GST_WARNING_OBJECT (self, "Unsupported transition type %d",
+            g_value_get_enum (value));
+      break;
+    case PROP_INVERT:
+      self->invert = g_value_get_boolean (value);
+      break;
+    case PROP_BORDER:
+      self->border = g_value_get_int (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
+static void
+ges_video_transition_mixer_finalize (GObject * object)
+{
+  GESVideoTransitionMixer *self = GES_VIDEO_TRANSITION_MIXER (object);
+
+  _video_input_clear (&self->inputs[0]);
+  _video_input_clear (&self->inputs[1]);
+  g_free (self->mask);
+  g_free (self->weights);
+
+  G_OBJECT_CLASS (ges_video_transition_mixer_parent_class)->finalize (object);
+}
+
+static void
+ges_video_transition_mixer_class_init (GESVideoTransitionMixerClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstAggregatorClass *agg_class = GST_AGGREGATOR_CLASS (klass);
+  GstVideoAggregatorClass *vagg_class = GST_VIDEO_AGGREGATOR_CLASS (klass);
+
+  GST_DEBUG_CATEGORY_INIT (ges_transition_mixer_debug, "gestransitionmixer",
+      0, "GES transition mixers");
+
+  object_class->get_property = ges_video_transition_mixer_get_property;
+  object_class->set_property = ges_video_transition_mixer_set_property;
+  object_class->finalize = ges_video_transition_mixer_finalize;
+
+  g_object_class_install_property (object_class, PROP_POSITION,
+      g_param_spec_double ("position", "Position",
+          "Progress of the transition", 0.0, 1.0, 0.0,
+          G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE |
+          G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_TYPE,
+      g_param_spec_enum ("type", "Type", "The type of the transition",
+          GES_VIDEO_STANDARD_TRANSITION_TYPE_TYPE,
+          GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /* Same meaning as on smptealpha, so that GESVideoTransition exposes the
+   * same children properties whichever implementation it uses */
+  g_object_class_install_property (object_class, PROP_INVERT,
+      g_param_spec_boolean ("invert", "Invert",
+          "Invert transition mask", TRUE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_BORDER,
+      g_param_spec_int ("border", "Border",
+          "The border width of the transition", 0, G_MAXINT, 0,
+          G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE |
+          G_PARAM_STATIC_STRINGS));
+
+  gst_element_class_add_static_pad_template_with_gtype (element_class,
+      &video_src_template, GST_TYPE_AGGREGATOR_PAD);
+  gst_element_class_add_static_pad_template_with_gtype (element_class,
+      &video_sink_template, GST_TYPE_VIDEO_AGGREGATOR_PAD);
+  gst_element_class_set_static_metadata (element_class,
+      "GES video transition mixer", "Filter/Editor/Video/Compositor",
+      "Crossfades or wipes between two video streams",
+      "GStreamer maintainers <gstreamer-devel@lists.freedesktop.org>");
+
+  agg_class->sink_query = ges_video_transition_mixer_sink_query;
+  agg_class->negotiated_src_caps =
+      ges_video_transition_mixer_negotiated_src_caps;
+  agg_class->stop = ges_video_transition_mixer_stop;
+  vagg_class->update_caps = ges_video_transition_mixer_update_caps;
+  vagg_class->aggregate_frames = ges_video_transition_mixer_aggregate_frames;
+}
+
+static void
+ges_video_transition_mixer_init (GESVideoTransitionMixer * self)
+{
+  self->type = GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE;
+  self->invert = TRUE;
+}
+
+GstElement *
+ges_video_transition_mixer_new (void)
+{
+  return g_object_new (GES_TYPE_VIDEO_TRANSITION_MIXER, NULL);
+}
+
+/****************************************************
+ *               GESAudioTransitionMixer            *
+ ****************************************************/
+
+G_DECLARE_FINAL_TYPE (GESAudioTransitionMixer, ges_audio_transition_mixer,
+    GES, AUDIO_TRANSITION_MIXER, GstAudioAggregator);
+
+struct _GESAudioTransitionMixer
+{
+  GstAudioAggregator parent;
+
+  /* Protected by the object lock */
+  gdouble position;
+};
+
+#define GES_TYPE_AUDIO_TRANSITION_MIXER (ges_audio_transition_mixer_get_type())
+G_DEFINE_TYPE (GESAudioTransitionMixer, ges_audio_transition_mixer,
+    GST_TYPE_AUDIO_AGGREGATOR);
+
+static GstStaticPadTemplate audio_src_template =
+GST_STATIC_PAD_TEMPLATE ("src", GST_PAD_SRC, GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("audio/x-raw, format = (string) " AUDIO_FORMATS
+        ", rate = (int) [ 1, MAX ], channels = (int) [ 1, MAX ], "
+        "layout = (string) interleaved"));
+
+static GstStaticPadTemplate audio_sink_template =
+GST_STATIC_PAD_TEMPLATE ("sink_%u", GST_PAD_SINK, GST_PAD_REQUEST,
+    GST_STATIC_CAPS ("audio/x-raw, format = (string) "
+        GST_AUDIO_FORMATS_ALL ", rate = (int) [ 1, MAX ], "
+        "channels = (int) [ 1, MAX ], layout = (string) interleaved"));
+
+/* Whether the samples of a track with @caps as restriction caps, which the
+ * audio sources output, can be mixed as they are */
+gboolean
+ges_audio_transition_mixer_can_mix (const GstCaps * caps)
+{
+  gint value;
+  const gchar *layout;
+  const GstStructure *structure;
+
+  if (!caps || gst_caps_is_any (caps) || gst_caps_is_empty (caps))
+    return FALSE;
+
+  structure = gst_caps_get_structure (caps, 0);
+  layout = gst_structure_get_string (structure, "layout");
+
+  return _has_format_of (&audio_src_template, structure) &&
+      gst_structure_get_int (structure, "rate", &value) &&
+      gst_structure_get_int (structure, "channels", &value) &&
+      (!gst_structure_has_field (structure, "layout") ||
+      !g_strcmp0 (layout, "interleaved"));
+}
+
+/* Adds @in, with a gain going linearly from @gain to @end_gain, to @out */
+static void
+_mix_f32 (gfloat * out, const gfloat * in, guint n_frames, gint channels,
+    gdouble gain, gdouble end_gain)
+{
+  guint i;
+  gint c;
+  gfloat step = (end_gain - gain) / n_frames;
+
+  for (i = 0; i < n_frames; i++) {
+    gfloat g = gain + step * i;
+
+    for (c = 0; c < channels; c++)
+      out[c] += in[c] * g;
+    out += channels;
+    in += channels;
+  }
+}
+
+static void
+_mix_s16 (gint16 * out, const gint16 * in, guint n_frames, gint channels,
+    gdouble gain, gdouble end_gain)
+{
+  guint i;
+  gint c;
+  /* Gains in Q30, stepped once per frame */
+  gint64 g = (gint64) (gain * (1 << 30));
+  gint64 step = (gint64) ((end_gain - gain) * (1 << 30)) / n_frames;
+
+  for (i = 0; i < n_frames; i++) {
+    for (c = 0; c < channels; c++) {
+      gint64 sample = out[c] + ((in[c] * g) >> 30);
+
+      out[c] = CLAMP (sample, G_MININT16, G_MAXINT16);
+    }
+    out += channels;
+    in += channels;
+    g += step;
+  }
+}
+
+static void
+_mix_s32 (gint32 * out, const gint32 * in, guint n_frames, gint channels,
+    gdouble gain, gdouble end_gain)
+{
+  guint i;
+  gint c;
+  /* Gains in Q30 too, a sample times a gain fitting in 62 bits */
+  gint64 g = (gint64) (gain * (1 << 30));
+  gint64 step = (gint64) ((end_gain - gain) * (1 << 30)) / n_frames;
+
+  for (i = 0; i < n_frames; i++) {
+    for (c = 0; c < channels; c++) {
+      gint64 sample = out[c] + ((in[c] * g) >> 30);
+
+      out[c] = CLAMP (sample, G_MININT32, G_MAXINT32);
+    }
+    out += channels;
+    in += channels;
+    g += step;
+  }
+}
+
+static gboolean
+ges_audio_transition_mixer_aggregate_one_buffer (GstAudioAggregator * aagg,
+    GstAudioAggregatorPad * pad, GstBuffer * inbuf, guint in_offset,
+    GstBuffer * outbuf, guint out_offset, guint num_frames)
+{
+  GESAudioTransitionMixer *self = GES_AUDIO_TRANSITION_MIXER (aagg);
+  GstAggregatorPad *srcpad = GST_AGGREGATOR_PAD (GST_AGGREGATOR_SRC_PAD (aagg));
+  GstAudioInfo *info = &GST_AUDIO_AGGREGATOR_PAD (srcpad)->info;
+  gint bpf = GST_AUDIO_INFO_BPF (info);
+  gint channels = GST_AUDIO_INFO_CHANNELS (info);
+  gboolean is_first = _is_first_sink_pad (GST_ELEMENT (self), GST_PAD (pad));
+  GstClockTime start = GST_CLOCK_TIME_NONE, end = GST_CLOCK_TIME_NONE;
+  gdouble position, start_gain, end_gain;
+  GstMapInfo inmap, outmap;
+
+  GST_OBJECT_LOCK (self);
+  position = self->position;
+  GST_OBJECT_UNLOCK (self);
+
+  if (GST_CLOCK_TIME_IS_VALID (srcpad->segment.position)) {
+    start = srcpad->segment.position +
+        gst_util_uint64_scale_int (out_offset, GST_SECOND,
+        GST_AUDIO_INFO_RATE (info));
+    end = start + gst_util_uint64_scale_int (num_frames, GST_SECOND,
+        GST_AUDIO_INFO_RATE (info));
+    start = gst_segment_to_stream_time (&srcpad->segment, GST_FORMAT_TIME,
+        start);
+    end = gst_segment_to_stream_time (&srcpad->segment, GST_FORMAT_TIME, end);
+  }
+
+  start_gain = _position_at (GST_OBJECT (self), position, start);
+  end_gain = _position_at (GST_OBJECT (self), position, end);
+  if (is_first) {
+    start_gain = 1.0 - start_gain;
+    end_gain = 1.0 - end_gain;
+  }
+
+  if (start_gain <= 0.0 && end_gain <= 0.0)
+    return FALSE;
+
+  gst_buffer_map (inbuf, &inmap, GST_MAP_READ);
+  gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
+
+  switch (GST_AUDIO_INFO_FORMAT (info)) {
+    case GST_AUDIO_FORMAT_F32:
+      _mix_f32 ((gfloat *) (outmap.data + out_offset * bpf),
+          (const gfloat *) (inmap.data + in_offset * bpf), num_frames,
+          channels, start_gain, end_gain);
+      break;
+    case GST_AUDIO_FORMAT_S32:
+      _mix_s32 ((gint32 *) (outmap.data + out_offset * bpf),
+          (const gint32 *) (inmap.data + in_offset * bpf), num_frames,
+          channels, start_gain, end_gain);
+      break;
+    case GST_AUDIO_FORMAT_S16:
+      _mix_s16 ((gint16 *) (outmap.data + out_offset * bpf),
+          (const gint16 *) (inmap.data + in_offset * bpf), num_frames,
+          channels, start_gain, end_gain);
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+
+  gst_buffer_unmap (inbuf, &inmap);
+  gst_buffer_unmap (outbuf, &outmap);
+
+  return TRUE;
+}
+
+static void
+ges_audio_transition_mixer_get_property (GObject * object, guint property_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GESAudioTransitionMixer *self = GES_AUDIO_TRANSITION_MIXER (object);
+
+  switch (property_id) {
+    case PROP_POSITION:
+      GST_OBJECT_LOCK (self);
+      g_value_set_double (value, self->position);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+  }
+}
+
+static void
+ges_audio_transition_mixer_set_property (GObject * object, guint property_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GESAudioTransitionMixer *self = GES_AUDIO_TRANSITION_MIXER (object);
+
+  switch (property_id) {
+    case PROP_POSITION:
+      GST_OBJECT_LOCK (self);
+      self->position = g_value_get_double (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+  }
+}
+
+static void
+ges_audio_transition_mixer_class_init (GESAudioTransitionMixerClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstAudioAggregatorClass *aagg_class = GST_AUDIO_AGGREGATOR_CLASS (klass);
+
+  object_class->get_property = ges_audio_transition_mixer_get_property;
+  object_class->set_property = ges_audio_transition_mixer_set_property;
+
+  g_object_class_install_property (object_class, PROP_POSITION,
+      g_param_spec_double ("position", "Position",
+          "Progress of the transition", 0.0, 1.0, 0.0,
+          G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE |
+          G_PARAM_STATIC_STRINGS));
+
+  gst_element_class_add_static_pad_template_with_gtype (element_class,
+      &audio_src_template, GST_TYPE_AUDIO_AGGREGATOR_PAD);
+  /* The inputs already have the output format when this mixer is used,
+   * which the convert pads pass through */
+  gst_element_class_add_static_pad_template_with_gtype (element_class,
+      &audio_sink_template, GST_TYPE_AUDIO_AGGREGATOR_CONVERT_PAD);
+  gst_element_class_set_static_metadata (element_class,
+      "GES audio transition mixer", "Filter/Editor/Audio/Mixer",
+      "Crossfades between two audio streams",
+      "GStreamer maintainers <gstreamer-devel@lists.freedesktop.org>");
+
+  aagg_class->aggregate_one_buffer =
+      ges_audio_transition_mixer_aggregate_one_buffer;
+}
+
+static void
+ges_audio_transition_mixer_init (GESAudioTransitionMixer * self)
+{
+}
+
+GstElement *
+ges_audio_transition_mixer_new (void)
+{
+  return g_object_new (GES_TYPE_AUDIO_TRANSITION_MIXER, NULL);
+}
+
+/****************************************************
+ *                  GESTransitionBin                *
+ ****************************************************/
+
+G_DECLARE_FINAL_TYPE (GESTransitionBin, ges_transition_bin, GES,
+    TRANSITION_BIN, GstBin);
+
+struct _GESTransitionBin
+{
+  GstBin parent;
+
+  GWeakRef owner;
+  GESTransitionBinSelectFunc use_native;
+
+  GstPad *sinka;
+  GstPad *sinkb;
+  GstPad *src;
+
+  /* The bin based transition and the native one, both exposing "sinka",
+   * "sinkb" and "src" pads. Only one of them is in the bin at a time */
+  GstElement *element;
+  GstElement *native;
+
+  /* Always in the bin, after the transition */
+  GstElement *output;
+};
+
+#define GES_TYPE_TRANSITION_BIN (ges_transition_bin_get_type())
+G_DEFINE_TYPE (GESTransitionBin, ges_transition_bin, GST_TYPE_BIN);
+
+static void
+_transition_bin_set_target (GESTransitionBin * self, GstPad * ghost,
+    GstElement * element, const gchar * name)
+{
+  GstPad *pad = gst_element_get_static_pad (element, name);
+
+  gst_ghost_pad_set_target (GST_GHOST_PAD (ghost), pad);
+  gst_object_unref (pad);
+}
+
+static void
+_transition_bin_use (GESTransitionBin * self, GstElement * transition)
+{
+  _transition_bin_set_target (self, self->sinka, transition, "sinka");
+  _transition_bin_set_target (self, self->sinkb, transition, "sinkb");
+
+  if (self->output) {
+    if (!gst_element_link_pads_full (transition, "src", self->output, "sink",
+            GST_PAD_LINK_CHECK_NOTHING))
+      GST_ERROR_OBJECT (self, "Could not link %" GST_PTR_FORMAT, transition);
+  } else {
+    _transition_bin_set_target (self, self->src, transition, "src");
+  }
+}
+
+/* Called when prerolling, before the children change their state */
+static void
+_transition_bin_update (GESTransitionBin * self)
+{
+  gboolean use_native, native_used;
+  GstElement *unused, *transition;
+  GESTrackElement *owner = g_weak_ref_get (&self->owner);
+
+  if (!owner)
+    return;
+
+  use_native = self->use_native (owner);
+  native_used = GST_OBJECT_PARENT (self->native) == GST_OBJECT (self);
+  if (use_native == native_used) {
+    gst_object_unref (owner);
+    return;
+  }
+
+  GST_DEBUG_OBJECT (owner, "Using the %s transition",
+      use_native ? "native" : "bin based");
+  unused = use_native ? self->element : self->native;
+  transition = use_native ? self->native : self->element;
+
+  gst_ghost_pad_set_target (GST_GHOST_PAD (self->sinka), NULL);
+  gst_ghost_pad_set_target (GST_GHOST_PAD (self->sinkb), NULL);
+  if (!self->output)
+    gst_ghost_pad_set_target (GST_GHOST_PAD (self->src), NULL);
+
+  gst_element_set_state (unused, GST_STATE_NULL);
+  gst_bin_remove (GST_BIN (self), unused);
+  gst_bin_add (GST_BIN (self), transition);
+  _transition_bin_use (self, transition);
+
+  gst_object_unref (owner);
+}
+
+static GstStateChangeReturn
+ges_transition_bin_change_state (GstElement * element,
+    GstStateChange transition)
+{
+  if (transition == GST_STATE_CHANGE_READY_TO_PAUSED)
+    _transition_bin_update (GES_TRANSITION_BIN (element));
+
+  return GST_ELEMENT_CLASS (ges_transition_bin_parent_class)->change_state
+      (element, transition);
+}
+
+static void
+ges_transition_bin_dispose (GObject * object)
+{
+  GESTransitionBin *self = GES_TRANSITION_BIN (object);
+
+  gst_clear_object (&self->element);
+  gst_clear_object (&self->native);
+  gst_clear_object (&self->output);
+
+  G_OBJECT_CLASS (ges_transition_bin_parent_class)->dispose (object);
+}
+
+static void
+ges_transition_bin_finalize (GObject * object)
+{
+  GESTransitionBin *self = GES_TRANSITION_BIN (object);
+
+  g_weak_ref_clear (&self->owner);
+
+  G_OBJECT_CLASS (ges_transition_bin_parent_class)->finalize (object);
+}
+
+static void
+ges_transition_bin_class_init (GESTransitionBinClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+
+  object_class->dispose = ges_transition_bin_dispose;
+  object_class->finalize = ges_transition_bin_finalize;
+
+  element_class->change_state =
+      GST_DEBUG_FUNCPTR (ges_transition_bin_change_state);
+}
+
+static void
+ges_transition_bin_init (GESTransitionBin * self)
+{
+  g_weak_ref_init (&self->owner, NULL);
+}
+
+/* @owner: The #GESTrackElement the transition is created for
+ * @element: (transfer floating): The bin based transition
+ * @native: (transfer floating): The transition using a native mixer
+ * @output: (transfer floating) (nullable): An element with "sink" and "src"
+ * pads to link after the transition
+ * @use_native: Called each time the transition prerolls, to know whether
+ * @native should be used, and to update it if so
+ *
+ * Returns: (transfer floating): A bin exposing the "sinka", "sinkb" and
+ * "src" pads of @element or @native, @element being used until
+ * @use_native returns %TRUE
+ */
+GstElement *
+ges_transition_bin_new (GESTrackElement * owner, GstElement * element,
+    GstElement * native, GstElement * output,
+    GESTransitionBinSelectFunc use_native)
+{
+  GESTransitionBin *self = g_object_new (GES_TYPE_TRANSITION_BIN,
+      "name", "transition-bin", NULL);
+
+  g_weak_ref_set (&self->owner, owner);
+  self->use_native = use_native;
+  self->element = gst_object_ref_sink (element);
+  self->native = gst_object_ref_sink (native);
+
+  self->sinka = gst_ghost_pad_new_no_target ("sinka", GST_PAD_SINK);
+  self->sinkb = gst_ghost_pad_new_no_target ("sinkb", GST_PAD_SINK);
+  self->src = gst_ghost_pad_new_no_target ("src", GST_PAD_SRC);
+  gst_element_add_pad (GST_ELEMENT (self), self->src);
+  gst_element_add_pad (GST_ELEMENT (self), self->sinka);
+  gst_element_add_pad (GST_ELEMENT (self), self->sinkb);
+
+  if (output) {
+    self->output = gst_object_ref_sink (output);
+    gst_bin_add (GST_BIN (self), output);
+    _transition_bin_set_target (self, self->src, output, "src");
+  }
+
+  gst_bin_add (GST_BIN (self), element);
+  _transition_bin_use (self, element);
+
+  return GST_ELEMENT (self);
+}
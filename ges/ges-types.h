@@ -233,6 +233,9 @@ typedef struct _GESEffectAsset GESEffectAsset;
 typedef struct _GESXmlFormatterClass GESXmlFormatterClass;
 typedef struct _GESXmlFormatter GESXmlFormatter;
 
+typedef struct _GESBinaryFormatterClass GESBinaryFormatterClass;
+typedef struct _GESBinaryFormatter GESBinaryFormatter;
+
 /**
  * GES_DECLARE_TYPE: (attributes doc.skip=true)
  */
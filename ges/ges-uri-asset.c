@@ -27,12 +27,20 @@
  * the media file to use inside the GStreamer Editing Services. It has APIs that
  * let you get information about the medias. Also, the tags found in the media file are
  * set as Metadata of the Asset.
+ *
+ * Discovering media files can be slow, the results can be kept on disk so
+ * that the assets of files which have not changed since they were last
+ * discovered can be loaded without running a #GstDiscoverer. The discovery
+ * cache is enabled by setting a directory to store it in with
+ * ges_uri_clip_asset_class_set_discovery_cache_dir() or the
+ * `GES_DISCOVERY_CACHE_DIR` environment variable.
  */
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
 
 #include <errno.h>
+#include <glib/gstdio.h>
 #include <gst/pbutils/pbutils.h>
 #include "ges.h"
 #include "ges-internal.h"
@@ -44,42 +52,287 @@ static GHashTable *parent_newparent_table = NULL;
 
 G_LOCK_DEFINE_STATIC (discoverers_lock);
 static GstClockTime discovering_timeout = DEFAULT_DISCOVERY_TIMEOUT;
-static GHashTable *discoverers = NULL;  /* Thread ID -> GstDiscoverer */
+static GHashTable *discoverers = NULL;  /* Thread ID -> GPtrArray<GstDiscoverer> */
+static GHashTable *discovery_start_times = NULL;        /* URI -> start time */
+static guint discovery_threads = 0;
+static GQuark discoverer_pending_quark;
 static void discoverer_discovered_cb (GstDiscoverer * discoverer,
     GstDiscovererInfo * info, GError * err, gpointer user_data);
 
+G_LOCK_DEFINE_STATIC (discovery_cache_lock);
+static gchar *discovery_cache_dir = NULL;
+static gboolean discovery_cache_dir_set = FALSE;
+static void _set_discovered_info (GESUriClipAsset * mfs,
+    GstDiscovererInfo * info);
+
+/* WITH discoverers_lock */
+static guint
+get_discovery_threads (void)
+{
+  const gchar *threads_str;
+
+  if (discovery_threads)
+    return discovery_threads;
+
+  threads_str = g_getenv ("GES_DISCOVERY_THREADS");
+  if (threads_str)
+    discovery_threads = g_ascii_strtoull (threads_str, NULL, 10);
+
+  if (!discovery_threads)
+    discovery_threads = 1;
+
+  return discovery_threads;
+}
+
 /* WITH discoverers_lock */
 static GstDiscoverer *
-create_discoverer (void)
+create_discoverer (GPtrArray * thread_discoverers)
 {
   GstDiscoverer *disco = gst_discoverer_new (discovering_timeout, NULL);
 
   g_signal_connect (disco, "discovered", G_CALLBACK (discoverer_discovered_cb),
       NULL);
-  GST_INFO_OBJECT (disco, "Creating new discoverer");
-  g_hash_table_insert (discoverers, g_thread_self (), disco);
+  GST_INFO_OBJECT (disco, "Creating new discoverer (%u running in thread %p)",
+      thread_discoverers->len + 1, g_thread_self ());
+  g_ptr_array_add (thread_discoverers, disco);
   gst_discoverer_start (disco);
 
   return disco;
 }
 
+/* Each thread uses up to get_discovery_threads() discoverers, each of them
+ * discovering one URI at a time. The discoverer with the least pending
+ * URIs is used, a new one being created if they all are busy and the limit
+ * has not been reached yet. */
 static GstDiscoverer *
 get_discoverer (void)
 {
-  GstDiscoverer *disco;
+  guint i, pending, min_pending = G_MAXUINT;
+  GPtrArray *thread_discoverers;
+  GstDiscoverer *disco = NULL;
 
   G_LOCK (discoverers_lock);
   g_assert (discoverers);
-  disco = g_hash_table_lookup (discoverers, g_thread_self ());
-  if (!disco) {
-    disco = create_discoverer ();
+  thread_discoverers = g_hash_table_lookup (discoverers, g_thread_self ());
+  if (!thread_discoverers) {
+    thread_discoverers = g_ptr_array_new_with_free_func (g_object_unref);
+    g_hash_table_insert (discoverers, g_thread_self (), thread_discoverers);
   }
+
+  for (i = 0; i < thread_discoverers->len; i++) {
+    GObject *tmpdisco = thread_discoverers->pdata[i];
+
+    pending = GPOINTER_TO_UINT (g_object_get_qdata (tmpdisco,
+            discoverer_pending_quark));
+
+    if (pending < min_pending) {
+      disco = GST_DISCOVERER (tmpdisco);
+      min_pending = pending;
+    }
+  }
+
+  if (!disco || (min_pending && thread_discoverers->len <
+          get_discovery_threads ())) {
+    disco = create_discoverer (thread_discoverers);
+    min_pending = 0;
+  }
+
+  g_object_set_qdata (G_OBJECT (disco), discoverer_pending_quark,
+      GUINT_TO_POINTER (min_pending + 1));
   disco = gst_object_ref (disco);
   G_UNLOCK (discoverers_lock);
 
   return disco;
 }
 
+static void
+release_discoverer (GstDiscoverer * disco, const gchar * uri)
+{
+  guint pending;
+  gint64 *start_time_p, start_time = 0;
+
+  G_LOCK (discoverers_lock);
+  pending = GPOINTER_TO_UINT (g_object_get_qdata (G_OBJECT (disco),
+          discoverer_pending_quark));
+  if (pending)
+    g_object_set_qdata (G_OBJECT (disco), discoverer_pending_quark,
+        GUINT_TO_POINTER (pending - 1));
+
+  if (discovery_start_times &&
+      (start_time_p = g_hash_table_lookup (discovery_start_times, uri))) {
+    start_time = *start_time_p;
+    g_hash_table_remove (discovery_start_times, uri);
+  }
+  G_UNLOCK (discoverers_lock);
+
+  if (start_time)
+    GST_INFO_OBJECT (disco, "Discovered %s in %" GST_TIME_FORMAT, uri,
+        GST_TIME_ARGS ((g_get_monotonic_time () - start_time) * GST_USECOND));
+}
+
+/* Discovery cache
+ *
+ * Entries are stored in a file per URI, named after the checksum of the URI,
+ * containing the version of the entry format and of GStreamer, the size and
+ * modification time of the file at the time it was discovered along with the
+ * serialized #GstDiscovererInfo. Entries written by another version or not
+ * matching the current size and modification time of the file are ignored.
+ *
+ * Only local files are cached, the stamp of other URIs can not be checked
+ * cheaply, if at all.
+ */
+#define DISCOVERY_CACHE_ENTRY_FORMAT "(usttv)"
+#define DISCOVERY_CACHE_VERSION 1
+
+static gchar *
+_discovery_cache_get_dir (void)
+{
+  gchar *dir;
+
+  G_LOCK (discovery_cache_lock);
+  if (!discovery_cache_dir_set) {
+    discovery_cache_dir = g_strdup (g_getenv ("GES_DISCOVERY_CACHE_DIR"));
+    discovery_cache_dir_set = TRUE;
+  }
+  dir = g_strdup (discovery_cache_dir);
+  G_UNLOCK (discovery_cache_lock);
+
+  return dir;
+}
+
+static gchar *
+_discovery_cache_get_path (const gchar * dir, const gchar * uri)
+{
+  gchar *checksum, *path;
+
+  checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, uri, -1);
+  path = g_build_filename (dir, checksum, NULL);
+  g_free (checksum);
+
+  return path;
+}
+
+/* Returns FALSE if the size of the file could not be queried, @mtime is set
+ * to GST_CLOCK_TIME_NONE if the modification time is unknown */
+static gboolean
+_query_file_stamp (const gchar * uri, guint64 * size, guint64 * mtime)
+{
+  GFile *gfile;
+  GFileInfo *file_info;
+
+  gfile = g_file_new_for_uri (uri);
+  file_info = g_file_query_info (gfile, G_FILE_ATTRIBUTE_STANDARD_SIZE ","
+      G_FILE_ATTRIBUTE_TIME_MODIFIED "," G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC,
+      G_FILE_QUERY_INFO_NONE, NULL, NULL);
+  g_object_unref (gfile);
+
+  if (!file_info)
+    return FALSE;
+
+  *size = g_file_info_get_attribute_uint64 (file_info,
+      G_FILE_ATTRIBUTE_STANDARD_SIZE);
+  *mtime = GST_CLOCK_TIME_NONE;
+  if (g_file_info_has_attribute (file_info, G_FILE_ATTRIBUTE_TIME_MODIFIED)) {
+    *mtime = g_file_info_get_attribute_uint64 (file_info,
+        G_FILE_ATTRIBUTE_TIME_MODIFIED) * G_USEC_PER_SEC +
+        g_file_info_get_attribute_uint32 (file_info,
+        G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC);
+  }
+  g_object_unref (file_info);
+
+  return TRUE;
+}
+
+static GstDiscovererInfo *
+_discovery_cache_lookup (const gchar * uri)
+{
+  gsize len;
+  guint32 version;
+  gchar *dir, *path = NULL, *data, *gst_version, *cached_gst_version = NULL;
+  GVariant *entry = NULL, *serialized_info;
+  guint64 size, mtime, cached_size, cached_mtime;
+  GstDiscovererInfo *info = NULL;
+
+  if (!gst_uri_has_protocol (uri, "file")
+      || !(dir = _discovery_cache_get_dir ()))
+    return NULL;
+
+  path = _discovery_cache_get_path (dir, uri);
+  if (!g_file_get_contents (path, &data, &len, NULL))
+    goto done;
+
+  entry = g_variant_ref_sink (g_variant_new_from_bytes (G_VARIANT_TYPE
+          (DISCOVERY_CACHE_ENTRY_FORMAT), g_bytes_new_take (data, len), FALSE));
+  g_variant_get (entry, DISCOVERY_CACHE_ENTRY_FORMAT, &version,
+      &cached_gst_version, &cached_size, &cached_mtime, &serialized_info);
+
+  gst_version = gst_version_string ();
+  if (version != DISCOVERY_CACHE_VERSION
+      || g_strcmp0 (cached_gst_version, gst_version)) {
+    GST_INFO ("%s was cached by another version, removing %s", uri, path);
+    g_unlink (path);
+  } else if (!_query_file_stamp (uri, &size, &mtime) || size != cached_size
+      || mtime != cached_mtime) {
+    GST_INFO ("%s changed since it was discovered, removing %s", uri, path);
+    g_unlink (path);
+  } else {
+    info = gst_discoverer_info_from_variant (serialized_info);
+    GST_DEBUG ("Got %s from the discovery cache", uri);
+  }
+  g_variant_unref (serialized_info);
+  g_free (gst_version);
+
+done:
+  g_free (cached_gst_version);
+  if (entry)
+    g_variant_unref (entry);
+  g_free (path);
+  g_free (dir);
+
+  return info;
+}
+
+static void
+_discovery_cache_store (const gchar * uri, GstDiscovererInfo * info)
+{
+  GVariant *entry;
+  GError *err = NULL;
+  guint64 size, mtime;
+  gchar *dir, *path, *gst_version;
+
+  if (!gst_uri_has_protocol (uri, "file")
+      || !(dir = _discovery_cache_get_dir ()))
+    return;
+
+  if (!_query_file_stamp (uri, &size, &mtime)
+      || !GST_CLOCK_TIME_IS_VALID (mtime)) {
+    GST_DEBUG ("Not caching %s, its modification time is unknown", uri);
+    g_free (dir);
+
+    return;
+  }
+
+  gst_version = gst_version_string ();
+  entry = g_variant_ref_sink (g_variant_new (DISCOVERY_CACHE_ENTRY_FORMAT,
+          DISCOVERY_CACHE_VERSION, gst_version, size, mtime,
+          gst_discoverer_info_to_variant (info,
+              GST_DISCOVERER_SERIALIZE_ALL)));
+  g_free (gst_version);
+
+  path = _discovery_cache_get_path (dir, uri);
+  if (g_mkdir_with_parents (dir, 0755) < 0
+      || !g_file_set_contents (path, g_variant_get_data (entry),
+          g_variant_get_size (entry), &err)) {
+    GST_WARNING ("Could not store discovery result of %s in %s: %s", uri,
+        path, err ? err->message : g_strerror (errno));
+    g_clear_error (&err);
+  }
+
+  g_variant_unref (entry);
+  g_free (path);
+  g_free (dir);
+}
+
 static void
 initable_iface_init (GInitableIface * initable_iface)
 {
@@ -167,12 +420,33 @@ _start_loading (GESAsset * asset, GError ** error)
 {
   gboolean ret;
   const gchar *uri;
-  GstDiscoverer *discoverer = get_discoverer ();
+  GstDiscoverer *discoverer;
+  GstDiscovererInfo *info;
 
   uri = ges_asset_get_id (asset);
+  info = _discovery_cache_lookup (uri);
+  if (info) {
+    _set_discovered_info (GES_URI_CLIP_ASSET (asset), info);
+    gst_discoverer_info_unref (info);
+
+    return GES_ASSET_LOADING_OK;
+  }
+
+  discoverer = get_discoverer ();
   GST_DEBUG_OBJECT (discoverer, "Started loading %s", uri);
 
+  G_LOCK (discoverers_lock);
+  if (discovery_start_times) {
+    gint64 *start_time = g_new (gint64, 1);
+
+    *start_time = g_get_monotonic_time ();
+    g_hash_table_insert (discovery_start_times, g_strdup (uri), start_time);
+  }
+  G_UNLOCK (discoverers_lock);
+
   ret = gst_discoverer_discover_uri_async (discoverer, uri);
+  if (!ret)
+    release_discoverer (discoverer, uri);
   gst_object_unref (discoverer);
 
   if (ret)
@@ -447,27 +721,11 @@ ges_uri_clip_asset_set_info (GESUriClipAsset * self, GstDiscovererInfo * info)
 static void
 _set_meta_file_size (const gchar * uri, GESUriClipAsset * asset)
 {
-  GError *error = NULL;
-  GFileInfo *file_info = NULL;
-  guint64 file_size;
-  GFile *gfile = NULL;
-
-  GESMetaContainer *container = GES_META_CONTAINER (asset);
+  guint64 file_size, mtime;
 
-  gfile = g_file_new_for_uri (uri);
-  file_info = g_file_query_info (gfile, "standard::size",
-      G_FILE_QUERY_INFO_NONE, NULL, &error);
-  if (!error) {
-    file_size = g_file_info_get_attribute_uint64 (file_info, "standard::size");
-    ges_meta_container_register_meta_uint64 (container, GES_META_READ_WRITE,
-        "file-size", file_size);
-  } else {
-    g_error_free (error);
-  }
-  if (gfile)
-    g_object_unref (gfile);
-  if (file_info)
-    g_object_unref (file_info);
+  if (_query_file_stamp (uri, &file_size, &mtime))
+    ges_meta_container_register_meta_uint64 (GES_META_CONTAINER (asset),
+        GES_META_READ_WRITE, "file-size", file_size);
 }
 
 static void
@@ -484,26 +742,42 @@ _set_meta_foreach (const GstTagList * tags, const gchar * tag,
   }
 }
 
+static void
+_set_discovered_metas (GESUriClipAsset * mfs, GstDiscovererInfo * info)
+{
+  const GstTagList *tags = gst_discoverer_info_get_tags (info);
+
+  if (tags)
+    gst_tag_list_foreach (tags, (GstTagForeachFunc) _set_meta_foreach, mfs);
+
+  _set_meta_file_size (gst_discoverer_info_get_uri (info), mfs);
+}
+
+static void
+_set_discovered_info (GESUriClipAsset * mfs, GstDiscovererInfo * info)
+{
+  _set_discovered_metas (mfs, info);
+  ges_uri_clip_asset_set_info (mfs, info);
+}
+
 static void
 discoverer_discovered_cb (GstDiscoverer * discoverer,
     GstDiscovererInfo * info, GError * err, gpointer user_data)
 {
   GError *error = NULL;
-  const GstTagList *tags;
 
   const gchar *uri = gst_discoverer_info_get_uri (info);
   GESUriClipAsset *mfs =
       GES_URI_CLIP_ASSET (ges_asset_cache_lookup (GES_TYPE_URI_CLIP, uri));
 
-  tags = gst_discoverer_info_get_tags (info);
-  if (tags)
-    gst_tag_list_foreach (tags, (GstTagForeachFunc) _set_meta_foreach, mfs);
-
-  _set_meta_file_size (uri, mfs);
+  release_discoverer (discoverer, uri);
 
   if (gst_discoverer_info_get_result (info) == GST_DISCOVERER_OK) {
-    ges_uri_clip_asset_set_info (mfs, info);
+    _set_discovered_info (mfs, info);
+    _discovery_cache_store (uri, info);
   } else {
+    _set_discovered_metas (mfs, info);
+
     if (err) {
       error = g_error_copy (err);
     } else {
@@ -701,7 +975,7 @@ ges_uri_clip_asset_request_sync (const gchar * uri, GError ** error)
   GError *lerror = NULL;
   GESUriClipAsset *asset;
   RequestSyncData data = { 0, };
-  GstDiscoverer *previous_discoverer;
+  GPtrArray *previous_discoverers;
 
   asset = GES_URI_CLIP_ASSET (ges_asset_request (GES_TYPE_URI_CLIP, uri,
           &lerror));
@@ -710,8 +984,14 @@ ges_uri_clip_asset_request_sync (const gchar * uri, GError ** error)
     return asset;
 
   data.ml = g_main_loop_new (NULL, TRUE);
-  previous_discoverer = get_discoverer ();
-  create_discoverer ();
+
+  /* Use new discoverers, only created if the asset is not in the
+   * discovery cache */
+  G_LOCK (discoverers_lock);
+  previous_discoverers = g_hash_table_lookup (discoverers, g_thread_self ());
+  if (previous_discoverers)
+    g_hash_table_steal (discoverers, g_thread_self ());
+  G_UNLOCK (discoverers_lock);
 
   ges_asset_request_async (GES_TYPE_URI_CLIP, uri, NULL,
       (GAsyncReadyCallback) asset_ready_cb, &data);
@@ -719,7 +999,10 @@ ges_uri_clip_asset_request_sync (const gchar * uri, GError ** error)
   g_main_loop_unref (data.ml);
 
   G_LOCK (discoverers_lock);
-  g_hash_table_insert (discoverers, g_thread_self (), previous_discoverer);
+  if (previous_discoverers)
+    g_hash_table_insert (discoverers, g_thread_self (), previous_discoverers);
+  else
+    g_hash_table_remove (discoverers, g_thread_self ());
   G_UNLOCK (discoverers_lock);
 
   if (data.error) {
@@ -744,8 +1027,9 @@ void
 ges_uri_clip_asset_class_set_timeout (GESUriClipAssetClass * klass,
     GstClockTime timeout)
 {
+  guint i;
   GHashTableIter iter;
-  gpointer value;
+  GPtrArray *thread_discoverers;
 
   g_return_if_fail (GES_IS_URI_CLIP_ASSET_CLASS (klass));
 
@@ -753,11 +1037,113 @@ ges_uri_clip_asset_class_set_timeout (GESUriClipAssetClass * klass,
 
   G_LOCK (discoverers_lock);
   g_hash_table_iter_init (&iter, discoverers);
-  while (g_hash_table_iter_next (&iter, NULL, &value))
-    g_object_set (value, "timeout", timeout, NULL);
+  while (g_hash_table_iter_next (&iter, NULL,
+          (gpointer *) & thread_discoverers)) {
+    for (i = 0; i < thread_discoverers->len; i++)
+      g_object_set (thread_discoverers->pdata[i], "timeout", timeout, NULL);
+  }
+  G_UNLOCK (discoverers_lock);
+}
+
+/**
+ * ges_uri_clip_asset_class_set_discovery_threads:
+ * @klass: The #GESUriClipAssetClass on which to set the number of
+ * discovery threads
+ * @n_threads: The maximum number of media files to discover concurrently
+ * in each thread, or 0 to use the default value
+ *
+ * Sets how many media files can be discovered in parallel when loading
+ * #GESUriClipAsset-s asynchronously, for example while loading a
+ * #GESProject. Each file is discovered by its own #GstDiscoverer. When set
+ * to 0, the `GES_DISCOVERY_THREADS` environment variable is used if set,
+ * otherwise files are discovered one after the other.
+ *
+ * Since: 1.20
+ */
+void
+ges_uri_clip_asset_class_set_discovery_threads (GESUriClipAssetClass * klass,
+    guint n_threads)
+{
+  g_return_if_fail (GES_IS_URI_CLIP_ASSET_CLASS (klass));
+
+  G_LOCK (discoverers_lock);
+  discovery_threads = n_threads;
   G_UNLOCK (discoverers_lock);
 }
 
+/**
+ * ges_uri_clip_asset_class_set_discovery_cache_dir:
+ * @klass: The #GESUriClipAssetClass on which to set the discovery cache
+ * directory
+ * @dir: (type filename) (nullable): The directory in which to store the
+ * discovery results, or %NULL to disable the discovery cache
+ *
+ * Sets the directory in which the results of the discovery of local media
+ * files are stored so that later requests for assets of files that have not
+ * changed since can be completed without running a #GstDiscoverer. This
+ * overrides the `GES_DISCOVERY_CACHE_DIR` environment variable.
+ *
+ * Since: 1.20
+ */
+void
+ges_uri_clip_asset_class_set_discovery_cache_dir (GESUriClipAssetClass * klass,
+    const gchar * dir)
+{
+  g_return_if_fail (GES_IS_URI_CLIP_ASSET_CLASS (klass));
+
+  G_LOCK (discovery_cache_lock);
+  g_free (discovery_cache_dir);
+  discovery_cache_dir = g_strdup (dir);
+  discovery_cache_dir_set = TRUE;
+  G_UNLOCK (discovery_cache_lock);
+}
+
+/**
+ * ges_uri_clip_asset_invalidate_discovery_cache:
+ * @uri: (nullable): The URI of the file for which to drop the cached
+ * discovery result, or %NULL to drop all of them
+ *
+ * Removes cached discovery results, so that the next time an asset is loaded
+ * for @uri, the file is discovered again. Cached results are automatically
+ * ignored when the size or modification time of the file changed, this is
+ * only needed when a file was changed in a way the cache can not notice.
+ *
+ * Note that this does not affect assets that are already loaded, see
+ * ges_asset_needs_reload().
+ *
+ * Returns: %TRUE if cached results were removed, %FALSE otherwise.
+ *
+ * Since: 1.20
+ */
+gboolean
+ges_uri_clip_asset_invalidate_discovery_cache (const gchar * uri)
+{
+  GDir *gdir;
+  gchar *dir, *path;
+  const gchar *name;
+  gboolean res = FALSE;
+
+  if (!(dir = _discovery_cache_get_dir ()))
+    return FALSE;
+
+  if (uri) {
+    path = _discovery_cache_get_path (dir, uri);
+    res = g_unlink (path) == 0;
+    g_free (path);
+  } else if ((gdir = g_dir_open (dir, 0, NULL))) {
+    while ((name = g_dir_read_name (gdir))) {
+      path = g_build_filename (dir, name, NULL);
+      if (g_unlink (path) == 0)
+        res = TRUE;
+      g_free (path);
+    }
+    g_dir_close (gdir);
+  }
+  g_free (dir);
+
+  return res;
+}
+
 /**
  * ges_uri_clip_asset_get_stream_assets:
  * @self: A #GESUriClipAsset
@@ -928,6 +1314,10 @@ _ges_uri_asset_cleanup (void)
     g_hash_table_destroy (discoverers);
     discoverers = NULL;
   }
+  if (discovery_start_times) {
+    g_hash_table_destroy (discovery_start_times);
+    discovery_start_times = NULL;
+  }
   gst_clear_object (&GES_URI_CLIP_ASSET_CLASS (g_type_class_peek
           (GES_TYPE_URI_CLIP_ASSET))->discoverer);
   G_UNLOCK (discoverers_lock);
@@ -983,7 +1373,12 @@ _ges_uri_asset_ensure_setup (gpointer uriasset_class)
   G_LOCK (discoverers_lock);
   if (discoverers == NULL) {
     discoverers = g_hash_table_new_full (g_direct_hash,
-        (GEqualFunc) g_direct_equal, NULL, g_object_unref);
+        (GEqualFunc) g_direct_equal, NULL,
+        (GDestroyNotify) g_ptr_array_unref);
+    discovery_start_times = g_hash_table_new_full (g_str_hash, g_str_equal,
+        g_free, g_free);
+    discoverer_pending_quark =
+        g_quark_from_static_string ("ges-discoverer-pending");
   }
   G_UNLOCK (discoverers_lock);
 
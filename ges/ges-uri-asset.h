@@ -80,6 +80,14 @@ GES_API
 void ges_uri_clip_asset_class_set_timeout           (GESUriClipAssetClass *klass,
                                                      GstClockTime timeout);
 GES_API
+void ges_uri_clip_asset_class_set_discovery_threads (GESUriClipAssetClass *klass,
+                                                     guint n_threads);
+GES_API
+void ges_uri_clip_asset_class_set_discovery_cache_dir (GESUriClipAssetClass *klass,
+                                                       const gchar *dir);
+GES_API
+gboolean ges_uri_clip_asset_invalidate_discovery_cache (const gchar *uri);
+GES_API
 const GList * ges_uri_clip_asset_get_stream_assets  (GESUriClipAsset *self);
 
 #define GES_TYPE_URI_SOURCE_ASSET ges_uri_source_asset_get_type()
@@ -55,6 +55,8 @@ typedef enum
   GST_AUTOPLUG_SELECT_SKIP,
 } GstAutoplugSelectResult;
 
+static const gchar *_uri_source_get_wanted_stream_id (GESUriSource * source);
+
 static gint
 autoplug_select_cb (GstElement * bin, GstPad * pad, GstCaps * caps,
     GstElementFactory * factory, GESUriSource * self)
@@ -65,10 +67,7 @@ autoplug_select_cb (GstElement * bin, GstPad * pad, GstCaps * caps,
   GstFormat segment_format;
   GstAutoplugSelectResult res = GST_AUTOPLUG_SELECT_TRY;
   gchar *stream_id = gst_pad_get_stream_id (pad);
-  const gchar *wanted_id =
-      gst_discoverer_stream_info_get_stream_id
-      (ges_uri_source_asset_get_stream_info (GES_URI_SOURCE_ASSET
-          (ges_extractable_get_asset (GES_EXTRACTABLE (self->element)))));
+  const gchar *wanted_id = _uri_source_get_wanted_stream_id (self);
   gboolean wanted = !g_strcmp0 (stream_id, wanted_id);
 
   if (!ges_source_get_rendering_smartly (GES_SOURCE (self->element))) {
@@ -123,6 +122,680 @@ done:
   return res;
 }
 
+/*
+ * Decoder pool
+ *
+ * Opening, typefinding and setting up the decoders of a file is expensive and
+ * edits commonly cut many times into the same media file. The uri sources
+ * added to a timeline whose #GESTimeline:decoder-pool-size is not zero get
+ * their uridecodebin replaced by a GESUriDecodeBin which takes its decoder
+ * from the pool of the timeline. When going back to READY, it keeps its
+ * (PAUSED) decoder aside in that pool with its source pad blocked instead of
+ * tearing it down, so that the next source of the same stream going to
+ * PAUSED can reuse it and only needs to seek it.
+ *
+ * At most #GESTimeline:decoder-pool-size idle decoders are kept around, the
+ * least recently used ones being released first. When the pool gets disabled
+ * afterwards, or when rendering smartly, the GESUriDecodeBin keeps a private
+ * decoder. It is also used by the sources of media files having a generated
+ * proxy, as it picks the file to decode when going to PAUSED. The other
+ * sources keep their bare uridecodebin.
+ */
+typedef struct
+{
+  gchar *key;
+  GstElement *decodebin;
+  GstPad *srcpad;
+  gulong block_id;
+
+  /* NULL for the private decoder of a source */
+  GESDecoderPool *pool;
+  /* The GESUriDecodeBin currently using it, protected by the pool lock */
+  GstElement *owner;
+} PooledDecoder;
+
+struct _GESDecoderPool
+{
+  gint refcount;
+
+  GMutex lock;
+  /* key -> GQueue of idle PooledDecoder */
+  GHashTable *decoders;
+  GQueue idle;
+  guint size;
+  guint hits;
+  guint misses;
+};
+
+static void _uri_decode_bin_set_target (GstElement * bin, GstPad * pad);
+
+static GstPadProbeReturn
+_pooled_decoder_block_cb (GstPad * pad, GstPadProbeInfo * info, gpointer udata)
+{
+  GST_LOG_OBJECT (pad, "Idle in the pool, blocking %" GST_PTR_FORMAT,
+      info->data);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+_pooled_decoder_free (PooledDecoder * decoder)
+{
+  GST_DEBUG_OBJECT (decoder->decodebin, "Releasing decoder for %s",
+      decoder->key);
+
+  /* Going to NULL unblocks the streaming threads */
+  gst_element_set_state (decoder->decodebin, GST_STATE_NULL);
+  g_signal_handlers_disconnect_by_data (decoder->decodebin, decoder);
+  if (decoder->block_id)
+    gst_pad_remove_probe (decoder->srcpad, decoder->block_id);
+  gst_clear_object (&decoder->srcpad);
+  gst_object_unref (decoder->decodebin);
+  g_clear_pointer (&decoder->pool, ges_decoder_pool_unref);
+  g_free (decoder->key);
+  g_free (decoder);
+}
+
+static GList *
+_decoder_pool_evict (GESDecoderPool * pool)
+{
+  GList *evicted = NULL;
+
+  while (pool->idle.length > pool->size) {
+    PooledDecoder *oldest = g_queue_pop_head (&pool->idle);
+    GQueue *decoders = g_hash_table_lookup (pool->decoders, oldest->key);
+
+    g_queue_remove (decoders, oldest);
+    if (g_queue_is_empty (decoders))
+      g_hash_table_remove (pool->decoders, oldest->key);
+    evicted = g_list_prepend (evicted, oldest);
+  }
+
+  return evicted;
+}
+
+GESDecoderPool *
+ges_decoder_pool_new (void)
+{
+  GESDecoderPool *pool = g_new0 (GESDecoderPool, 1);
+
+  pool->refcount = 1;
+  g_mutex_init (&pool->lock);
+  pool->decoders = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+      (GDestroyNotify) g_queue_free);
+  g_queue_init (&pool->idle);
+
+  return pool;
+}
+
+GESDecoderPool *
+ges_decoder_pool_ref (GESDecoderPool * pool)
+{
+  g_atomic_int_inc (&pool->refcount);
+
+  return pool;
+}
+
+void
+ges_decoder_pool_unref (GESDecoderPool * pool)
+{
+  if (!g_atomic_int_dec_and_test (&pool->refcount))
+    return;
+
+  /* Idle decoders do not hold a reference on their pool */
+  g_list_free_full (pool->idle.head, (GDestroyNotify) _pooled_decoder_free);
+  g_queue_init (&pool->idle);
+  g_hash_table_unref (pool->decoders);
+  g_mutex_clear (&pool->lock);
+  g_free (pool);
+}
+
+/* Releases the idle decoders over @size right away */
+void
+ges_decoder_pool_set_size (GESDecoderPool * pool, guint size)
+{
+  GList *evicted;
+
+  g_mutex_lock (&pool->lock);
+  pool->size = size;
+  evicted = _decoder_pool_evict (pool);
+  g_mutex_unlock (&pool->lock);
+
+  g_list_free_full (evicted, (GDestroyNotify) _pooled_decoder_free);
+}
+
+guint
+ges_decoder_pool_get_size (GESDecoderPool * pool)
+{
+  guint size;
+
+  g_mutex_lock (&pool->lock);
+  size = pool->size;
+  g_mutex_unlock (&pool->lock);
+
+  return size;
+}
+
+void
+ges_decoder_pool_get_stats (GESDecoderPool * pool, guint * hits,
+    guint * misses)
+{
+  g_mutex_lock (&pool->lock);
+  if (hits)
+    *hits = pool->hits;
+  if (misses)
+    *misses = pool->misses;
+  g_mutex_unlock (&pool->lock);
+}
+
+static gint
+pooled_autoplug_select_cb (GstElement * bin, GstPad * pad, GstCaps * caps,
+    GstElementFactory * factory, const gchar * wanted_id)
+{
+  gchar *stream_id;
+  GstAutoplugSelectResult res = GST_AUTOPLUG_SELECT_TRY;
+
+  if (!are_raw_caps (caps))
+    return res;
+
+  stream_id = gst_pad_get_stream_id (pad);
+  if (g_strcmp0 (stream_id, wanted_id)) {
+    GST_INFO_OBJECT (bin, "Not matching stream id: %s -> SKIPPING", stream_id);
+    res = GST_AUTOPLUG_SELECT_SKIP;
+  }
+  g_free (stream_id);
+
+  return res;
+}
+
+/* Protects the srcpad and owner fields of the private decoders, the pooled
+ * ones use the lock of their pool */
+G_LOCK_DEFINE_STATIC (private_decoders);
+
+static void
+_pooled_decoder_lock (PooledDecoder * decoder)
+{
+  if (decoder->pool)
+    g_mutex_lock (&decoder->pool->lock);
+  else
+    G_LOCK (private_decoders);
+}
+
+static void
+_pooled_decoder_unlock (PooledDecoder * decoder)
+{
+  if (decoder->pool)
+    g_mutex_unlock (&decoder->pool->lock);
+  else
+    G_UNLOCK (private_decoders);
+}
+
+static void
+pooled_decoder_pad_added_cb (GstElement * decodebin, GstPad * pad,
+    PooledDecoder * decoder)
+{
+  GstElement *owner = NULL;
+
+  _pooled_decoder_lock (decoder);
+  if (decoder->srcpad) {
+    _pooled_decoder_unlock (decoder);
+    GST_INFO_OBJECT (decodebin, "Already exposed a pad, ignoring %"
+        GST_PTR_FORMAT, pad);
+
+    return;
+  }
+
+  decoder->srcpad = gst_object_ref (pad);
+  if (decoder->owner)
+    owner = gst_object_ref (decoder->owner);
+  _pooled_decoder_unlock (decoder);
+
+  if (owner) {
+    _uri_decode_bin_set_target (owner, pad);
+    gst_object_unref (owner);
+  }
+}
+
+/* Decodes @media, either the stream of @source itself or the matching
+ * stream of its generated proxy */
+static PooledDecoder *
+_pooled_decoder_new (GESUriSource * source, GESUriSourceAsset * media,
+    gchar * key, const GstCaps * caps, GESDecoderPool * pool)
+{
+  const gchar *uri = source->uri;
+  PooledDecoder *decoder = g_new0 (PooledDecoder, 1);
+
+  if (GES_ASSET (media) !=
+      ges_extractable_get_asset (GES_EXTRACTABLE (source->element)))
+    uri = ges_asset_get_id (GES_ASSET
+        (ges_uri_source_asset_get_filesource_asset (media)));
+
+  decoder->key = key;
+  decoder->pool = pool;
+  decoder->decodebin = gst_object_ref_sink (gst_element_factory_make
+      ("uridecodebin", NULL));
+  g_object_set (decoder->decodebin, "caps", caps,
+      "expose-all-streams", FALSE, "uri", uri, NULL);
+
+  if (!pool) {
+    /* Only used by @source, which might render smartly */
+    g_signal_connect (decoder->decodebin, "autoplug-select",
+        G_CALLBACK (autoplug_select_cb), source);
+  } else {
+    g_signal_connect_data (decoder->decodebin, "autoplug-select",
+        G_CALLBACK (pooled_autoplug_select_cb),
+        g_strdup (ges_asset_get_id (GES_ASSET (media))),
+        (GClosureNotify) g_free, 0);
+  }
+  g_signal_connect (decoder->decodebin, "pad-added",
+      G_CALLBACK (pooled_decoder_pad_added_cb), decoder);
+
+  return decoder;
+}
+
+static GESDecoderPool *
+_get_decoder_pool (GESUriSource * source)
+{
+  GESTimeline *timeline = GES_TIMELINE_ELEMENT_GET_TIMELINE (source->element);
+
+  /* Smart rendering depends on what is downstream of the source, such a
+   * decoder is not shared */
+  if (!timeline
+      || ges_source_get_rendering_smartly (GES_SOURCE (source->element)))
+    return NULL;
+
+  return timeline_get_decoder_pool (timeline);
+}
+
+static gboolean
+_is_generated_proxy (GESAsset * asset)
+{
+  gboolean generated = FALSE;
+
+  return GES_IS_URI_CLIP_ASSET (asset)
+      && ges_meta_container_get_boolean (GES_META_CONTAINER (asset),
+      GES_META_GENERATED_PROXY, &generated) && generated;
+}
+
+/* Returns the stream of @clip_asset at the same index, among the streams of
+ * the same type, as @asset in its own clip asset */
+static GESUriSourceAsset *
+_get_matching_stream (GESUriSourceAsset * asset, GESUriClipAsset * clip_asset)
+{
+  const GList *tmp;
+  guint index = 0;
+  GESTrackType type =
+      ges_track_element_asset_get_track_type (GES_TRACK_ELEMENT_ASSET (asset));
+
+  for (tmp = ges_uri_clip_asset_get_stream_assets ((GESUriClipAsset *)
+          ges_uri_source_asset_get_filesource_asset (asset));
+      tmp && tmp->data != asset; tmp = tmp->next) {
+    if (ges_track_element_asset_get_track_type (tmp->data) == type)
+      index++;
+  }
+
+  if (!tmp)
+    return NULL;
+
+  for (tmp = ges_uri_clip_asset_get_stream_assets (clip_asset); tmp;
+      tmp = tmp->next) {
+    if (ges_track_element_asset_get_track_type (tmp->data) == type
+        && index-- == 0)
+      return tmp->data;
+  }
+
+  return NULL;
+}
+
+/* Picks the stream to decode for @source: in timelines previewing with the
+ * proxies generated for the project (see
+ * ges_project_set_proxy_generation()), the matching stream of the proxy of
+ * its media file, the matching stream of the original media file otherwise.
+ * The latter is needed for clips created once a proxy was generated, as
+ * requesting the asset of the media file then gives its proxy. The asset of
+ * the clip is never changed */
+static GESUriSourceAsset *
+_uri_source_get_media (GESUriSource * source)
+{
+  GESAsset *media;
+  GESUriSourceAsset *stream;
+  gboolean previewing;
+  GESTimeline *timeline = GES_TIMELINE_ELEMENT_GET_TIMELINE (source->element);
+  GESUriSourceAsset *asset =
+      GES_URI_SOURCE_ASSET (ges_extractable_get_asset (GES_EXTRACTABLE
+          (source->element)));
+  GESAsset *clip_asset =
+      (GESAsset *) ges_uri_source_asset_get_filesource_asset (asset);
+
+  if (!clip_asset)
+    return asset;
+
+  previewing = timeline && ges_timeline_get_use_generated_proxies (timeline);
+  if (_is_generated_proxy (clip_asset)) {
+    if (previewing)
+      return asset;
+
+    media = ges_asset_get_proxy_target (clip_asset);
+  } else {
+    if (!previewing)
+      return asset;
+
+    media = ges_asset_get_proxy (clip_asset);
+    if (!_is_generated_proxy (media))
+      return asset;
+  }
+
+  if (!GES_IS_URI_CLIP_ASSET (media)
+      || !(stream = _get_matching_stream (asset, GES_URI_CLIP_ASSET (media)))) {
+    GST_INFO_OBJECT (source->element, "No stream matching %s in %s",
+        ges_asset_get_id (GES_ASSET (asset)),
+        media ? ges_asset_get_id (media) : "no media");
+
+    return asset;
+  }
+
+  GST_DEBUG_OBJECT (source->element, "Decoding %s instead of %s",
+      ges_asset_get_id (GES_ASSET (stream)),
+      ges_asset_get_id (GES_ASSET (asset)));
+
+  return stream;
+}
+
+static PooledDecoder *
+_decoder_pool_acquire (GESUriSource * source, GESUriSourceAsset * media,
+    GstElement * owner)
+{
+  gchar *key, *caps_str;
+  GQueue *decoders;
+  GESTrack *track;
+  const GstCaps *caps = NULL;
+  PooledDecoder *decoder = NULL;
+  GESDecoderPool *pool = _get_decoder_pool (source);
+
+  track = ges_track_element_get_track (source->element);
+  if (track)
+    caps = ges_track_get_caps (track);
+
+  caps_str = caps ? gst_caps_to_string (caps) : g_strdup ("ANY");
+  key = g_strdup_printf ("%s %s", ges_asset_get_id (GES_ASSET (media)),
+      caps_str);
+  g_free (caps_str);
+
+  if (!pool || !ges_decoder_pool_get_size (pool)) {
+    g_clear_pointer (&pool, ges_decoder_pool_unref);
+    decoder = _pooled_decoder_new (source, media, key, caps, NULL);
+    decoder->owner = owner;
+
+    return decoder;
+  }
+
+  g_mutex_lock (&pool->lock);
+  if ((decoders = g_hash_table_lookup (pool->decoders, key))) {
+    decoder = g_queue_pop_tail (decoders);
+    g_queue_remove (&pool->idle, decoder);
+    if (g_queue_is_empty (decoders))
+      g_hash_table_remove (pool->decoders, key);
+  }
+
+  if (decoder) {
+    pool->hits++;
+    decoder->owner = owner;
+  } else {
+    pool->misses++;
+  }
+  GST_DEBUG_OBJECT (source->element, "Decoder pool %s for %s (hits: %u,"
+      " misses: %u)", decoder ? "hit" : "miss", key, pool->hits,
+      pool->misses);
+  g_mutex_unlock (&pool->lock);
+
+  if (decoder) {
+    /* The pool reference was given back to the pool when it went idle */
+    decoder->pool = pool;
+    g_free (key);
+  } else {
+    decoder = _pooled_decoder_new (source, media, key, caps, pool);
+    decoder->owner = owner;
+  }
+
+  return decoder;
+}
+
+static void
+_decoder_pool_release (PooledDecoder * decoder)
+{
+  GQueue *decoders;
+  GList *evicted = NULL;
+  GESDecoderPool *pool = decoder->pool;
+
+  g_mutex_lock (&pool->lock);
+  decoder->owner = NULL;
+  if (!decoder->srcpad || !pool->size) {
+    g_mutex_unlock (&pool->lock);
+    _pooled_decoder_free (decoder);
+
+    return;
+  }
+
+  decoders = g_hash_table_lookup (pool->decoders, decoder->key);
+  if (!decoders) {
+    decoders = g_queue_new ();
+    g_hash_table_insert (pool->decoders, g_strdup (decoder->key), decoders);
+  }
+  g_queue_push_tail (decoders, decoder);
+  g_queue_push_tail (&pool->idle, decoder);
+  /* Idle decoders do not keep their pool alive */
+  decoder->pool = NULL;
+
+  evicted = _decoder_pool_evict (pool);
+  g_mutex_unlock (&pool->lock);
+
+  g_list_free_full (evicted, (GDestroyNotify) _pooled_decoder_free);
+  ges_decoder_pool_unref (pool);
+}
+
+G_DECLARE_FINAL_TYPE (GESUriDecodeBin, ges_uri_decode_bin, GES,
+    URI_DECODE_BIN, GstBin);
+
+struct _GESUriDecodeBin
+{
+  GstBin parent;
+
+  GESUriSource *source;
+  PooledDecoder *decoder;
+  GstPad *ghostpad;
+
+  /* The stream being decoded, see _uri_source_get_media() */
+  GESUriSourceAsset *media;
+};
+
+#define GES_TYPE_URI_DECODE_BIN (ges_uri_decode_bin_get_type())
+G_DEFINE_TYPE (GESUriDecodeBin, ges_uri_decode_bin, GST_TYPE_BIN);
+
+static gboolean
+_copy_sticky_event (GstPad * pad, GstEvent ** event, GstPad * ghostpad)
+{
+  gst_pad_store_sticky_event (ghostpad, *event);
+
+  return TRUE;
+}
+
+static void
+_uri_decode_bin_set_target (GstElement * bin, GstPad * pad)
+{
+  GESUriDecodeBin *self = GES_URI_DECODE_BIN (bin);
+
+  if (self->ghostpad) {
+    gst_ghost_pad_set_target (GST_GHOST_PAD (self->ghostpad), pad);
+
+    return;
+  }
+
+  /* Expose the sticky events right away so that the stream can be selected
+   * in the pad-added handler */
+  self->ghostpad = gst_ghost_pad_new ("src", pad);
+  gst_pad_set_active (self->ghostpad, TRUE);
+  gst_pad_sticky_events_foreach (pad,
+      (GstPadStickyEventsForeachFunction) _copy_sticky_event, self->ghostpad);
+  gst_element_add_pad (bin, self->ghostpad);
+  gst_element_no_more_pads (bin);
+}
+
+static void
+_uri_decode_bin_drop_decoder (GESUriDecodeBin * self)
+{
+  PooledDecoder *decoder = self->decoder;
+
+  self->decoder = NULL;
+  if (self->ghostpad)
+    gst_ghost_pad_set_target (GST_GHOST_PAD (self->ghostpad), NULL);
+  gst_bin_remove (GST_BIN (self), decoder->decodebin);
+
+  if (decoder->pool) {
+    _decoder_pool_release (decoder);
+  } else {
+    decoder->owner = NULL;
+    _pooled_decoder_free (decoder);
+  }
+}
+
+static GstStateChangeReturn
+ges_uri_decode_bin_change_state (GstElement * element,
+    GstStateChange transition)
+{
+  GstStateChangeReturn ret;
+  GESUriDecodeBin *self = GES_URI_DECODE_BIN (element);
+
+  switch (transition) {
+    case GST_STATE_CHANGE_READY_TO_PAUSED:
+    {
+      PooledDecoder *decoder = self->decoder;
+      GESUriSourceAsset *media = _uri_source_get_media (self->source);
+
+      /* Switch to the pool if it got enabled meanwhile, or to the other
+       * media if the proxy got generated or the pipeline mode changed */
+      if (decoder && !decoder->pool) {
+        GESDecoderPool *pool = _get_decoder_pool (self->source);
+
+        if ((pool && ges_decoder_pool_get_size (pool)) || media != self->media)
+          _uri_decode_bin_drop_decoder (self);
+        g_clear_pointer (&pool, ges_decoder_pool_unref);
+      }
+      g_set_object (&self->media, media);
+
+      if (self->decoder) {
+        GESTrack *track = ges_track_element_get_track (self->source->element);
+
+        /* The private decoder stayed in the bin */
+        if (track)
+          g_object_set (self->decoder->decodebin, "caps",
+              ges_track_get_caps (track), NULL);
+        break;
+      }
+
+      decoder = _decoder_pool_acquire (self->source, self->media, element);
+      self->decoder = decoder;
+      gst_bin_add (GST_BIN (self), decoder->decodebin);
+      if (decoder->srcpad) {
+        GstEvent *seek;
+
+        GST_INFO_OBJECT (self->source->element, "Reusing %" GST_PTR_FORMAT,
+            decoder->decodebin);
+
+        /* Restart streaming, the composition will position the source
+         * precisely once it gets its first buffer */
+        seek = gst_event_new_seek (1.0, GST_FORMAT_TIME,
+            GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT, GST_SEEK_TYPE_SET,
+            _INPOINT (self->source->element), GST_SEEK_TYPE_NONE,
+            GST_CLOCK_TIME_NONE);
+        gst_pad_send_event (decoder->srcpad, seek);
+
+        _uri_decode_bin_set_target (element, decoder->srcpad);
+      }
+      break;
+    }
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+    {
+      PooledDecoder *decoder = self->decoder;
+
+      if (!decoder)
+        break;
+
+      if (!decoder->pool) {
+        /* The private decoder removes its pads when going to READY */
+        G_LOCK (private_decoders);
+        gst_clear_object (&decoder->srcpad);
+        G_UNLOCK (private_decoders);
+        break;
+      }
+
+      if (decoder->srcpad) {
+        decoder->block_id = gst_pad_add_probe (decoder->srcpad,
+            GST_PAD_PROBE_TYPE_BLOCK_DOWNSTREAM, _pooled_decoder_block_cb,
+            NULL, NULL);
+      }
+      _uri_decode_bin_drop_decoder (self);
+      break;
+    }
+    default:
+      break;
+  }
+
+  ret = GST_ELEMENT_CLASS (ges_uri_decode_bin_parent_class)->change_state
+      (element, transition);
+
+  if (transition == GST_STATE_CHANGE_READY_TO_PAUSED
+      && ret != GST_STATE_CHANGE_FAILURE && self->decoder->block_id) {
+    gst_pad_remove_probe (self->decoder->srcpad, self->decoder->block_id);
+    self->decoder->block_id = 0;
+  }
+
+  return ret;
+}
+
+static void
+ges_uri_decode_bin_dispose (GObject * object)
+{
+  GESUriDecodeBin *self = GES_URI_DECODE_BIN (object);
+
+  if (self->decoder) {
+    gst_bin_remove (GST_BIN (self), self->decoder->decodebin);
+    _pooled_decoder_free (self->decoder);
+    self->decoder = NULL;
+  }
+  g_clear_object (&self->media);
+
+  G_OBJECT_CLASS (ges_uri_decode_bin_parent_class)->dispose (object);
+}
+
+static void
+ges_uri_decode_bin_class_init (GESUriDecodeBinClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+
+  object_class->dispose = ges_uri_decode_bin_dispose;
+
+  element_class->change_state =
+      GST_DEBUG_FUNCPTR (ges_uri_decode_bin_change_state);
+}
+
+static void
+ges_uri_decode_bin_init (GESUriDecodeBin * self)
+{
+}
+
+static const gchar *
+_uri_source_get_wanted_stream_id (GESUriSource * source)
+{
+  if (source->decodebin && GES_IS_URI_DECODE_BIN (source->decodebin)
+      && GES_URI_DECODE_BIN (source->decodebin)->media)
+    return ges_asset_get_id (GES_ASSET (GES_URI_DECODE_BIN
+            (source->decodebin)->media));
+
+  return ges_asset_get_id (ges_extractable_get_asset (GES_EXTRACTABLE
+          (source->element)));
+}
+
 GstElement *
 ges_uri_source_create_source (GESUriSource * self)
 {
@@ -145,7 +818,62 @@ ges_uri_source_create_source (GESUriSource * self)
       G_CALLBACK (autoplug_select_cb), self);
 
   return decodebin;
+}
+
+/* Replaces the uridecodebin of @self by a GESUriDecodeBin when the timeline
+ * of @track has a decoder pool, or when the media file of @self has a
+ * generated proxy or is one, so that the stream to decode can be picked when
+ * going to PAUSED */
+static void
+_uri_source_use_uri_decode_bin (GESUriSource * self, GESTrack * track)
+{
+  GESAsset *clip_asset;
+  GESUriDecodeBin *bin;
+  GESDecoderPool *pool;
+  gboolean needed = FALSE;
+  GESTimeline *timeline = (GESTimeline *) ges_track_get_timeline (track);
+
+  if (!timeline || !self->decodebin || GES_IS_URI_DECODE_BIN (self->decodebin))
+    return;
+
+  pool = timeline_get_decoder_pool (timeline);
+  needed = ges_decoder_pool_get_size (pool) > 0;
+  ges_decoder_pool_unref (pool);
 
+  clip_asset = (GESAsset *)
+      ges_uri_source_asset_get_filesource_asset (GES_URI_SOURCE_ASSET
+      (ges_extractable_get_asset (GES_EXTRACTABLE (self->element))));
+  if (clip_asset && (_is_generated_proxy (clip_asset)
+          || _is_generated_proxy (ges_asset_get_proxy (clip_asset))))
+    needed = TRUE;
+
+  if (!needed)
+    return;
+
+  bin = gst_object_ref_sink (g_object_new (GES_TYPE_URI_DECODE_BIN, NULL));
+  bin->source = self;
+  if (ges_source_replace_sub_element (GES_SOURCE (self->element),
+          GST_ELEMENT (bin))) {
+    GST_DEBUG_OBJECT (self->element, "Now decoding through %" GST_PTR_FORMAT,
+        bin);
+    self->decodebin = GST_ELEMENT (bin);
+  }
+  gst_object_unref (bin);
+}
+
+static void
+_clip_asset_proxy_changed_cb (GESAsset * clip_asset,
+    GParamSpec * arg G_GNUC_UNUSED, GESTrackElement * element)
+{
+  GESTrack *track = ges_track_element_get_track (element);
+  GESUriSource *self = GES_IS_VIDEO_URI_SOURCE (element) ?
+      GES_VIDEO_URI_SOURCE (element)->priv :
+      GES_AUDIO_URI_SOURCE (element)->priv;
+
+  /* Sources being used keep decoding their current media until they are
+   * added to a track again */
+  if (track)
+    _uri_source_use_uri_decode_bin (self, track);
 }
 
 static void
@@ -153,7 +881,9 @@ ges_uri_source_track_set_cb (GESTrackElement * element,
     GParamSpec * arg G_GNUC_UNUSED, GESUriSource * self)
 {
   GESTrack *track;
-  const GstCaps *caps = NULL;
+  GESAsset *clip_asset;
+  GstElement *decodebin;
+  PooledDecoder *decoder;
 
   if (!self->decodebin)
     return;
@@ -162,15 +892,30 @@ ges_uri_source_track_set_cb (GESTrackElement * element,
   if (!track)
     return;
 
-  caps = ges_track_get_caps (track);
+  if (!self->watching_proxy && (clip_asset = (GESAsset *)
+          ges_uri_source_asset_get_filesource_asset (GES_URI_SOURCE_ASSET
+              (ges_extractable_get_asset (GES_EXTRACTABLE (element)))))) {
+    g_signal_connect_object (clip_asset, "notify::proxy",
+        G_CALLBACK (_clip_asset_proxy_changed_cb), element, 0);
+    self->watching_proxy = TRUE;
+  }
 
-  GST_INFO_OBJECT (element,
-      "Setting %" GST_PTR_FORMAT "caps to: %" GST_PTR_FORMAT, self->decodebin,
-      caps);
-  g_object_set (self->decodebin, "caps", caps, NULL);
-}
+  _uri_source_use_uri_decode_bin (self, track);
 
+  /* Pooled decoders get the track caps when they are acquired */
+  if (!GES_IS_URI_DECODE_BIN (self->decodebin)) {
+    decodebin = self->decodebin;
+  } else if ((decoder = GES_URI_DECODE_BIN (self->decodebin)->decoder)
+      && !decoder->pool) {
+    decodebin = decoder->decodebin;
+  } else {
+    return;
+  }
 
+  GST_INFO_OBJECT (element, "Setting %" GST_PTR_FORMAT "caps to: %"
+      GST_PTR_FORMAT, decodebin, ges_track_get_caps (track));
+  g_object_set (decodebin, "caps", ges_track_get_caps (track), NULL);
+}
 
 void
 ges_uri_source_init (GESTrackElement * element, GESUriSource * self)
@@ -198,8 +943,22 @@ ges_uri_source_select_pad (GESSource * self, GstPad * pad)
   const GESUriClipAsset *clip_asset =
       ges_uri_source_asset_get_filesource_asset (asset);
   const gchar *wanted_stream_id = ges_asset_get_id (GES_ASSET (asset));
+  GstObject *parent = gst_pad_get_parent (pad);
   gchar *stream_id;
 
+  if (ges_still_frame_bin_owns_pad (pad)) {
+    gst_clear_object (&parent);
+
+    return TRUE;
+  }
+
+  /* The pad of the stream of a generated proxy */
+  if (parent && GES_IS_URI_DECODE_BIN (parent)
+      && GES_URI_DECODE_BIN (parent)->media)
+    wanted_stream_id =
+        ges_asset_get_id (GES_ASSET (GES_URI_DECODE_BIN (parent)->media));
+  gst_clear_object (&parent);
+
   if (clip_asset) {
     g_object_get (G_OBJECT (clip_asset), "is-nested-timeline",
         &is_nested_timeline, NULL);
@@ -33,6 +33,9 @@ struct _GESUriSource
   gchar *uri;
 
   GESTrackElement *element;
+
+  /* Whether notify::proxy of the clip asset is connected */
+  gboolean watching_proxy;
 };
 
 G_GNUC_INTERNAL gboolean      ges_uri_source_select_pad   (GESSource *self, GstPad *pad);
@@ -118,7 +118,7 @@ ges_video_source_create_filters (GESVideoSource * self, GPtrArray * elements,
   = { "alpha", "posx", "posy", "width", "height", "operator", NULL };
   const gchar *videoflip_props[] = { "video-direction", NULL };
 
-  g_ptr_array_add (elements, gst_element_factory_make ("queue", NULL));
+  g_ptr_array_add (elements, ges_source_make_converter ("queue", NULL));
 
   /* That positioner will add metadata to buffers according to its
      properties, acting like a proxy for our smart-mixer dynamic pads. */
@@ -128,7 +128,8 @@ ges_video_source_create_filters (GESVideoSource * self, GPtrArray * elements,
   g_ptr_array_add (elements, positioner);
 
   if (needs_converters)
-    g_ptr_array_add (elements, gst_element_factory_make ("videoconvert", NULL));
+    g_ptr_array_add (elements, ges_source_make_converter ("videoconvert",
+            NULL));
 
   /* If there's image-orientation tag, make sure the image is correctly oriented
    * before we scale it. */
@@ -137,12 +138,12 @@ ges_video_source_create_filters (GESVideoSource * self, GPtrArray * elements,
   g_ptr_array_add (elements, videoflip);
 
   if (needs_converters) {
-    g_ptr_array_add (elements, gst_element_factory_make ("videoscale",
+    g_ptr_array_add (elements, ges_source_make_converter ("videoscale",
             "track-element-videoscale"));
-    g_ptr_array_add (elements, gst_element_factory_make ("videoconvert",
+    g_ptr_array_add (elements, ges_source_make_converter ("videoconvert",
             "track-element-videoconvert"));
   }
-  g_ptr_array_add (elements, gst_element_factory_make ("videorate",
+  g_ptr_array_add (elements, ges_source_make_converter ("videorate",
           "track-element-videorate"));
 
   capsfilter =
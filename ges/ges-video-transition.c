@@ -73,6 +73,12 @@ struct _GESVideoTransitionPrivate
   gboolean pending_inverted;
 
   GstElement *positioner;
+
+  /* The native transition mixer, used instead of @smpte and @mixer when the
+   * timeline has native-transitions set, the mixer supports @type and the
+   * frames of the track can be blended as they are */
+  GstElement *native_mixer;
+  GstTimedValueControlSource *native_control_source;
 };
 
 enum
@@ -253,6 +259,8 @@ ges_video_transition_dispose (GObject * object)
     priv->smpte_control_source = NULL;
   }
 
+  gst_clear_object (&priv->native_control_source);
+  gst_clear_object (&priv->native_mixer);
   ges_video_transition_release_mixer (self);
 
   g_signal_handlers_disconnect_by_func (GES_TRACK_ELEMENT (self),
@@ -328,10 +336,98 @@ set_interpolation (GstObject * element, GESVideoTransitionPrivate * priv,
   return GST_TIMED_VALUE_CONTROL_SOURCE (control_source);
 }
 
+/* Called by the GESTransitionBin each time the transition prerolls */
+static gboolean
+ges_video_transition_use_native (GESTrackElement * element)
+{
+  GstCaps *restriction;
+  gboolean invert, use_native;
+  gint border;
+  GESVideoTransition *self = GES_VIDEO_TRANSITION (element);
+  GESVideoTransitionPrivate *priv = self->priv;
+  GESTimeline *timeline = GES_TIMELINE_ELEMENT_GET_TIMELINE (element);
+  GESTrack *track = ges_track_element_get_track (element);
+
+  if (!timeline || !track || !timeline_get_native_transitions (timeline))
+    return FALSE;
+
+  if (!ges_video_transition_mixer_supports_type (priv->type)) {
+    GST_INFO_OBJECT (self, "Type %d not supported by the native transition "
+        "mixer", priv->type);
+    return FALSE;
+  }
+
+  restriction = ges_track_get_restriction_caps (track);
+  use_native = ges_video_transition_mixer_can_blend (restriction);
+  if (!use_native)
+    GST_INFO_OBJECT (self, "Frames restricted to %" GST_PTR_FORMAT " can not "
+        "be blended natively", restriction);
+  gst_clear_caps (&restriction);
+
+  if (use_native) {
+    g_object_get (priv->smpte, "invert", &invert, "border", &border, NULL);
+    g_object_set (priv->native_mixer, "type", priv->type, "invert", invert,
+        "border", border, NULL);
+  }
+
+  return use_native;
+}
+
+/* Keeps the native mixer in sync with the "invert" and "border" children
+ * properties, which are the ones of the smptealpha */
+static void
+_smpte_notify_cb (GObject * smpte, GParamSpec * pspec,
+    GESVideoTransition * self)
+{
+  GValue value = G_VALUE_INIT;
+
+  g_value_init (&value, pspec->value_type);
+  g_object_get_property (smpte, pspec->name, &value);
+  g_object_set_property (G_OBJECT (self->priv->native_mixer), pspec->name,
+      &value);
+  g_value_unset (&value);
+}
+
+/* A single mixer doing both the crossfades and the wipes */
+static GstElement *
+ges_video_transition_create_native_element (GESVideoTransition * self)
+{
+  GstElement *topbin;
+  GstPad *sinka_target, *sinkb_target, *src_target;
+  GESVideoTransitionPrivate *priv = self->priv;
+
+  GST_LOG ("creating a native video bin");
+
+  topbin = gst_bin_new ("native-transition");
+
+  priv->native_mixer = gst_object_ref (ges_video_transition_mixer_new ());
+  gst_bin_add (GST_BIN (topbin), priv->native_mixer);
+
+  /* The first requested pad is the one being faded out */
+  sinka_target = gst_element_request_pad_simple (priv->native_mixer,
+      "sink_%u");
+  sinkb_target = gst_element_request_pad_simple (priv->native_mixer,
+      "sink_%u");
+  src_target = gst_element_get_static_pad (priv->native_mixer, "src");
+
+  gst_element_add_pad (topbin, gst_ghost_pad_new ("src", src_target));
+  gst_element_add_pad (topbin, gst_ghost_pad_new ("sinka", sinka_target));
+  gst_element_add_pad (topbin, gst_ghost_pad_new ("sinkb", sinkb_target));
+
+  gst_object_unref (sinka_target);
+  gst_object_unref (sinkb_target);
+  gst_object_unref (src_target);
+
+  priv->native_control_source =
+      set_interpolation (GST_OBJECT (priv->native_mixer), priv, "position");
+
+  return topbin;
+}
+
 static GstElement *
 ges_video_transition_create_element (GESTrackElement * object)
 {
-  GstElement *topbin, *iconva, *iconvb;
+  GstElement *topbin, *iconva, *iconvb, *native;
   GstElement *mixer = NULL;
   GstPad *sinka_target, *sinkb_target, *src_target, *sinka, *sinkb, *src;
   GESVideoTransition *self;
@@ -343,7 +439,7 @@ ges_video_transition_create_element (GESTrackElement * object)
 
   GST_LOG ("creating a video bin");
 
-  topbin = gst_bin_new ("transition-bin");
+  topbin = gst_bin_new ("smpte-transition");
 
   iconva = gst_element_factory_make ("videoconvert", "tr-csp-a");
   iconvb = gst_element_factory_make ("videoconvert", "tr-csp-b");
@@ -352,7 +448,7 @@ ges_video_transition_create_element (GESTrackElement * object)
   g_object_set (priv->positioner, "zorder",
       G_MAXUINT - GES_TIMELINE_ELEMENT_PRIORITY (self), NULL);
 
-  gst_bin_add_many (GST_BIN (topbin), iconva, iconvb, priv->positioner, NULL);
+  gst_bin_add_many (GST_BIN (topbin), iconva, iconvb, NULL);
 
   mixer =
       g_object_new (GES_TYPE_SMART_MIXER, "name",
@@ -379,11 +475,9 @@ ges_video_transition_create_element (GESTrackElement * object)
       priv->type ==
       GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE ? "add" : "over");
 
-  fast_element_link (mixer, priv->positioner);
-
   sinka_target = gst_element_get_static_pad (iconva, "sink");
   sinkb_target = gst_element_get_static_pad (iconvb, "sink");
-  src_target = gst_element_get_static_pad (priv->positioner, "src");
+  src_target = gst_element_get_static_pad (mixer, "src");
 
   sinka = gst_ghost_pad_new ("sinka", sinka_target);
   sinkb = gst_ghost_pad_new ("sinkb", sinkb_target);
@@ -407,6 +501,12 @@ ges_video_transition_create_element (GESTrackElement * object)
       set_interpolation (GST_OBJECT (priv->smpte), priv, "position");
   priv->mixer = gst_object_ref (mixer);
 
+  native = ges_video_transition_create_native_element (self);
+  g_signal_connect_object (priv->smpte, "notify::invert",
+      G_CALLBACK (_smpte_notify_cb), self, 0);
+  g_signal_connect_object (priv->smpte, "notify::border",
+      G_CALLBACK (_smpte_notify_cb), self, 0);
+
   if (priv->pending_type)
     ges_video_transition_set_transition_type_internal (self,
         priv->pending_type);
@@ -424,7 +524,8 @@ ges_video_transition_create_element (GESTrackElement * object)
   ges_track_element_add_children_props (GES_TRACK_ELEMENT (self),
       priv->smpte, NULL, NULL, smpte_properties);
 
-  return topbin;
+  return ges_transition_bin_new (object, topbin, native, priv->positioner,
+      ges_video_transition_use_native);
 }
 
 static GObject *
@@ -473,6 +574,10 @@ ges_video_transition_update_control_sources (GESVideoTransition * self,
       ges_timeline_element_get_duration (GES_TIMELINE_ELEMENT (self));
 
   GST_LOG ("updating controller");
+  if (priv->native_control_source)
+    ges_video_transition_update_control_source (priv->native_control_source,
+        duration, 0.0, 1.0);
+
   if (type == GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE) {
     ges_video_transition_update_control_source
         (priv->fade_in_control_source, duration, 0.0, 1.0);
@@ -548,6 +653,13 @@ ges_video_transition_set_transition_type_internal (GESVideoTransition
 
   priv->type = type;
 
+  /* The bin based transition gets used instead from the next time the
+   * transition prerolls if the native mixer does not support @type */
+  if (ges_video_transition_mixer_supports_type (type))
+    g_object_set (priv->native_mixer, "type", type, NULL);
+  else
+    GST_DEBUG_OBJECT (self, "Type %d not supported natively", type);
+
   if (type != GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE) {
     g_object_set (priv->smpte, "type", (gint) type, NULL);
   }
@@ -53,7 +53,16 @@ enum
 static GstElement *
 ges_video_uri_source_create_source (GESSource * element)
 {
-  return ges_uri_source_create_source (GES_VIDEO_URI_SOURCE (element)->priv);
+  GESVideoUriSource *self = GES_VIDEO_URI_SOURCE (element);
+  GESAsset *asset = ges_extractable_get_asset (GES_EXTRACTABLE (self));
+  GstElement *source = ges_uri_source_create_source (self->priv);
+
+  /* Images can be rendered once with GESTimeline:still-frames */
+  if (asset && ges_uri_source_asset_is_image (GES_URI_SOURCE_ASSET (asset)))
+    return ges_still_frame_bin_new_for_uri (GES_TRACK_ELEMENT (self), source,
+        self->uri);
+
+  return source;
 }
 
 static gboolean
@@ -226,7 +235,7 @@ ges_video_uri_source_create_filters (GESVideoSource * source,
               "deinterlace"), ("deinterlacing won't work"));
     } else {
       /* Right after the queue */
-      g_ptr_array_insert (elements, 1, gst_element_factory_make ("videoconvert",
+      g_ptr_array_insert (elements, 1, ges_source_make_converter ("videoconvert",
               NULL));
       g_ptr_array_insert (elements, 2, deinterlace);
       ges_track_element_add_children_props (GES_TRACK_ELEMENT (source),
@@ -235,6 +244,7 @@ ges_video_uri_source_create_filters (GESVideoSource * source,
 
   }
 
+  /* Also used with still frames, it then simply repeats the single frame */
   if (ges_uri_source_asset_is_image (GES_URI_SOURCE_ASSET (asset))) {
     guint i;
 
@@ -243,7 +253,7 @@ ges_video_uri_source_create_filters (GESVideoSource * source,
     /* Adding the imagefreeze right before the positionner so positioning can happen
      * properly */
     g_ptr_array_insert (elements, i,
-        gst_element_factory_make ("imagefreeze", NULL));
+        ges_source_make_converter ("imagefreeze", NULL));
   }
 
   return TRUE;
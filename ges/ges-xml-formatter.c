@@ -357,6 +357,8 @@ _parse_asset (GMarkupParseContext * context, const gchar * element_name,
       }
       g_markup_parse_context_get_position (context, &subproj_data->start_line,
           &subproj_data->start_char);
+      ges_base_xml_formatter_start_capture (GES_BASE_XML_FORMATTER (self),
+          subproj_data->start_line, subproj_data->start_char);
       id = g_filename_to_uri (subproj_data->filename, NULL, NULL);
       G_LOCK (uri_subprojects_map_lock);
       g_hash_table_insert (priv->subprojects_map, g_strdup (subproj_data->id),
@@ -955,6 +957,25 @@ _save_subproject_data (GESXmlFormatter * self, SubprojectData * subproj_data,
   gsize start = 0, end = 0;
   gchar *xml = GES_BASE_XML_FORMATTER (self)->xmlcontent;
 
+  if (!xml) {
+    /* Streaming, the content is not kept around */
+    xml = ges_base_xml_formatter_end_capture (GES_BASE_XML_FORMATTER (self),
+        subproject_end_line, subproject_end_char, &size);
+    if (!xml) {
+      GST_DEBUG_OBJECT (self, "Only checking the file, not saving %s",
+          subproj_data->id);
+
+      return TRUE;
+    }
+
+    GST_INFO_OBJECT (self, "Saving subproject %s (%" G_GSIZE_FORMAT " bytes)",
+        subproj_data->id, size);
+    res = g_file_set_contents (subproj_data->filename, xml, size, error);
+    g_free (xml);
+
+    return res;
+  }
+
   for (i = 0; xml[i] != '\0'; i++) {
     if (!start && line == subproj_data->start_line) {
       i += subproj_data->start_char - 1;
@@ -1115,8 +1136,8 @@ _init_value_from_spec_for_serialization (GValue * value, GParamSpec * spec)
     g_value_init (value, spec->value_type);
 }
 
-static gchar *
-_serialize_properties (GObject * object, gint * ret_n_props,
+gchar *
+ges_util_serialize_properties (GObject * object, gint * ret_n_props,
     const gchar * fieldname, ...)
 {
   gchar *ret;
@@ -1234,7 +1255,8 @@ _save_subproject (GESXmlFormatter * self, GString * str, GESProject * project,
 
   subproject = ges_extractable_get_asset (GES_EXTRACTABLE (timeline));
   substr = g_string_new (NULL);
-  properties = _serialize_properties (G_OBJECT (subproject), NULL, NULL);
+  properties =
+      ges_util_serialize_properties (G_OBJECT (subproject), NULL, NULL);
   metas = ges_meta_container_metas_to_string (GES_META_CONTAINER (subproject));
   append_escaped (str,
       g_markup_printf_escaped
@@ -1292,7 +1314,7 @@ _serialize_streams (GESXmlFormatter * self, GString * str,
         ges_uri_source_asset_get_stream_info (tmp->data);
     GstCaps *caps = gst_discoverer_stream_info_get_caps (sinfo);
 
-    properties = _serialize_properties (tmp->data, NULL, NULL);
+    properties = ges_util_serialize_properties (tmp->data, NULL, NULL);
     metas = ges_meta_container_metas_to_string (tmp->data);
     capsstr = gst_caps_to_string (caps);
 
@@ -1343,7 +1365,7 @@ _save_assets (GESXmlFormatter * self, GString * str, GESProject * project,
       G_UNLOCK (uri_subprojects_map_lock);
     }
 
-    properties = _serialize_properties (G_OBJECT (asset), NULL, NULL);
+    properties = ges_util_serialize_properties (G_OBJECT (asset), NULL, NULL);
     metas = ges_meta_container_metas_to_string (GES_META_CONTAINER (asset));
     append_escaped (str,
         g_markup_printf_escaped
@@ -1407,7 +1429,8 @@ _save_tracks (GESXmlFormatter * self, GString * str, GESTimeline * timeline,
   tracks = ges_timeline_get_tracks (timeline);
   for (tmp = tracks; tmp; tmp = tmp->next) {
     track = GES_TRACK (tmp->data);
-    properties = _serialize_properties (G_OBJECT (track), NULL, "caps", NULL);
+    properties =
+        ges_util_serialize_properties (G_OBJECT (track), NULL, "caps", NULL);
     strtmp = gst_caps_to_string (ges_track_get_caps (track));
     metas = ges_meta_container_metas_to_string (GES_META_CONTAINER (track));
     append_escaped (str,
@@ -1421,14 +1444,13 @@ _save_tracks (GESXmlFormatter * self, GString * str, GESTimeline * timeline,
   g_list_free_full (tracks, gst_object_unref);
 }
 
-static inline void
-_save_children_properties (GString * str, GESTimelineElement * element,
-    guint depth)
+gchar *
+ges_util_serialize_children_properties (GESTimelineElement * element)
 {
+  gchar *ret;
   GstStructure *structure;
   GParamSpec **pspecs, *spec;
   guint i, n_props;
-  gchar *struct_str;
 
   pspecs = ges_timeline_element_list_children_properties (element, &n_props);
 
@@ -1453,10 +1475,20 @@ _save_children_properties (GString * str, GESTimelineElement * element,
   }
   g_free (pspecs);
 
-  struct_str = gst_structure_to_string (structure);
+  ret = gst_structure_to_string (structure);
+  gst_structure_free (structure);
+
+  return ret;
+}
+
+static inline void
+_save_children_properties (GString * str, GESTimelineElement * element,
+    guint depth)
+{
+  gchar *struct_str = ges_util_serialize_children_properties (element);
+
   append_escaped (str,
       g_markup_printf_escaped (" children-properties='%s'", struct_str), 0);
-  gst_structure_free (structure);
   g_free (struct_str);
 }
 
@@ -1558,8 +1590,8 @@ _save_effect (GString * str, guint clip_id, GESTrackElement * trackelement,
   }
   g_list_free_full (tracks, gst_object_unref);
 
-  properties = _serialize_properties (G_OBJECT (trackelement), NULL, "start",
-      "duration", "locked", "name", "priority", NULL);
+  properties = ges_util_serialize_properties (G_OBJECT (trackelement), NULL,
+      "start", "duration", "locked", "name", "priority", NULL);
   metas =
       ges_meta_container_metas_to_string (GES_META_CONTAINER (trackelement));
   extractable_id = ges_extractable_get_id (GES_EXTRACTABLE (trackelement));
@@ -1637,7 +1669,7 @@ _save_source (GESXmlFormatter * self, GString * str,
       g_markup_printf_escaped
       ("          <source track-id='%i' ", index), depth);
 
-  properties = _serialize_properties (G_OBJECT (element), &n_props,
+  properties = ges_util_serialize_properties (G_OBJECT (element), &n_props,
       "in-point", "priority", "start", "duration", "track", "track-type"
       "uri", "name", "max-duration", NULL);
 
@@ -1670,8 +1702,8 @@ _save_layers (GESXmlFormatter * self, GString * str, GESTimeline * timeline,
     layer = GES_LAYER (tmplayer->data);
 
     priority = ges_layer_get_priority (layer);
-    properties =
-        _serialize_properties (G_OBJECT (layer), NULL, "priority", NULL);
+    properties = ges_util_serialize_properties (G_OBJECT (layer), NULL,
+        "priority", NULL);
     metas = ges_meta_container_metas_to_string (GES_META_CONTAINER (layer));
     append_escaped (str,
         g_markup_printf_escaped
@@ -1700,7 +1732,7 @@ _save_layers (GESXmlFormatter * self, GString * str, GESTimeline * timeline,
 
       /* We escape all mandatrorry properties that are handled sparetely
        * and vtype for StandarTransition as it is the asset ID */
-      properties = _serialize_properties (G_OBJECT (clip), NULL,
+      properties = ges_util_serialize_properties (G_OBJECT (clip), NULL,
           "supported-formats", "rate", "in-point", "start", "duration",
           "max-duration", "priority", "vtype", "uri", NULL);
       extractable_id = ges_extractable_get_id (GES_EXTRACTABLE (clip));
@@ -1794,7 +1826,7 @@ _save_group (GESXmlFormatter * self, GString * str, GList ** seen_groups,
     }
   }
 
-  properties = _serialize_properties (G_OBJECT (group), NULL, NULL);
+  properties = ges_util_serialize_properties (G_OBJECT (group), NULL, NULL);
 
   metadatas = ges_meta_container_metas_to_string (GES_META_CONTAINER (group));
   self->priv->min_version = MAX (self->priv->min_version, 5);
@@ -1841,9 +1873,12 @@ _save_timeline (GESXmlFormatter * self, GString * str, GESTimeline * timeline,
 {
   gchar *properties = NULL, *metas = NULL;
 
-  properties =
-      _serialize_properties (G_OBJECT (timeline), NULL, "update", "name",
-      "async-handling", "message-forward", NULL);
+  /* The playback and rendering tuning knobs are not part of the project */
+  properties = ges_util_serialize_properties (G_OBJECT (timeline), NULL,
+      "update", "name", "async-handling", "message-forward",
+      "decoder-pool-size", "occlusion-culling", "warm-sources",
+      "coalesce-commits", "still-frames", "native-transitions", "smart-cut",
+      NULL);
 
   ges_meta_container_set_uint64 (GES_META_CONTAINER (timeline), "duration",
       ges_timeline_get_duration (timeline));
@@ -2043,7 +2078,7 @@ _save_project (GESFormatter * formatter, GString * str, GESProject * project,
   GESXmlFormatter *self = GES_XML_FORMATTER (formatter);
   GESXmlFormatterPrivate *priv = _GET_PRIV (formatter);
 
-  properties = _serialize_properties (G_OBJECT (project), NULL, NULL);
+  properties = ges_util_serialize_properties (G_OBJECT (project), NULL, NULL);
   metas = ges_meta_container_metas_to_string (GES_META_CONTAINER (project));
   append_escaped (str,
       g_markup_printf_escaped ("  <project properties='%s' metadatas='%s'>\n",
@@ -55,6 +55,7 @@
 #include <ges/ges-extractable.h>
 #include <ges/ges-base-xml-formatter.h>
 #include <ges/ges-xml-formatter.h>
+#include <ges/ges-binary-formatter.h>
 
 #include <ges/ges-track.h>
 #include <ges/ges-track-element.h>
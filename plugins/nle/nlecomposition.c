@@ -50,6 +50,10 @@ enum
 {
   PROP_0,
   PROP_ID,
+  PROP_LOOKAHEAD,
+  PROP_SCRUBBING,
+  PROP_DROPPED_SEEKS,
+  PROP_EXECUTED_SEEKS,
   PROP_LAST,
 };
 
@@ -108,6 +112,25 @@ typedef struct _Action
   gint priority;
 } Action;
 
+/* Static index of the objects of the composition used to compute the stacks.
+ *
+ * by_start is sorted as objects_start and is viewed as an implicit balanced
+ * binary tree (the root of [lo, hi[ being (lo + hi) / 2), where max_stop
+ * contains the biggest stop of the sub-tree rooted at each position. This
+ * allows finding the objects playing at a given time in O(log n + k).
+ *
+ * It is rebuilt lazily after the objects or their values changed. */
+typedef struct
+{
+  NleObject **by_start;
+  GstClockTime *max_stop;
+  /* sorted as objects_stop */
+  NleObject **by_stop;
+  guint len;
+
+  gboolean dirty;
+} ObjectsIndex;
+
 struct _NleCompositionPrivate
 {
   gboolean dispose_has_run;
@@ -125,6 +148,9 @@ struct _NleCompositionPrivate
   GList *objects_stop;
   GHashTable *objects_hash;
 
+  /* Index of objects_start/objects_stop, see ObjectsIndex */
+  ObjectsIndex objects_index;
+
   /* List of NleObject to be inserted or removed from the composition on the
    * next commit */
   GHashTable *pending_io;
@@ -178,7 +204,7 @@ struct _NleCompositionPrivate
   /* Protect the actions list */
   GMutex actions_lock;
   GCond actions_cond;
-  GList *actions;
+  GQueue actions;
   Action *current_action;
 
   gboolean running;
@@ -186,6 +212,20 @@ struct _NleCompositionPrivate
 
   GstElement *current_bin;
 
+  /* Sources of the next stack being prerolled while the current one
+   * plays, see the "lookahead" property */
+  gboolean lookahead;
+  GstElement *lookahead_bin;
+  /* NleObject -> id of the probe blocking its source pad */
+  GHashTable *lookahead_probes;
+  gboolean lookahead_failed;
+
+  /* Whether a new flushing seek supersedes the pending ones, see the
+   * "scrubbing" property. The counters are protected by the actions lock */
+  gboolean scrubbing;
+  guint64 dropped_seeks;
+  guint64 executed_seeks;
+
   gboolean seeking_itself;
   gint real_eos_seqnum;
   gint next_eos_seqnum;
@@ -270,12 +310,14 @@ static void _deactivate_stack (NleComposition * comp,
 static void _set_real_eos_seqnum_from_seek (NleComposition * comp,
     GstEvent * event);
 static void _emit_commited_signal_func (NleComposition * comp, gpointer udata);
-static void _restart_task (NleComposition * comp);
+static void _restart_task_locked (NleComposition * comp);
+static void _restart_task_if_ready (NleComposition * comp, GstEvent * event);
 static void
 _add_action (NleComposition * comp, GCallback func, gpointer data,
     gint priority);
 static gboolean
 _is_ready_to_restart_task (NleComposition * comp, GstEvent * event);
+static void _lookahead_release_all (NleComposition * comp);
 
 
 /* COMP_REAL_START: actual position to start current playback at. */
@@ -346,24 +388,21 @@ _remove_actions_for_type (NleComposition * comp, GCallback callback)
 
   ACTIONS_LOCK (comp);
 
-  GST_LOG_OBJECT (comp, "finding action[callback=%s], action count = %d",
-      GST_DEBUG_FUNCPTR_NAME (callback), g_list_length (comp->priv->actions));
-  tmp = g_list_first (comp->priv->actions);
+  GST_LOG_OBJECT (comp, "finding action[callback=%s], action count = %u",
+      GST_DEBUG_FUNCPTR_NAME (callback), comp->priv->actions.length);
+  tmp = comp->priv->actions.head;
   while (tmp != NULL) {
     Action *act = tmp->data;
-    GList *removed = NULL;
+    GList *next = tmp->next;
 
     if (ACTION_CALLBACK (act) == callback) {
       GST_LOG_OBJECT (comp, "remove action for callback %s",
           GST_DEBUG_FUNCPTR_NAME (callback));
-      removed = tmp;
       g_closure_unref ((GClosure *) act);
-      comp->priv->actions = g_list_remove_link (comp->priv->actions, removed);
+      g_queue_delete_link (&comp->priv->actions, tmp);
     }
 
-    tmp = g_list_next (tmp);
-    if (removed)
-      g_list_free (removed);
+    tmp = next;
   }
 
   ACTIONS_UNLOCK (comp);
@@ -382,7 +421,7 @@ _execute_actions (NleComposition * comp)
     return;
   }
 
-  if (priv->actions == NULL)
+  if (g_queue_is_empty (&priv->actions))
     WAIT_FOR_AN_ACTION (comp);
 
   if (comp->priv->running == FALSE) {
@@ -392,34 +431,30 @@ _execute_actions (NleComposition * comp)
     return;
   }
 
-  if (priv->actions) {
+  if (!g_queue_is_empty (&priv->actions)) {
     GValue params[1] = { G_VALUE_INIT };
-    GList *lact;
+    Action *action;
 
-    GST_LOG_OBJECT (comp, "scheduled actions [%d]",
-        g_list_length (priv->actions));
+    GST_LOG_OBJECT (comp, "scheduled actions [%u]", priv->actions.length);
 
     g_value_init (&params[0], G_TYPE_OBJECT);
     g_value_set_object (&params[0], comp);
 
-    lact = g_list_first (priv->actions);
-    priv->actions = g_list_remove_link (priv->actions, lact);
-    priv->current_action = lact->data;
+    action = g_queue_pop_head (&priv->actions);
+    priv->current_action = action;
     ACTIONS_UNLOCK (comp);
 
     GST_INFO_OBJECT (comp, "Invoking %p:%s",
-        lact->data, GST_DEBUG_FUNCPTR_NAME ((ACTION_CALLBACK (lact->data))));
-    g_closure_invoke (lact->data, NULL, 1, params, NULL);
+        action, GST_DEBUG_FUNCPTR_NAME ((ACTION_CALLBACK (action))));
+    g_closure_invoke ((GClosure *) action, NULL, 1, params, NULL);
     g_value_unset (&params[0]);
 
     ACTIONS_LOCK (comp);
-    g_closure_unref (lact->data);
-    g_list_free (lact);
+    g_closure_unref ((GClosure *) action);
     priv->current_action = NULL;
     ACTIONS_UNLOCK (comp);
 
-    GST_LOG_OBJECT (comp, "remaining actions [%d]",
-        g_list_length (priv->actions));
+    GST_LOG_OBJECT (comp, "remaining actions [%u]", priv->actions.length);
   } else {
     ACTIONS_UNLOCK (comp);
   }
@@ -614,9 +649,14 @@ _seek_pipeline_func (NleComposition * comp, SeekData * seekd)
   }
 #endif
 
-  if (!initializing_stack)
+  if (!initializing_stack) {
+    ACTIONS_LOCK (comp);
+    priv->executed_seeks++;
+    ACTIONS_UNLOCK (comp);
+
     _post_start_composition_update (seekd->comp,
         gst_event_get_seqnum (seekd->event), COMP_UPDATE_STACK_ON_SEEK);
+  }
 
   /* crop the segment start/stop values */
   /* Only crop segment start value if we don't have a default object */
@@ -713,6 +753,7 @@ _commit_all_values (NleComposition * comp, NleUpdateStackReason reason)
       (priv->objects_start, (GCompareFunc) objects_start_compare);
   priv->objects_stop = g_list_sort
       (priv->objects_stop, (GCompareFunc) objects_stop_compare);
+  priv->objects_index.dirty = TRUE;
 
   return TRUE;
 }
@@ -884,12 +925,12 @@ _add_action_locked (NleComposition * comp, GCallback func,
       action, GST_DEBUG_FUNCPTR_NAME (func));
 
   if (priority == G_PRIORITY_HIGH)
-    priv->actions = g_list_prepend (priv->actions, action);
+    g_queue_push_head (&priv->actions, action);
   else
-    priv->actions = g_list_append (priv->actions, action);
+    g_queue_push_tail (&priv->actions, action);
 
-  GST_LOG_OBJECT (comp, "the number of remaining actions: %d",
-      g_list_length (priv->actions));
+  GST_LOG_OBJECT (comp, "the number of remaining actions: %u",
+      priv->actions.length);
 
   SIGNAL_NEW_ACTION (comp);
 }
@@ -914,11 +955,55 @@ create_seek_data (NleComposition * comp, GstEvent * event)
   return seekd;
 }
 
+/* Must be called with the actions lock taken */
+static void
+_drop_pending_seeks_locked (NleComposition * comp)
+{
+  GList *tmp;
+  NleCompositionPrivate *priv = comp->priv;
+
+  tmp = priv->actions.head;
+  while (tmp != NULL) {
+    Action *act = tmp->data;
+    GList *next = tmp->next;
+
+    if (ACTION_CALLBACK (act) == G_CALLBACK (_seek_pipeline_func)) {
+      SeekData *seekd = ((GClosure *) act)->data;
+
+      /* The stack initialization seek is ours, it has to run for the stack
+       * being set up to ever preroll */
+      if (seekd->event != priv->stack_initialization_seek) {
+        GST_DEBUG_OBJECT (comp, "Dropping superseded seek %" GST_PTR_FORMAT,
+            seekd->event);
+        priv->dropped_seeks++;
+        g_closure_unref ((GClosure *) act);
+        g_queue_delete_link (&priv->actions, tmp);
+      }
+    }
+
+    tmp = next;
+  }
+}
+
+/* Whether the task is paused waiting for the stack set up by a previous
+ * seek to preroll, which a new flushing seek would throw away anyway */
+static gboolean
+_is_prerolling_seek (NleComposition * comp)
+{
+  NleCompositionPrivate *priv = comp->priv;
+
+  return priv->seqnum_to_restart_task &&
+      priv->updating_reason == COMP_UPDATE_STACK_ON_SEEK &&
+      priv->stack_initialization_seek == NULL;
+}
+
 static void
 _add_seek_action (NleComposition * comp, GstEvent * event)
 {
   SeekData *seekd;
   GList *tmp;
+  GstSeekFlags flags;
+  gboolean interrupt_preroll = FALSE;
   guint32 seqnum = gst_event_get_seqnum (event);
 
   ACTIONS_LOCK (comp);
@@ -930,7 +1015,7 @@ _add_seek_action (NleComposition * comp, GstEvent * event)
   }
 
   /* Check if this seqnum is already queued up but not handled yet */
-  for (tmp = comp->priv->actions; tmp != NULL; tmp = tmp->next) {
+  for (tmp = comp->priv->actions.head; tmp != NULL; tmp = tmp->next) {
     Action *act = tmp->data;
 
     if (ACTION_CALLBACK (act) == G_CALLBACK (_seek_pipeline_func)) {
@@ -960,6 +1045,12 @@ _add_seek_action (NleComposition * comp, GstEvent * event)
     }
   }
 
+  gst_event_parse_seek (event, NULL, NULL, &flags, NULL, NULL, NULL, NULL);
+  if (comp->priv->scrubbing && (flags & GST_SEEK_FLAG_FLUSH)) {
+    _drop_pending_seeks_locked (comp);
+    interrupt_preroll = _is_prerolling_seek (comp);
+  }
+
   GST_DEBUG_OBJECT (comp, "Adding seek Action");
   seekd = create_seek_data (comp, event);
 
@@ -969,6 +1060,11 @@ _add_seek_action (NleComposition * comp, GstEvent * event)
   _add_action_locked (comp, G_CALLBACK (_seek_pipeline_func), seekd,
       G_PRIORITY_DEFAULT);
 
+  if (interrupt_preroll) {
+    GST_INFO_OBJECT (comp, "Not waiting for the previous seek to preroll");
+    _restart_task_locked (comp);
+  }
+
   ACTIONS_UNLOCK (comp);
 }
 
@@ -1017,6 +1113,17 @@ nle_composition_handle_message (GstBin * bin, GstMessage * message)
     GST_DEBUG_OBJECT (comp, "Dropping message %" GST_PTR_FORMAT " from "
         "object being teared down to READY!", message);
     goto drop;
+  } else if (gst_object_has_as_ancestor (GST_MESSAGE_SRC (message),
+          GST_OBJECT_CAST (priv->lookahead_bin))) {
+    /* The lookahead bin is not part of the running stack, its async state
+     * changes must not make the pipeline lose its state, and errors will be
+     * reported again if the stack actually gets activated */
+    if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR) {
+      GST_INFO_OBJECT (comp, "Error while prerolling next stack: %"
+          GST_PTR_FORMAT, message);
+      priv->lookahead_failed = TRUE;
+    }
+    goto drop;
   }
 
   GST_BIN_CLASS (parent_class)->handle_message (bin, message);
@@ -1041,6 +1148,24 @@ nle_composition_get_property (GObject * object, guint property_id,
       g_value_set_string (value, comp->priv->id);
       GST_OBJECT_UNLOCK (comp);
       break;
+    case PROP_LOOKAHEAD:
+      g_value_set_boolean (value, g_atomic_int_get (&comp->priv->lookahead));
+      break;
+    case PROP_SCRUBBING:
+      ACTIONS_LOCK (comp);
+      g_value_set_boolean (value, comp->priv->scrubbing);
+      ACTIONS_UNLOCK (comp);
+      break;
+    case PROP_DROPPED_SEEKS:
+      ACTIONS_LOCK (comp);
+      g_value_set_uint64 (value, comp->priv->dropped_seeks);
+      ACTIONS_UNLOCK (comp);
+      break;
+    case PROP_EXECUTED_SEEKS:
+      ACTIONS_LOCK (comp);
+      g_value_set_uint64 (value, comp->priv->executed_seeks);
+      ACTIONS_UNLOCK (comp);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (comp, property_id, pspec);
   }
@@ -1059,6 +1184,14 @@ nle_composition_set_property (GObject * object, guint property_id,
       comp->priv->id = g_value_dup_string (value);
       GST_OBJECT_UNLOCK (comp);
       break;
+    case PROP_LOOKAHEAD:
+      g_atomic_int_set (&comp->priv->lookahead, g_value_get_boolean (value));
+      break;
+    case PROP_SCRUBBING:
+      ACTIONS_LOCK (comp);
+      comp->priv->scrubbing = g_value_get_boolean (value);
+      ACTIONS_UNLOCK (comp);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (comp, property_id, pspec);
   }
@@ -1114,6 +1247,54 @@ nle_composition_class_init (NleCompositionClass * klass)
       g_param_spec_string ("id", "Id", "The stream-id of the composition",
       NULL,
       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | GST_PARAM_DOC_SHOW_DEFAULT);
+
+  /**
+   * NleComposition:lookahead:
+   *
+   * Whether the sources of the next stack should be prerolled while the
+   * current stack is playing, so that switching stacks during forward
+   * playback does not have to wait for them to be brought up.
+   */
+  properties[PROP_LOOKAHEAD] =
+      g_param_spec_boolean ("lookahead", "Lookahead",
+      "Preroll the sources of the next stack while the current one is playing",
+      FALSE,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | GST_PARAM_DOC_SHOW_DEFAULT);
+
+  /**
+   * NleComposition:scrubbing:
+   *
+   * Whether a newly queued flushing seek should supersede all the seeks
+   * that have not been handled yet, and stop waiting for the stack set up
+   * by a previous seek to preroll. Only the latest seek of a burst then
+   * gets handled, keeping latency bounded while the user scrubs.
+   */
+  properties[PROP_SCRUBBING] =
+      g_param_spec_boolean ("scrubbing", "Scrubbing",
+      "Only handle the latest of the pending flushing seeks",
+      FALSE,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | GST_PARAM_DOC_SHOW_DEFAULT);
+
+  /**
+   * NleComposition:dropped-seeks:
+   *
+   * The number of seeks that were superseded by a later seek before being
+   * handled, see #NleComposition:scrubbing.
+   */
+  properties[PROP_DROPPED_SEEKS] =
+      g_param_spec_uint64 ("dropped-seeks", "Dropped seeks",
+      "Number of seeks superseded before being handled", 0, G_MAXUINT64, 0,
+      G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * NleComposition:executed-seeks:
+   *
+   * The number of seeks that have been handled by the composition.
+   */
+  properties[PROP_EXECUTED_SEEKS] =
+      g_param_spec_uint64 ("executed-seeks", "Executed seeks",
+      "Number of seeks handled by the composition", 0, G_MAXUINT64, 0,
+      G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
   g_object_class_install_properties (gobject_class, PROP_LAST, properties);
 
   _signals[COMMITED_SIGNAL] =
@@ -1145,6 +1326,7 @@ nle_composition_init (NleComposition * comp)
   priv = nle_composition_get_instance_private (comp);
   priv->objects_start = NULL;
   priv->objects_stop = NULL;
+  priv->objects_index.dirty = TRUE;
 
   priv->segment = gst_segment_new ();
   priv->seek_segment = gst_segment_new ();
@@ -1164,6 +1346,11 @@ nle_composition_init (NleComposition * comp)
   priv->current_bin = gst_bin_new ("current-bin");
   gst_bin_add (GST_BIN (comp), priv->current_bin);
 
+  priv->lookahead_probes = g_hash_table_new (g_direct_hash, g_direct_equal);
+  priv->lookahead_bin = gst_bin_new ("lookahead-bin");
+  gst_element_set_locked_state (priv->lookahead_bin, TRUE);
+  gst_bin_add (GST_BIN (comp), priv->lookahead_bin);
+
   nle_composition_reset (comp);
 
   priv->id = gst_pad_create_stream_id (NLE_OBJECT_SRC (comp),
@@ -1213,7 +1400,8 @@ nle_composition_dispose (GObject * object)
   g_list_foreach (priv->objects_stop, _remove_each_nleobj, comp);
   g_list_free (priv->objects_stop);
 
-  g_list_free_full (priv->actions, (GDestroyNotify) _remove_each_action);
+  g_list_free_full (priv->actions.head, (GDestroyNotify) _remove_each_action);
+  g_queue_init (&priv->actions);
   g_clear_object (&priv->stack_initialization_seek);
 
   nle_composition_reset_target_pad (comp);
@@ -1239,6 +1427,10 @@ nle_composition_finalize (GObject * object)
   }
 
   g_hash_table_destroy (priv->objects_hash);
+  g_hash_table_destroy (priv->lookahead_probes);
+  g_free (priv->objects_index.by_start);
+  g_free (priv->objects_index.max_stop);
+  g_free (priv->objects_index.by_stop);
 
   gst_segment_free (priv->segment);
   gst_segment_free (priv->seek_segment);
@@ -1322,6 +1514,7 @@ nle_composition_reset (NleComposition * comp)
   priv->flush_seqnum = 0;
 
   _empty_bin (GST_BIN_CAST (priv->current_bin));
+  _lookahead_release_all (comp);
 
   GST_DEBUG_OBJECT (comp, "Composition now resetted");
 }
@@ -1361,10 +1554,12 @@ ghost_event_probe_handler (GstPad * ghostpad G_GNUC_UNUSED,
       return GST_PAD_PROBE_DROP;
     }
 
+    ACTIONS_LOCK (comp);
     if (priv->waiting_serialized_query_or_buffer) {
       GST_INFO_OBJECT (comp, "update_pipeline DONE");
-      _restart_task (comp);
+      _restart_task_locked (comp);
     }
+    ACTIONS_UNLOCK (comp);
 
     return GST_PAD_PROBE_OK;
   }
@@ -1375,13 +1570,14 @@ ghost_event_probe_handler (GstPad * ghostpad G_GNUC_UNUSED,
 
   switch (GST_EVENT_TYPE (event)) {
     case GST_EVENT_FLUSH_STOP:
-      if (_is_ready_to_restart_task (comp, event))
-        _restart_task (comp);
+      _restart_task_if_ready (comp, event);
 
       if (g_atomic_int_compare_and_exchange
           (&priv->stack_initialization_seek_sent, TRUE, FALSE)) {
         GST_INFO_OBJECT (comp, "Done seeking initialization stack.");
+        ACTIONS_LOCK (comp);
         gst_clear_event (&priv->stack_initialization_seek);
+        ACTIONS_UNLOCK (comp);
       }
 
       if (gst_event_get_seqnum (event) != comp->priv->flush_seqnum) {
@@ -1460,8 +1656,7 @@ ghost_event_probe_handler (GstPad * ghostpad G_GNUC_UNUSED,
         return GST_PAD_PROBE_DROP;
       }
 
-      if (_is_ready_to_restart_task (comp, event))
-        _restart_task (comp);
+      _restart_task_if_ready (comp, event);
 
       gst_event_parse_segment (event, &segment);
       gst_segment_copy_into (segment, &copy);
@@ -1499,12 +1694,7 @@ ghost_event_probe_handler (GstPad * ghostpad G_GNUC_UNUSED,
       GST_INFO_OBJECT (comp, "Got EOS, last EOS seqnum id : %i current "
           "seq num is: %i", comp->priv->real_eos_seqnum, seqnum);
 
-      if (_is_ready_to_restart_task (comp, event)) {
-        GST_INFO_OBJECT (comp, "We got an EOS right after seeing the right"
-            " segment, restarting task");
-
-        _restart_task (comp);
-      }
+      _restart_task_if_ready (comp, event);
 
       if (g_atomic_int_compare_and_exchange (&comp->priv->real_eos_seqnum,
               seqnum, 1)) {
@@ -2175,6 +2365,128 @@ beach:
   return ret;
 }
 
+static GstClockTime
+_objects_index_build (ObjectsIndex * index, guint lo, guint hi)
+{
+  guint mid;
+  GstClockTime max_stop;
+
+  if (lo >= hi)
+    return 0;
+
+  mid = lo + (hi - lo) / 2;
+  max_stop = index->by_start[mid]->stop;
+  max_stop = MAX (max_stop, _objects_index_build (index, lo, mid));
+  max_stop = MAX (max_stop, _objects_index_build (index, mid + 1, hi));
+  index->max_stop[mid] = max_stop;
+
+  return max_stop;
+}
+
+/* WITH OBJECTS LOCK TAKEN */
+static void
+_objects_index_rebuild (NleComposition * comp)
+{
+  guint i;
+  GList *tmp;
+  NleCompositionPrivate *priv = comp->priv;
+  ObjectsIndex *index = &priv->objects_index;
+
+  index->len = g_list_length (priv->objects_start);
+  index->by_start = g_renew (NleObject *, index->by_start, index->len);
+  index->max_stop = g_renew (GstClockTime, index->max_stop, index->len);
+  index->by_stop = g_renew (NleObject *, index->by_stop, index->len);
+
+  for (tmp = priv->objects_start, i = 0; tmp; tmp = tmp->next, i++)
+    index->by_start[i] = tmp->data;
+  for (tmp = priv->objects_stop, i = 0; tmp; tmp = tmp->next, i++)
+    index->by_stop[i] = tmp->data;
+
+  _objects_index_build (index, 0, index->len);
+  index->dirty = FALSE;
+
+  GST_DEBUG_OBJECT (comp, "Rebuilt objects index with %u objects", index->len);
+}
+
+/* Prepends to @found the objects from [@lo, @hi[ for which
+ * start <= @timestamp < stop */
+static void
+_objects_index_find_at (ObjectsIndex * index, guint lo, guint hi,
+    GstClockTime timestamp, GList ** found)
+{
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+    NleObject *object = index->by_start[mid];
+
+    if (index->max_stop[mid] <= timestamp)
+      return;
+
+    _objects_index_find_at (index, lo, mid, timestamp, found);
+
+    /* everything after starts after timestamp */
+    if (object->start > timestamp)
+      return;
+
+    if (object->stop > timestamp)
+      *found = g_list_prepend (*found, object);
+
+    lo = mid + 1;
+  }
+}
+
+/* The smallest start after @timestamp */
+static GstClockTime
+_objects_index_get_next_start (ObjectsIndex * index, GstClockTime timestamp)
+{
+  guint lo = 0, hi = index->len;
+
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+
+    if (index->by_start[mid]->start > timestamp)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+
+  return lo < index->len ? index->by_start[lo]->start : GST_CLOCK_TIME_NONE;
+}
+
+/* The biggest stop before @timestamp */
+static GstClockTime
+_objects_index_get_previous_stop (ObjectsIndex * index, GstClockTime timestamp)
+{
+  guint lo = 0, hi = index->len;
+
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+
+    if (index->by_stop[mid]->stop < timestamp)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+
+  return lo < index->len ? index->by_stop[lo]->stop : GST_CLOCK_TIME_NONE;
+}
+
+/* Sorts the stack by priority, objects with the same priority are sorted
+ * in the reverse order they would be met when going through
+ * objects_start (or objects_stop in reverse playback) */
+static gint
+_stack_priority_compare (NleObject * a, NleObject * b, gpointer reverse)
+{
+  gint res = priority_comp (a, b);
+
+  if (res)
+    return res;
+
+  if (GPOINTER_TO_INT (reverse))
+    return objects_stop_compare (b, a);
+
+  return objects_start_compare (b, a);
+}
+
 /*
  * get_stack_list:
  * @comp: The #NleComposition
@@ -2197,8 +2509,9 @@ get_stack_list (NleComposition * comp, GstClockTime timestamp,
     GstClockTime * stop, guint * highprio)
 {
   GList *tmp;
-  GList *stack = NULL;
+  GList *stack = NULL, *found = NULL;
   GNode *ret = NULL;
+  ObjectsIndex *index = &comp->priv->objects_index;
   GstClockTime nstart = GST_CLOCK_TIME_NONE;
   GstClockTime nstop = GST_CLOCK_TIME_NONE;
   GstClockTime first_out_of_stack = GST_CLOCK_TIME_NONE;
@@ -2212,57 +2525,39 @@ get_stack_list (NleComposition * comp, GstClockTime timestamp,
   GST_LOG ("objects_start:%p objects_stop:%p", comp->priv->objects_start,
       comp->priv->objects_stop);
 
+  if (index->dirty)
+    _objects_index_rebuild (comp);
+
   if (reverse) {
-    for (tmp = comp->priv->objects_stop; tmp; tmp = g_list_next (tmp)) {
-      NleObject *object = (NleObject *) tmp->data;
-
-      GST_LOG_OBJECT (object,
-          "start: %" GST_TIME_FORMAT ", stop:%" GST_TIME_FORMAT " , duration:%"
-          GST_TIME_FORMAT ", priority:%u, active:%d",
-          GST_TIME_ARGS (object->start), GST_TIME_ARGS (object->stop),
-          GST_TIME_ARGS (object->duration), object->priority, object->active);
-
-      if (object->stop >= timestamp) {
-        if ((object->start < timestamp) &&
-            (object->priority >= priority) &&
-            ((!activeonly) || (NLE_OBJECT_ACTIVE (object)))) {
-          GST_LOG_OBJECT (comp, "adding %s: sorted to the stack",
-              GST_OBJECT_NAME (object));
-          stack = g_list_insert_sorted (stack, object,
-              (GCompareFunc) priority_comp);
-        }
-      } else {
-        GST_LOG_OBJECT (comp, "too far, stopping iteration");
-        first_out_of_stack = object->stop;
-        break;
-      }
-    }
+    /* start < timestamp <= stop is the same as
+     * start <= timestamp - 1 < stop */
+    if (timestamp > 0)
+      _objects_index_find_at (index, 0, index->len, timestamp - 1, &found);
+    first_out_of_stack = _objects_index_get_previous_stop (index, timestamp);
   } else {
-    for (tmp = comp->priv->objects_start; tmp; tmp = g_list_next (tmp)) {
-      NleObject *object = (NleObject *) tmp->data;
-
-      GST_LOG_OBJECT (object,
-          "start: %" GST_TIME_FORMAT " , stop:%" GST_TIME_FORMAT " , duration:%"
-          GST_TIME_FORMAT ", priority:%u", GST_TIME_ARGS (object->start),
-          GST_TIME_ARGS (object->stop), GST_TIME_ARGS (object->duration),
-          object->priority);
-
-      if (object->start <= timestamp) {
-        if ((object->stop > timestamp) &&
-            (object->priority >= priority) &&
-            ((!activeonly) || (NLE_OBJECT_ACTIVE (object)))) {
-          GST_LOG_OBJECT (comp, "adding %s: sorted to the stack",
-              GST_OBJECT_NAME (object));
-          stack = g_list_insert_sorted (stack, object,
-              (GCompareFunc) priority_comp);
-        }
-      } else {
-        GST_LOG_OBJECT (comp, "too far, stopping iteration");
-        first_out_of_stack = object->start;
-        break;
-      }
+    _objects_index_find_at (index, 0, index->len, timestamp, &found);
+    first_out_of_stack = _objects_index_get_next_start (index, timestamp);
+  }
+
+  for (tmp = found; tmp; tmp = tmp->next) {
+    NleObject *object = (NleObject *) tmp->data;
+
+    GST_LOG_OBJECT (object,
+        "start: %" GST_TIME_FORMAT " , stop:%" GST_TIME_FORMAT " , duration:%"
+        GST_TIME_FORMAT ", priority:%u, active:%d",
+        GST_TIME_ARGS (object->start), GST_TIME_ARGS (object->stop),
+        GST_TIME_ARGS (object->duration), object->priority, object->active);
+
+    if ((object->priority >= priority) &&
+        ((!activeonly) || (NLE_OBJECT_ACTIVE (object)))) {
+      GST_LOG_OBJECT (comp, "adding %s to the stack", GST_OBJECT_NAME (object));
+      stack = g_list_prepend (stack, object);
     }
   }
+  g_list_free (found);
+
+  stack = g_list_sort_with_data (stack,
+      (GCompareDataFunc) _stack_priority_compare, GINT_TO_POINTER (reverse));
 
   /* Insert the expandables */
   if (G_LIKELY (timestamp < NLE_OBJECT_STOP (comp)))
@@ -2450,14 +2745,16 @@ _emit_commited_signal_func (NleComposition * comp, gpointer udata)
   g_signal_emit (comp, _signals[COMMITED_SIGNAL], 0, TRUE);
 }
 
+/* Must be called with the actions lock taken, which serializes restarting
+ * the task from the streaming threads and from a scrubbing seek */
 static void
-_restart_task (NleComposition * comp)
+_restart_task_locked (NleComposition * comp)
 {
   GST_INFO_OBJECT (comp, "Restarting task! after %s DONE",
       UPDATE_PIPELINE_REASONS[comp->priv->updating_reason]);
 
   if (comp->priv->updating_reason == COMP_UPDATE_STACK_ON_COMMIT)
-    _add_action (comp, G_CALLBACK (_emit_commited_signal_func), comp,
+    _add_action_locked (comp, G_CALLBACK (_emit_commited_signal_func), comp,
         G_PRIORITY_HIGH);
 
   comp->priv->seqnum_to_restart_task = 0;
@@ -2509,6 +2806,15 @@ _is_ready_to_restart_task (NleComposition * comp, GstEvent * event)
   return FALSE;
 }
 
+static void
+_restart_task_if_ready (NleComposition * comp, GstEvent * event)
+{
+  ACTIONS_LOCK (comp);
+  if (_is_ready_to_restart_task (comp, event))
+    _restart_task_locked (comp);
+  ACTIONS_UNLOCK (comp);
+}
+
 static void
 _commit_func (NleComposition * comp, UpdateCompositionData * ucompo)
 {
@@ -2692,6 +2998,7 @@ nle_composition_change_state (GstElement * element, GstStateChange transition)
       break;
     case GST_STATE_CHANGE_READY_TO_NULL:
       gst_element_set_state (comp->priv->current_bin, GST_STATE_NULL);
+      gst_element_set_state (comp->priv->lookahead_bin, GST_STATE_NULL);
       comp->priv->tearing_down_stack = FALSE;
       break;
     default:
@@ -2865,6 +3172,206 @@ _link_to_parent (NleComposition * comp, NleObject * newobj,
   }
 }
 
+/*
+ * Lookahead
+ *
+ * When the "lookahead" property is set, the sources of the stack following
+ * the current one during forward playback are added to the (state locked)
+ * lookahead bin and brought to PAUSED while the current stack is playing,
+ * with their source pad blocked so that nothing flows out of them.
+ * When that stack gets activated, _relink_single_node() moves them to the
+ * current bin without changing their state, and the blocking probes are
+ * removed once the stack is activated so that the usual initializing seek
+ * positions them.
+ *
+ * WITH OBJECTS LOCK TAKEN
+ */
+static GstPadProbeReturn
+_lookahead_block_cb (GstPad * pad, GstPadProbeInfo * info, gpointer udata)
+{
+  GST_LOG_OBJECT (pad, "Prerolled, blocking %" GST_PTR_FORMAT, info->data);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+_lookahead_remove_probe (NleComposition * comp, NleObject * object)
+{
+  gpointer probe_id;
+
+  if (!g_hash_table_lookup_extended (comp->priv->lookahead_probes, object,
+          NULL, &probe_id))
+    return;
+
+  gst_pad_remove_probe (NLE_OBJECT_SRC (object), GPOINTER_TO_SIZE (probe_id));
+  g_hash_table_remove (comp->priv->lookahead_probes, object);
+}
+
+static void
+_lookahead_release (NleComposition * comp, NleObject * object)
+{
+  NleCompositionPrivate *priv = comp->priv;
+
+  if (GST_OBJECT_PARENT (object) == GST_OBJECT_CAST (priv->lookahead_bin)) {
+    GST_DEBUG_OBJECT (comp, "Releasing prerolled %" GST_PTR_FORMAT, object);
+
+    /* Going to READY unblocks the streaming thread, only then can the
+     * probe be removed without anything being pushed out */
+    gst_element_set_state (GST_ELEMENT (object), GST_STATE_READY);
+    gst_bin_remove (GST_BIN (priv->lookahead_bin), GST_ELEMENT (object));
+  }
+
+  _lookahead_remove_probe (comp, object);
+}
+
+static void
+_lookahead_release_all (NleComposition * comp)
+{
+  GList *tmp, *objects;
+  NleCompositionPrivate *priv = comp->priv;
+
+  objects = g_hash_table_get_keys (priv->lookahead_probes);
+  for (tmp = objects; tmp; tmp = tmp->next)
+    _lookahead_release (comp, tmp->data);
+  g_list_free (objects);
+
+  if (GST_STATE (priv->lookahead_bin) > GST_STATE_READY)
+    gst_element_set_state (priv->lookahead_bin, GST_STATE_READY);
+  priv->lookahead_failed = FALSE;
+}
+
+/* Removes the probes of the objects that have been moved out of the
+ * lookahead bin */
+static void
+_lookahead_unblock_adopted (NleComposition * comp)
+{
+  GHashTableIter iter;
+  gpointer object, probe_id;
+  NleCompositionPrivate *priv = comp->priv;
+
+  g_hash_table_iter_init (&iter, priv->lookahead_probes);
+  while (g_hash_table_iter_next (&iter, &object, &probe_id)) {
+    if (GST_OBJECT_PARENT (object) == GST_OBJECT_CAST (priv->lookahead_bin))
+      continue;
+
+    GST_DEBUG_OBJECT (comp, "Unblocking %" GST_PTR_FORMAT, object);
+    gst_pad_remove_probe (NLE_OBJECT_SRC (object), GPOINTER_TO_SIZE (probe_id));
+    g_hash_table_iter_remove (&iter);
+  }
+}
+
+/* Returns TRUE if @object was prerolled and can be used as is */
+static gboolean
+_lookahead_adopt (NleComposition * comp, NleObject * object)
+{
+  NleCompositionPrivate *priv = comp->priv;
+
+  if (GST_OBJECT_PARENT (object) != GST_OBJECT_CAST (priv->lookahead_bin))
+    return FALSE;
+
+  if (priv->lookahead_failed) {
+    GST_INFO_OBJECT (comp, "Prerolling failed, not reusing %" GST_PTR_FORMAT,
+        object);
+    _lookahead_release (comp, object);
+
+    return FALSE;
+  }
+
+  GST_INFO_OBJECT (comp, "Reusing prerolled %" GST_PTR_FORMAT, object);
+  gst_bin_remove (GST_BIN (priv->lookahead_bin), GST_ELEMENT (object));
+
+  return TRUE;
+}
+
+static void
+_lookahead_preroll (NleComposition * comp, NleObject * object)
+{
+  gulong probe_id;
+  NleCompositionPrivate *priv = comp->priv;
+
+  GST_DEBUG_OBJECT (comp, "Prerolling %" GST_PTR_FORMAT, object);
+
+  /* Go to READY while unparented so the object does not consider itself
+   * outside of a composition */
+  if (GST_STATE (object) < GST_STATE_READY)
+    gst_element_set_state (GST_ELEMENT (object), GST_STATE_READY);
+
+  probe_id = gst_pad_add_probe (NLE_OBJECT_SRC (object),
+      GST_PAD_PROBE_TYPE_BLOCK_DOWNSTREAM,
+      (GstPadProbeCallback) _lookahead_block_cb, NULL, NULL);
+  g_hash_table_insert (priv->lookahead_probes, object,
+      GSIZE_TO_POINTER (probe_id));
+
+  gst_bin_add (GST_BIN (priv->lookahead_bin), GST_ELEMENT (object));
+  gst_element_set_state (GST_ELEMENT (object), GST_STATE_PAUSED);
+}
+
+static gboolean
+_lookahead_collect_source (GNode * node, GHashTable * sources)
+{
+  if (NLE_IS_SOURCE (node->data))
+    g_hash_table_add (sources, node->data);
+
+  return FALSE;
+}
+
+static void
+_lookahead_prepare_next_stack (NleComposition * comp)
+{
+  GList *tmp, *objects;
+  GHashTable *next_sources;
+  GNode *stack;
+  guint highprio;
+  GHashTableIter iter;
+  gpointer object;
+  GstClockTime start = G_MAXUINT64, stop = G_MAXUINT64;
+  NleCompositionPrivate *priv = comp->priv;
+  GstClockTime next = priv->current_stack_stop;
+
+  if (!g_atomic_int_get (&priv->lookahead) || priv->segment->rate < 0.0
+      || !priv->current || !GST_CLOCK_TIME_IS_VALID (next)
+      || next >= COMP_REAL_STOP (comp)) {
+    if (g_hash_table_size (priv->lookahead_probes))
+      _lookahead_release_all (comp);
+
+    return;
+  }
+
+  next_sources = g_hash_table_new (g_direct_hash, g_direct_equal);
+  stack = get_stack_list (comp, next, 0, TRUE, &start, &stop, &highprio);
+  if (stack) {
+    g_node_traverse (stack, G_PRE_ORDER, G_TRAVERSE_LEAVES, -1,
+        (GNodeTraverseFunc) _lookahead_collect_source, next_sources);
+    g_node_destroy (stack);
+  }
+
+  /* Release what is not part of the next stack anymore */
+  objects = g_hash_table_get_keys (priv->lookahead_probes);
+  for (tmp = objects; tmp; tmp = tmp->next) {
+    if (!g_hash_table_contains (next_sources, tmp->data))
+      _lookahead_release (comp, tmp->data);
+  }
+  g_list_free (objects);
+
+  if (!g_hash_table_size (priv->lookahead_probes))
+    priv->lookahead_failed = FALSE;
+
+  GST_DEBUG_OBJECT (comp, "Prerolling stack at %" GST_TIME_FORMAT
+      " (%u sources)", GST_TIME_ARGS (next), g_hash_table_size (next_sources));
+
+  gst_element_set_state (priv->lookahead_bin, GST_STATE_PAUSED);
+  g_hash_table_iter_init (&iter, next_sources);
+  while (g_hash_table_iter_next (&iter, &object, NULL)) {
+    /* Used by the current stack or already prerolling */
+    if (GST_OBJECT_PARENT (object))
+      continue;
+
+    _lookahead_preroll (comp, object);
+  }
+
+  g_hash_table_unref (next_sources);
+}
+
 static void
 _relink_children_recursively (NleComposition * comp,
     NleObject * newobj, GNode * node, GstEvent * toplevel_seek)
@@ -2916,6 +3423,7 @@ _relink_single_node (NleComposition * comp, GNode * node,
 {
   NleObject *newobj;
   NleObject *newparent;
+  gboolean prerolled;
   GstPad *srcpad = NULL, *sinkpad = NULL;
 
   if (G_UNLIKELY (!node))
@@ -2929,8 +3437,10 @@ _relink_single_node (NleComposition * comp, GNode * node,
 
   srcpad = NLE_OBJECT_SRC (newobj);
 
+  prerolled = _lookahead_adopt (comp, newobj);
   gst_bin_add (GST_BIN (comp->priv->current_bin), GST_ELEMENT (newobj));
-  gst_element_sync_state_with_parent (GST_ELEMENT_CAST (newobj));
+  if (!prerolled)
+    gst_element_sync_state_with_parent (GST_ELEMENT_CAST (newobj));
 
   /* link to parent if needed.  */
   if (newparent) {
@@ -2977,6 +3487,7 @@ _deactivate_stack (NleComposition * comp, NleUpdateStackReason reason)
 
   ptarget = gst_ghost_pad_get_target (GST_GHOST_PAD (NLE_OBJECT_SRC (comp)));
   _empty_bin (GST_BIN_CAST (comp->priv->current_bin));
+  _lookahead_unblock_adopted (comp);
 
   if (comp->priv->ghosteventprobe) {
     GST_INFO_OBJECT (comp, "Removing old ghost pad probe");
@@ -3094,7 +3605,9 @@ _activate_new_stack (NleComposition * comp, GstEvent * toplevel_seek)
     g_atomic_int_set (&priv->send_stream_start, TRUE);
   } else {
     GST_INFO_OBJECT (comp, "Needs seeking to initialize stack");
+    ACTIONS_LOCK (comp);
     comp->priv->stack_initialization_seek = toplevel_seek;
+    ACTIONS_UNLOCK (comp);
   }
 
   topelement = GST_ELEMENT (priv->current->data);
@@ -3263,6 +3776,7 @@ update_pipeline (NleComposition * comp, GstClockTime currenttime, gint32 seqnum,
 
   GstEvent *toplevel_seek;
 
+  gboolean res;
   GNode *stack = NULL;
   gboolean tear_down = FALSE;
   gboolean updatestoponly = FALSE;
@@ -3369,8 +3883,10 @@ update_pipeline (NleComposition * comp, GstClockTime currenttime, gint32 seqnum,
         " and stopping children thread until we are actually ready with"
         " that new stack");
 
+    ACTIONS_LOCK (comp);
     comp->priv->updating_reason = update_reason;
     comp->priv->seqnum_to_restart_task = seqnum;
+    ACTIONS_UNLOCK (comp);
 
     /* Subcomposition can preroll without sending initializing seeks
      * as the toplevel composition will send it anyway.
@@ -3393,10 +3909,18 @@ update_pipeline (NleComposition * comp, GstClockTime currenttime, gint32 seqnum,
   }
 
   /* Activate stack */
-  if (tear_down)
-    return _activate_new_stack (comp, toplevel_seek);
-  return _seek_current_stack (comp, toplevel_seek,
-      _have_to_flush_downstream (update_reason));
+  if (tear_down) {
+    res = _activate_new_stack (comp, toplevel_seek);
+    _lookahead_unblock_adopted (comp);
+  } else {
+    res = _seek_current_stack (comp, toplevel_seek,
+        _have_to_flush_downstream (update_reason));
+  }
+
+  if (res)
+    _lookahead_prepare_next_stack (comp);
+
+  return res;
 }
 
 static gboolean
@@ -3405,7 +3929,8 @@ nle_composition_add_object (GstBin * bin, GstElement * element)
   NleObject *object;
   NleComposition *comp = (NleComposition *) bin;
 
-  if (element == comp->priv->current_bin) {
+  if (element == comp->priv->current_bin
+      || element == comp->priv->lookahead_bin) {
     GST_INFO_OBJECT (comp, "Adding internal bin");
     return GST_BIN_CLASS (parent_class)->add_element (bin, element);
   }
@@ -3491,6 +4016,7 @@ _nle_composition_add_object (NleComposition * comp, NleObject * object)
 
   priv->objects_stop = g_list_insert_sorted
       (priv->objects_stop, object, (GCompareFunc) objects_stop_compare);
+  priv->objects_index.dirty = TRUE;
 
   /* Now the object is ready to be commited and then used */
 
@@ -3510,7 +4036,8 @@ nle_composition_remove_object (GstBin * bin, GstElement * element)
   NleObject *object;
   NleComposition *comp = (NleComposition *) bin;
 
-  if (element == comp->priv->current_bin) {
+  if (element == comp->priv->current_bin
+      || element == comp->priv->lookahead_bin) {
     GST_INFO_OBJECT (comp, "Removing internal bin");
     return GST_BIN_CLASS (parent_class)->remove_element (bin, element);
   }
@@ -3536,6 +4063,7 @@ _nle_composition_remove_object (NleComposition * comp, NleObject * object)
     return FALSE;
   }
 
+  _lookahead_release (comp, object);
   gst_element_set_locked_state (GST_ELEMENT (object), FALSE);
   gst_element_set_state (GST_ELEMENT (object), GST_STATE_NULL);
 
@@ -3547,6 +4075,7 @@ _nle_composition_remove_object (NleComposition * comp, NleObject * object)
     /* remove it from the objects list and resort the lists */
     priv->objects_start = g_list_remove (priv->objects_start, object);
     priv->objects_stop = g_list_remove (priv->objects_stop, object);
+    priv->objects_index.dirty = TRUE;
     GST_LOG_OBJECT (object, "Removed from the objects start/stop list");
   }
 
@@ -0,0 +1,113 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <ges/ges.h>
+
+#define NUM_OBJECTS 10000
+#define NUM_LAYERS 4
+#define NUM_SEEKS 200
+
+/* Measures the time it takes for the NLE composition of a track to switch
+ * to a new stack when seeking in a timeline with many objects. */
+
+static GstClockTime
+seek_and_wait (GstElement * pipeline, GstClockTime position)
+{
+  GstClockTime start = gst_util_get_timestamp ();
+
+  gst_element_seek_simple (pipeline, GST_FORMAT_TIME,
+      GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE, position);
+  gst_element_get_state (pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+
+  return gst_util_get_timestamp () - start;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint i;
+  GESAsset *asset;
+  GESTimeline *timeline;
+  GESTrack *track;
+  GstElement *pipeline, *sink;
+  GstPad *srcpad, *sinkpad;
+  GstClockTime start, end, total = 0, max_seek_time = 0,
+      min_seek_time = GST_CLOCK_TIME_NONE;
+
+  gst_init (&argc, &argv);
+  ges_init ();
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+
+  timeline = ges_timeline_new ();
+  track = GES_TRACK (ges_audio_track_new ());
+  ges_timeline_add_track (timeline, track);
+  for (i = 0; i < NUM_LAYERS; i++)
+    ges_timeline_append_layer (timeline);
+
+  start = gst_util_get_timestamp ();
+  /* clips on the different layers are shifted so that every clip boundary
+   * is a stack boundary */
+  for (i = 0; i < NUM_OBJECTS; i++) {
+    GESLayer *layer = g_list_nth_data (timeline->layers, i % NUM_LAYERS);
+
+    ges_layer_add_asset (layer, asset,
+        (i / NUM_LAYERS) * GST_SECOND + (i % NUM_LAYERS) * GST_MSECOND, 0,
+        GST_SECOND, GES_TRACK_TYPE_AUDIO);
+  }
+  ges_timeline_commit_sync (timeline);
+  end = gst_util_get_timestamp ();
+  gst_print ("%" GST_TIME_FORMAT " - adding and committing %d clips\n",
+      GST_TIME_ARGS (end - start), NUM_OBJECTS);
+
+  pipeline = gst_pipeline_new (NULL);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", FALSE, NULL);
+  gst_bin_add_many (GST_BIN (pipeline), GST_ELEMENT (timeline), sink, NULL);
+
+  srcpad = ges_timeline_get_pad_for_track (timeline, track);
+  sinkpad = gst_element_get_static_pad (sink, "sink");
+  gst_pad_link (srcpad, sinkpad);
+  gst_object_unref (sinkpad);
+
+  start = gst_util_get_timestamp ();
+  gst_element_set_state (pipeline, GST_STATE_PAUSED);
+  gst_element_get_state (pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+  end = gst_util_get_timestamp ();
+  gst_print ("%" GST_TIME_FORMAT " - prerolling\n",
+      GST_TIME_ARGS (end - start));
+
+  for (i = 0; i < NUM_SEEKS; i++) {
+    GstClockTime position = g_random_int_range (0, NUM_OBJECTS / NUM_LAYERS)
+        * GST_SECOND + GST_SECOND / 2;
+    GstClockTime seek_time = seek_and_wait (pipeline, position);
+
+    total += seek_time;
+    max_seek_time = MAX (max_seek_time, seek_time);
+    min_seek_time = MIN (min_seek_time, seek_time);
+  }
+  gst_print ("%" GST_TIME_FORMAT " - switching stack %d times, max: %"
+      GST_TIME_FORMAT " min: %" GST_TIME_FORMAT " mean: %" GST_TIME_FORMAT
+      "\n", GST_TIME_ARGS (total), NUM_SEEKS, GST_TIME_ARGS (max_seek_time),
+      GST_TIME_ARGS (min_seek_time), GST_TIME_ARGS (total / NUM_SEEKS));
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+  gst_object_unref (asset);
+
+  return 0;
+}
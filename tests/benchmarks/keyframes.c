@@ -0,0 +1,105 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <ges/ges.h>
+
+#define DEFAULT_NUM_KEYFRAMES 10000
+#define NUM_TRIMS 1000
+
+/* Measures trimming a clip with a keyframe on its alpha every millisecond.
+ *
+ * Usage: benchmark-keyframes [NUM_KEYFRAMES]
+ *
+ * Each trim moves one of the edges of the clip by one millisecond,
+ * removing one keyframe. */
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint i;
+  gdouble *values;
+  GstClockTime *timestamps;
+  GstClockTime start, set_time, trim_time;
+  GstControlSource *source;
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GESClip *clip;
+  GESTrackElement *video_source;
+  GList *children;
+  guint num_keyframes = DEFAULT_NUM_KEYFRAMES;
+
+  gst_init (&argc, &argv);
+  ges_init ();
+
+  if (argc > 1)
+    num_keyframes = MAX (g_ascii_strtoull (argv[1], NULL, 10), 2 * NUM_TRIMS);
+
+  timeline = ges_timeline_new ();
+  ges_timeline_add_track (timeline, GES_TRACK (ges_video_track_new ()));
+  layer = ges_timeline_append_layer (timeline);
+
+  clip = GES_CLIP (ges_test_clip_new ());
+  ges_timeline_element_set_duration (GES_TIMELINE_ELEMENT (clip),
+      num_keyframes * GST_MSECOND);
+  ges_layer_add_clip (layer, clip);
+
+  children = ges_container_get_children (GES_CONTAINER (clip), FALSE);
+  video_source = children->data;
+
+  source = gst_interpolation_control_source_new ();
+  g_object_set (source, "mode", GST_INTERPOLATION_MODE_LINEAR, NULL);
+  ges_track_element_set_control_source (video_source, source, "alpha",
+      "direct");
+  gst_object_unref (source);
+
+  timestamps = g_new (GstClockTime, num_keyframes + 1);
+  values = g_new (gdouble, num_keyframes + 1);
+  for (i = 0; i <= num_keyframes; i++) {
+    timestamps[i] = i * GST_MSECOND;
+    values[i] = (i % 100) / 100.0;
+  }
+
+  start = gst_util_get_timestamp ();
+  ges_track_element_set_control_values (video_source, "alpha", timestamps,
+      values, num_keyframes + 1);
+  set_time = gst_util_get_timestamp () - start;
+  gst_print ("%" GST_TIME_FORMAT " - setting %u keyframes\n",
+      GST_TIME_ARGS (set_time), num_keyframes + 1);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_TRIMS; i++) {
+    GESTimelineElement *element = GES_TIMELINE_ELEMENT (clip);
+
+    if (i % 2)
+      ges_timeline_element_edit (element, NULL, -1, GES_EDIT_MODE_TRIM,
+          GES_EDGE_START, element->start + GST_MSECOND);
+    else
+      ges_timeline_element_edit (element, NULL, -1, GES_EDIT_MODE_TRIM,
+          GES_EDGE_END, element->start + element->duration - GST_MSECOND);
+  }
+  trim_time = gst_util_get_timestamp () - start;
+  gst_print ("%" GST_TIME_FORMAT " - %u trims (%" G_GUINT64_FORMAT
+      " ns per trim)\n", GST_TIME_ARGS (trim_time), NUM_TRIMS,
+      trim_time / NUM_TRIMS);
+
+  g_list_free_full (children, gst_object_unref);
+  g_free (timestamps);
+  g_free (values);
+  gst_object_unref (timeline);
+
+  return 0;
+}
@@ -0,0 +1,193 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <ges/ges.h>
+#ifdef G_OS_UNIX
+#include <unistd.h>
+#endif
+
+#define DEFAULT_NUM_CLIPS 10000
+#define DEFAULT_WARM_SOURCES "16"
+
+/* Measures the memory used by the sources of a big timeline, and by playing
+ * through its beginning, for a given number of warm sources.
+ *
+ * Usage: benchmark-lazy-sources [NUM_CLIPS] [WARM_SOURCES|default]
+ *
+ * WARM_SOURCES is the value to use for GESTimeline:warm-sources, "default"
+ * not setting it so that all the sources are built right away. Without it,
+ * both the default and 16 warm sources are measured, each in its own process
+ * so that they do not share any memory. */
+
+static guint64
+get_resident_memory (void)
+{
+  guint64 res = 0;
+#ifdef G_OS_UNIX
+  gchar *statm;
+
+  if (g_file_get_contents ("/proc/self/statm", &statm, NULL, NULL)) {
+    gchar **values = g_strsplit (statm, " ", -1);
+
+    if (values[0] && values[1])
+      res = g_ascii_strtoull (values[1], NULL, 10) * sysconf (_SC_PAGESIZE);
+    g_strfreev (values);
+    g_free (statm);
+  }
+#endif
+
+  return res;
+}
+
+static guint
+count_elements (GstElement * element)
+{
+  guint n = 1;
+  GList *tmp;
+
+  if (!GST_IS_BIN (element))
+    return n;
+
+  GST_OBJECT_LOCK (element);
+  for (tmp = GST_BIN_CHILDREN (element); tmp; tmp = tmp->next)
+    n += count_elements (tmp->data);
+  GST_OBJECT_UNLOCK (element);
+
+  return n;
+}
+
+static guint
+count_source_elements (GESLayer * layer)
+{
+  guint n = 0;
+  GList *clips, *tmp, *children, *child;
+
+  clips = ges_layer_get_clips (layer);
+  for (tmp = clips; tmp; tmp = tmp->next) {
+    children = ges_container_get_children (tmp->data, FALSE);
+    for (child = children; child; child = child->next)
+      n += count_elements (ges_track_element_get_nleobject (child->data));
+    g_list_free_full (children, gst_object_unref);
+  }
+  g_list_free_full (clips, gst_object_unref);
+
+  return n;
+}
+
+static void
+print_usage (const gchar * step, GESLayer * layer, guint64 base_memory)
+{
+  gst_print ("%-24s %8u elements, %8" G_GUINT64_FORMAT " kB\n", step,
+      count_source_elements (layer),
+      (get_resident_memory () - base_memory) / 1024);
+}
+
+static void
+run_both (const gchar * program, const gchar * num_clips)
+{
+  guint i;
+  GError *error = NULL;
+  const gchar *modes[] = { "default", DEFAULT_WARM_SOURCES };
+
+  for (i = 0; i < G_N_ELEMENTS (modes); i++) {
+    gint status;
+    const gchar *args[] = { program, num_clips, modes[i], NULL };
+
+    gst_print ("%s warm sources:\n", modes[i]);
+    fflush (stdout);
+    if (!g_spawn_sync (NULL, (gchar **) args, NULL, G_SPAWN_DEFAULT, NULL,
+            NULL, NULL, NULL, &status, &error)) {
+      gst_printerr ("Could not run %s: %s\n", program, error->message);
+      g_clear_error (&error);
+    }
+  }
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint i;
+  guint64 base_memory;
+  GstElement *sink;
+  GstMessage *message;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+  guint num_clips = DEFAULT_NUM_CLIPS;
+
+  if (argc > 1)
+    num_clips = g_ascii_strtoull (argv[1], NULL, 10);
+  if (argc < 3) {
+    gchar *clips = g_strdup_printf ("%u", num_clips);
+
+    run_both (argv[0], clips);
+    g_free (clips);
+
+    return 0;
+  }
+
+  gst_init (&argc, &argv);
+  ges_init ();
+
+  base_memory = get_resident_memory ();
+  timeline = ges_timeline_new_audio_video ();
+  if (g_strcmp0 (argv[2], "default"))
+    g_object_set (timeline, "warm-sources",
+        (guint) g_ascii_strtoull (argv[2], NULL, 10), NULL);
+  layer = ges_timeline_append_layer (timeline);
+  for (i = 0; i < num_clips; i++) {
+    GESClip *clip = GES_CLIP (ges_test_clip_new ());
+
+    ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip),
+        i * GST_SECOND / 10);
+    ges_timeline_element_set_duration (GES_TIMELINE_ELEMENT (clip),
+        GST_SECOND / 10);
+    ges_layer_add_clip (layer, clip);
+  }
+  print_usage ("Timeline created:", layer, base_memory);
+
+  pipeline = ges_pipeline_new ();
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", FALSE, NULL);
+  ges_pipeline_preview_set_video_sink (pipeline, sink);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", FALSE, NULL);
+  ges_pipeline_preview_set_audio_sink (pipeline, sink);
+  ges_pipeline_set_timeline (pipeline, timeline);
+
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PAUSED);
+  gst_element_get_state (GST_ELEMENT (pipeline), NULL, NULL,
+      GST_CLOCK_TIME_NONE);
+  print_usage ("Pipeline prerolled:", layer, base_memory);
+
+  /* Play through the first hundred clips */
+  gst_element_seek (GST_ELEMENT (pipeline), 1.0, GST_FORMAT_TIME,
+      GST_SEEK_FLAG_FLUSH, GST_SEEK_TYPE_SET, 0, GST_SEEK_TYPE_SET,
+      10 * GST_SECOND);
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PLAYING);
+  message = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline),
+      GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+    gst_printerr ("Error while playing\n");
+  gst_message_unref (message);
+  print_usage ("Played 100 clips:", layer, base_memory);
+
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  return 0;
+}
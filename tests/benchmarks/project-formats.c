@@ -0,0 +1,173 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <glib/gstdio.h>
+#include <ges/ges.h>
+
+#define DEFAULT_NUM_CLIPS 5000
+#define NUM_SAVES 10
+
+/* Compares saving and loading the same timeline with the XML (.xges) and
+ * the binary (.gesb) formatters.
+ *
+ * Usage: benchmark-project-formats [NUM_CLIPS]
+ *
+ * Every clip of the timeline gets an effect with keyframes so that all the
+ * parts of the formats are used. */
+
+static const gchar *extensions[] = { "xges", "gesb" };
+
+static void
+project_loaded_cb (GESProject * project, GESTimeline * timeline,
+    GMainLoop * ml)
+{
+  g_main_loop_quit (ml);
+}
+
+static void
+error_loading_cb (GESProject * project, GESTimeline * timeline,
+    GError * error, GMainLoop * ml)
+{
+  gst_printerr ("Error loading project: %s\n", error->message);
+  g_main_loop_quit (ml);
+}
+
+static GESTimeline *
+create_timeline (guint num_clips)
+{
+  guint i;
+  GESLayer *layer;
+  GESTimeline *timeline = ges_timeline_new_audio_video ();
+
+  layer = ges_timeline_append_layer (timeline);
+  for (i = 0; i < num_clips; i++) {
+    GESClip *clip = GES_CLIP (ges_test_clip_new ());
+    GESEffect *effect = ges_effect_new ("videobalance");
+    GstControlSource *source = gst_interpolation_control_source_new ();
+
+    ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip),
+        i * GST_SECOND);
+    ges_timeline_element_set_duration (GES_TIMELINE_ELEMENT (clip),
+        GST_SECOND);
+    ges_layer_add_clip (layer, clip);
+    ges_container_add (GES_CONTAINER (clip), GES_TIMELINE_ELEMENT (effect));
+
+    ges_track_element_set_control_source (GES_TRACK_ELEMENT (effect), source,
+        "saturation", "direct");
+    gst_timed_value_control_source_set (GST_TIMED_VALUE_CONTROL_SOURCE
+        (source), 0, 0.5);
+    gst_timed_value_control_source_set (GST_TIMED_VALUE_CONTROL_SOURCE
+        (source), GST_SECOND / 2, 1.0);
+    gst_object_unref (source);
+  }
+
+  return timeline;
+}
+
+static void
+run (GESTimeline * timeline, const gchar * extension)
+{
+  guint i, n_clips = 0;
+  gint fd;
+  gchar *filename, *template, *uri;
+  GstClockTime start;
+  GStatBuf stat_buf;
+  GMainLoop *ml;
+  GESProject *project;
+  GESTimeline *loaded;
+  GList *layers, *tmp;
+  GError *err = NULL;
+
+  template = g_strdup_printf ("benchmark-XXXXXX.%s", extension);
+  fd = g_file_open_tmp (template, &filename, &err);
+  g_free (template);
+  if (fd == -1) {
+    gst_printerr ("Could not create project file: %s\n", err->message);
+    g_error_free (err);
+
+    return;
+  }
+  g_close (fd, NULL);
+  uri = gst_filename_to_uri (filename, NULL);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_SAVES; i++) {
+    if (!ges_timeline_save_to_uri (timeline, uri, NULL, TRUE, &err)) {
+      gst_printerr ("Could not save project: %s\n", err->message);
+      g_error_free (err);
+      goto done;
+    }
+  }
+
+  g_stat (filename, &stat_buf);
+  gst_print ("%" GST_TIME_FORMAT " - saving as .%s (%" G_GINT64_FORMAT
+      " bytes)\n", GST_TIME_ARGS ((gst_util_get_timestamp () - start) /
+          NUM_SAVES), extension, (gint64) stat_buf.st_size);
+
+  ml = g_main_loop_new (NULL, FALSE);
+  project = ges_project_new (uri);
+  g_signal_connect (project, "loaded", G_CALLBACK (project_loaded_cb), ml);
+  g_signal_connect (project, "error-loading", G_CALLBACK (error_loading_cb),
+      ml);
+
+  start = gst_util_get_timestamp ();
+  loaded = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  g_main_loop_run (ml);
+
+  layers = ges_timeline_get_layers (loaded);
+  for (tmp = layers; tmp; tmp = tmp->next) {
+    GList *clips = ges_layer_get_clips (tmp->data);
+
+    n_clips += g_list_length (clips);
+    g_list_free_full (clips, gst_object_unref);
+  }
+  g_list_free_full (layers, gst_object_unref);
+
+  gst_print ("%" GST_TIME_FORMAT " - loading %u clips from .%s\n",
+      GST_TIME_ARGS (gst_util_get_timestamp () - start), n_clips, extension);
+
+  gst_object_unref (loaded);
+  gst_object_unref (project);
+  g_main_loop_unref (ml);
+
+done:
+  g_unlink (filename);
+  g_free (filename);
+  g_free (uri);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint i;
+  GESTimeline *timeline;
+  guint num_clips = DEFAULT_NUM_CLIPS;
+
+  gst_init (&argc, &argv);
+  ges_init ();
+
+  if (argc > 1)
+    num_clips = g_ascii_strtoull (argv[1], NULL, 10);
+
+  timeline = create_timeline (num_clips);
+  for (i = 0; i < G_N_ELEMENTS (extensions); i++)
+    run (timeline, extensions[i]);
+  gst_object_unref (timeline);
+
+  return 0;
+}
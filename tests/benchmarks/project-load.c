@@ -0,0 +1,198 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <glib/gstdio.h>
+#include <ges/ges.h>
+
+#ifdef G_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+#define DEFAULT_NUM_CLIPS 10000
+
+/* Compares loading a project with the default two pass loader and with the
+ * streaming one (GESProject:streaming-load), each load running in its own
+ * process so that their peak memory usage can be reported.
+ *
+ * Usage: benchmark-project-load [NUM_CLIPS] [MEDIA_URI]
+ *
+ * The generated project contains NUM_CLIPS test clips, or clips of
+ * MEDIA_URI when given. */
+
+static void
+project_loaded_cb (GESProject * project, GESTimeline * timeline,
+    GMainLoop * ml)
+{
+  g_main_loop_quit (ml);
+}
+
+static void
+error_loading_cb (GESProject * project, GESTimeline * timeline,
+    GError * error, GMainLoop * ml)
+{
+  gst_printerr ("Error loading project: %s\n", error->message);
+  g_main_loop_quit (ml);
+}
+
+static gint
+load (const gchar * uri, gboolean streaming)
+{
+  GMainLoop *ml;
+  GESProject *project;
+  GESTimeline *timeline;
+  GstClockTime start;
+  guint n_clips = 0;
+  GList *layers, *tmp;
+
+  ges_init ();
+
+  ml = g_main_loop_new (NULL, FALSE);
+  project = ges_project_new (uri);
+  g_object_set (project, "streaming-load", streaming, NULL);
+  g_signal_connect (project, "loaded", G_CALLBACK (project_loaded_cb), ml);
+  g_signal_connect (project, "error-loading", G_CALLBACK (error_loading_cb),
+      ml);
+
+  start = gst_util_get_timestamp ();
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  g_main_loop_run (ml);
+
+  layers = ges_timeline_get_layers (timeline);
+  for (tmp = layers; tmp; tmp = tmp->next) {
+    GList *clips = ges_layer_get_clips (tmp->data);
+
+    n_clips += g_list_length (clips);
+    g_list_free_full (clips, gst_object_unref);
+  }
+  g_list_free_full (layers, gst_object_unref);
+
+  gst_print ("%" GST_TIME_FORMAT " - loading %u clips (%s)\n",
+      GST_TIME_ARGS (gst_util_get_timestamp () - start), n_clips,
+      streaming ? "streaming" : "two passes");
+
+#ifdef G_OS_UNIX
+  {
+    struct rusage usage;
+
+    if (getrusage (RUSAGE_SELF, &usage) == 0)
+      gst_print ("    peak memory usage: %ld kB\n", usage.ru_maxrss);
+  }
+#endif
+
+  gst_object_unref (timeline);
+  gst_object_unref (project);
+  g_main_loop_unref (ml);
+
+  return 0;
+}
+
+static gchar *
+generate_project (guint num_clips, const gchar * media_uri)
+{
+  guint i;
+  gint fd;
+  gchar *filename, *uri = NULL;
+  GESAsset *asset;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GError *err = NULL;
+
+  fd = g_file_open_tmp ("benchmark-XXXXXX.xges", &filename, &err);
+  if (fd == -1) {
+    gst_printerr ("Could not create project file: %s\n", err->message);
+    g_error_free (err);
+
+    return NULL;
+  }
+  g_close (fd, NULL);
+
+  if (media_uri)
+    asset = GES_ASSET (ges_uri_clip_asset_request_sync (media_uri, &err));
+  else
+    asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, &err);
+
+  if (!asset) {
+    gst_printerr ("Could not get asset: %s\n", err->message);
+    g_error_free (err);
+    goto done;
+  }
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  for (i = 0; i < num_clips; i++)
+    ges_layer_add_asset (layer, asset, i * GST_SECOND, 0, GST_SECOND,
+        GES_TRACK_TYPE_UNKNOWN);
+
+  uri = gst_filename_to_uri (filename, NULL);
+  if (!ges_timeline_save_to_uri (timeline, uri, NULL, TRUE, &err)) {
+    gst_printerr ("Could not save project: %s\n", err->message);
+    g_clear_error (&err);
+    g_clear_pointer (&uri, g_free);
+  }
+
+  gst_object_unref (timeline);
+  gst_object_unref (asset);
+
+done:
+  if (!uri)
+    g_unlink (filename);
+  g_free (filename);
+
+  return uri;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  gint i, status;
+  gchar *uri, *filename;
+  guint num_clips = DEFAULT_NUM_CLIPS;
+  GError *err = NULL;
+
+  gst_init (&argc, &argv);
+
+  if (argc == 4 && !g_strcmp0 (argv[1], "--load"))
+    return load (argv[2], !g_strcmp0 (argv[3], "streaming"));
+
+  if (argc > 1)
+    num_clips = g_ascii_strtoull (argv[1], NULL, 10);
+
+  ges_init ();
+  uri = generate_project (num_clips, argc > 2 ? argv[2] : NULL);
+  if (!uri)
+    return 1;
+
+  for (i = 0; i < 2; i++) {
+    gchar *args[] = { argv[0], (gchar *) "--load", uri,
+      (gchar *) (i ? "streaming" : "two-passes"), NULL
+    };
+
+    if (!g_spawn_sync (NULL, args, NULL, G_SPAWN_DEFAULT, NULL, NULL, NULL,
+            NULL, &status, &err)) {
+      gst_printerr ("Could not run the %s load: %s\n", args[3], err->message);
+      g_clear_error (&err);
+    }
+  }
+
+  filename = g_filename_from_uri (uri, NULL, NULL);
+  g_unlink (filename);
+  g_free (filename);
+  g_free (uri);
+
+  return 0;
+}
@@ -0,0 +1,167 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <glib/gstdio.h>
+#include <ges/ges.h>
+
+#define DEFAULT_NUM_CLIPS 60
+
+/* Compares rendering a timeline with a single pipeline and with
+ * ges_pipeline_render_segmented().
+ *
+ * Usage: benchmark-render-segments [NUM_CLIPS] [NUM_SEGMENTS]
+ *
+ * The timeline is made of one second long test clips, NUM_SEGMENTS
+ * defaults to the number of processors. */
+
+static GstEncodingProfile *
+create_profile (void)
+{
+  GstCaps *caps;
+  GstEncodingContainerProfile *profile;
+
+  caps = gst_caps_from_string ("application/ogg");
+  profile = gst_encoding_container_profile_new ("benchmark", NULL, caps, NULL);
+  gst_caps_unref (caps);
+
+  caps = gst_caps_from_string ("video/x-theora");
+  gst_encoding_container_profile_add_profile (profile,
+      (GstEncodingProfile *) gst_encoding_video_profile_new (caps, NULL, NULL,
+          0));
+  gst_caps_unref (caps);
+
+  caps = gst_caps_from_string ("audio/x-vorbis");
+  gst_encoding_container_profile_add_profile (profile,
+      (GstEncodingProfile *) gst_encoding_audio_profile_new (caps, NULL, NULL,
+          0));
+  gst_caps_unref (caps);
+
+  return (GstEncodingProfile *) profile;
+}
+
+static GESPipeline *
+create_pipeline (guint num_clips, const gchar * uri)
+{
+  guint i;
+  GESLayer *layer;
+  GESPipeline *pipeline = ges_pipeline_new ();
+  GESTimeline *timeline = ges_timeline_new_audio_video ();
+  GstEncodingProfile *profile = create_profile ();
+
+  layer = ges_timeline_append_layer (timeline);
+  for (i = 0; i < num_clips; i++) {
+    GESClip *clip = GES_CLIP (ges_test_clip_new ());
+
+    ges_test_clip_set_vpattern (GES_TEST_CLIP (clip), i % 20);
+    ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip),
+        i * GST_SECOND);
+    ges_timeline_element_set_duration (GES_TIMELINE_ELEMENT (clip),
+        GST_SECOND);
+    ges_layer_add_clip (layer, clip);
+  }
+
+  ges_pipeline_set_timeline (pipeline, timeline);
+  ges_pipeline_set_render_settings (pipeline, uri, profile);
+  ges_pipeline_set_mode (pipeline, GES_PIPELINE_MODE_RENDER);
+  gst_encoding_profile_unref (profile);
+
+  return pipeline;
+}
+
+static gboolean
+render_single (GESPipeline * pipeline)
+{
+  GstMessage *message;
+  GstBus *bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PLAYING);
+  message = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+  gst_object_unref (bus);
+
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR) {
+    GError *err;
+
+    gst_message_parse_error (message, &err, NULL);
+    gst_printerr ("Could not render: %s\n", err->message);
+    g_error_free (err);
+    gst_message_unref (message);
+
+    return FALSE;
+  }
+  gst_message_unref (message);
+
+  return TRUE;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  gint fd;
+  gchar *filename, *uri;
+  GstClockTime start, single, segmented;
+  GESPipeline *pipeline;
+  GError *err = NULL;
+  guint num_clips = DEFAULT_NUM_CLIPS, num_segments = g_get_num_processors ();
+
+  gst_init (&argc, &argv);
+  ges_init ();
+
+  if (argc > 1)
+    num_clips = g_ascii_strtoull (argv[1], NULL, 10);
+  if (argc > 2)
+    num_segments = g_ascii_strtoull (argv[2], NULL, 10);
+
+  fd = g_file_open_tmp ("benchmark-XXXXXX.ogg", &filename, &err);
+  if (fd == -1) {
+    gst_printerr ("Could not create output file: %s\n", err->message);
+    g_error_free (err);
+
+    return 1;
+  }
+  g_close (fd, NULL);
+  uri = gst_filename_to_uri (filename, NULL);
+
+  pipeline = create_pipeline (num_clips, uri);
+  start = gst_util_get_timestamp ();
+  if (!render_single (pipeline))
+    goto done;
+  single = gst_util_get_timestamp () - start;
+  gst_print ("%" GST_TIME_FORMAT " - rendering %u seconds with one pipeline\n",
+      GST_TIME_ARGS (single), num_clips);
+
+  start = gst_util_get_timestamp ();
+  if (!ges_pipeline_render_segmented (pipeline, num_segments, &err)) {
+    gst_printerr ("Could not render: %s\n", err->message);
+    g_error_free (err);
+    goto done;
+  }
+  segmented = gst_util_get_timestamp () - start;
+  gst_print ("%" GST_TIME_FORMAT " - rendering %u seconds in %u segments"
+      " (x%.2f)\n", GST_TIME_ARGS (segmented), num_clips, num_segments,
+      (gdouble) single / segmented);
+
+done:
+  gst_object_unref (pipeline);
+  g_unlink (filename);
+  g_free (filename);
+  g_free (uri);
+
+  return 0;
+}
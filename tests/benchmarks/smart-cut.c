@@ -0,0 +1,127 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <glib/gstdio.h>
+#include <ges/ges.h>
+
+#define DEFAULT_NUM_CUTS 10
+
+/* Measures smart rendering cuts of a media file which are not on keyframes.
+ *
+ * Usage: benchmark-smart-cut URI [NUM_CUTS] [SMART_CUT]
+ *
+ * SMART_CUT is the value to use for GESTimeline:smart-cut, 1 by default, 0
+ * meaning that the cuts are not handled GOP by GOP. The file is cut in
+ * NUM_CUTS one second long clips starting a third of a second after each
+ * other second of the file, and rendered in its own formats. */
+
+gint
+main (gint argc, gchar * argv[])
+{
+  gint fd;
+  guint i;
+  gchar *filename, *uri;
+  GstBus *bus;
+  GstMessage *message;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+  GESUriClipAsset *asset;
+  GstEncodingProfile *profile;
+  GstClockTime start, rendered;
+  GError *err = NULL;
+  gboolean smart_cut = TRUE;
+  guint num_cuts = DEFAULT_NUM_CUTS;
+
+  if (argc < 2) {
+    gst_printerr ("Usage: %s URI [NUM_CUTS] [SMART_CUT]\n", argv[0]);
+
+    return 1;
+  }
+  if (argc > 2)
+    num_cuts = MAX (g_ascii_strtoull (argv[2], NULL, 10), 1);
+  if (argc > 3)
+    smart_cut = g_strcmp0 (argv[3], "0") != 0;
+
+  gst_init (&argc, &argv);
+  ges_init ();
+
+  asset = ges_uri_clip_asset_request_sync (argv[1], &err);
+  if (!asset) {
+    gst_printerr ("Could not load %s: %s\n", argv[1], err->message);
+    g_error_free (err);
+
+    return 1;
+  }
+
+  fd = g_file_open_tmp ("benchmark-XXXXXX", &filename, &err);
+  if (fd == -1) {
+    gst_printerr ("Could not create output file: %s\n", err->message);
+    g_error_free (err);
+    gst_object_unref (asset);
+
+    return 1;
+  }
+  g_close (fd, NULL);
+  uri = gst_filename_to_uri (filename, NULL);
+
+  timeline = ges_timeline_new_audio_video ();
+  g_object_set (timeline, "smart-cut", smart_cut, NULL);
+  layer = ges_timeline_append_layer (timeline);
+  for (i = 0; i < num_cuts; i++) {
+    ges_layer_add_asset (layer, GES_ASSET (asset), i * GST_SECOND,
+        i * 2 * GST_SECOND + GST_SECOND / 3, GST_SECOND,
+        GES_TRACK_TYPE_UNKNOWN);
+  }
+
+  profile =
+      gst_encoding_profile_from_discoverer (ges_uri_clip_asset_get_info
+      (asset));
+  pipeline = ges_pipeline_new ();
+  ges_pipeline_set_timeline (pipeline, timeline);
+  ges_pipeline_set_render_settings (pipeline, uri, profile);
+  ges_pipeline_set_mode (pipeline, GES_PIPELINE_MODE_SMART_RENDER);
+  gst_encoding_profile_unref (profile);
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+  start = gst_util_get_timestamp ();
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PLAYING);
+  message = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  rendered = gst_util_get_timestamp () - start;
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+  gst_object_unref (bus);
+
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR) {
+    gst_message_parse_error (message, &err, NULL);
+    gst_printerr ("Could not render: %s\n", err->message);
+    g_error_free (err);
+  } else {
+    gst_print ("%" GST_TIME_FORMAT " - smart rendering %u cuts (%s)\n",
+        GST_TIME_ARGS (rendered), num_cuts,
+        smart_cut ? "GOP by GOP" : "whole sources");
+  }
+  gst_message_unref (message);
+
+  gst_object_unref (pipeline);
+  gst_object_unref (asset);
+  g_unlink (filename);
+  g_free (filename);
+  g_free (uri);
+
+  return 0;
+}
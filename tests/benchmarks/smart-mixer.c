@@ -0,0 +1,79 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <ges/ges.h>
+
+#define DEFAULT_NUM_PADS 32
+#define NUM_FRAMES 2000
+
+/* Measures the per frame overhead of the smart mixer with many sink pads.
+ * Frames are tiny so that the cost of synchronizing the pads with the
+ * positioner metas dominates over the actual blending.
+ *
+ * Usage: benchmark-smart-mixer [NUM_PADS] */
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint i, num_pads = DEFAULT_NUM_PADS;
+  GString *desc;
+  GstBus *bus;
+  GstMessage *message;
+  GstElement *pipeline;
+  GstClockTime start;
+  GError *err = NULL;
+
+  gst_init (&argc, &argv);
+  ges_init ();
+
+  if (argc > 1)
+    num_pads = g_ascii_strtoull (argv[1], NULL, 10);
+
+  desc = g_string_new ("gescompositor name=m ! fakesink sync=false");
+  for (i = 0; i < num_pads; i++)
+    g_string_append_printf (desc, " videotestsrc num-buffers=%u pattern=%u"
+        " ! video/x-raw,format=I420,width=16,height=16,framerate=60/1"
+        " ! framepositioner zorder=%u width=16 height=16 ! m.",
+        NUM_FRAMES, i % 20, i + 1);
+
+  pipeline = gst_parse_launch (desc->str, &err);
+  g_string_free (desc, TRUE);
+  if (!pipeline) {
+    gst_printerr ("Could not create pipeline: %s\n", err->message);
+    g_error_free (err);
+
+    return 1;
+  }
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+  start = gst_util_get_timestamp ();
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  message = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_EOS)
+    gst_print ("%u pads: %" GST_TIME_FORMAT " per frame\n", num_pads,
+        GST_TIME_ARGS ((gst_util_get_timestamp () - start) / NUM_FRAMES));
+  else
+    gst_printerr ("Error while mixing %u pads\n", num_pads);
+
+  gst_message_unref (message);
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+
+  return 0;
+}
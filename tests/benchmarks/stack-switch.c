@@ -0,0 +1,154 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gst/gst.h>
+
+#define NUM_SOURCES 50
+#define SOURCE_DURATION (GST_SECOND / 2)
+
+/* Measures how long the output of a NleComposition stalls when playback
+ * crosses a stack boundary, with and without the "lookahead" property.
+ *
+ * Usage: benchmark-stack-switch [URI]
+ *
+ * When an URI is given every source of the composition decodes it, otherwise
+ * audiotestsrc is used. */
+
+typedef struct
+{
+  GstClockTime last_buffer_time;
+  guint next_boundary;
+  guint n_switches;
+  GstClockTime total;
+  GstClockTime max;
+} SwitchStats;
+
+static GstPadProbeReturn
+buffer_probe_cb (GstPad * pad, GstPadProbeInfo * info, SwitchStats * stats)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  GstClockTime now = gst_util_get_timestamp ();
+
+  if (GST_BUFFER_PTS_IS_VALID (buffer) &&
+      GST_BUFFER_PTS (buffer) >= stats->next_boundary * SOURCE_DURATION) {
+    if (stats->next_boundary > 0 &&
+        GST_CLOCK_TIME_IS_VALID (stats->last_buffer_time)) {
+      GstClockTime delta = now - stats->last_buffer_time;
+
+      stats->total += delta;
+      stats->max = MAX (stats->max, delta);
+      stats->n_switches++;
+    }
+    stats->next_boundary = GST_BUFFER_PTS (buffer) / SOURCE_DURATION + 1;
+  }
+  stats->last_buffer_time = now;
+
+  return GST_PAD_PROBE_OK;
+}
+
+static GstElement *
+make_source (const gchar * uri, guint i)
+{
+  GstElement *source;
+
+  if (uri) {
+    GstCaps *caps = gst_caps_new_empty_simple ("audio/x-raw");
+
+    source = gst_element_factory_make ("nleurisource", NULL);
+    g_object_set (source, "uri", uri, "caps", caps, NULL);
+    gst_caps_unref (caps);
+  } else {
+    source = gst_element_factory_make ("nlesource", NULL);
+    gst_bin_add (GST_BIN (source),
+        gst_element_factory_make ("audiotestsrc", NULL));
+  }
+
+  g_object_set (source, "start", i * SOURCE_DURATION,
+      "duration", SOURCE_DURATION, "inpoint", (guint64) 0, "priority", 1,
+      NULL);
+
+  return source;
+}
+
+static void
+run (const gchar * uri, gboolean lookahead)
+{
+  guint i;
+  gboolean ret;
+  GstBus *bus;
+  GstPad *sinkpad;
+  GstMessage *message;
+  GstElement *pipeline, *composition, *sink;
+  SwitchStats stats = { GST_CLOCK_TIME_NONE, 0, 0, 0, 0 };
+  GstClockTime start;
+
+  pipeline = gst_pipeline_new (NULL);
+  composition = gst_element_factory_make ("nlecomposition", NULL);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", FALSE, NULL);
+  g_object_set (composition, "lookahead", lookahead, NULL);
+
+  gst_bin_add_many (GST_BIN (pipeline), composition, sink, NULL);
+  gst_element_link (composition, sink);
+
+  for (i = 0; i < NUM_SOURCES; i++)
+    gst_bin_add (GST_BIN (composition), make_source (uri, i));
+  g_signal_emit_by_name (composition, "commit", TRUE, &ret);
+
+  sinkpad = gst_element_get_static_pad (sink, "sink");
+  gst_pad_add_probe (sinkpad, GST_PAD_PROBE_TYPE_BUFFER,
+      (GstPadProbeCallback) buffer_probe_cb, &stats, NULL);
+  gst_object_unref (sinkpad);
+
+  start = gst_util_get_timestamp ();
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+
+  bus = gst_element_get_bus (pipeline);
+  message = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+    gst_printerr ("Got error %" GST_PTR_FORMAT "\n", message);
+  gst_message_unref (message);
+  gst_object_unref (bus);
+
+  gst_print ("%" GST_TIME_FORMAT " - playing %d sources with lookahead %s\n",
+      GST_TIME_ARGS (gst_util_get_timestamp () - start), NUM_SOURCES,
+      lookahead ? "enabled" : "disabled");
+  if (stats.n_switches)
+    gst_print ("    %d stack switches - max stall: %" GST_TIME_FORMAT
+        " - mean stall: %" GST_TIME_FORMAT "\n", stats.n_switches,
+        GST_TIME_ARGS (stats.max),
+        GST_TIME_ARGS (stats.total / stats.n_switches));
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  const gchar *uri;
+
+  gst_init (&argc, &argv);
+  uri = argc > 1 ? argv[1] : NULL;
+
+  run (uri, FALSE);
+  run (uri, TRUE);
+
+  return 0;
+}
@@ -0,0 +1,105 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include <ges/ges.h>
+
+#define NUM_FRAMES 300
+
+/* Measures the cost of compositing each frame of 1, 4 and 16 stacked
+ * layers of opaque full frame clips, with and without the occlusion
+ * culling of the smart mixer.
+ *
+ * Usage: benchmark-stacked-layers */
+
+static const guint num_layers[] = { 1, 4, 16 };
+
+static GstClockTime
+run (guint n_layers, gboolean occlusion_culling)
+{
+  guint i;
+  GstBus *bus;
+  GstMessage *message;
+  GstElement *sink;
+  GstClockTime start, ret = GST_CLOCK_TIME_NONE;
+  GESPipeline *pipeline = ges_pipeline_new ();
+  GESTimeline *timeline = ges_timeline_new ();
+  GESTrack *track = GES_TRACK (ges_video_track_new ());
+  GstCaps *caps =
+      gst_caps_from_string ("video/x-raw,format=I420,width=1920,height=1080,"
+      "framerate=30/1");
+
+  ges_track_set_restriction_caps (track, caps);
+  gst_caps_unref (caps);
+  g_object_set (timeline, "occlusion-culling", occlusion_culling, NULL);
+  ges_timeline_add_track (timeline, track);
+
+  for (i = 0; i < n_layers; i++) {
+    GESLayer *layer = ges_timeline_append_layer (timeline);
+    GESClip *clip = GES_CLIP (ges_test_clip_new ());
+
+    ges_test_clip_set_vpattern (GES_TEST_CLIP (clip), i % 20);
+    ges_timeline_element_set_duration (GES_TIMELINE_ELEMENT (clip),
+        gst_util_uint64_scale (NUM_FRAMES, GST_SECOND, 30));
+    ges_layer_add_clip (layer, clip);
+  }
+
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", FALSE, NULL);
+  ges_pipeline_preview_set_video_sink (pipeline, sink);
+  ges_pipeline_set_timeline (pipeline, timeline);
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+  start = gst_util_get_timestamp ();
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PLAYING);
+  message = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_EOS)
+    ret = (gst_util_get_timestamp () - start) / NUM_FRAMES;
+  else
+    gst_printerr ("Error while playing %u layers\n", n_layers);
+
+  gst_message_unref (message);
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+
+  return ret;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint i;
+
+  gst_init (&argc, &argv);
+  ges_init ();
+
+  for (i = 0; i < G_N_ELEMENTS (num_layers); i++) {
+    GstClockTime culled, blended;
+
+    culled = run (num_layers[i], TRUE);
+    blended = run (num_layers[i], FALSE);
+
+    gst_print ("%2u layers: %" GST_TIME_FORMAT " per frame with culling, %"
+        GST_TIME_FORMAT " without\n", num_layers[i], GST_TIME_ARGS (culled),
+        GST_TIME_ARGS (blended));
+  }
+
+  return 0;
+}
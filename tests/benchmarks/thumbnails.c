@@ -0,0 +1,107 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <ges/ges.h>
+
+#define DEFAULT_NUM_CLIPS 60
+#define DEFAULT_NUM_THUMBNAILS 300
+
+/* Measures how many thumbnails per second ges_pipeline_get_thumbnails()
+ * produces, with accurate and with keyframe seeks.
+ *
+ * Usage: benchmark-thumbnails [NUM_THUMBNAILS] [NUM_CLIPS] */
+
+static void
+run (GESPipeline * pipeline, GstCaps * caps, const GstClockTime * timestamps,
+    guint n_timestamps, GstSeekFlags flags, const gchar * name)
+{
+  GstClockTime start, elapsed;
+  GPtrArray *samples;
+  GError *err = NULL;
+
+  start = gst_util_get_timestamp ();
+  samples = ges_pipeline_get_thumbnails (pipeline, caps, timestamps,
+      n_timestamps, flags, &err);
+  elapsed = gst_util_get_timestamp () - start;
+
+  if (!samples) {
+    gst_printerr ("Could not get thumbnails: %s\n", err->message);
+    g_error_free (err);
+
+    return;
+  }
+
+  gst_print ("%" GST_TIME_FORMAT " - %u %s thumbnails (%.1f per second)\n",
+      GST_TIME_ARGS (elapsed), samples->len, name,
+      (gdouble) samples->len * GST_SECOND / MAX (elapsed, 1));
+  g_ptr_array_unref (samples);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint i;
+  GstCaps *caps;
+  GESLayer *layer;
+  GESPipeline *pipeline;
+  GESTimeline *timeline;
+  GstClockTime *timestamps;
+  guint num_thumbnails = DEFAULT_NUM_THUMBNAILS, num_clips = DEFAULT_NUM_CLIPS;
+
+  gst_init (&argc, &argv);
+  ges_init ();
+
+  if (argc > 1)
+    num_thumbnails = g_ascii_strtoull (argv[1], NULL, 10);
+  if (argc > 2)
+    num_clips = g_ascii_strtoull (argv[2], NULL, 10);
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  for (i = 0; i < num_clips; i++) {
+    GESClip *clip = GES_CLIP (ges_test_clip_new ());
+
+    ges_test_clip_set_vpattern (GES_TEST_CLIP (clip), i % 20);
+    ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip),
+        i * GST_SECOND);
+    ges_timeline_element_set_duration (GES_TIMELINE_ELEMENT (clip),
+        GST_SECOND);
+    ges_layer_add_clip (layer, clip);
+  }
+
+  pipeline = ges_pipeline_new ();
+  ges_pipeline_set_timeline (pipeline, timeline);
+
+  /* Shuffled on purpose, the pipeline sorts them */
+  timestamps = g_new (GstClockTime, num_thumbnails);
+  for (i = 0; i < num_thumbnails; i++)
+    timestamps[i] = gst_util_uint64_scale (num_clips * GST_SECOND,
+        (i * 7919) % num_thumbnails, num_thumbnails);
+
+  caps = gst_caps_from_string ("video/x-raw,format=RGB,width=160,height=90");
+  run (pipeline, caps, timestamps, num_thumbnails, GST_SEEK_FLAG_ACCURATE,
+      "accurate");
+  run (pipeline, caps, timestamps, num_thumbnails, GST_SEEK_FLAG_KEY_UNIT,
+      "keyframe");
+  gst_caps_unref (caps);
+
+  g_free (timestamps);
+  gst_object_unref (pipeline);
+
+  return 0;
+}
@@ -22,11 +22,14 @@
 
 
 #define NUM_OBJECTS 1000
+#define NUM_BULK_OBJECTS 100000
+#define NUM_TRANSITION_OBJECTS 10000
 
 gint
 main (gint argc, gchar * argv[])
 {
   guint i;
+  GList *clips = NULL;
   GESAsset *asset;
   GESTimeline *timeline;
   GESLayer *layer;
@@ -93,5 +96,87 @@ main (gint argc, gchar * argv[])
   gst_print ("%" GST_TIME_FORMAT " - freeing the timeline\n",
       GST_TIME_ARGS (end - start));
 
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  ges_layer_set_auto_transition (layer, TRUE);
+  for (i = 0; i < NUM_BULK_OBJECTS; i++) {
+    GESTimelineElement *clip =
+        GES_TIMELINE_ELEMENT (ges_asset_extract (asset, NULL));
+
+    ges_timeline_element_set_start (clip, i * 1000);
+    ges_timeline_element_set_duration (clip, 1000);
+    clips = g_list_prepend (clips, clip);
+  }
+
+  start = gst_util_get_timestamp ();
+  if (!ges_layer_add_clips (layer, clips, NULL))
+    gst_printerr ("Could not add the clips\n");
+  end = gst_util_get_timestamp ();
+  gst_print ("%" GST_TIME_FORMAT " - adding %d clips to the timeline at once"
+      "\n", GST_TIME_ARGS (end - start), NUM_BULK_OBJECTS);
+  g_list_free (clips);
+  clips = NULL;
+
+  start = gst_util_get_timestamp ();
+  gst_object_unref (timeline);
+  end = gst_util_get_timestamp ();
+  gst_print ("%" GST_TIME_FORMAT " - freeing the timeline\n",
+      GST_TIME_ARGS (end - start));
+
+  /* Each clip overlaps with the next one, so there is an auto-transition
+   * between every pair of neighbours in both tracks */
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  ges_layer_set_auto_transition (layer, TRUE);
+  for (i = 0; i < NUM_TRANSITION_OBJECTS; i++) {
+    GESTimelineElement *clip =
+        GES_TIMELINE_ELEMENT (ges_asset_extract (asset, NULL));
+
+    ges_timeline_element_set_start (clip, i * 1000);
+    ges_timeline_element_set_duration (clip, 1500);
+    clips = g_list_prepend (clips, clip);
+  }
+  container = GES_CONTAINER (g_list_last (clips)->data);
+
+  start = gst_util_get_timestamp ();
+  if (!ges_layer_add_clips (layer, clips, NULL))
+    gst_printerr ("Could not add the clips\n");
+  end = gst_util_get_timestamp ();
+  gst_print ("%" GST_TIME_FORMAT " - adding %d overlapping clips to the "
+      "timeline (with auto-transition on)\n", GST_TIME_ARGS (end - start),
+      NUM_TRANSITION_OBJECTS);
+  g_list_free (clips);
+
+  start = gst_util_get_timestamp ();
+  ges_timeline_commit (timeline);
+  end = gst_util_get_timestamp ();
+  gst_print ("%" GST_TIME_FORMAT " - committing %d overlapping clips\n",
+      GST_TIME_ARGS (end - start), NUM_TRANSITION_OBJECTS);
+
+  min_rippling_time = GST_CLOCK_TIME_NONE;
+  max_rippling_time = 0;
+  start_ripple = gst_util_get_timestamp ();
+  for (i = 1; i < 51; i++) {
+    start = gst_util_get_timestamp ();
+    ges_container_edit (container, NULL, 0, GES_EDIT_MODE_RIPPLE,
+        GES_EDGE_NONE, i * 10);
+    ges_timeline_commit (timeline);
+    end = gst_util_get_timestamp ();
+    max_rippling_time = MAX (max_rippling_time, end - start);
+    min_rippling_time = MIN (min_rippling_time, end - start);
+  }
+  end_ripple = gst_util_get_timestamp ();
+  gst_print ("%" GST_TIME_FORMAT " - rippling and committing %d overlapping "
+      "clips %d times, max: %" GST_TIME_FORMAT " min: %" GST_TIME_FORMAT
+      " (with auto-transition on)\n", GST_TIME_ARGS (end_ripple - start_ripple),
+      NUM_TRANSITION_OBJECTS, i - 1, GST_TIME_ARGS (max_rippling_time),
+      GST_TIME_ARGS (min_rippling_time));
+
+  start = gst_util_get_timestamp ();
+  gst_object_unref (timeline);
+  end = gst_util_get_timestamp ();
+  gst_print ("%" GST_TIME_FORMAT " - freeing the timeline\n",
+      GST_TIME_ARGS (end - start));
+
   return 0;
 }
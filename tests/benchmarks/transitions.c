@@ -0,0 +1,180 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <ges/ges.h>
+
+#define DEFAULT_NUM_CLIPS 20
+
+/* Measures the time it takes to play through a timeline made only of
+ * transitions, with the transition bins or with the native transition
+ * mixers.
+ *
+ * Usage: benchmark-transitions [NUM_CLIPS] [NATIVE] [TYPE]
+ *
+ * NATIVE is the value to use for #GESTimeline:native-transitions, 0 (the
+ * default) meaning that the transition bins are used. TYPE is the nick of
+ * the #GESVideoStandardTransitionType to use, "crossfade" by default. Types
+ * the native mixers do not implement keep using the transition bins.
+ *
+ * Clips are two seconds long and overlap by one second, the output is
+ * 1280x720 at 30 frames per second. */
+
+static guint
+count_elements (GstElement * element)
+{
+  guint n = 1;
+  GList *tmp;
+
+  if (!GST_IS_BIN (element))
+    return n;
+
+  GST_OBJECT_LOCK (element);
+  for (tmp = GST_BIN_CHILDREN (element); tmp; tmp = tmp->next)
+    n += count_elements (tmp->data);
+  GST_OBJECT_UNLOCK (element);
+
+  return n;
+}
+
+/* Calls @func on each of the transitions of @layer */
+static void
+foreach_transition (GESLayer * layer, GFunc func, gpointer data)
+{
+  GList *clips, *tmp;
+
+  clips = ges_layer_get_clips (layer);
+  for (tmp = clips; tmp; tmp = tmp->next) {
+    if (GES_IS_TRANSITION_CLIP (tmp->data))
+      func (tmp->data, data);
+  }
+  g_list_free_full (clips, gst_object_unref);
+}
+
+static void
+set_type (GESTransitionClip * transition, GEnumValue * type)
+{
+  g_object_set (transition, "vtype", type->value, NULL);
+}
+
+static void
+add_elements (GESTransitionClip * transition, guint * n)
+{
+  GList *children, *child;
+
+  children = ges_container_get_children (GES_CONTAINER (transition), FALSE);
+  for (child = children; child; child = child->next)
+    *n += count_elements (ges_track_element_get_nleobject (child->data));
+  g_list_free_full (children, gst_object_unref);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint i, n_elements = 0;
+  gboolean is_native = FALSE;
+  GstCaps *caps;
+  GESTrack *track;
+  GstElement *sink;
+  GstMessage *message;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+  GEnumClass *enum_class;
+  GEnumValue *type_value;
+  GstClockTime start, played;
+  const gchar *type_nick = "crossfade";
+  guint num_clips = DEFAULT_NUM_CLIPS;
+
+  if (argc > 1)
+    num_clips = MAX (g_ascii_strtoull (argv[1], NULL, 10), 2);
+  if (argc > 2)
+    is_native = g_strcmp0 (argv[2], "0") != 0;
+  if (argc > 3)
+    type_nick = argv[3];
+
+  gst_init (&argc, &argv);
+  ges_init ();
+
+  enum_class = g_type_class_ref (GES_VIDEO_STANDARD_TRANSITION_TYPE_TYPE);
+  type_value = g_enum_get_value_by_nick (enum_class, type_nick);
+  g_type_class_unref (enum_class);
+  if (!type_value) {
+    gst_printerr ("Unknown transition type %s\n", type_nick);
+
+    return 1;
+  }
+
+  timeline = ges_timeline_new ();
+  g_object_set (timeline, "native-transitions", is_native, NULL);
+  track = GES_TRACK (ges_video_track_new ());
+  caps = gst_caps_from_string ("video/x-raw, width=1280, height=720, "
+      "framerate=30/1");
+  ges_track_set_restriction_caps (track, caps);
+  gst_caps_unref (caps);
+  ges_timeline_add_track (timeline, track);
+  ges_timeline_add_track (timeline, GES_TRACK (ges_audio_track_new ()));
+
+  layer = ges_timeline_append_layer (timeline);
+  ges_layer_set_auto_transition (layer, TRUE);
+  for (i = 0; i < num_clips; i++) {
+    GESClip *clip = GES_CLIP (ges_test_clip_new ());
+
+    ges_test_clip_set_vpattern (GES_TEST_CLIP (clip), i % 20);
+    ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip),
+        i * GST_SECOND);
+    ges_timeline_element_set_duration (GES_TIMELINE_ELEMENT (clip),
+        2 * GST_SECOND);
+    ges_layer_add_clip (layer, clip);
+  }
+  ges_timeline_commit (timeline);
+  foreach_transition (layer, (GFunc) set_type, type_value);
+  ges_timeline_commit (timeline);
+
+  pipeline = ges_pipeline_new ();
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", FALSE, NULL);
+  ges_pipeline_preview_set_video_sink (pipeline, sink);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", FALSE, NULL);
+  ges_pipeline_preview_set_audio_sink (pipeline, sink);
+  ges_pipeline_set_timeline (pipeline, timeline);
+
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PAUSED);
+  gst_element_get_state (GST_ELEMENT (pipeline), NULL, NULL,
+      GST_CLOCK_TIME_NONE);
+
+  start = gst_util_get_timestamp ();
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PLAYING);
+  message = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline),
+      GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  played = gst_util_get_timestamp () - start;
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+    gst_printerr ("Error while playing\n");
+  gst_message_unref (message);
+
+  /* Each transition picked its implementation when it prerolled */
+  foreach_transition (layer, (GFunc) add_elements, &n_elements);
+
+  gst_print ("%" GST_TIME_FORMAT " - playing %u %s transitions (%s), "
+      "%u elements\n", GST_TIME_ARGS (played), num_clips - 1, type_nick,
+      is_native ? "native" : "bins", n_elements);
+
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  return 0;
+}
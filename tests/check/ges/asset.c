@@ -23,6 +23,7 @@
 /* #include "../../../ges/ges-internal.h" */
 #include <ges/ges.h>
 #include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
 
 static GMainLoop *mainloop;
 
@@ -734,6 +735,222 @@ GST_START_TEST (test_proxy_setters)
 
 GST_END_TEST;
 
+typedef struct
+{
+  GMainLoop *loop;
+  guint pending;
+  guint loaded;
+  guint failed;
+} ParallelDiscoveryData;
+
+static void
+parallel_asset_loaded_cb (GObject * source, GAsyncResult * res,
+    ParallelDiscoveryData * data)
+{
+  GError *error = NULL;
+  GESAsset *asset = ges_asset_request_finish (res, &error);
+
+  if (asset) {
+    fail_if (error);
+    fail_unless (GES_IS_URI_CLIP_ASSET (asset));
+    fail_unless (GST_CLOCK_TIME_IS_VALID (ges_uri_clip_asset_get_duration
+            (GES_URI_CLIP_ASSET (asset))));
+    data->loaded++;
+    gst_object_unref (asset);
+  } else {
+    fail_unless (error);
+    g_clear_error (&error);
+    data->failed++;
+  }
+
+  if (--data->pending == 0)
+    g_main_loop_quit (data->loop);
+}
+
+GST_START_TEST (test_parallel_discovery)
+{
+  guint i, j;
+  gchar *uris[4];
+  const guint n_threads[] = { 1, G_N_ELEMENTS (uris) };
+  GESUriClipAssetClass *klass;
+  ParallelDiscoveryData data = { 0, };
+
+  ges_init ();
+
+  klass = g_type_class_ref (GES_TYPE_URI_CLIP_ASSET);
+  uris[0] = ges_test_file_uri ("audio_video.ogg");
+  uris[1] = ges_test_file_uri ("audio_only.ogg");
+  uris[2] = ges_test_file_uri ("image.png");
+  uris[3] = g_strdup ("file:///this/is/not/for/real");
+
+  data.loop = g_main_loop_new (NULL, FALSE);
+
+  /* Discover the files one after the other, then all at once, a failing
+   * discovery should not prevent the others from completing */
+  for (j = 0; j < G_N_ELEMENTS (n_threads); j++) {
+    ges_uri_clip_asset_class_set_discovery_threads (klass, n_threads[j]);
+
+    data.loaded = data.failed = 0;
+    data.pending = G_N_ELEMENTS (uris);
+    for (i = 0; i < G_N_ELEMENTS (uris); i++) {
+      ges_asset_needs_reload (GES_TYPE_URI_CLIP, uris[i]);
+      ges_asset_request_async (GES_TYPE_URI_CLIP, uris[i], NULL,
+          (GAsyncReadyCallback) parallel_asset_loaded_cb, &data);
+    }
+    g_main_loop_run (data.loop);
+
+    assert_equals_int (data.loaded, 3);
+    assert_equals_int (data.failed, 1);
+  }
+
+  ges_uri_clip_asset_class_set_discovery_threads (klass, 0);
+  g_type_class_unref (klass);
+  for (i = 0; i < G_N_ELEMENTS (uris); i++)
+    g_free (uris[i]);
+  g_main_loop_unref (data.loop);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
+static void
+_set_file_mtime (GFile * file, guint64 mtime, guint32 mtime_usec)
+{
+  fail_unless (g_file_set_attribute_uint64 (file,
+          G_FILE_ATTRIBUTE_TIME_MODIFIED, mtime, G_FILE_QUERY_INFO_NONE, NULL,
+          NULL));
+  fail_unless (g_file_set_attribute_uint32 (file,
+          G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC, mtime_usec,
+          G_FILE_QUERY_INFO_NONE, NULL, NULL));
+}
+
+GST_START_TEST (test_discovery_cache)
+{
+  GFile *src, *file;
+  GFileInfo *file_info;
+  gchar *tmpdir, *cache_dir, *filename, *uri, *src_uri, *checksum, *entry;
+  gchar *garbage, *cached, *gst_version;
+  gsize size, cached_size;
+  guint32 version;
+  guint64 mtime, stamp_size, stamp_mtime;
+  guint32 mtime_usec;
+  GVariant *variant, *info;
+  GESUriClipAsset *asset;
+  GESUriClipAssetClass *klass;
+  GError *error = NULL;
+
+  ges_init ();
+
+  tmpdir = g_dir_make_tmp ("ges-discovery-cache-XXXXXX", NULL);
+  fail_unless (tmpdir);
+  cache_dir = g_build_filename (tmpdir, "cache", NULL);
+  filename = g_build_filename (tmpdir, "audio_video.ogg", NULL);
+  uri = gst_filename_to_uri (filename, NULL);
+
+  /* Work on a copy, its content gets replaced below */
+  src_uri = ges_test_file_uri ("audio_video.ogg");
+  src = g_file_new_for_uri (src_uri);
+  g_free (src_uri);
+  file = g_file_new_for_path (filename);
+  fail_unless (g_file_copy (src, file, G_FILE_COPY_NONE, NULL, NULL, NULL,
+          NULL));
+  g_object_unref (src);
+
+  klass = g_type_class_ref (GES_TYPE_URI_CLIP_ASSET);
+  ges_uri_clip_asset_class_set_discovery_cache_dir (klass, cache_dir);
+
+  /* The first discovery fills the cache */
+  asset = ges_uri_clip_asset_request_sync (uri, &error);
+  fail_unless (asset, "Could not load %s: %s", uri,
+      error ? error->message : "no error");
+  assert_equals_uint64 (ges_uri_clip_asset_get_duration (asset), GST_SECOND);
+
+  checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, uri, -1);
+  entry = g_build_filename (cache_dir, checksum, NULL);
+  g_free (checksum);
+  fail_unless (g_file_test (entry, G_FILE_TEST_IS_REGULAR));
+
+  /* Replace the content of the file, keeping its size and modification time
+   * so that the cache can not notice it: the asset still loads from the cache
+   * while discovering the file would fail */
+  file_info = g_file_query_info (file, G_FILE_ATTRIBUTE_TIME_MODIFIED ","
+      G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC, G_FILE_QUERY_INFO_NONE, NULL, NULL);
+  mtime = g_file_info_get_attribute_uint64 (file_info,
+      G_FILE_ATTRIBUTE_TIME_MODIFIED);
+  mtime_usec = g_file_info_get_attribute_uint32 (file_info,
+      G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC);
+  g_object_unref (file_info);
+
+  fail_unless (g_file_get_contents (filename, &garbage, &size, NULL));
+  memset (garbage, 0, size);
+  fail_unless (g_file_set_contents (filename, garbage, size, NULL));
+  g_free (garbage);
+  _set_file_mtime (file, mtime, mtime_usec);
+
+  fail_unless (ges_asset_needs_reload (GES_TYPE_URI_CLIP, uri));
+  gst_object_unref (asset);
+  asset = ges_uri_clip_asset_request_sync (uri, &error);
+  fail_unless (asset, "Could not load %s from the cache: %s", uri,
+      error ? error->message : "no error");
+  assert_equals_uint64 (ges_uri_clip_asset_get_duration (asset), GST_SECOND);
+  gst_object_unref (asset);
+
+  /* Entries written by another version of GStreamer are discarded */
+  fail_unless (g_file_get_contents (entry, &cached, &cached_size, NULL));
+  variant = g_variant_ref_sink (g_variant_new_from_data (G_VARIANT_TYPE
+          ("(usttv)"), cached, cached_size, FALSE, NULL, NULL));
+  g_variant_get (variant, "(usttv)", &version, &gst_version, &stamp_size,
+      &stamp_mtime, &info);
+  g_variant_unref (variant);
+  g_free (gst_version);
+  variant = g_variant_ref_sink (g_variant_new ("(usttv)", version, "0.0.0",
+          stamp_size, stamp_mtime, info));
+  fail_unless (g_file_set_contents (entry, g_variant_get_data (variant),
+          g_variant_get_size (variant), NULL));
+  g_variant_unref (variant);
+  g_variant_unref (info);
+
+  fail_unless (ges_asset_needs_reload (GES_TYPE_URI_CLIP, uri));
+  asset = ges_uri_clip_asset_request_sync (uri, &error);
+  fail_if (asset);
+  fail_unless (error);
+  g_clear_error (&error);
+  fail_if (g_file_test (entry, G_FILE_TEST_EXISTS));
+  fail_unless (g_file_set_contents (entry, cached, cached_size, NULL));
+  g_free (cached);
+
+  /* Once invalidated, the file is discovered again */
+  fail_unless (ges_uri_clip_asset_invalidate_discovery_cache (uri));
+  fail_if (g_file_test (entry, G_FILE_TEST_EXISTS));
+  fail_if (ges_uri_clip_asset_invalidate_discovery_cache (uri));
+
+  fail_unless (ges_asset_needs_reload (GES_TYPE_URI_CLIP, uri));
+  asset = ges_uri_clip_asset_request_sync (uri, &error);
+  fail_if (asset);
+  fail_unless (error);
+  g_clear_error (&error);
+  fail_if (g_file_test (entry, G_FILE_TEST_EXISTS));
+
+  fail_if (ges_uri_clip_asset_invalidate_discovery_cache (NULL));
+  ges_uri_clip_asset_class_set_discovery_cache_dir (klass, NULL);
+  g_type_class_unref (klass);
+
+  g_file_delete (file, NULL, NULL);
+  g_object_unref (file);
+  g_rmdir (cache_dir);
+  g_rmdir (tmpdir);
+  g_free (entry);
+  g_free (uri);
+  g_free (filename);
+  g_free (cache_dir);
+  g_free (tmpdir);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -748,6 +965,8 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_uri_clip_change_asset);
   tcase_add_test (tc_chain, test_list_asset);
   tcase_add_test (tc_chain, test_proxy_setters);
+  tcase_add_test (tc_chain, test_parallel_discovery);
+  tcase_add_test (tc_chain, test_discovery_cache);
 
   return s;
 }
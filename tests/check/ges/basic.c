@@ -1115,6 +1115,143 @@ GST_START_TEST (test_ges_pipeline_change_state)
 
 GST_END_TEST;
 
+static void
+count_commited_cb (GESTimeline * timeline, guint * count)
+{
+  *count += 1;
+}
+
+GST_START_TEST (test_ges_timeline_coalesce_commits)
+{
+  GESTimeline *timeline;
+  guint count = 0;
+
+  ges_init ();
+
+  timeline = ges_timeline_new ();
+  ges_timeline_append_layer (timeline);
+  g_signal_connect (timeline, "commited", G_CALLBACK (count_commited_cb),
+      &count);
+
+  /* Without any track, the commit is done right away and there is
+   * nothing to commit */
+  fail_if (ges_timeline_commit (timeline));
+  assert_equals_int (count, 1);
+
+  g_object_set (timeline, "coalesce-commits", TRUE, NULL);
+  fail_unless (ges_timeline_commit (timeline));
+  fail_unless (ges_timeline_commit (timeline));
+  assert_equals_int (count, 1);
+
+  /* Both commits are merged */
+  while (g_main_context_iteration (NULL, FALSE));
+  assert_equals_int (count, 2);
+
+  /* Disabling the coalescing commits the pending changes */
+  fail_unless (ges_timeline_commit (timeline));
+  assert_equals_int (count, 2);
+  g_object_set (timeline, "coalesce-commits", FALSE, NULL);
+  assert_equals_int (count, 3);
+  while (g_main_context_iteration (NULL, FALSE));
+  assert_equals_int (count, 3);
+
+  gst_object_unref (timeline);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
+static gboolean
+count_composition_commit_cb (GstElement * composition, gboolean recurse,
+    guint * count)
+{
+  *count += 1;
+
+  return FALSE;
+}
+
+static void
+connect_composition_commit (GESTrack * track, guint * count)
+{
+  GList *tmp;
+
+  for (tmp = GST_BIN_CHILDREN (track); tmp; tmp = tmp->next) {
+    GstElementFactory *factory = gst_element_get_factory (tmp->data);
+
+    if (factory && !g_strcmp0 (GST_OBJECT_NAME (factory), "nlecomposition"))
+      g_signal_connect (tmp->data, "commit",
+          G_CALLBACK (count_composition_commit_cb), count);
+  }
+}
+
+GST_START_TEST (test_ges_timeline_commit_dirty_tracks)
+{
+  GESAsset *asset;
+  GESTimeline *timeline;
+  GESClip *video_clip;
+  GESTrack *audio_track, *video_track;
+  GstCaps *caps;
+  guint audio_commits = 0, video_commits = 0;
+
+  ges_init ();
+
+  timeline = ges_timeline_new ();
+  audio_track = GES_TRACK (ges_audio_track_new ());
+  video_track = GES_TRACK (ges_video_track_new ());
+  fail_unless (ges_timeline_add_track (timeline, audio_track));
+  fail_unless (ges_timeline_add_track (timeline, video_track));
+  connect_composition_commit (audio_track, &audio_commits);
+  connect_composition_commit (video_track, &video_commits);
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  fail_unless (ges_layer_add_asset (ges_timeline_append_layer (timeline),
+          asset, 0, 0, 10 * GST_SECOND, GES_TRACK_TYPE_AUDIO));
+  video_clip = ges_layer_add_asset (ges_timeline_append_layer (timeline),
+      asset, 0, 0, GST_SECOND, GES_TRACK_TYPE_VIDEO);
+  fail_unless (video_clip);
+  gst_object_unref (asset);
+
+  /* The first commit updates everything */
+  fail_unless (ges_timeline_commit (timeline));
+  assert_equals_int (audio_commits, 1);
+  assert_equals_int (video_commits, 1);
+
+  /* Nothing changed */
+  fail_if (ges_timeline_commit (timeline));
+  assert_equals_int (audio_commits, 1);
+  assert_equals_int (video_commits, 1);
+
+  /* Moving a clip without changing the duration of the timeline only
+   * commits its own track */
+  fail_unless (ges_timeline_element_set_start (GES_TIMELINE_ELEMENT
+          (video_clip), 2 * GST_SECOND));
+  ges_timeline_commit (timeline);
+  assert_equals_int (audio_commits, 1);
+  assert_equals_int (video_commits, 2);
+
+  /* as does changing the restriction caps of a track */
+  caps = gst_caps_from_string ("audio/x-raw,rate=48000");
+  ges_track_set_restriction_caps (audio_track, caps);
+  gst_caps_unref (caps);
+  ges_timeline_commit (timeline);
+  assert_equals_int (audio_commits, 2);
+  assert_equals_int (video_commits, 2);
+
+  /* while a duration change moves the last gap of every track */
+  fail_unless (ges_timeline_element_set_start (GES_TIMELINE_ELEMENT
+          (video_clip), 20 * GST_SECOND));
+  ges_timeline_commit (timeline);
+  assert_equals_int (audio_commits, 3);
+  assert_equals_int (video_commits, 3);
+
+  gst_object_unref (timeline);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_ges_timeline_element_name)
 {
   GESClip *clip, *clip1, *clip2, *clip3, *clip4, *clip5;
@@ -1197,6 +1334,8 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_ges_timeline_multiple_tracks);
   tcase_add_test (tc_chain, test_ges_pipeline_change_state);
   tcase_add_test (tc_chain, test_ges_timeline_element_name);
+  tcase_add_test (tc_chain, test_ges_timeline_coalesce_commits);
+  tcase_add_test (tc_chain, test_ges_timeline_commit_dirty_tracks);
 
   return s;
 }
@@ -4993,6 +4993,85 @@ GST_START_TEST (test_children_property_bindings_with_rate_effects)
 
 GST_END_TEST;
 
+GST_START_TEST (test_control_values)
+{
+  GESTimeline *timeline;
+  GESTrack *track;
+  GESLayer *layer;
+  GESClip *clip;
+  GESTrackElement *video_source;
+  GstControlSource *ctrl_source;
+  GSList *vals = NULL;
+  GstClockTime timestamps[] = { 0, 2, 4, 5, 6, 10 };
+  gdouble values[] = { 0.0, 0.2, 0.4, 0.5, 0.6, 1.0 };
+
+  ges_init ();
+
+  timeline = ges_timeline_new ();
+  track = GES_TRACK (ges_video_track_new ());
+  fail_unless (ges_timeline_add_track (timeline, track));
+
+  layer = ges_timeline_append_layer (timeline);
+
+  clip = GES_CLIP (ges_test_clip_new ());
+  assert_set_duration (clip, 4);
+  assert_set_start (clip, 20);
+  assert_set_inpoint (clip, 3);
+
+  fail_unless (ges_layer_add_clip (layer, clip));
+
+  video_source = ges_clip_find_track_element (clip, track, GES_TYPE_SOURCE);
+  fail_unless (video_source);
+  gst_object_unref (video_source);
+
+  fail_if (ges_track_element_set_control_values (video_source, "alpha",
+          timestamps, values, G_N_ELEMENTS (timestamps)));
+  fail_unless_equals_int (ges_track_element_unset_control_values
+      (video_source, "alpha", 0, GST_CLOCK_TIME_NONE), 0);
+
+  ctrl_source = GST_CONTROL_SOURCE (gst_interpolation_control_source_new ());
+  g_object_set (G_OBJECT (ctrl_source), "mode",
+      GST_INTERPOLATION_MODE_LINEAR, NULL);
+  fail_unless (ges_track_element_set_control_source (video_source, ctrl_source,
+          "alpha", "direct"));
+  gst_object_unref (ctrl_source);
+
+  /* clamped between the in-point:3 and the out-point:7 once all the values
+   * are set */
+  fail_unless (ges_track_element_set_control_values (video_source, "alpha",
+          timestamps, values, G_N_ELEMENTS (timestamps)));
+  _THREE_TIMED_VALS (vals, 5, 0.5, 6, 0.6, 7, 0.7);
+  vals = g_slist_prepend (vals, _new_timed_value (4, 0.4));
+  vals = g_slist_prepend (vals, _new_timed_value (3, 0.3));
+  _assert_control_source (video_source, "alpha", vals);
+
+  fail_unless_equals_int (ges_track_element_unset_control_values
+      (video_source, "alpha", 4, 6), 2);
+  _THREE_TIMED_VALS (vals, 3, 0.3, 6, 0.6, 7, 0.7);
+  _assert_control_source (video_source, "alpha", vals);
+
+  fail_unless_equals_int (ges_track_element_unset_control_values
+      (video_source, "alpha", 8, GST_CLOCK_TIME_NONE), 0);
+  fail_unless_equals_int (ges_track_element_unset_control_values
+      (video_source, "alpha", 6, GST_CLOCK_TIME_NONE), 2);
+  g_slist_free_full (vals, g_free);
+  vals = g_slist_prepend (NULL, _new_timed_value (3, 0.3));
+  _assert_control_source (video_source, "alpha", vals);
+
+  /* a single keyframe ends up at the out-point:9 when trimming */
+  assert_set_inpoint (video_source, 5);
+  g_slist_free_full (vals, g_free);
+  vals = g_slist_prepend (NULL, _new_timed_value (9, 0.3));
+  _assert_control_source (video_source, "alpha", vals);
+
+  g_slist_free_full (vals, g_free);
+  gst_object_unref (timeline);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_unchanged_after_layer_add_failure)
 {
   GList *found;
@@ -5542,6 +5621,7 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_children_properties_change);
   tcase_add_test (tc_chain, test_copy_paste_children_properties);
   tcase_add_test (tc_chain, test_children_property_bindings_with_rate_effects);
+  tcase_add_test (tc_chain, test_control_values);
   tcase_add_test (tc_chain, test_unchanged_after_layer_add_failure);
   tcase_add_test (tc_chain, test_convert_time);
 
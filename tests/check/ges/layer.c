@@ -1708,6 +1708,66 @@ GST_START_TEST (test_layer_get_clips_in_interval)
 
 GST_END_TEST;
 
+GST_START_TEST (test_layer_add_clips)
+{
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GESClip *clip, *clip2, *clip3;
+  GList *clips, *objects;
+  GError *error = NULL;
+
+  ges_init ();
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  ges_layer_set_auto_transition (layer, TRUE);
+
+  clip = (GESClip *) ges_test_clip_new ();
+  g_object_set (clip, "start", 0, "duration", 30, NULL);
+  clip2 = (GESClip *) ges_test_clip_new ();
+  g_object_set (clip2, "start", 20, "duration", 30, NULL);
+  clips = g_list_append (NULL, clip2);
+  clips = g_list_append (clips, clip);
+
+  fail_unless (ges_layer_add_clips (layer, clips, &error));
+  fail_if (error);
+  g_list_free (clips);
+
+  /* Sorted by start, with the transition created once both were added */
+  objects = ges_layer_get_clips (layer);
+  assert_equals_int (g_list_length (objects), 3);
+  fail_unless (objects->data == clip);
+  fail_unless (GES_IS_TRANSITION_CLIP (objects->next->data));
+  fail_unless (objects->next->next->data == clip2);
+  g_list_free_full (objects, gst_object_unref);
+
+  /* Triple overlap with the existing clips, nothing should be added */
+  clip2 = (GESClip *) ges_test_clip_new ();
+  g_object_set (clip2, "start", 100, "duration", 10, NULL);
+  clip3 = (GESClip *) ges_test_clip_new ();
+  g_object_set (clip3, "start", 10, "duration", 30, NULL);
+  gst_object_ref (clip3);
+  clips = g_list_append (NULL, clip2);
+  clips = g_list_append (clips, clip3);
+
+  fail_if (ges_layer_add_clips (layer, clips, &error));
+  fail_unless (error);
+  g_clear_error (&error);
+  g_list_free (clips);
+
+  fail_if (ges_clip_get_layer (clip3));
+  objects = ges_layer_get_clips (layer);
+  assert_equals_int (g_list_length (objects), 3);
+  g_list_free_full (objects, gst_object_unref);
+  gst_object_unref (clip3);
+
+  gst_object_unref (timeline);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -1737,6 +1797,7 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_layer_meta_register);
   tcase_add_test (tc_chain, test_layer_meta_foreach);
   tcase_add_test (tc_chain, test_layer_get_clips_in_interval);
+  tcase_add_test (tc_chain, test_layer_add_clips);
 
   return s;
 }
@@ -227,6 +227,160 @@ done:
 
 GST_END_TEST;
 
+/* Returns the compositor pad with the lowest zorder of @pipeline */
+static GstPad *
+_get_bottom_compositor_pad (GESPipeline * pipeline)
+{
+  GList *tmp;
+  guint zorder, lowest = G_MAXUINT;
+  GstPad *ret = NULL;
+  GstElement *compositor = NULL;
+  GValue item = G_VALUE_INIT;
+  GstIterator *it = gst_bin_iterate_recurse (GST_BIN (pipeline));
+
+  while (!compositor && gst_iterator_next (it, &item) == GST_ITERATOR_OK) {
+    GstElement *element = g_value_get_object (&item);
+    GstElementFactory *factory = gst_element_get_factory (element);
+
+    if (factory && !g_strcmp0 (GST_OBJECT_NAME (factory), "compositor"))
+      compositor = gst_object_ref (element);
+    g_value_reset (&item);
+  }
+  g_value_unset (&item);
+  gst_iterator_free (it);
+  fail_unless (compositor);
+
+  GST_OBJECT_LOCK (compositor);
+  for (tmp = compositor->sinkpads; tmp; tmp = tmp->next) {
+    g_object_get (tmp->data, "zorder", &zorder, NULL);
+    if (zorder < lowest) {
+      lowest = zorder;
+      gst_object_replace ((GstObject **) & ret, tmp->data);
+    }
+  }
+  GST_OBJECT_UNLOCK (compositor);
+  gst_object_unref (compositor);
+
+  return ret;
+}
+
+#define STACKED_WIDTH 64
+
+/* Prerolls a full frame white clip, at @top_alpha and @top_width, above a
+ * red one. Returns the alpha that the compositor pad of the red clip got,
+ * and the first and last pixels of the first line of the output */
+static gdouble
+_preroll_stacked_clips (gboolean occlusion_culling, gdouble top_alpha,
+    gint top_width, guint8 first[3], guint8 last[3])
+{
+  gdouble alpha;
+  GESAsset *asset;
+  GESLayer *layer;
+  GESClip *top, *bottom;
+  GESTrack *track;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+  GstElement *sink;
+  GstSample *sample;
+  GstPad *pad;
+  GstCaps *caps;
+  GstMapInfo map;
+
+  track = GES_TRACK (ges_video_track_new ());
+  caps = gst_caps_new_simple ("video/x-raw", "format", G_TYPE_STRING, "RGB",
+      "width", G_TYPE_INT, STACKED_WIDTH, "height", G_TYPE_INT, 48, NULL);
+  ges_track_set_restriction_caps (track, caps);
+  gst_caps_unref (caps);
+
+  timeline = ges_timeline_new ();
+  g_object_set (timeline, "occlusion-culling", occlusion_culling, NULL);
+  fail_unless (ges_timeline_add_track (timeline, track));
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  layer = ges_timeline_append_layer (timeline);
+  top = ges_layer_add_asset (layer, asset, 0, 0, GST_SECOND,
+      GES_TRACK_TYPE_VIDEO);
+  layer = ges_timeline_append_layer (timeline);
+  bottom = ges_layer_add_asset (layer, asset, 0, 0, GST_SECOND,
+      GES_TRACK_TYPE_VIDEO);
+  gst_object_unref (asset);
+
+  ges_test_clip_set_vpattern (GES_TEST_CLIP (top),
+      GES_VIDEO_TEST_PATTERN_WHITE);
+  ges_test_clip_set_vpattern (GES_TEST_CLIP (bottom),
+      GES_VIDEO_TEST_PATTERN_RED);
+  fail_unless (ges_timeline_element_set_child_properties
+      (GES_TIMELINE_ELEMENT (top), "alpha", top_alpha, "width", top_width,
+          NULL));
+  fail_unless (ges_timeline_commit (timeline));
+
+  pipeline = ges_test_create_pipeline (timeline);
+  g_object_get (pipeline, "video-sink", &sink, NULL);
+  g_object_set (sink, "enable-last-sample", TRUE, NULL);
+  fail_if (gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PAUSED)
+      == GST_STATE_CHANGE_FAILURE);
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), NULL, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+
+  pad = _get_bottom_compositor_pad (pipeline);
+  fail_unless (pad);
+  g_object_get (pad, "alpha", &alpha, NULL);
+  gst_object_unref (pad);
+
+  g_object_get (sink, "last-sample", &sample, NULL);
+  fail_unless (sample);
+  fail_unless (gst_buffer_map (gst_sample_get_buffer (sample), &map,
+          GST_MAP_READ));
+  memcpy (first, map.data, 3);
+  memcpy (last, map.data + (STACKED_WIDTH - 1) * 3, 3);
+  gst_buffer_unmap (gst_sample_get_buffer (sample), &map);
+  gst_sample_unref (sample);
+  gst_object_unref (sink);
+
+  fail_if (gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL)
+      == GST_STATE_CHANGE_FAILURE);
+  gst_object_unref (pipeline);
+
+  return alpha;
+}
+
+GST_START_TEST (test_video_mixer_occlusion_culling)
+{
+  guint8 first[3], last[3];
+
+  ges_init ();
+
+  /* Disabled by default */
+  assert_equals_float (_preroll_stacked_clips (FALSE, 1.0, STACKED_WIDTH,
+          first, last), 1.0);
+  assert_equals_int (first[0], 255);
+  assert_equals_int (first[1], 255);
+
+  /* An opaque full frame above hides the red clip, which is skipped */
+  assert_equals_float (_preroll_stacked_clips (TRUE, 1.0, STACKED_WIDTH,
+          first, last), 0.0);
+  assert_equals_int (first[0], 255);
+  assert_equals_int (first[1], 255);
+  assert_equals_int (last[1], 255);
+
+  /* A translucent frame does not */
+  assert_equals_float (_preroll_stacked_clips (TRUE, 0.5, STACKED_WIDTH,
+          first, last), 1.0);
+  assert_equals_int (first[0], 255);
+  fail_unless (first[1] > 64 && first[1] < 192, "Not blended: %u",
+      first[1]);
+
+  /* Neither does a frame only covering part of the output */
+  assert_equals_float (_preroll_stacked_clips (TRUE, 1.0, STACKED_WIDTH / 2,
+          first, last), 1.0);
+  assert_equals_int (first[1], 255);
+  assert_equals_int (last[0], 255);
+  assert_equals_int (last[1], 0);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -238,6 +392,7 @@ ges_suite (void)
   tcase_add_test (tc_chain, simple_smart_adder_test);
   tcase_add_test (tc_chain, simple_audio_mixed_with_pipeline);
   tcase_add_test (tc_chain, audio_video_mixed_with_pipeline);
+  tcase_add_test (tc_chain, test_video_mixer_occlusion_culling);
 
   return s;
 }
@@ -0,0 +1,778 @@
+/* GStreamer Editing Services
+ *
+ * Copyright (C) 2021 GStreamer Editing Services contributors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "test-utils.h"
+#include <ges/ges.h>
+#include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
+
+#define THUMBNAIL_CAPS "video/x-raw,format=RGB,width=32,height=24"
+
+static GESTimeline *
+_create_test_timeline (GESTestClip ** clip)
+{
+  GESLayer *layer;
+  GESTimeline *timeline = ges_timeline_new ();
+
+  fail_unless (ges_timeline_add_track (timeline,
+          GES_TRACK (ges_video_track_new ())));
+  layer = ges_timeline_append_layer (timeline);
+  *clip = GES_TEST_CLIP (ges_layer_add_asset (layer,
+          ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL), 0, 0,
+          GST_SECOND, GES_TRACK_TYPE_VIDEO));
+  fail_unless (*clip);
+  ges_test_clip_set_vpattern (*clip, GES_VIDEO_TEST_PATTERN_BLACK);
+  fail_unless (ges_timeline_commit (timeline));
+
+  return timeline;
+}
+
+static guint8
+_first_red_value (GstSample * sample)
+{
+  guint8 value;
+  GstMapInfo map;
+  GstBuffer *buffer = gst_sample_get_buffer (sample);
+
+  fail_unless (gst_buffer_map (buffer, &map, GST_MAP_READ));
+  value = map.data[0];
+  gst_buffer_unmap (buffer, &map);
+
+  return value;
+}
+
+GST_START_TEST (test_pipeline_thumbnails)
+{
+  GstCaps *caps;
+  GESTestClip *clip;
+  GESPipeline *pipeline;
+  GPtrArray *samples;
+  GESTimeline *timeline;
+  GstStructure *structure;
+  gint width;
+  GstClockTime timestamps[] = { GST_SECOND / 2, 0, GST_SECOND / 2 };
+
+  ges_init ();
+
+  timeline = _create_test_timeline (&clip);
+  pipeline = ges_pipeline_new ();
+  fail_unless (ges_pipeline_set_timeline (pipeline, timeline));
+
+  caps = gst_caps_from_string (THUMBNAIL_CAPS);
+  samples = ges_pipeline_get_thumbnails (pipeline, caps, timestamps,
+      G_N_ELEMENTS (timestamps), GST_SEEK_FLAG_ACCURATE, NULL);
+  fail_unless (samples);
+  assert_equals_int (samples->len, G_N_ELEMENTS (timestamps));
+  structure = gst_caps_get_structure (gst_sample_get_caps (g_ptr_array_index
+          (samples, 0)), 0);
+  fail_unless (gst_structure_get_int (structure, "width", &width));
+  assert_equals_int (width, 32);
+  /* The same position gives the same frame */
+  fail_unless (gst_sample_get_buffer (g_ptr_array_index (samples, 0)) ==
+      gst_sample_get_buffer (g_ptr_array_index (samples, 2)));
+  assert_equals_int (_first_red_value (g_ptr_array_index (samples, 1)), 0);
+  g_ptr_array_unref (samples);
+
+  /* The prerolled thumbnailer is reused as long as the timeline is not
+   * committed */
+  ges_test_clip_set_vpattern (clip, GES_VIDEO_TEST_PATTERN_WHITE);
+  samples = ges_pipeline_get_thumbnails (pipeline, caps, timestamps, 1,
+      GST_SEEK_FLAG_ACCURATE, NULL);
+  fail_unless (samples);
+  assert_equals_int (_first_red_value (g_ptr_array_index (samples, 0)), 0);
+  g_ptr_array_unref (samples);
+
+  /* and rebuilt after a commit */
+  fail_unless (ges_timeline_commit (timeline));
+  samples = ges_pipeline_get_thumbnails (pipeline, caps, timestamps, 1,
+      GST_SEEK_FLAG_ACCURATE, NULL);
+  fail_unless (samples);
+  assert_equals_int (_first_red_value (g_ptr_array_index (samples, 0)), 255);
+  g_ptr_array_unref (samples);
+
+  /* One thumbnail every 250ms until the end of the timeline */
+  samples = ges_pipeline_get_thumbnails_for_range (pipeline, caps, 0,
+      GST_CLOCK_TIME_NONE, GST_SECOND / 4, GST_SEEK_FLAG_ACCURATE, NULL);
+  fail_unless (samples);
+  assert_equals_int (samples->len, 4);
+  g_ptr_array_unref (samples);
+
+  gst_caps_unref (caps);
+  gst_object_unref (pipeline);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_pipeline_thumbnails_without_timeline)
+{
+  GstCaps *caps;
+  GError *error = NULL;
+  GESPipeline *pipeline;
+
+  ges_init ();
+
+  pipeline = ges_pipeline_new ();
+  caps = gst_caps_from_string (THUMBNAIL_CAPS);
+  /* Must not try to get a thumbnail every second until G_MAXUINT64 */
+  fail_unless (ges_pipeline_get_thumbnails_for_range (pipeline, caps, 0,
+          GST_CLOCK_TIME_NONE, GST_SECOND, 0, &error) == NULL);
+  fail_unless (error);
+
+  g_clear_error (&error);
+  gst_caps_unref (caps);
+  gst_object_unref (pipeline);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
+static GstEncodingProfile *
+_create_render_profile (void)
+{
+  GstCaps *caps;
+  GstEncodingContainerProfile *container;
+
+  caps = gst_caps_from_string ("application/ogg");
+  container = gst_encoding_container_profile_new ("ogg", NULL, caps, NULL);
+  gst_caps_unref (caps);
+
+  caps = gst_caps_from_string ("video/x-theora");
+  gst_encoding_container_profile_add_profile (container,
+      (GstEncodingProfile *) gst_encoding_video_profile_new (caps, NULL, NULL,
+          0));
+  gst_caps_unref (caps);
+
+  return (GstEncodingProfile *) container;
+}
+
+/* Returns the entries of the render cache in @directory, with their inode
+ * to tell whether they got written again */
+static GHashTable *
+_list_render_cache (const gchar * directory)
+{
+  GDir *dir;
+  const gchar *name;
+  GHashTable *entries = g_hash_table_new_full (g_str_hash, g_str_equal,
+      g_free, NULL);
+
+  dir = g_dir_open (directory, 0, NULL);
+  fail_unless (dir);
+  while ((name = g_dir_read_name (dir))) {
+    GStatBuf stat_buf;
+    gchar *path = g_build_filename (directory, name, NULL);
+
+    fail_if (g_str_has_suffix (name, ".part"));
+    fail_if (g_stat (path, &stat_buf));
+    g_hash_table_insert (entries, g_strdup (name),
+        GSIZE_TO_POINTER (stat_buf.st_ino));
+    g_free (path);
+  }
+  g_dir_close (dir);
+
+  return entries;
+}
+
+/* Checks that all the entries of @before are still in @after, untouched */
+static void
+_check_render_cache_hits (GHashTable * before, GHashTable * after)
+{
+  GHashTableIter iter;
+  gpointer name, inode;
+
+  g_hash_table_iter_init (&iter, before);
+  while (g_hash_table_iter_next (&iter, &name, &inode)) {
+    fail_unless (g_hash_table_contains (after, name), "%s was removed",
+        (gchar *) name);
+    fail_unless (g_hash_table_lookup (after, name) == inode,
+        "%s was rendered again", (gchar *) name);
+  }
+}
+
+static void
+_clear_directory (const gchar * directory)
+{
+  GDir *dir;
+  const gchar *name;
+
+  dir = g_dir_open (directory, 0, NULL);
+  fail_unless (dir);
+  while ((name = g_dir_read_name (dir))) {
+    gchar *path = g_build_filename (directory, name, NULL);
+
+    g_unlink (path);
+    g_free (path);
+  }
+  g_dir_close (dir);
+  g_rmdir (directory);
+}
+
+GST_START_TEST (test_pipeline_render_cache)
+{
+  GESLayer *layer, *top;
+  GESClip *first, *second, *crossing;
+  GError *error = NULL;
+  GESPipeline *pipeline;
+  GESTimeline *timeline;
+  GstEncodingProfile *profile;
+  GHashTable *entries, *new_entries;
+  GstDiscovererInfo *info;
+  GstDiscoverer *discoverer;
+  gchar *tmpdir, *cache_dir, *output, *output_uri;
+  GESAsset *asset;
+
+  ges_init ();
+
+  tmpdir = g_dir_make_tmp ("ges-render-cache-XXXXXX", NULL);
+  fail_unless (tmpdir);
+  cache_dir = g_build_filename (tmpdir, "cache", NULL);
+  output = g_build_filename (tmpdir, "output.ogg", NULL);
+  output_uri = gst_filename_to_uri (output, NULL);
+
+  /* Two clips, each in its own cached region */
+  timeline = ges_timeline_new ();
+  fail_unless (ges_timeline_add_track (timeline,
+          GES_TRACK (ges_video_track_new ())));
+  layer = ges_timeline_append_layer (timeline);
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  first = ges_layer_add_asset (layer, asset, 0, 0, GST_SECOND / 2,
+      GES_TRACK_TYPE_VIDEO);
+  second = ges_layer_add_asset (layer, asset, GST_SECOND / 2, 0,
+      GST_SECOND / 2, GES_TRACK_TYPE_VIDEO);
+  fail_unless (first && second);
+  gst_object_unref (asset);
+  fail_unless (ges_timeline_commit (timeline));
+
+  pipeline = ges_pipeline_new ();
+  fail_unless (ges_pipeline_set_timeline (pipeline, timeline));
+  profile = _create_render_profile ();
+  fail_unless (ges_pipeline_set_render_settings (pipeline, output_uri,
+          profile));
+  gst_encoding_profile_unref (profile);
+  fail_unless (ges_pipeline_set_mode (pipeline, GES_PIPELINE_MODE_RENDER));
+  ges_pipeline_set_render_cache (pipeline, cache_dir, 0);
+
+  fail_unless (ges_pipeline_render_segmented (pipeline, 2, &error),
+      "Could not render: %s", error ? error->message : "no error");
+  entries = _list_render_cache (cache_dir);
+  assert_equals_int (g_hash_table_size (entries), 2);
+
+  /* Nothing changed, both regions are reused */
+  fail_unless (ges_pipeline_render_segmented (pipeline, 2, &error),
+      "Could not render: %s", error ? error->message : "no error");
+  new_entries = _list_render_cache (cache_dir);
+  assert_equals_int (g_hash_table_size (new_entries), 2);
+  _check_render_cache_hits (entries, new_entries);
+  g_hash_table_unref (new_entries);
+
+  /* Editing the second clip only renders its region again */
+  ges_test_clip_set_vpattern (GES_TEST_CLIP (second),
+      GES_VIDEO_TEST_PATTERN_BLACK);
+  ges_timeline_commit (timeline);
+  fail_unless (ges_pipeline_render_segmented (pipeline, 2, &error),
+      "Could not render: %s", error ? error->message : "no error");
+  new_entries = _list_render_cache (cache_dir);
+  assert_equals_int (g_hash_table_size (new_entries), 3);
+  _check_render_cache_hits (entries, new_entries);
+  g_hash_table_unref (entries);
+  entries = new_entries;
+
+  /* Deactivating the layer in the video track invalidates both regions */
+  fail_unless (ges_layer_set_active_for_tracks (layer, FALSE, NULL));
+  fail_unless (ges_timeline_commit (timeline));
+  fail_unless (ges_pipeline_render_segmented (pipeline, 2, &error),
+      "Could not render: %s", error ? error->message : "no error");
+  new_entries = _list_render_cache (cache_dir);
+  assert_equals_int (g_hash_table_size (new_entries), 5);
+  _check_render_cache_hits (entries, new_entries);
+  g_hash_table_unref (entries);
+  entries = new_entries;
+
+  /* A clip crossing both regions splits them at its start and end */
+  top = ges_timeline_append_layer (timeline);
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  crossing = ges_layer_add_asset (top, asset, GST_SECOND / 4, 0,
+      GST_SECOND / 2, GES_TRACK_TYPE_VIDEO);
+  fail_unless (crossing);
+  gst_object_unref (asset);
+  fail_unless (ges_timeline_commit (timeline));
+  fail_unless (ges_pipeline_render_segmented (pipeline, 2, &error),
+      "Could not render: %s", error ? error->message : "no error");
+  new_entries = _list_render_cache (cache_dir);
+  assert_equals_int (g_hash_table_size (new_entries), 9);
+  _check_render_cache_hits (entries, new_entries);
+  g_hash_table_unref (entries);
+  entries = new_entries;
+
+  /* and editing it only renders the two regions it overlaps again */
+  ges_test_clip_set_vpattern (GES_TEST_CLIP (crossing),
+      GES_VIDEO_TEST_PATTERN_BLACK);
+  ges_timeline_commit (timeline);
+  fail_unless (ges_pipeline_render_segmented (pipeline, 2, &error),
+      "Could not render: %s", error ? error->message : "no error");
+  new_entries = _list_render_cache (cache_dir);
+  assert_equals_int (g_hash_table_size (new_entries), 11);
+  _check_render_cache_hits (entries, new_entries);
+  g_hash_table_unref (new_entries);
+  g_hash_table_unref (entries);
+
+  /* The concatenated output covers the whole timeline */
+  discoverer = gst_discoverer_new (10 * GST_SECOND, NULL);
+  info = gst_discoverer_discover_uri (discoverer, output_uri, NULL);
+  fail_unless (info);
+  assert_equals_int (gst_discoverer_info_get_result (info),
+      GST_DISCOVERER_OK);
+  fail_unless (gst_discoverer_info_get_duration (info) > GST_SECOND / 2);
+  gst_discoverer_info_unref (info);
+  gst_object_unref (discoverer);
+
+  gst_object_unref (pipeline);
+
+  g_unlink (output);
+  _clear_directory (cache_dir);
+  g_rmdir (tmpdir);
+  g_free (output_uri);
+  g_free (output);
+  g_free (cache_dir);
+  g_free (tmpdir);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
+static guint
+_count_videorates (GstElement * element)
+{
+  GList *tmp;
+  guint n = 0;
+  GstElementFactory *factory = gst_element_get_factory (element);
+
+  if (factory && !g_strcmp0 (GST_OBJECT_NAME (factory), "videorate"))
+    n++;
+
+  if (!GST_IS_BIN (element))
+    return n;
+
+  GST_OBJECT_LOCK (element);
+  for (tmp = GST_BIN_CHILDREN (element); tmp; tmp = tmp->next)
+    n += _count_videorates (tmp->data);
+  GST_OBJECT_UNLOCK (element);
+
+  return n;
+}
+
+/* The converters of the sources are released asynchronously */
+static gboolean
+_wait_source_converters (GESClip * clip, guint expected)
+{
+  gint i;
+  GList *children = GES_CONTAINER_CHILDREN (clip);
+  GstElement *nleobject =
+      ges_track_element_get_nleobject (GES_TRACK_ELEMENT (children->data));
+
+  for (i = 0; i < 500; i++) {
+    if (_count_videorates (nleobject) == expected)
+      return TRUE;
+    g_usleep (10000);
+  }
+
+  return FALSE;
+}
+
+static void
+_seek_and_wait (GESPipeline * pipeline, GstClockTime position)
+{
+  fail_unless (gst_element_seek_simple (GST_ELEMENT (pipeline),
+          GST_FORMAT_TIME, GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE,
+          position));
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), NULL, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+}
+
+static void
+_check_warm_sources (guint warm_sources)
+{
+  GESLayer *layer;
+  GESPipeline *pipeline;
+  GESClip *first, *second;
+  GESTimeline *timeline = ges_timeline_new ();
+  gboolean lazy = warm_sources != G_MAXUINT;
+
+  g_object_set (timeline, "warm-sources", warm_sources, NULL);
+  fail_unless (ges_timeline_add_track (timeline,
+          GES_TRACK (ges_video_track_new ())));
+  layer = ges_timeline_append_layer (timeline);
+  first = ges_layer_add_asset (layer, ges_asset_request (GES_TYPE_TEST_CLIP,
+          NULL, NULL), 0, 0, GST_SECOND, GES_TRACK_TYPE_VIDEO);
+  second = ges_layer_add_asset (layer, ges_asset_request (GES_TYPE_TEST_CLIP,
+          NULL, NULL), GST_SECOND, 0, GST_SECOND, GES_TRACK_TYPE_VIDEO);
+  fail_unless (first && second);
+  fail_unless (ges_timeline_commit (timeline));
+
+  /* Sources are built right away by default, and only once played when
+   * the number of warm sources is limited */
+  pipeline = ges_test_create_pipeline (timeline);
+  fail_unless (_wait_source_converters (first, !lazy));
+  fail_unless (_wait_source_converters (second, !lazy));
+
+  fail_unless (gst_element_set_state (GST_ELEMENT (pipeline),
+          GST_STATE_PAUSED) != GST_STATE_CHANGE_FAILURE);
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), NULL, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+  fail_unless (_wait_source_converters (first, 1));
+  fail_unless (_wait_source_converters (second, !lazy));
+
+  /* The first source becomes unused */
+  _seek_and_wait (pipeline, GST_SECOND * 3 / 2);
+  fail_unless (_wait_source_converters (second, 1));
+  if (warm_sources) {
+    g_usleep (G_USEC_PER_SEC / 10);
+    fail_unless (_wait_source_converters (first, 1));
+  } else {
+    fail_unless (_wait_source_converters (first, 0));
+  }
+
+  /* and gets its converters back when used again */
+  _seek_and_wait (pipeline, 0);
+  fail_unless (_wait_source_converters (first, 1));
+
+  fail_unless (gst_element_set_state (GST_ELEMENT (pipeline),
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (pipeline);
+}
+
+GST_START_TEST (test_pipeline_warm_sources)
+{
+  guint warm_sources;
+  GESTimeline *timeline;
+
+  ges_init ();
+
+  timeline = ges_timeline_new ();
+  g_object_get (timeline, "warm-sources", &warm_sources, NULL);
+  assert_equals_uint64 (warm_sources, G_MAXUINT);
+  gst_object_unref (timeline);
+
+  _check_warm_sources (G_MAXUINT);
+  _check_warm_sources (0);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
+static gboolean
+_has_smart_cut_elements (void)
+{
+  guint i;
+  const gchar *elements[] = { "x264enc", "h264parse", "avdec_h264",
+    "mpegtsmux", "tsdemux"
+  };
+
+  for (i = 0; i < G_N_ELEMENTS (elements); i++) {
+    if (!gst_registry_check_feature_version (gst_registry_get (),
+            elements[i], 1, 0, 0))
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Three seconds of H.264 in MPEG-TS, with a keyframe every half second,
+ * B-frames and the parameter sets repeated on each keyframe if
+ * @repeat_parameter_sets, or only sent at the start of the stream */
+static void
+_generate_h264_file (const gchar * filename, gboolean repeat_parameter_sets)
+{
+  GstBus *bus;
+  GstMessage *message;
+  GstElement *pipeline;
+  GError *error = NULL;
+  gchar *description = g_strdup_printf ("videotestsrc num-buffers=90 ! "
+      "video/x-raw,width=64,height=48,framerate=30/1 ! "
+      "x264enc key-int-max=15 bframes=2 option-string=scenecut=0 ! %s ! "
+      "mpegtsmux ! filesink location=\"%s\"", repeat_parameter_sets ?
+      "video/x-h264,stream-format=byte-stream ! h264parse config-interval=-1" :
+      "video/x-h264,stream-format=avc ! h264parse ! "
+      "video/x-h264,stream-format=byte-stream", filename);
+
+  pipeline = gst_parse_launch (description, &error);
+  fail_unless (pipeline, "Could not create pipeline: %s",
+      error ? error->message : "no error");
+  g_free (description);
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+  fail_if (gst_element_set_state (pipeline, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE);
+  message = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (GST_MESSAGE_TYPE (message) == GST_MESSAGE_EOS);
+  gst_message_unref (message);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+}
+
+typedef struct
+{
+  GstElement *cutter;
+  gint gops;
+  GstClockTime last_dts;
+  gboolean dts_not_increasing;
+} SmartCutData;
+
+static GstPadProbeReturn
+_smart_cutter_input_cb (GstPad * pad, GstPadProbeInfo * info,
+    SmartCutData * data)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+
+  if (!GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT))
+    g_atomic_int_inc (&data->gops);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static GstPadProbeReturn
+_smart_cutter_output_cb (GstPad * pad, GstPadProbeInfo * info,
+    SmartCutData * data)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+
+  if (!GST_BUFFER_DTS_IS_VALID (buffer))
+    return GST_PAD_PROBE_OK;
+
+  if (GST_CLOCK_TIME_IS_VALID (data->last_dts)
+      && GST_BUFFER_DTS (buffer) <= data->last_dts)
+    data->dts_not_increasing = TRUE;
+  data->last_dts = GST_BUFFER_DTS (buffer);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+_deep_element_added_cb (GstBin * bin, GstBin * sub_bin, GstElement * element,
+    SmartCutData * data)
+{
+  GstPad *pad;
+
+  if (g_strcmp0 (G_OBJECT_TYPE_NAME (element), "GESSmartCutter"))
+    return;
+
+  /* A single source, reusing its smart cutter */
+  fail_if (data->cutter);
+  data->cutter = gst_object_ref (element);
+
+  pad = gst_element_get_static_pad (element, "sink");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+      (GstPadProbeCallback) _smart_cutter_input_cb, data, NULL);
+  gst_object_unref (pad);
+
+  pad = gst_element_get_static_pad (element, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+      (GstPadProbeCallback) _smart_cutter_output_cb, data, NULL);
+  gst_object_unref (pad);
+}
+
+static guint
+_count_decoded_frames (const gchar * uri)
+{
+  GstBus *bus;
+  GstSample *sample;
+  GstMessage *message;
+  guint n_frames = 0;
+  gboolean eos;
+  GstElement *pipeline, *sink;
+  gchar *description = g_strdup_printf ("uridecodebin uri=\"%s\" ! "
+      "appsink name=sink sync=false", uri);
+
+  pipeline = gst_parse_launch (description, NULL);
+  fail_unless (pipeline);
+  g_free (description);
+
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  fail_if (gst_element_set_state (pipeline, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE);
+  while (TRUE) {
+    g_signal_emit_by_name (sink, "try-pull-sample", 5 * GST_SECOND, &sample);
+    if (!sample)
+      break;
+
+    n_frames++;
+    gst_sample_unref (sample);
+  }
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+  message = gst_bus_pop_filtered (bus, GST_MESSAGE_ERROR);
+  fail_if (message, "Could not decode %s", uri);
+  g_object_get (sink, "eos", &eos, NULL);
+  fail_unless (eos);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (bus);
+  gst_object_unref (sink);
+  gst_object_unref (pipeline);
+
+  return n_frames;
+}
+
+static void
+_check_smart_cut (gboolean repeat_parameter_sets, gint expected_passed,
+    gint expected_reencoded)
+{
+  GstBus *bus;
+  GESLayer *layer;
+  guint n_frames;
+  GstMessage *message;
+  GESPipeline *pipeline;
+  GESTimeline *timeline;
+  GESUriClipAsset *asset;
+  GstEncodingProfile *profile;
+  GError *error = NULL;
+  gint passed, reencoded, dropped;
+  gchar *tmpdir, *input, *input_uri, *output, *output_uri;
+  SmartCutData data = { NULL, 0, GST_CLOCK_TIME_NONE, FALSE };
+
+  ges_init ();
+
+  tmpdir = g_dir_make_tmp ("ges-smart-cut-XXXXXX", NULL);
+  fail_unless (tmpdir);
+  input = g_build_filename (tmpdir, "input.ts", NULL);
+  input_uri = gst_filename_to_uri (input, NULL);
+  output = g_build_filename (tmpdir, "output.ts", NULL);
+  output_uri = gst_filename_to_uri (output, NULL);
+
+  _generate_h264_file (input, repeat_parameter_sets);
+  asset = ges_uri_clip_asset_request_sync (input_uri, &error);
+  fail_unless (asset, "Could not load %s: %s", input_uri,
+      error ? error->message : "no error");
+
+  /* From the middle of the second GOP to the middle of the fifth one */
+  timeline = ges_timeline_new ();
+  g_object_set (timeline, "smart-cut", TRUE, NULL);
+  fail_unless (ges_timeline_add_track (timeline,
+          GES_TRACK (ges_video_track_new ())));
+  layer = ges_timeline_append_layer (timeline);
+  fail_unless (ges_layer_add_asset (layer, GES_ASSET (asset), 0,
+          GST_SECOND * 6 / 10, GST_SECOND * 17 / 10, GES_TRACK_TYPE_VIDEO));
+  fail_unless (ges_timeline_commit (timeline));
+
+  pipeline = ges_pipeline_new ();
+  fail_unless (ges_pipeline_set_timeline (pipeline, timeline));
+  profile =
+      gst_encoding_profile_from_discoverer (ges_uri_clip_asset_get_info
+      (asset));
+  fail_unless (ges_pipeline_set_render_settings (pipeline, output_uri,
+          profile));
+  gst_encoding_profile_unref (profile);
+  fail_unless (ges_pipeline_set_mode (pipeline,
+          GES_PIPELINE_MODE_SMART_RENDER));
+  g_signal_connect (pipeline, "deep-element-added",
+      G_CALLBACK (_deep_element_added_cb), &data);
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+  fail_if (gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PLAYING)
+      == GST_STATE_CHANGE_FAILURE);
+  message = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (GST_MESSAGE_TYPE (message) == GST_MESSAGE_EOS,
+      "Could not render %s", output_uri);
+  gst_message_unref (message);
+
+  fail_unless (data.cutter);
+  g_object_get (data.cutter, "passed-gops", &passed, "reencoded-gops",
+      &reencoded, "dropped-gops", &dropped, NULL);
+  assert_equals_int (passed, expected_passed);
+  assert_equals_int (reencoded, expected_reencoded);
+  assert_equals_int (passed + reencoded + dropped, data.gops);
+  fail_if (data.dts_not_increasing);
+
+  fail_unless (gst_element_set_state (GST_ELEMENT (pipeline),
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (data.cutter);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+  gst_object_unref (asset);
+
+  /* The frames from the in-point to the out-point, give or take one for the
+   * rounding of the MPEG-TS timestamps */
+  n_frames = _count_decoded_frames (output_uri);
+  fail_unless (n_frames >= 50 && n_frames <= 52, "Decoded %u frames",
+      n_frames);
+
+  g_unlink (input);
+  g_unlink (output);
+  g_rmdir (tmpdir);
+  g_free (input_uri);
+  g_free (input);
+  g_free (output_uri);
+  g_free (output);
+  g_free (tmpdir);
+
+  ges_deinit ();
+}
+
+GST_START_TEST (test_pipeline_smart_cut)
+{
+  /* The GOPs crossing the in-point and the out-point are encoded again, the
+   * two in between passed through and the ones around dropped */
+  _check_smart_cut (TRUE, 2, 2);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_pipeline_smart_cut_without_repeated_parameter_sets)
+{
+  /* After the GOP crossing the in-point got encoded again, the following
+   * ones can't be decoded without the parameter sets of the stream */
+  _check_smart_cut (FALSE, 0, 4);
+}
+
+GST_END_TEST;
+
+static Suite *
+ges_suite (void)
+{
+  Suite *s = suite_create ("ges-pipeline");
+  TCase *tc_chain = tcase_create ("pipeline");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_pipeline_thumbnails);
+  tcase_add_test (tc_chain, test_pipeline_thumbnails_without_timeline);
+  tcase_add_test (tc_chain, test_pipeline_render_cache);
+  tcase_add_test (tc_chain, test_pipeline_warm_sources);
+
+  if (_has_smart_cut_elements ()) {
+    tcase_add_test (tc_chain, test_pipeline_smart_cut);
+    tcase_add_test (tc_chain,
+        test_pipeline_smart_cut_without_repeated_parameter_sets);
+  } else {
+    GST_WARNING ("H.264 or MPEG-TS elements not available, skipping 2 tests");
+  }
+
+  return s;
+}
+
+GST_CHECK_MAIN (ges);
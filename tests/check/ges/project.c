@@ -21,6 +21,7 @@
 #include "test-utils.h"
 #include <ges/ges.h>
 #include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
 #include <gst/controller/gstdirectcontrolbinding.h>
 #include <gst/controller/gstinterpolationcontrolsource.h>
 
@@ -295,6 +296,9 @@ _add_properties (GESTimeline * timeline)
   GList *tracks;
   GList *tmp;
 
+  /* Playback tuning, which should not be saved */
+  g_object_set (timeline, "decoder-pool-size", 3, "smart-cut", TRUE, NULL);
+
   tracks = ges_timeline_get_tracks (timeline);
   for (tmp = tracks; tmp; tmp = tmp->next) {
     GESTrack *track;
@@ -370,6 +374,13 @@ _check_properties (GESTimeline * timeline)
 {
   GList *tracks;
   GList *tmp;
+  guint pool_size;
+  gboolean smart_cut;
+
+  g_object_get (timeline, "decoder-pool-size", &pool_size, "smart-cut",
+      &smart_cut, NULL);
+  assert_equals_int (pool_size, 0);
+  fail_if (smart_cut);
 
   tracks = ges_timeline_get_tracks (timeline);
   for (tmp = tracks; tmp; tmp = tmp->next) {
@@ -497,6 +508,224 @@ GST_START_TEST (test_project_add_properties)
 
 GST_END_TEST;
 
+GST_START_TEST (test_project_binary_round_trip)
+{
+  GESProject *project;
+  GESTimeline *timeline;
+  GESAsset *formatter_asset;
+  gchar *uri;
+
+  ges_init ();
+
+  uri = ges_test_file_uri ("test-properties.xges");
+  project = ges_project_new (uri);
+  g_free (uri);
+  mainloop = g_main_loop_new (NULL, FALSE);
+
+  g_signal_connect (project, "loaded", (GCallback) project_loaded_cb, mainloop);
+  g_signal_connect (project, "missing-uri", (GCallback) _set_new_uri, NULL);
+
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  g_main_loop_run (mainloop);
+  _add_properties (timeline);
+
+  uri = ges_test_get_tmp_uri ("test-properties-save.gesb");
+  formatter_asset = ges_asset_request (GES_TYPE_FORMATTER, "gesb", NULL);
+  fail_unless (formatter_asset != NULL);
+  fail_unless (ges_project_save (project, timeline, uri, formatter_asset,
+          TRUE, NULL));
+  gst_object_unref (timeline);
+  gst_object_unref (project);
+
+  project = ges_project_new (uri);
+  g_free (uri);
+  g_signal_connect (project, "loaded", (GCallback) project_loaded_cb, mainloop);
+
+  GST_LOG ("Loading binary project");
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  fail_unless (GES_IS_TIMELINE (timeline));
+  g_main_loop_run (mainloop);
+
+  _check_properties (timeline);
+
+  gst_object_unref (timeline);
+  gst_object_unref (project);
+  g_main_loop_unref (mainloop);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_project_streaming_round_trip)
+{
+  GList *clips, *groups;
+  GESLayer *layer;
+  GESProject *project;
+  GESTimeline *timeline;
+  GESAsset *formatter_asset;
+  GESTimelineElement *clip;
+  gboolean streaming_load;
+  gchar *uri;
+
+  ges_init ();
+
+  uri = ges_test_file_uri ("test-properties.xges");
+  project = ges_project_new (uri);
+  g_free (uri);
+  mainloop = g_main_loop_new (NULL, FALSE);
+
+  g_signal_connect (project, "loaded", (GCallback) project_loaded_cb, mainloop);
+  g_signal_connect (project, "missing-uri", (GCallback) _set_new_uri, NULL);
+
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  g_main_loop_run (mainloop);
+
+  /* Group the clip with a new one, with keyframes on the effect */
+  layer = timeline->layers->data;
+  clips = ges_layer_get_clips (layer);
+  fail_unless (ges_layer_add_asset (layer,
+          ges_extractable_get_asset (clips->data), 2 * GST_SECOND, 0,
+          GST_SECOND, GES_TRACK_TYPE_UNKNOWN));
+  g_list_free_full (clips, gst_object_unref);
+  clips = ges_layer_get_clips (layer);
+  fail_unless (GES_IS_GROUP (ges_container_group (clips)));
+  g_list_free_full (clips, gst_object_unref);
+  _add_properties (timeline);
+
+  uri = ges_test_get_tmp_uri ("test-streaming-round-trip.xges");
+  formatter_asset = ges_asset_request (GES_TYPE_FORMATTER, "ges", NULL);
+  fail_unless (formatter_asset != NULL);
+  fail_unless (ges_project_save (project, timeline, uri, formatter_asset,
+          TRUE, NULL));
+  gst_object_unref (formatter_asset);
+  gst_object_unref (timeline);
+  gst_object_unref (project);
+
+  project = ges_project_new (uri);
+  g_free (uri);
+  g_object_get (project, "streaming-load", &streaming_load, NULL);
+  fail_if (streaming_load);
+  g_object_set (project, "streaming-load", TRUE, NULL);
+  g_signal_connect (project, "loaded", (GCallback) project_loaded_cb, mainloop);
+
+  GST_LOG ("Streaming the saved project");
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  fail_unless (GES_IS_TIMELINE (timeline));
+  g_main_loop_run (mainloop);
+
+  _check_properties (timeline);
+
+  layer = timeline->layers->data;
+  clips = ges_layer_get_clips (layer);
+  fail_unless_equals_int (g_list_length (clips), 2);
+  clip = g_list_last (clips)->data;
+  assert_equals_uint64 (_START (clip), 2 * GST_SECOND);
+  assert_equals_uint64 (_DURATION (clip), GST_SECOND);
+
+  groups = ges_timeline_get_groups (timeline);
+  fail_unless_equals_int (g_list_length (groups), 1);
+  fail_unless_equals_int (g_list_length (GES_CONTAINER_CHILDREN
+          (groups->data)), 2);
+  fail_unless (GES_TIMELINE_ELEMENT_PARENT (clips->data) == groups->data);
+  fail_unless (GES_TIMELINE_ELEMENT_PARENT (clip) == groups->data);
+  g_list_free_full (clips, gst_object_unref);
+
+  gst_object_unref (timeline);
+  gst_object_unref (project);
+  g_main_loop_unref (mainloop);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_project_incremental_save)
+{
+  GESProject *project;
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GList *clips, *effects;
+  GESTimelineElement *clip, *effect;
+  gchar *uri, *journal_uri, *journal_path;
+  guint scratch_lines;
+
+  ges_init ();
+
+  uri = ges_test_file_uri ("test-properties.xges");
+  project = ges_project_new (uri);
+  g_free (uri);
+  mainloop = g_main_loop_new (NULL, FALSE);
+
+  g_signal_connect (project, "loaded", (GCallback) project_loaded_cb, mainloop);
+  g_signal_connect (project, "missing-uri", (GCallback) _set_new_uri, NULL);
+
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  g_main_loop_run (mainloop);
+
+  uri = ges_test_get_tmp_uri ("test-incremental-save.xges");
+  journal_uri = g_strconcat (uri, ".journal", NULL);
+  journal_path = gst_uri_get_location (journal_uri);
+
+  /* The first save is a full one */
+  fail_unless (ges_project_save_incremental (project, timeline, uri, NULL,
+          NULL));
+  fail_if (g_file_test (journal_path, G_FILE_TEST_EXISTS));
+
+  layer = timeline->layers->data;
+  clips = ges_layer_get_clips (layer);
+  clip = clips->data;
+  effects = ges_clip_get_top_effects (GES_CLIP (clip));
+  effect = effects->data;
+
+  fail_unless (ges_timeline_element_set_start (clip, 2 * GST_SECOND));
+  ges_timeline_element_set_child_properties (effect, "scratch-lines", 20,
+      NULL);
+  fail_unless (ges_project_save_incremental (project, timeline, uri, NULL,
+          NULL));
+  fail_unless (g_file_test (journal_path, G_FILE_TEST_EXISTS));
+
+  g_list_free_full (effects, gst_object_unref);
+  g_list_free_full (clips, gst_object_unref);
+  gst_object_unref (timeline);
+  gst_object_unref (project);
+
+  /* The journal is replayed on top of the full save */
+  project = ges_project_new (uri);
+  g_signal_connect (project, "loaded", (GCallback) project_loaded_cb, mainloop);
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  g_main_loop_run (mainloop);
+
+  layer = timeline->layers->data;
+  clips = ges_layer_get_clips (layer);
+  fail_unless_equals_int (g_list_length (clips), 1);
+  clip = clips->data;
+  assert_equals_uint64 (_START (clip), 2 * GST_SECOND);
+
+  effects = ges_clip_get_top_effects (GES_CLIP (clip));
+  fail_unless_equals_int (g_list_length (effects), 1);
+  ges_timeline_element_get_child_properties (effects->data, "scratch-lines",
+      &scratch_lines, NULL);
+  fail_unless_equals_int (scratch_lines, 20);
+  g_list_free_full (effects, gst_object_unref);
+  g_list_free_full (clips, gst_object_unref);
+
+  /* A full save truncates the journal */
+  fail_unless (ges_project_save (project, timeline, uri, NULL, TRUE, NULL));
+  fail_if (g_file_test (journal_path, G_FILE_TEST_EXISTS));
+
+  gst_object_unref (timeline);
+  gst_object_unref (project);
+  g_main_loop_unref (mainloop);
+  g_free (journal_path);
+  g_free (journal_uri);
+  g_free (uri);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_project_load_xges)
 {
   gboolean saved;
@@ -668,6 +897,217 @@ GST_START_TEST (test_project_auto_transition)
 
 GST_END_TEST;
 
+/* Returns the URI decoded by all the uridecodebins of @pipeline */
+static gchar *
+_get_decoded_uri (GESPipeline * pipeline)
+{
+  gchar *uri, *ret = NULL;
+  GValue item = G_VALUE_INIT;
+  GstIterator *it = gst_bin_iterate_recurse (GST_BIN (pipeline));
+
+  while (gst_iterator_next (it, &item) == GST_ITERATOR_OK) {
+    GstElement *element = g_value_get_object (&item);
+    GstElementFactory *factory = gst_element_get_factory (element);
+
+    if (factory && !g_strcmp0 (GST_OBJECT_NAME (factory), "uridecodebin")) {
+      g_object_get (element, "uri", &uri, NULL);
+      if (ret) {
+        assert_equals_string (uri, ret);
+        g_free (uri);
+      } else {
+        ret = uri;
+      }
+    }
+    g_value_reset (&item);
+  }
+  g_value_unset (&item);
+  gst_iterator_free (it);
+
+  return ret;
+}
+
+static void
+_proxy_set_cb (GESAsset * asset, GParamSpec * pspec, GMainLoop * loop)
+{
+  g_main_loop_quit (loop);
+}
+
+static gboolean
+_can_load_contents (const gchar * contents)
+{
+  gboolean res;
+  gchar *uri, *filename;
+
+  uri = ges_test_get_tmp_uri ("test-can-load.xges");
+  filename = g_filename_from_uri (uri, NULL, NULL);
+  fail_unless (g_file_set_contents (filename, contents, -1, NULL));
+  res = ges_formatter_can_load_uri (uri, NULL);
+  g_unlink (filename);
+  g_free (filename);
+  g_free (uri);
+
+  return res;
+}
+
+GST_START_TEST (test_project_can_load_uri)
+{
+  gchar *contents;
+  GString *str;
+
+  ges_init ();
+
+  fail_if (_can_load_contents (""));
+  fail_if (_can_load_contents ("<?xml version='1.0'?><project/>"));
+  fail_if (_can_load_contents ("<ges version='42.0'>"));
+
+  /* Only the root element is checked */
+  fail_unless (_can_load_contents ("<ges version='0.1'><project><garbage"));
+
+  /* A root element after too much content is not looked for */
+  str = g_string_new ("<?xml version='1.0'?>");
+  while (str->len < 128 * 1024)
+    g_string_append (str, "<!-- Padding -->");
+  g_string_append (str, "<ges version='0.1'></ges>");
+  contents = g_string_free (str, FALSE);
+  fail_if (_can_load_contents (contents));
+  g_free (contents);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_project_proxy_generation)
+{
+  GList *streams;
+  GFile *src, *file;
+  GMainLoop *loop;
+  GESLayer *layer;
+  GESClip *clip, *clip2;
+  GESProject *project;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+  GESAsset *asset, *proxy, *requested;
+  GstEncodingProfile *profile;
+  gboolean generated = FALSE;
+  gchar *tmpdir, *filename, *uri, *src_uri, *proxy_uri, *decoded_uri;
+  gchar *output_uri;
+
+  ges_init ();
+
+  /* The proxies are written next to the media files */
+  tmpdir = g_dir_make_tmp ("ges-proxy-generation-XXXXXX", NULL);
+  fail_unless (tmpdir);
+  filename = g_build_filename (tmpdir, "audio_video.ogg", NULL);
+  uri = gst_filename_to_uri (filename, NULL);
+  src_uri = ges_test_file_uri ("audio_video.ogg");
+  src = g_file_new_for_uri (src_uri);
+  file = g_file_new_for_path (filename);
+  fail_unless (g_file_copy (src, file, G_FILE_COPY_NONE, NULL, NULL, NULL,
+          NULL));
+  g_object_unref (src);
+  g_object_unref (file);
+  g_free (src_uri);
+
+  project = ges_project_new (NULL);
+  timeline = ges_timeline_new_audio_video ();
+  asset = ges_asset_request (GES_TYPE_URI_CLIP, uri, NULL);
+  fail_unless (asset);
+  fail_unless (ges_project_add_asset (project, asset));
+  layer = ges_timeline_append_layer (timeline);
+  clip = ges_layer_add_asset (layer, asset, 0, 0, GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  fail_unless (clip);
+
+  loop = g_main_loop_new (NULL, FALSE);
+  g_signal_connect (asset, "notify::proxy", G_CALLBACK (_proxy_set_cb), loop);
+  ges_project_set_proxy_generation (project, 1, 0, 16);
+  g_main_loop_run (loop);
+  g_signal_handlers_disconnect_by_func (asset, _proxy_set_cb, loop);
+
+  /* A 16 pixels high proxy was transcoded next to the file */
+  proxy = ges_asset_get_proxy (asset);
+  fail_unless (GES_IS_URI_CLIP_ASSET (proxy));
+  fail_unless (ges_meta_container_get_boolean (GES_META_CONTAINER (proxy),
+          "ges-generated-proxy", &generated) && generated);
+  proxy_uri = g_strdup_printf ("%s.16p.proxy.mkv", uri);
+  assert_equals_string (ges_asset_get_id (proxy), proxy_uri);
+  fail_unless (ges_project_get_asset (project, proxy_uri, GES_TYPE_URI_CLIP)
+      == proxy);
+  streams = gst_discoverer_info_get_video_streams (ges_uri_clip_asset_get_info
+      (GES_URI_CLIP_ASSET (proxy)));
+  fail_unless (streams);
+  assert_equals_int (gst_discoverer_video_info_get_height (streams->data),
+      16);
+  gst_discoverer_stream_info_list_free (streams);
+
+  /* Requesting the asset of the file now gives the proxy */
+  requested = ges_asset_request (GES_TYPE_URI_CLIP, uri, NULL);
+  fail_unless (requested == proxy);
+  clip2 = ges_layer_add_asset (layer, requested, GST_SECOND, 0, GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  fail_unless (clip2);
+  gst_object_unref (requested);
+
+  /* Previewing decodes the proxy without changing the asset of the clip */
+  pipeline = ges_test_create_pipeline (timeline);
+  fail_if (gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PAUSED)
+      == GST_STATE_CHANGE_FAILURE);
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), NULL, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+  fail_unless (ges_extractable_get_asset (GES_EXTRACTABLE (clip)) == asset);
+  decoded_uri = _get_decoded_uri (pipeline);
+  assert_equals_string (decoded_uri, proxy_uri);
+  g_free (decoded_uri);
+  fail_if (gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL)
+      == GST_STATE_CHANGE_FAILURE);
+
+  /* while rendering decodes the original file */
+  profile = gst_encoding_profile_from_discoverer (ges_uri_clip_asset_get_info
+      (GES_URI_CLIP_ASSET (asset)));
+  output_uri = g_strconcat (uri, ".rendered.ogg", NULL);
+  fail_unless (ges_pipeline_set_render_settings (pipeline, output_uri,
+          profile));
+  fail_unless (ges_pipeline_set_mode (pipeline, GES_PIPELINE_MODE_RENDER));
+  fail_if (gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PAUSED)
+      == GST_STATE_CHANGE_FAILURE);
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), NULL, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+  fail_unless (ges_extractable_get_asset (GES_EXTRACTABLE (clip)) == asset);
+  fail_unless (ges_extractable_get_asset (GES_EXTRACTABLE (clip2)) == proxy);
+  /* including for the clip created from the proxy */
+  decoded_uri = _get_decoded_uri (pipeline);
+  assert_equals_string (decoded_uri, uri);
+  g_free (decoded_uri);
+  fail_if (gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL)
+      == GST_STATE_CHANGE_FAILURE);
+
+  gst_encoding_profile_unref (profile);
+  gst_object_unref (pipeline);
+  gst_object_unref (asset);
+  gst_object_unref (project);
+  g_main_loop_unref (loop);
+
+  g_unlink (filename);
+  g_free (filename);
+  filename = gst_uri_get_location (proxy_uri);
+  g_unlink (filename);
+  g_free (filename);
+  filename = gst_uri_get_location (output_uri);
+  g_unlink (filename);
+  g_rmdir (tmpdir);
+
+  g_free (output_uri);
+  g_free (proxy_uri);
+  g_free (filename);
+  g_free (tmpdir);
+  g_free (uri);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
 /*  FIXME This test does not pass for some bad reason */
 #if 0
 static void
@@ -766,7 +1206,12 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_project_add_assets);
   tcase_add_test (tc_chain, test_project_load_xges);
   tcase_add_test (tc_chain, test_project_add_properties);
+  tcase_add_test (tc_chain, test_project_binary_round_trip);
+  tcase_add_test (tc_chain, test_project_streaming_round_trip);
+  tcase_add_test (tc_chain, test_project_incremental_save);
   tcase_add_test (tc_chain, test_project_auto_transition);
+  tcase_add_test (tc_chain, test_project_can_load_uri);
+  tcase_add_test (tc_chain, test_project_proxy_generation);
   /*tcase_add_test (tc_chain, test_load_xges_and_play); */
   tcase_add_test (tc_chain, test_project_unexistant_effect);
 
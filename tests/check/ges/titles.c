@@ -207,6 +207,190 @@ GST_START_TEST (test_title_source_in_layer)
 
 GST_END_TEST;
 
+static void
+preroll_and_check (GstElement * pipeline, GstElement * sink)
+{
+  GstMessage *message;
+  GstSample *sample = NULL;
+  GstBus *bus = gst_element_get_bus (pipeline);
+
+  message = gst_bus_timed_pop_filtered (bus, 10 * GST_SECOND,
+      GST_MESSAGE_ASYNC_DONE | GST_MESSAGE_ERROR);
+  fail_unless (message);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (message), GST_MESSAGE_ASYNC_DONE);
+  gst_message_unref (message);
+  gst_object_unref (bus);
+
+  g_object_get (sink, "last-sample", &sample, NULL);
+  fail_unless (sample);
+  fail_unless (gst_sample_get_buffer (sample));
+  gst_sample_unref (sample);
+}
+
+static void
+seek_and_check (GstElement * pipeline, GstElement * sink,
+    GstClockTime position)
+{
+  fail_unless (gst_element_seek_simple (pipeline, GST_FORMAT_TIME,
+          GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE, position));
+  preroll_and_check (pipeline, sink);
+}
+
+static GstElement *
+find_still_frame_source (GstElement * element)
+{
+  GList *tmp;
+  GstElement *res = NULL;
+
+  if (!g_strcmp0 (G_OBJECT_TYPE_NAME (element), "GESStillFrameSource"))
+    return gst_object_ref (element);
+
+  if (!GST_IS_BIN (element))
+    return NULL;
+
+  GST_OBJECT_LOCK (element);
+  for (tmp = GST_BIN_CHILDREN (element); tmp && !res; tmp = tmp->next)
+    res = find_still_frame_source (tmp->data);
+  GST_OBJECT_UNLOCK (element);
+
+  return res;
+}
+
+static GstElement *
+get_still_frame_source (GESClip * clip)
+{
+  GESTrackElement *source = GES_CONTAINER_CHILDREN (clip)->data;
+
+  return find_still_frame_source (ges_track_element_get_nleobject (source));
+}
+
+static GstPadProbeReturn
+record_buffer_cb (GstPad * pad, GstPadProbeInfo * info, GstBuffer ** buffer)
+{
+  gst_buffer_replace (buffer, GST_PAD_PROBE_INFO_BUFFER (info));
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* Records the buffers pushed by the still frame source of @clip, which
+ * exists once @clip got prerolled */
+static void
+record_still_frames (GESClip * clip, GstBuffer ** buffer)
+{
+  GstPad *pad;
+  GstElement *source = get_still_frame_source (clip);
+
+  fail_unless (source);
+  pad = gst_element_get_static_pad (source, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+      (GstPadProbeCallback) record_buffer_cb, buffer, NULL);
+  gst_object_unref (pad);
+  gst_object_unref (source);
+}
+
+static gboolean
+buffers_have_same_content (GstBuffer * buffer, GstBuffer * other)
+{
+  gboolean res;
+  GstMapInfo map, other_map;
+
+  fail_unless (gst_buffer_map (buffer, &map, GST_MAP_READ));
+  fail_unless (gst_buffer_map (other, &other_map, GST_MAP_READ));
+  res = map.size == other_map.size
+      && !memcmp (map.data, other_map.data, map.size);
+  gst_buffer_unmap (buffer, &map);
+  gst_buffer_unmap (other, &other_map);
+
+  return res;
+}
+
+static GESPipeline *
+create_titles_pipeline (gboolean still_frames, GESClip ** title,
+    GESClip ** title2, GstElement ** sink)
+{
+  GESLayer *layer;
+  GESPipeline *pipeline;
+  GESTimeline *timeline = ges_timeline_new ();
+
+  g_object_set (timeline, "still-frames", still_frames, NULL);
+  ges_timeline_add_track (timeline, GES_TRACK (ges_video_track_new ()));
+  layer = ges_timeline_append_layer (timeline);
+
+  *title = GES_CLIP (ges_title_clip_new ());
+  g_object_set (*title, "duration", (guint64) GST_SECOND, "text", "title",
+      NULL);
+  fail_unless (ges_layer_add_clip (layer, *title));
+
+  /* Same content, shares the frame of the first title */
+  *title2 = GES_CLIP (ges_title_clip_new ());
+  g_object_set (*title2, "start", (guint64) GST_SECOND, "duration",
+      (guint64) GST_SECOND, "text", "title", NULL);
+  fail_unless (ges_layer_add_clip (layer, *title2));
+  fail_unless (ges_timeline_commit (timeline));
+
+  pipeline = ges_pipeline_new ();
+  *sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (*sink, "enable-last-sample", TRUE, NULL);
+  ges_pipeline_preview_set_video_sink (pipeline, *sink);
+  fail_unless (ges_pipeline_set_timeline (pipeline, timeline));
+
+  return pipeline;
+}
+
+GST_START_TEST (test_title_source_still_frames)
+{
+  GESPipeline *pipeline;
+  GESClip *title, *title2;
+  GstElement *sink, *source;
+  GstBuffer *frame = NULL, *frame2 = NULL;
+
+  ges_init ();
+
+  pipeline = create_titles_pipeline (TRUE, &title, &title2, &sink);
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PAUSED);
+  preroll_and_check (GST_ELEMENT (pipeline), sink);
+  record_still_frames (title, &frame);
+  seek_and_check (GST_ELEMENT (pipeline), sink, GST_SECOND / 2);
+  fail_unless (frame);
+
+  seek_and_check (GST_ELEMENT (pipeline), sink, GST_SECOND * 3 / 2);
+  record_still_frames (title2, &frame2);
+  seek_and_check (GST_ELEMENT (pipeline), sink, GST_SECOND * 3 / 2);
+  fail_unless (frame2);
+
+  /* The frame got rendered once for both titles */
+  fail_unless (gst_buffer_peek_memory (frame, 0) ==
+      gst_buffer_peek_memory (frame2, 0));
+
+  /* Changing the text renders the frame again */
+  g_object_set (title2, "text", "other title", NULL);
+  gst_clear_buffer (&frame2);
+  seek_and_check (GST_ELEMENT (pipeline), sink, GST_SECOND * 3 / 2);
+  fail_unless (frame2);
+  fail_if (gst_buffer_peek_memory (frame, 0) ==
+      gst_buffer_peek_memory (frame2, 0));
+  fail_if (buffers_have_same_content (frame, frame2));
+
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+  gst_object_unref (pipeline);
+  gst_buffer_unref (frame);
+  gst_buffer_unref (frame2);
+
+  /* Every frame gets rendered by default */
+  pipeline = create_titles_pipeline (FALSE, &title, &title2, &sink);
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PAUSED);
+  preroll_and_check (GST_ELEMENT (pipeline), sink);
+  source = get_still_frame_source (title);
+  fail_if (source);
+
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -218,6 +402,7 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_title_source_basic);
   tcase_add_test (tc_chain, test_title_source_properties);
   tcase_add_test (tc_chain, test_title_source_in_layer);
+  tcase_add_test (tc_chain, test_title_source_still_frames);
 
   return s;
 }
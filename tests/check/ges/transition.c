@@ -21,6 +21,7 @@
 #include "test-utils.h"
 #include <ges/ges.h>
 #include <gst/check/gstcheck.h>
+#include <gst/audio/audio.h>
 
 /* This test uri will eventually have to be fixed */
 #define TEST_URI "blahblahblah"
@@ -176,7 +177,304 @@ GST_START_TEST (test_transition_properties)
 
 GST_END_TEST;
 
+#define NATIVE_WIDTH 64
 
+/* Whether @pipeline contains an element whose type is called @type_name */
+static gboolean
+has_element_of_type (GESPipeline * pipeline, const gchar * type_name)
+{
+  gboolean found = FALSE;
+  GValue item = G_VALUE_INIT;
+  GstIterator *it = gst_bin_iterate_recurse (GST_BIN (pipeline));
+
+  while (!found && gst_iterator_next (it, &item) == GST_ITERATOR_OK) {
+    found = !g_strcmp0 (G_OBJECT_TYPE_NAME (g_value_get_object (&item)),
+        type_name);
+    g_value_reset (&item);
+  }
+  g_value_unset (&item);
+  gst_iterator_free (it);
+
+  return found;
+}
+
+/* Prerolls the middle of a @type transition from a red clip to a blue one
+ * and returns the first pixel of the output, in RGBA, and whether the
+ * native transition mixers got used */
+static void
+preroll_transition (gboolean native, GESVideoStandardTransitionType type,
+    guint8 pixel[4], gboolean * native_video, gboolean * native_audio)
+{
+  GList *clips, *tmp;
+  GESAsset *asset;
+  GESLayer *layer;
+  GESClip *red, *blue;
+  GESTrack *track;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+  GstElement *sink;
+  GstSample *sample;
+  GstCaps *caps;
+  GstMapInfo map;
+
+  track = GES_TRACK (ges_video_track_new ());
+  caps = gst_caps_new_simple ("video/x-raw", "format", G_TYPE_STRING, "RGBA",
+      "width", G_TYPE_INT, NATIVE_WIDTH, "height", G_TYPE_INT, 48, NULL);
+  ges_track_set_restriction_caps (track, caps);
+  gst_caps_unref (caps);
+
+  timeline = ges_timeline_new ();
+  g_object_set (timeline, "native-transitions", native, NULL);
+  fail_unless (ges_timeline_add_track (timeline, track));
+  fail_unless (ges_timeline_add_track (timeline,
+          GES_TRACK (ges_audio_track_new ())));
+  layer = ges_timeline_append_layer (timeline);
+  ges_layer_set_auto_transition (layer, TRUE);
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  red = ges_layer_add_asset (layer, asset, 0, 0, 2 * GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  blue = ges_layer_add_asset (layer, asset, GST_SECOND, 0, 2 * GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  gst_object_unref (asset);
+  ges_test_clip_set_vpattern (GES_TEST_CLIP (red),
+      GES_VIDEO_TEST_PATTERN_RED);
+  ges_test_clip_set_vpattern (GES_TEST_CLIP (blue),
+      GES_VIDEO_TEST_PATTERN_BLUE);
+
+  clips = ges_layer_get_clips (layer);
+  for (tmp = clips; tmp; tmp = tmp->next) {
+    if (GES_IS_TRANSITION_CLIP (tmp->data))
+      g_object_set (tmp->data, "vtype", type, NULL);
+  }
+  g_list_free_full (clips, gst_object_unref);
+  fail_unless (ges_timeline_commit (timeline));
+
+  pipeline = ges_test_create_pipeline (timeline);
+  g_object_get (pipeline, "video-sink", &sink, NULL);
+  g_object_set (sink, "enable-last-sample", TRUE, NULL);
+  fail_if (gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PAUSED)
+      == GST_STATE_CHANGE_FAILURE);
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), NULL, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+  fail_unless (gst_element_seek_simple (GST_ELEMENT (pipeline),
+          GST_FORMAT_TIME, GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE,
+          GST_SECOND + GST_SECOND / 2));
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), NULL, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+
+  *native_video = has_element_of_type (pipeline, "GESVideoTransitionMixer");
+  *native_audio = has_element_of_type (pipeline, "GESAudioTransitionMixer");
+
+  g_object_get (sink, "last-sample", &sample, NULL);
+  fail_unless (sample);
+  fail_unless (gst_buffer_map (gst_sample_get_buffer (sample), &map,
+          GST_MAP_READ));
+  memcpy (pixel, map.data, 4);
+  gst_buffer_unmap (gst_sample_get_buffer (sample), &map);
+  gst_sample_unref (sample);
+  gst_object_unref (sink);
+
+  fail_if (gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL)
+      == GST_STATE_CHANGE_FAILURE);
+  gst_object_unref (pipeline);
+}
+
+/* Mixes @a and @b, the first one being faded out, with a new instance of
+ * the native transition mixer called @type_name, and returns all the
+ * output as a single buffer */
+static GstBuffer *
+mix_buffers (const gchar * type_name, const gchar * caps_str, GstBuffer * a,
+    GstBuffer * b, const gchar * first_property_name, ...)
+{
+  guint i;
+  va_list args;
+  GstCaps *caps;
+  GstSample *sample;
+  GstFlowReturn flow;
+  GstBuffer *mixed, *inputs[2] = { a, b };
+  GstElement *pipeline, *mixer, *sink, *srcs[2];
+  GType type = g_type_from_name (type_name);
+
+  fail_unless (type, "%s is not registered", type_name);
+  mixer = g_object_new (type, NULL);
+  va_start (args, first_property_name);
+  g_object_set_valist (G_OBJECT (mixer), first_property_name, args);
+  va_end (args);
+
+  pipeline = gst_pipeline_new (NULL);
+  caps = gst_caps_from_string (caps_str);
+  sink = gst_element_factory_make ("appsink", NULL);
+  g_object_set (sink, "caps", caps, "sync", FALSE, NULL);
+  gst_bin_add_many (GST_BIN (pipeline), mixer, sink, NULL);
+  fail_unless (gst_element_link (mixer, sink));
+
+  for (i = 0; i < 2; i++) {
+    GstPad *srcpad, *sinkpad;
+
+    srcs[i] = gst_element_factory_make ("appsrc", NULL);
+    g_object_set (srcs[i], "caps", caps, "format", GST_FORMAT_TIME, NULL);
+    gst_bin_add (GST_BIN (pipeline), srcs[i]);
+
+    srcpad = gst_element_get_static_pad (srcs[i], "src");
+    sinkpad = gst_element_request_pad_simple (mixer, "sink_%u");
+    fail_unless (gst_pad_link (srcpad, sinkpad) == GST_PAD_LINK_OK);
+    gst_object_unref (srcpad);
+    gst_object_unref (sinkpad);
+  }
+  gst_caps_unref (caps);
+
+  fail_if (gst_element_set_state (pipeline, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE);
+  for (i = 0; i < 2; i++) {
+    g_signal_emit_by_name (srcs[i], "push-buffer", inputs[i], &flow);
+    assert_equals_int (flow, GST_FLOW_OK);
+    g_signal_emit_by_name (srcs[i], "end-of-stream", &flow);
+  }
+
+  mixed = gst_buffer_new ();
+  for (;;) {
+    g_signal_emit_by_name (sink, "pull-sample", &sample);
+    if (!sample)
+      break;
+
+    mixed = gst_buffer_append (mixed,
+        gst_buffer_ref (gst_sample_get_buffer (sample)));
+    gst_sample_unref (sample);
+  }
+
+  fail_if (gst_element_set_state (pipeline, GST_STATE_NULL) ==
+      GST_STATE_CHANGE_FAILURE);
+  gst_object_unref (pipeline);
+
+  return mixed;
+}
+
+/* A 4x1 RGBA frame of @color, lasting 100ms */
+static GstBuffer *
+new_frame (guint32 color)
+{
+  guint i;
+  GstBuffer *buffer = gst_buffer_new_allocate (NULL, 4 * 4, NULL);
+  GstMapInfo map;
+
+  gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+  for (i = 0; i < 4; i++)
+    GST_WRITE_UINT32_BE (map.data + i * 4, color);
+  gst_buffer_unmap (buffer, &map);
+  GST_BUFFER_PTS (buffer) = 0;
+  GST_BUFFER_DURATION (buffer) = GST_SECOND / 10;
+
+  return buffer;
+}
+
+/* 100 mono S32 samples of @value at 1000Hz */
+static GstBuffer *
+new_samples (gint32 value)
+{
+  guint i;
+  GstBuffer *buffer = gst_buffer_new_allocate (NULL, 100 * 4, NULL);
+  GstMapInfo map;
+
+  gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+  for (i = 0; i < 100; i++)
+    ((gint32 *) map.data)[i] = value;
+  gst_buffer_unmap (buffer, &map);
+  GST_BUFFER_PTS (buffer) = 0;
+  GST_BUFFER_DURATION (buffer) = GST_SECOND / 10;
+
+  return buffer;
+}
+
+#define FRAME_CAPS "video/x-raw, format=RGBA, width=4, height=1, " \
+    "framerate=10/1"
+#define SAMPLES_CAPS "audio/x-raw, format=" GST_AUDIO_NE (S32) ", " \
+    "rate=1000, channels=1, layout=interleaved"
+
+GST_START_TEST (test_transition_native_mixers)
+{
+  guint i;
+  guint8 pixel[4];
+  GstMapInfo map;
+  GstBuffer *a, *b, *mixed;
+  gboolean native_video, native_audio;
+
+  ges_init ();
+
+  /* Disabled by default, the bins blending the clips */
+  preroll_transition (FALSE, GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE,
+      pixel, &native_video, &native_audio);
+  fail_if (native_video);
+  fail_if (native_audio);
+  fail_unless (pixel[0] > 96 && pixel[0] < 160, "Not blended: %u", pixel[0]);
+  fail_unless (pixel[2] > 96 && pixel[2] < 160, "Not blended: %u", pixel[2]);
+
+  /* The native mixers blend them the same way */
+  preroll_transition (TRUE, GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE,
+      pixel, &native_video, &native_audio);
+  fail_unless (native_video);
+  fail_unless (native_audio);
+  fail_unless (pixel[0] > 96 && pixel[0] < 160, "Not blended: %u", pixel[0]);
+  assert_equals_int (pixel[1], 0);
+  fail_unless (pixel[2] > 96 && pixel[2] < 160, "Not blended: %u", pixel[2]);
+  assert_equals_int (pixel[3], 255);
+
+  /* Types the native mixer does not implement use the bins */
+  preroll_transition (TRUE, GES_VIDEO_STANDARD_TRANSITION_TYPE_CLOCK_CW12,
+      pixel, &native_video, &native_audio);
+  fail_if (native_video);
+  fail_unless (native_audio);
+
+  /* A quarter of a crossfade */
+  a = new_frame (0xc8000aff);
+  b = new_frame (0x28ff64ff);
+  mixed = mix_buffers ("GESVideoTransitionMixer", FRAME_CAPS, a, b,
+      "position", 0.25, NULL);
+  fail_unless (gst_buffer_map (mixed, &map, GST_MAP_READ));
+  assert_equals_int (map.size, 4 * 4);
+  for (i = 0; i < 4; i++) {
+    assert_equals_int (map.data[i * 4], (200 * 192 + 40 * 64) >> 8);
+    assert_equals_int (map.data[i * 4 + 1], (255 * 64) >> 8);
+    assert_equals_int (map.data[i * 4 + 2], (10 * 192 + 100 * 64) >> 8);
+    assert_equals_int (map.data[i * 4 + 3], 255);
+  }
+  gst_buffer_unmap (mixed, &map);
+  gst_buffer_unref (mixed);
+
+  /* Half of a left to right wipe, the second frame covering the left half */
+  mixed = mix_buffers ("GESVideoTransitionMixer", FRAME_CAPS, a, b,
+      "position", 0.5, "type", GES_VIDEO_STANDARD_TRANSITION_TYPE_BAR_WIPE_LR,
+      NULL);
+  fail_unless (gst_buffer_map (mixed, &map, GST_MAP_READ));
+  assert_equals_int (GST_READ_UINT32_BE (map.data), 0x28ff64ff);
+  assert_equals_int (GST_READ_UINT32_BE (map.data + 4), 0x28ff64ff);
+  assert_equals_int (GST_READ_UINT32_BE (map.data + 8), 0xc8000aff);
+  assert_equals_int (GST_READ_UINT32_BE (map.data + 12), 0xc8000aff);
+  gst_buffer_unmap (mixed, &map);
+  gst_buffer_unref (mixed);
+  gst_buffer_unref (a);
+  gst_buffer_unref (b);
+
+  /* A quarter of an audio crossfade, in the default format of audio
+   * tracks */
+  a = new_samples (1 << 20);
+  b = new_samples (-(1 << 21));
+  mixed = mix_buffers ("GESAudioTransitionMixer", SAMPLES_CAPS, a, b,
+      "position", 0.25, NULL);
+  fail_unless (gst_buffer_map (mixed, &map, GST_MAP_READ));
+  assert_equals_int (map.size, 100 * 4);
+  for (i = 0; i < 100; i++)
+    assert_equals_int (((gint32 *) map.data)[i],
+        (1 << 20) * 3 / 4 - (1 << 21) / 4);
+  gst_buffer_unmap (mixed, &map);
+  gst_buffer_unref (mixed);
+  gst_buffer_unref (a);
+  gst_buffer_unref (b);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
 
 static Suite *
 ges_suite (void)
@@ -188,6 +486,7 @@ ges_suite (void)
 
   tcase_add_test (tc_chain, test_transition_basic);
   tcase_add_test (tc_chain, test_transition_properties);
+  tcase_add_test (tc_chain, test_transition_native_mixers);
 
   return s;
 }
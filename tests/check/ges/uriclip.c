@@ -274,6 +274,103 @@ GST_START_TEST (test_filesource_images)
 GST_END_TEST;
 
 
+static gboolean
+_clip_has_element (GESClip * clip, const gchar * type_name)
+{
+  GList *tmp, *children;
+  GstIterator *it;
+  GValue item = G_VALUE_INIT;
+  gboolean found = FALSE;
+
+  children = ges_container_get_children (GES_CONTAINER (clip), FALSE);
+  for (tmp = children; tmp && !found; tmp = tmp->next) {
+    it = gst_bin_iterate_recurse (GST_BIN (ges_track_element_get_nleobject
+            (tmp->data)));
+    while (!found && gst_iterator_next (it, &item) == GST_ITERATOR_OK) {
+      found = !g_strcmp0 (G_OBJECT_TYPE_NAME (g_value_get_object (&item)),
+          type_name);
+      g_value_reset (&item);
+    }
+    g_value_unset (&item);
+    gst_iterator_free (it);
+  }
+  g_list_free_full (children, gst_object_unref);
+
+  return found;
+}
+
+GST_START_TEST (test_filesource_decoder_pool)
+{
+  GstBus *bus;
+  GstMessage *message;
+  GESClip *clip;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+  GESUriClipAsset *asset;
+  guint size, hits, misses;
+
+  ges_init ();
+
+  asset = ges_uri_clip_asset_request_sync (av_uri, NULL);
+  fail_unless (asset);
+
+  timeline = ges_timeline_new_audio_video ();
+  g_object_get (timeline, "decoder-pool-size", &size, NULL);
+  assert_equals_int (size, 0);
+
+  /* Without a pool, the sources keep using a bare uridecodebin */
+  layer = ges_timeline_append_layer (timeline);
+  clip = ges_layer_add_asset (layer, GES_ASSET (asset), 0, 0, GST_SECOND / 2,
+      GES_TRACK_TYPE_UNKNOWN);
+  fail_unless (clip);
+  fail_if (_clip_has_element (clip, "GESUriDecodeBin"));
+  fail_unless (_clip_has_element (clip, "GstURIDecodeBin"));
+  fail_unless (ges_timeline_remove_layer (timeline, layer));
+
+  g_object_set (timeline, "decoder-pool-size", 2, NULL);
+
+  /* Two cuts of the same file played one after the other, the second ones
+   * should reuse the decoders of the first ones */
+  layer = ges_timeline_append_layer (timeline);
+  clip = ges_layer_add_asset (layer, GES_ASSET (asset), 0, 0, GST_SECOND / 2,
+      GES_TRACK_TYPE_UNKNOWN);
+  fail_unless (clip);
+  fail_unless (_clip_has_element (clip, "GESUriDecodeBin"));
+  fail_unless (ges_layer_add_asset (layer, GES_ASSET (asset), GST_SECOND / 2,
+          GST_SECOND / 2, GST_SECOND / 2, GES_TRACK_TYPE_UNKNOWN));
+  ges_timeline_commit (timeline);
+
+  pipeline = ges_test_create_pipeline (timeline);
+  bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+  fail_if (gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PLAYING)
+      == GST_STATE_CHANGE_FAILURE);
+  message = gst_bus_timed_pop_filtered (bus, 10 * GST_SECOND,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (message);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (message), GST_MESSAGE_EOS);
+  gst_message_unref (message);
+
+  ges_timeline_get_decoder_pool_stats (timeline, &hits, &misses);
+  GST_INFO ("Decoder pool hits: %u, misses: %u", hits, misses);
+  fail_unless (hits >= 1);
+  fail_unless (misses >= 2);
+
+  fail_if (gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL)
+      == GST_STATE_CHANGE_FAILURE);
+
+  /* Disabling the pool releases the idle decoders */
+  g_object_set (timeline, "decoder-pool-size", 0, NULL);
+
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+  gst_object_unref (asset);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -285,6 +382,7 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_filesource_basic);
   tcase_add_test (tc_chain, test_filesource_images);
   tcase_add_test (tc_chain, test_filesource_properties);
+  tcase_add_test (tc_chain, test_filesource_decoder_pool);
 
   return s;
 }
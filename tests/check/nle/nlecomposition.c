@@ -296,6 +296,103 @@ GST_START_TEST (test_remove_last_object)
 
 GST_END_TEST;
 
+/* Waits up to 5 seconds for @element to be moved to a bin named @name */
+static gboolean
+_wait_for_parent (GstElement * element, const gchar * name)
+{
+  gint i;
+
+  for (i = 0; i < 500; i++) {
+    gboolean found;
+    GstObject *parent = gst_object_get_parent (GST_OBJECT (element));
+
+    found = parent && !g_strcmp0 (GST_OBJECT_NAME (parent), name);
+    gst_clear_object (&parent);
+    if (found)
+      return TRUE;
+
+    g_usleep (10000);
+  }
+
+  return FALSE;
+}
+
+GST_START_TEST (test_lookahead)
+{
+  gboolean ret;
+  GstBus *bus;
+  GstMessage *message;
+  GstElement *pipeline, *composition, *fakesink, *source1, *source2;
+  GstElement *audiotestsrc;
+
+  ges_init ();
+
+  pipeline = GST_ELEMENT (gst_pipeline_new (NULL));
+  bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+
+  composition = gst_element_factory_make ("nlecomposition", "composition");
+  g_object_set (composition, "lookahead", TRUE, NULL);
+  gst_element_set_state (composition, GST_STATE_READY);
+
+  fakesink = gst_element_factory_make ("fakeaudiosink", NULL);
+  g_object_set (fakesink, "sync", FALSE, NULL);
+  gst_bin_add_many (GST_BIN (pipeline), composition, fakesink, NULL);
+  gst_element_link (composition, fakesink);
+
+  source1 = gst_element_factory_make ("nlesource", "source1");
+  audiotestsrc = gst_element_factory_make ("audiotestsrc", NULL);
+  gst_bin_add (GST_BIN (source1), audiotestsrc);
+  g_object_set (source1, "start", (guint64) 0, "duration", GST_SECOND,
+      "inpoint", (guint64) 0, "priority", 1, NULL);
+  nle_composition_add (GST_BIN (composition), source1);
+
+  source2 = gst_element_factory_make ("nlesource", "source2");
+  audiotestsrc = gst_element_factory_make ("audiotestsrc", NULL);
+  gst_bin_add (GST_BIN (source2), audiotestsrc);
+  g_object_set (source2, "start", GST_SECOND, "duration", GST_SECOND,
+      "inpoint", (guint64) 0, "priority", 1, NULL);
+  nle_composition_add (GST_BIN (composition), source2);
+  gst_object_ref (source2);
+
+  fail_if (gst_element_set_state (pipeline, GST_STATE_PAUSED)
+      == GST_STATE_CHANGE_FAILURE);
+  commit_and_wait (composition, &ret);
+  message = gst_bus_timed_pop_filtered (bus, 5 * GST_SECOND,
+      GST_MESSAGE_ASYNC_DONE | GST_MESSAGE_ERROR);
+  fail_unless (message);
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+    fail_error_message (message);
+  gst_message_unref (message);
+
+  /* The source of the next stack gets prerolled while the first one is
+   * the current stack, which can happen after ASYNC_DONE */
+  fail_unless (_wait_for_parent (source2, "lookahead-bin"));
+  check_state_simple (source2, GST_STATE_PAUSED);
+
+  /* And gets used once playback reaches it */
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  message = gst_bus_timed_pop_filtered (bus, 10 * GST_SECOND,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (message);
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+    fail_error_message (message);
+  gst_message_unref (message);
+
+  parent = GST_ELEMENT (gst_object_get_parent (GST_OBJECT (source2)));
+  fail_unless (parent);
+  fail_unless_equals_string (GST_OBJECT_NAME (parent), "current-bin");
+  gst_object_unref (parent);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (source2);
+  gst_object_unref (pipeline);
+  gst_object_unref (bus);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_dispose_on_commit)
 {
   GstElement *composition;
@@ -764,6 +861,7 @@ gnonlin_suite (void)
   tcase_add_test (tc_chain, test_nest_deep);
 
   tcase_add_test (tc_chain, test_dispose_on_commit);
+  tcase_add_test (tc_chain, test_lookahead);
 
   if (gst_registry_check_feature_version (gst_registry_get (), "audiomixer", 1,
           0, 0)) {
@@ -743,6 +743,79 @@ GST_START_TEST (test_one_bin_after_other)
 
 GST_END_TEST;
 
+#define NUM_SCRUB_SEEKS 50
+
+GST_START_TEST (test_scrubbing)
+{
+  guint i;
+  gboolean ret;
+  GstBus *bus;
+  GstMessage *message;
+  gint64 position;
+  guint64 dropped = 0, executed = 0;
+  GstElement *pipeline, *comp, *source1, *source2, *sink;
+
+  pipeline = gst_pipeline_new ("test_pipeline");
+  comp =
+      gst_element_factory_make_or_warn ("nlecomposition", "test_composition");
+  fail_if (comp == NULL);
+  g_object_set (comp, "scrubbing", TRUE, NULL);
+
+  source1 = videotest_nle_src ("source1", 0, 5 * GST_SECOND, 2, 1);
+  source2 = videotest_nle_src ("source2", 5 * GST_SECOND, 5 * GST_SECOND, 3,
+      1);
+  nle_composition_add (GST_BIN (comp), source1);
+  nle_composition_add (GST_BIN (comp), source2);
+  commit_and_wait (comp, &ret);
+  fail_unless (ret);
+
+  sink = gst_element_factory_make_or_warn ("fakevideosink", "sink");
+  fail_if (sink == NULL);
+  gst_bin_add_many (GST_BIN (pipeline), comp, sink, NULL);
+  gst_element_link (comp, sink);
+
+  bus = gst_element_get_bus (pipeline);
+  fail_if (gst_element_set_state (pipeline,
+          GST_STATE_PAUSED) == GST_STATE_CHANGE_FAILURE);
+  message = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_ASYNC_DONE | GST_MESSAGE_ERROR);
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+    fail_error_message (message);
+  gst_message_unref (message);
+
+  /* Scrub back and forth across the two stacks faster than they can
+   * preroll, every seek is either handled or superseded by a later one */
+  for (i = 0; i < NUM_SCRUB_SEEKS; i++)
+    fail_unless (gst_element_seek_simple (pipeline, GST_FORMAT_TIME,
+            GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE,
+            (i % 2) ? 7 * GST_SECOND : 2 * GST_SECOND));
+
+  for (i = 0; i < 100 && dropped + executed < NUM_SCRUB_SEEKS; i++) {
+    g_usleep (G_USEC_PER_SEC / 20);
+    g_object_get (comp, "dropped-seeks", &dropped, "executed-seeks",
+        &executed, NULL);
+  }
+
+  GST_INFO ("Dropped %" G_GUINT64_FORMAT " seeks, executed %" G_GUINT64_FORMAT,
+      dropped, executed);
+  fail_unless_equals_uint64 (dropped + executed, NUM_SCRUB_SEEKS);
+  fail_unless (executed > 0);
+
+  /* The last seek is never superseded and ends up prerolled */
+  fail_unless_equals_int (gst_element_get_state (pipeline, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+  fail_unless (gst_element_query_position (pipeline, GST_FORMAT_TIME,
+          &position));
+  fail_unless_equals_uint64 (position, 7 * GST_SECOND);
+
+  fail_if (gst_element_set_state (pipeline,
+          GST_STATE_NULL) == GST_STATE_CHANGE_FAILURE);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
 
 static Suite *
 gnonlin_suite (void)
@@ -766,6 +839,7 @@ gnonlin_suite (void)
   tcase_add_test (tc_chain, test_one_after_other);
   tcase_add_test (tc_chain, test_one_under_another);
   tcase_add_test (tc_chain, test_one_bin_after_other);
+  tcase_add_test (tc_chain, test_scrubbing);
 
   if (compositor_element) {
     tcase_add_test (tc_chain, test_complex_operations);
@@ -568,6 +568,27 @@ _set_rendering_details (GESLauncher * self)
   return TRUE;
 }
 
+static void
+_render_segmented (GESLauncher * self)
+{
+  GError *err = NULL;
+  GESLauncherParsedOptions *opts = &self->priv->parsed_options;
+
+  gst_print ("\nRendering in up to %d parallel segments\n",
+      opts->render_segments);
+  if (opts->render_cache)
+    ges_pipeline_set_render_cache (self->priv->pipeline, opts->render_cache,
+        0);
+  if (!ges_pipeline_render_segmented (self->priv->pipeline,
+          opts->render_segments, &err)) {
+    ges_printerr ("Could not render: %s\n", err->message);
+    g_error_free (err);
+    self->priv->seenerrors = TRUE;
+  }
+
+  g_application_quit (G_APPLICATION (self));
+}
+
 static void
 _track_set_mixing (GESTrack * track, GESLauncherParsedOptions * opts)
 {
@@ -699,6 +720,11 @@ _project_loaded_cb (GESProject * project, GESTimeline * timeline,
 
   g_free (project_uri);
 
+  if (!self->priv->seenerrors && opts->outputuri && opts->render_segments > 1) {
+    _render_segmented (self);
+    return;
+  }
+
   if (!self->priv->seenerrors && opts->needs_set_state &&
       gst_element_set_state (GST_ELEMENT (self->priv->pipeline),
           GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
@@ -955,6 +981,13 @@ _run_pipeline (GESLauncher * self)
   g_signal_connect (bus, "message", G_CALLBACK (bus_message_cb), self);
 
   if (!opts->load_path) {
+    if (opts->outputuri && opts->render_segments > 1) {
+      g_application_hold (G_APPLICATION (self));
+      _render_segmented (self);
+
+      return TRUE;
+    }
+
     if (opts->needs_set_state
         && gst_element_set_state (GST_ELEMENT (self->priv->pipeline),
             GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
@@ -1125,6 +1158,16 @@ ges_launcher_get_rendering_option_group (GESLauncherParsedOptions * opts)
     {"smart-rendering", 0, 0, G_OPTION_ARG_NONE, &opts->smartrender,
           "Avoid reencoding when rendering. This option implies --disable-mixing.",
         NULL},
+    {"render-segments", 0, 0, G_OPTION_ARG_INT, &opts->render_segments,
+          "Split the timeline in up to N segments that are rendered in parallel "
+          "and then concatenated. "
+          "This will have no effect if no outputuri has been specified.",
+        "<N>"},
+    {"render-cache", 0, 0, G_OPTION_ARG_FILENAME, &opts->render_cache,
+          "Keep the rendered regions of the timeline in a directory so that "
+          "only the modified ones are encoded again in the next renders. "
+          "This will have no effect if --render-segments is not set.",
+        "<directory>"},
     {NULL}
   };
 
@@ -1510,6 +1553,7 @@ _finalize (GObject * object)
   g_free (opts->outputuri);
   g_free (opts->format);
   g_free (opts->encoding_profile);
+  g_free (opts->render_cache);
   g_free (opts->videosink);
   g_free (opts->audiosink);
   g_free (opts->video_track_caps);
@@ -33,6 +33,8 @@ typedef struct
   GESTrackType track_types;
   gboolean needs_set_state;
   gboolean smartrender;
+  gint render_segments;
+  gchar *render_cache;
   gchar *scenario;
   gchar *testfile;
   gchar *format;